@@ -173,6 +173,8 @@ int main (int argc, char** argv)
     // The Optimization:
     //
     // Your job is to loop, calling anneal.step(), until anneal.state tells you to stop...
+    // (Alternatively, set anneal.objective and call anneal.run(), or anneal.run_tempering()
+    // to run several chains concurrently, if your objective function is thread-safe.)
     while (anneal.state != morph::Anneal_State::ReadyToStop) {
 
         // ...and on each loop, compute the objectives that anneal asks you to:
@@ -24,6 +24,8 @@ int main()
     v.showTitle (true);
     v.backgroundWhite();
     v.lightingEffects();
+    // The scenes are static, so only re-draw a window when something in it changes
+    v.renderOnDemand (true);
 
     { // I create two morph::Visuals here in their own scope, so that I can demonstrate the creation
       // of a new, follow-on morph::Visual at the end
@@ -34,6 +36,7 @@ int main()
         v2.showTitle (true);
         v2.backgroundWhite();
         v2.lightingEffects();
+        v2.renderOnDemand (true);
 
         try {
             // Set up data for the first Visual
@@ -89,6 +92,7 @@ int main()
     v3.showTitle (true);
     v3.backgroundWhite();
     v3.lightingEffects();
+    v3.renderOnDemand (true);
 
     while (v3.readyToFinish() == false && v.readyToFinish() == false) {
         v3.waitevents (0.018);
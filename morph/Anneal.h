@@ -5,6 +5,11 @@
  * Ingber, L. (1989). Very fast simulated re-annealing. Mathematical and Computer
  * Modelling 12, 967-973.
  *
+ * Set Anneal::objective and call run() to have the class evaluate the objective itself,
+ * or call run_tempering() to run several chains at different acceptance temperatures
+ * concurrently (with OpenMP), exchanging their states every few steps (parallel
+ * tempering, or replica exchange).
+ *
  * Author: Seb James
  * Date: September 2021
  */
@@ -13,6 +18,8 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <cmath>
+#include <functional>
 #include <morph/MathAlgo.h>
 #include <morph/vvec.h>
 #include <morph/vec.h>
@@ -32,7 +39,8 @@ namespace morph {
         NeedToStep,
         // Client code needs to compute the objective of the candidate
         NeedToCompute,
-        // Client needs to compute the objectives of a set of parameter sets, x_set
+        // Client needs to compute the objective of x_plusdelta or, if tangent_set is
+        // true, the objectives of the set of parameter sets, x_set
         NeedToComputeSet,
         // The algorithm has finished
         ReadyToStop
@@ -102,6 +110,22 @@ namespace morph {
         bool display_temperatures = true;
         // Display info on reannealing?
         bool display_reanneal = true;
+        /*!
+         * If true, a reanneal estimates each of the D tangents of the objective from its
+         * own parameter set, x_set[i], in which only parameter i is changed. This costs D
+         * objective evaluations rather than one, but the evaluations are independent, so
+         * run() will compute them concurrently if parallel is true.
+         */
+        bool tangent_set = false;
+        /*!
+         * If true, run() evaluates the objective for the parameter sets in x_set
+         * concurrently (with OpenMP). Only set this if your objective function is
+         * thread-safe.
+         */
+        bool parallel = false;
+        //! The acceptance temperature T_cost is multiplied by this factor in the
+        //! acceptance function. run_tempering() sets it for each of its chains.
+        T tempering_factor = T{1};
 
     public: // Parameter vectors and objective fn results need to be client-accessible.
 
@@ -125,8 +149,21 @@ namespace morph {
         unsigned int f_x_best_repeats = 0;
         //! A special set of parameters to ask the user to compute (when computing reanneal).
         morph::vvec<T> x_plusdelta;
-        //! The set of objective function values for x_set.
+        //! The objective function value for x_plusdelta.
         T f_x_plusdelta = T{0};
+        //! If tangent_set is true, the parameter sets to compute on reannealing. x_set[i]
+        //! is x, with element i changed to x_plusdelta[i].
+        morph::vvec<morph::vvec<T>> x_set;
+        //! The objective function values for x_set.
+        morph::vvec<T> f_x_set;
+
+        /*!
+         * The objective function, used by run() and run_tempering(). Set it in your
+         * client code with something like:
+         *
+         * anneal.objective = myobj;
+         */
+        std::function<T(const morph::vvec<T>& params)> objective = {};
 
     public: // Statistical records and state.
 
@@ -153,6 +190,12 @@ namespace morph {
 
         //! Absolute count of number of calls to ::step().
         unsigned int steps = 0;
+        //! The number of times run() or run_tempering() have evaluated the objective
+        unsigned long long int evaluation_count = 0ULL;
+        //! The number of state exchanges between chains attempted by run_tempering()
+        unsigned int num_exchanges_attempted = 0;
+        //! The number of state exchanges between chains made by run_tempering()
+        unsigned int num_exchanges_accepted = 0;
         //! A history of all accepted parameters evaluated
         morph::vvec<morph::vvec<T>> param_hist_accepted;
         //! For each entry in param_hist, record also its objective function value.
@@ -296,7 +339,11 @@ namespace morph {
 
             if (this->state == Anneal_State::NeedToComputeSet) {
                 this->complete_reanneal();
-                this->state = Anneal_State::NeedToStep;
+                // The candidate generated before the reanneal was never evaluated (and x
+                // has moved to x_best), so generate a new one for the client to compute.
+                this->generate_next();
+                this->state = Anneal_State::NeedToCompute;
+                return;
             }
 
             this->cooling_schedule();
@@ -315,6 +362,86 @@ namespace morph {
             }
         }
 
+        /*!
+         * Run the optimization, evaluating the objective function as the state requires. If
+         * it returns false, you didn't set the objective function. Calls init() if you
+         * haven't.
+         */
+        bool run()
+        {
+            if (!this->objective) { return false; } // user did not set an objective function
+            if (this->state == Anneal_State::NeedToInit) { this->init(); }
+            while (this->state != Anneal_State::ReadyToStop) {
+                this->evaluate_requested();
+                this->step();
+            }
+            return true;
+        }
+
+        /*!
+         * Run M chains at once (with OpenMP), each a copy of this Anneal with its
+         * acceptance temperature multiplied by a factor that rises geometrically from 1,
+         * for chain 0, to \a hottest, for chain M-1. Every \a exchange_every steps,
+         * neighbouring chains offer to swap their current parameters (along with their
+         * pending candidates) using the Metropolis criterion, so that states found by the
+         * hotter, more exploratory chains can move down to the colder ones. The objective
+         * function must be thread-safe.
+         *
+         * The run finishes when chain 0 reaches ReadyToStop. Afterwards, *this holds chain
+         * 0, along with its histories (so that save() records the coldest chain), but with
+         * x_best and f_x_best set from whichever chain found the best objective. Copies of
+         * all the chains are written into \a chains, if it is non-null.
+         *
+         * \return The index of the chain that found the best objective, or -1 if there was
+         * no objective.
+         */
+        int run_tempering (unsigned int M, unsigned int exchange_every = 10, T hottest = T{10},
+                           std::vector<Anneal<T, debug>>* chains = nullptr)
+        {
+            if (!this->objective || M == 0) { return -1; }
+            if (this->state == Anneal_State::NeedToInit) { this->init(); }
+
+            const int nch = static_cast<int>(M);
+            std::vector<Anneal<T, debug>> ch (M, *this);
+            for (int j = 0; j < nch; ++j) {
+                ch[j].tempering_factor = nch > 1 ? std::pow (hottest, static_cast<T>(j) / (nch - 1)) : T{1};
+            }
+
+            unsigned int round = 0;
+            while (ch[0].state != Anneal_State::ReadyToStop) {
+#pragma omp parallel for schedule(dynamic)
+                for (int j = 0; j < nch; ++j) {
+                    if (ch[j].state == Anneal_State::ReadyToStop) { continue; }
+                    ch[j].evaluate_requested();
+                    ch[j].step();
+                }
+                ++round;
+                if (exchange_every > 0 && round % exchange_every == 0) {
+                    this->exchange (ch, (round / exchange_every) % 2);
+                }
+            }
+
+            int best = 0;
+            unsigned long long int evals = 0ULL;
+            for (int j = 0; j < nch; ++j) {
+                evals += ch[j].evaluation_count;
+                if ((this->downhill && ch[j].f_x_best < ch[best].f_x_best)
+                    || (!this->downhill && ch[j].f_x_best > ch[best].f_x_best)) {
+                    best = j;
+                }
+            }
+            const unsigned int n_att = this->num_exchanges_attempted;
+            const unsigned int n_acc = this->num_exchanges_accepted;
+            *this = ch[0];
+            this->x_best = ch[best].x_best;
+            this->f_x_best = ch[best].f_x_best;
+            this->evaluation_count = evals;
+            this->num_exchanges_attempted = n_att;
+            this->num_exchanges_accepted = n_acc;
+            if (chains != nullptr) { chains->swap (ch); }
+            return best;
+        }
+
         //! Save optimization info/history into an HDF5 file. Save the optimization
         //! parameters too, along with the temperature histories.
         void save (const std::string& path) const
@@ -342,6 +469,9 @@ namespace morph {
             data.add_val ("/num_generated_best", this->num_generated_best);
             data.add_val ("/num_accepted", this->num_accepted);
             data.add_val ("/num_accepted_best", this->num_accepted_best);
+            data.add_val ("/evaluation_count", this->evaluation_count);
+            data.add_val ("/num_exchanges_attempted", this->num_exchanges_attempted);
+            data.add_val ("/num_exchanges_accepted", this->num_exchanges_accepted);
 
             data.add_val ("/D", this->D);
             data.add_contained_vals ("/T_0", this->T_0);
@@ -364,10 +494,59 @@ namespace morph {
             data.add_val ("/downhill", this->downhill);
             data.add_val ("/reanneal_after_steps", this->reanneal_after_steps);
             data.add_val ("/exit_at_T_f", this->exit_at_T_f);
+            data.add_val ("/tangent_set", this->tangent_set);
+            data.add_val ("/tempering_factor", this->tempering_factor);
         }
 
     protected: // Internal algorithm methods.
 
+        //! Evaluate the objective for the parameters that the state asks for.
+        void evaluate_requested()
+        {
+            if (this->state == Anneal_State::NeedToCompute) {
+                this->f_x_cand = this->objective (this->x_cand);
+                ++this->evaluation_count;
+            } else if (this->state == Anneal_State::NeedToComputeSet && this->tangent_set) {
+                const int nset = static_cast<int>(this->x_set.size());
+                this->f_x_set.resize (nset);
+#pragma omp parallel for schedule(dynamic) if (this->parallel)
+                for (int i = 0; i < nset; ++i) {
+                    this->f_x_set[i] = this->objective (this->x_set[i]);
+                }
+                this->evaluation_count += nset;
+            } else if (this->state == Anneal_State::NeedToComputeSet) {
+                this->f_x_plusdelta = this->objective (this->x_plusdelta);
+                ++this->evaluation_count;
+            }
+        }
+
+        /*!
+         * Offer to swap the current parameters of neighbouring chains (0 with 1, 2 with 3
+         * and so on if \a odd is false; 1 with 2, 3 with 4... if it is true). A swap is
+         * accepted with probability min(1, exp((b_j - b_j+1)(f_j - f_j+1))) where b is the
+         * inverse acceptance temperature (the signs of the f are reversed if ascending).
+         * Chains that have stopped or are partway through a reanneal are left alone.
+         */
+        void exchange (std::vector<Anneal<T, debug>>& ch, unsigned int odd)
+        {
+            for (std::size_t j = odd; j + 1 < ch.size(); j += 2) {
+                Anneal<T, debug>& a = ch[j];
+                Anneal<T, debug>& b = ch[j + 1];
+                if (a.state != Anneal_State::NeedToCompute || b.state != Anneal_State::NeedToCompute) { continue; }
+                ++this->num_exchanges_attempted;
+                T beta_a = T{1} / (eps + a.T_cost.mean() * a.tempering_factor);
+                T beta_b = T{1} / (eps + b.T_cost.mean() * b.tempering_factor);
+                T df = this->downhill ? (a.f_x - b.f_x) : (b.f_x - a.f_x);
+                T p = std::min (T{1}, std::exp ((beta_a - beta_b) * df));
+                if (p >= this->rng_u.get()) {
+                    ++this->num_exchanges_accepted;
+                    std::swap (a.x, b.x);
+                    std::swap (a.f_x, b.f_x);
+                    std::swap (a.x_cand, b.x_cand);
+                }
+            }
+        }
+
         //! Generate delta parameter near to x_start, for cost tangent estimation
         morph::vvec<T> generate_delta_parameter (const morph::vvec<T>& x_start) const
         {
@@ -447,13 +626,13 @@ namespace morph {
                 ++this->num_worse;
             }
 
-            T p = std::exp(-(this->f_x_cand - this->f_x)/(eps+this->T_cost.mean()));
+            T p = std::exp(-(this->f_x_cand - this->f_x)/(eps+this->T_cost.mean() * this->tempering_factor));
             p = std::min (T{1}, p);
             T u = this->rng_u.get();
             bool accepted = p >= u ? true : false;
 
             if (candidate_is_better==false && accepted==true) {
-                std::cout << "Accepted worse candidate\n";
+                if (display_temperatures == true) { std::cout << "Accepted worse candidate\n"; }
                 ++this->num_worse_accepted;
             }
 
@@ -536,6 +715,14 @@ namespace morph {
 
             // add a delta to the current parameters and then ask client to compute f_x and f_x_plusdelta (instead of f_x_cand)
             this->x_plusdelta = this->generate_delta_parameter (this->x);
+            if (this->tangent_set) {
+                // One parameter set per dimension, each changing only one parameter
+                this->x_set.resize (this->D);
+                for (unsigned int i = 0; i < this->D; ++i) {
+                    this->x_set[i] = this->x;
+                    this->x_set[i][i] = this->x_plusdelta[i];
+                }
+            }
 
             if (display_reanneal) { std::cout << "Reannealing... "; }
             return true;
@@ -546,7 +733,13 @@ namespace morph {
         void complete_reanneal()
         {
             // Compute dCost/dx and place in tangents
-            this->tangents = (f_x_plusdelta - f_x) / (x_plusdelta - x + eps);
+            if (this->tangent_set) {
+                for (unsigned int i = 0; i < this->D; ++i) {
+                    this->tangents[i] = (f_x_set[i] - f_x) / (x_plusdelta[i] - x[i] + eps);
+                }
+            } else {
+                this->tangents = (f_x_plusdelta - f_x) / (x_plusdelta - x + eps);
+            }
 
             if (tangents.has_nan_or_inf()) { throw std::runtime_error ("NaN or inf in tangents"); }
 
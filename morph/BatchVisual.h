@@ -0,0 +1,203 @@
+/*!
+ * \file
+ *
+ * \brief Merge many small, static VisualModels into one, so that they are drawn with one call.
+ *
+ * A scene made of thousands of spheres, rods or arrows, each its own VisualModel, spends much of
+ * each frame setting uniforms and making draw calls, one set per model. A BatchVisual takes
+ * ownership of such models and concatenates their vertices into its own buffers. Each member's
+ * model matrix (its offset, rotation and scaling) is baked into its copy of the vertex positions
+ * on the CPU, so the whole batch can usually be drawn with a single glDrawElements call.
+ *
+ * Members can still be hidden, faded or moved after they have been batched. Hidden members are
+ * left out of the draw and members with a different alpha are drawn in runs of their own. A
+ * member that has moved has only its own vertices re-transformed and re-uploaded.
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <morph/VisualModel.h>
+#include <morph/mat44.h>
+#include <morph/vec.h>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace morph {
+
+    /*!
+     * A VisualModel made from other VisualModels. Bind and finalize each model as usual, but
+     * add() it to the BatchVisual instead of adding it to the Visual. Then finalize the batch and
+     * add that to the Visual:
+     *
+     *   auto batch = std::make_unique<morph::BatchVisual<>>();
+     *   v.bindmodel (batch);
+     *   for (auto p : positions) {
+     *       auto sv = std::make_unique<morph::SphereVisual<>> (p, 0.1f, morph::colour::crimson);
+     *       v.bindmodel (sv);
+     *       sv->finalize();
+     *       batch->add (sv);
+     *   }
+     *   batch->finalize();
+     *   v.addVisualModel (batch);
+     *
+     * Members never get buffers of their own on the GPU. Their geometry must not change once the
+     * batch is finalized (call reinit() on the batch if it does) and any text labels they carry are
+     * not drawn; add labels to the batch instead.
+     */
+    template <int glver = morph::gl::version_4_1>
+    class BatchVisual : public VisualModel<glver>
+    {
+    public:
+        BatchVisual() : VisualModel<glver>() {}
+        BatchVisual (const vec<float> _offset) : VisualModel<glver>(_offset) {}
+
+        //! Take ownership of model, which should have been finalized, but not added to the
+        //! Visual. Returns a non-owning pointer to the model.
+        template <typename T>
+        T* add (std::unique_ptr<T>& model)
+        {
+            T* mp = model.get();
+            this->members.push_back (std::move (model));
+            return mp;
+        }
+
+        //! The number of models in the batch
+        std::size_t size() const { return this->members.size(); }
+
+        //! The number of draw calls that the last render() made for the batch
+        std::size_t draw_calls() const { return this->draw_ranges.empty() ? 1u : this->draw_ranges.size(); }
+
+        //! Concatenate the members' vertices, transforming each member's positions by its model matrix
+        void initializeVertices()
+        {
+            const std::size_t nm = this->members.size();
+            this->member_ranges.assign (nm, member_range{});
+            std::size_t nv = 0;
+            std::size_t ni = 0;
+            for (std::size_t m = 0; m < nm; ++m) {
+                const morph::VertexArena& mv = this->members[m]->vertices();
+                this->member_ranges[m].first_vertex = nv;
+                this->member_ranges[m].num_vertices = mv.vertexPositions.size() / 3;
+                this->member_ranges[m].first_index = ni;
+                this->member_ranges[m].num_indices = mv.indices.size();
+                nv += this->member_ranges[m].num_vertices;
+                ni += mv.indices.size();
+            }
+            this->vertexPositions.resize (3 * nv);
+            this->vertexNormals.resize (3 * nv);
+            this->vertexColors.resize (3 * nv);
+            this->indices.resize (ni);
+            this->idx = static_cast<typename morph::VertexArena::GLuint>(nv);
+
+            const std::int64_t n = static_cast<std::int64_t>(nm);
+#pragma omp parallel for if (n > 64)
+            for (std::int64_t mi = 0; mi < n; ++mi) {
+                const std::size_t m = static_cast<std::size_t>(mi);
+                const morph::VertexArena& mv = this->members[m]->vertices();
+                const member_range& r = this->member_ranges[m];
+                const std::size_t v0 = 3 * r.first_vertex;
+                // Normals are not transformed by the model matrix in the shader, so are copied as they are
+                std::copy (mv.vertexNormals.begin(), mv.vertexNormals.end(), this->vertexNormals.begin() + v0);
+                std::copy (mv.vertexColors.begin(), mv.vertexColors.end(), this->vertexColors.begin() + v0);
+                const auto offset = static_cast<typename morph::VertexArena::GLuint>(r.first_vertex);
+                for (std::size_t i = 0; i < r.num_indices; ++i) { this->indices[r.first_index + i] = mv.indices[i] + offset; }
+                this->bake (m);
+            }
+            this->update_draw_ranges();
+        }
+
+        /*!
+         * Re-transform the vertices of any member that has moved since the last frame and work out
+         * which runs of indices to draw, then render as usual.
+         */
+        void render()
+        {
+            if (this->hide == false && !this->member_ranges.empty()) {
+                bool moved = false;
+                for (std::size_t m = 0; m < this->members.size(); ++m) {
+                    if (this->members[m]->getModelMatrix() != this->member_ranges[m].model_matrix) {
+                        this->bake (m);
+                        moved = true;
+                    }
+                }
+                if (moved) {
+                    this->set_dirty (this->posnVBO);
+                    this->reinit_dirty_buffers();
+                }
+                this->update_draw_ranges();
+            }
+            VisualModel<glver>::render();
+        }
+
+    protected:
+
+        //! Where a member's vertices and indices are in the batch, and how it was placed there
+        struct member_range
+        {
+            std::size_t first_vertex = 0;
+            std::size_t num_vertices = 0;
+            std::size_t first_index = 0;
+            std::size_t num_indices = 0;
+            mat44<float> model_matrix = {};
+        };
+
+        //! Copy the positions of member m into the batch, transformed by its current model matrix
+        void bake (const std::size_t m)
+        {
+            member_range& r = this->member_ranges[m];
+            r.model_matrix = this->members[m]->getModelMatrix();
+            const std::vector<float>& p = this->members[m]->vertices().vertexPositions;
+            float* bp = this->vertexPositions.data() + 3 * r.first_vertex;
+            for (std::size_t i = 0; i < 3 * r.num_vertices; i += 3) {
+                vec<float, 4> t = r.model_matrix * vec<float>{ p[i], p[i + 1], p[i + 2] };
+                bp[i] = t[0];
+                bp[i + 1] = t[1];
+                bp[i + 2] = t[2];
+            }
+        }
+
+        /*!
+         * Set draw_ranges from the members' hide and alpha attributes. Neighbouring members that
+         * are visible and have the same alpha share a range. If every member is visible with the
+         * batch's own alpha, draw_ranges is left empty and the whole batch is drawn in one call.
+         */
+        void update_draw_ranges()
+        {
+            this->draw_ranges.clear();
+            bool all_drawn = true;
+            for (std::size_t m = 0; m < this->members.size(); ++m) {
+                const member_range& r = this->member_ranges[m];
+                if (this->members[m]->hidden() || r.num_indices == 0) {
+                    all_drawn = all_drawn && r.num_indices == 0;
+                    continue;
+                }
+                const float a = this->alpha * this->members[m]->getAlpha();
+                if (a != this->alpha) { all_drawn = false; }
+                if (!this->draw_ranges.empty() && this->draw_ranges.back().alpha == a
+                    && this->draw_ranges.back().first + this->draw_ranges.back().count == r.first_index) {
+                    this->draw_ranges.back().count += r.num_indices;
+                } else {
+                    this->draw_ranges.push_back ({ r.first_index, r.num_indices, a });
+                }
+            }
+            if (all_drawn) {
+                this->draw_ranges.clear();
+            } else if (this->draw_ranges.empty()) {
+                // Every member is hidden. An empty range draws nothing.
+                this->draw_ranges.push_back ({ 0, 0, this->alpha });
+            }
+        }
+
+        //! The models in the batch
+        std::vector<std::unique_ptr<VisualModel<glver>>> members;
+        //! Where each member is in the batch's vertices and indices
+        std::vector<member_range> member_ranges;
+    };
+
+} // namespace morph
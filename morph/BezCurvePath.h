@@ -17,6 +17,7 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <algorithm>
 
 namespace morph
 {
@@ -168,6 +169,29 @@ namespace morph
             return c;
         }
 
+        /*!
+         * Treating \a points as the vertices of a closed polygon, find the x coordinates at
+         * which the polygon's edges cross the horizontal line at \a y. These are returned in
+         * ascending order, so that the points on the line that lie between crossings 0 and 1, 2
+         * and 3 and so on are inside the polygon (by the even-odd rule). An edge crosses the line
+         * if one of its ends is below y and the other is at or above y, so that a vertex which
+         * lies exactly on the line is counted once.
+         */
+        static std::vector<Flt> rowCrossings (const std::vector<BezCoord<Flt>>& points, const Flt y)
+        {
+            std::vector<Flt> xc;
+            const std::size_t n = points.size();
+            for (std::size_t i = 0; i < n; ++i) {
+                const morph::vec<Flt, 2>& p0 = points[i].coord;
+                const morph::vec<Flt, 2>& p1 = points[(i + 1) % n].coord;
+                if ((p0[1] < y) != (p1[1] < y)) {
+                    xc.push_back (p0[0] + (y - p0[1]) * (p1[0] - p0[0]) / (p1[1] - p0[1]));
+                }
+            }
+            std::sort (xc.begin(), xc.end());
+            return xc;
+        }
+
         /*!
          * Crunch the numbers to generate the coordinates for the path, doing the right
          * thing between curves (skipping remaining, then advancing step-remaining into
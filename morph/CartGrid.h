@@ -7,6 +7,7 @@
 
 #include <morph/Rect.h>
 #include <morph/GridFeatures.h>
+#include <morph/distance_transform.h>
 
 // CartGrid contains carried over code (from HexGrid) which allows for the imposition of
 // arbitrary boundaries, specified as Bezier curves. This brings in a link dependency on
@@ -22,6 +23,7 @@
 #include <morph/vvec.h>
 #include <morph/scale.h>
 #include <morph/range.h>
+#include <morph/fft.h>
 
 // If the CartGrid::save and CartGrid::load methods are required, define
 // CARTGRID_COMPILE_LOAD_AND_SAVE. A link to libhdf5 will be required in your program.
@@ -41,6 +43,8 @@
 #include <vector>
 #include <stdexcept>
 #include <limits>
+#include <algorithm>
+#include <iterator>
 
 namespace morph {
 
@@ -666,6 +670,20 @@ namespace morph {
             this->init2 (x1, y1, x2, y2);
         }
 
+#ifdef CARTGRID_COMPILE_WITH_BEZCURVES
+        /*!
+         * Construct a grid with rectangular element width d_ and height v_ which contains only
+         * the elements that lie inside the boundary \a p. The elements are found by rasterising
+         * the boundary, so no elements outside the boundary are created (see init (float, float,
+         * std::vector<BezCoord<float>>&, float, bool)). The domain shape is
+         * GridDomainShape::Boundary.
+         */
+        CartGrid (float d_, float v_, const BezCurvePath<float>& p, float z_ = 0.0f, bool loffset = true)
+        {
+            this->init (d_, v_, p, z_, loffset);
+        }
+#endif
+
         //! Initialisation common code
         void init (float d_, float v_, float x_span_, float y_span_, float z_ = 0.0f)
         {
@@ -681,6 +699,44 @@ namespace morph {
             this->init (d_, d_, x_span_, x_span_, z_);
         }
 
+#ifdef CARTGRID_COMPILE_WITH_BEZCURVES
+        /*!
+         * Initialise a grid of elements of width d_ and height v_ containing only the elements
+         * inside the boundary \a p. Points on \a p are computed with a step of d_/2, as they are
+         * in setBoundary (const BezCurvePath<float>&, bool).
+         */
+        void init (float d_, float v_, const BezCurvePath<float>& p, float z_ = 0.0f, bool loffset = true)
+        {
+            this->boundary = p;
+            if (this->boundary.isNull()) {
+                throw std::runtime_error ("CartGrid::init: The boundary path is null");
+            }
+            this->boundary.computePoints (d_/2.0f, true);
+            std::vector<morph::BezCoord<float>> bpoints = this->boundary.getPoints();
+            this->init (d_, v_, bpoints, z_, loffset);
+        }
+
+        /*!
+         * Initialise a grid of elements of width d_ and height v_ containing only the elements
+         * inside the boundary given by the closed sequence of points \a bpoints. As in
+         * setBoundary (std::vector<BezCoord<float>>&, bool), \a bpoints is translated so that
+         * its centroid is at (0,0) unless \a loffset is false.
+         *
+         * Each row of elements is intersected with the boundary polygon to find the elements
+         * whose centres lie inside it (the rows are processed in parallel). The element closest
+         * to each point in \a bpoints is marked as a boundary element. Only these elements are
+         * created; there is no initial rectangle of elements to discard.
+         */
+        void init (float d_, float v_, std::vector<BezCoord<float>>& bpoints, float z_ = 0.0f, bool loffset = true)
+        {
+            this->d = d_;
+            this->v = v_;
+            this->z = z_;
+            this->domainShape = GridDomainShape::Boundary;
+            this->initFromBoundary (bpoints, loffset);
+        }
+#endif
+
         //! Compute centre of mass of the passed in variable, defined across this CartGrid
         template<typename F = float>
         morph::vec<float, 2> centre_of_mass (morph::vvec<F>& data)
@@ -1298,35 +1354,23 @@ namespace morph {
         float getRectArea() const { return (this->d * this->v); }
 
         /*!
-         * Run through all the rects and compute the distance to the nearest boundary
-         * rect.
+         * Compute the distance from each rect to the nearest boundary rect, writing the result
+         * into d_distToBoundary and into each Rect's distToBoundary attribute. Boundary rects have
+         * distance 0 and rects outside the boundary are given the dummy value -100.
+         *
+         * The distances are found by propagating outwards from the boundary over the d_ne, d_nne
+         * (and so on) neighbour relations, which takes time proportional to the number of rects.
+         * With the default distance_metric::euclidean, the distance is the exact Euclidean
+         * distance to the nearest boundary rect, the same as an exhaustive search would give (see
+         * distance_transform::from_boundary).
          */
-        void computeDistanceToBoundary()
+        void computeDistanceToBoundary (const distance_metric metric = distance_metric::euclidean)
         {
-            std::list<morph::Rect>::iterator r = this->rects.begin();
-            while (r != this->rects.end()) {
-                if (r->testFlags(RECT_IS_BOUNDARY) == true) {
-                    r->distToBoundary = 0.0f;
-                } else {
-                    if (r->testFlags(RECT_INSIDE_BOUNDARY) == false) {
-                        // Set to a dummy, negative value
-                        r->distToBoundary = -100.0;
-                    } else {
-                        // Not a boundary rect, but inside boundary
-                        std::list<morph::Rect>::iterator br = this->rects.begin();
-                        while (br != this->rects.end()) {
-                            if (br->testFlags(RECT_IS_BOUNDARY) == true) {
-                                float delta = r->distanceFrom (*br);
-                                if (delta < r->distToBoundary || r->distToBoundary < 0.0f) {
-                                    r->distToBoundary = delta;
-                                }
-                            }
-                            ++br;
-                        }
-                    }
-                }
-                ++r;
-            }
+            if (this->d_x.size() != this->rects.size()) { this->populate_d_vectors(); }
+            std::array<const std::vector<int>*, 8> nbrs = { &this->d_ne, &this->d_nne, &this->d_nn, &this->d_nnw, &this->d_nw, &this->d_nsw, &this->d_ns, &this->d_nse };
+            distance_transform::from_boundary (this->d_x, this->d_y, this->d_flags, RECT_IS_BOUNDARY, RECT_INSIDE_BOUNDARY,
+                                               nbrs, this->d_distToBoundary, metric);
+            for (auto& r : this->rects) { r.distToBoundary = this->d_distToBoundary[r.di]; }
         }
 
         /*!
@@ -1742,6 +1786,59 @@ namespace morph {
             }
         }
 
+        /*!
+         * Make an FFT convolver which applies the kernel \a kerneldata (on \a kernelgrid) to
+         * data on this CartGrid, giving the same result as convolve(). The kernel is
+         * transformed once, here, so each call of the convolver's convolve() method costs
+         * O(N log N), however large the kernel. The CartGrid must be a complete rectangle.
+         * Where the edges wrap (see domainWrap) the convolution is circular.
+         */
+        template<typename T>
+        morph::fft::convolver2d<T> fft_convolver (const CartGrid& kernelgrid, const std::vector<T>& kerneldata) const
+        {
+            if (kernelgrid.getd() != this->d) {
+                throw std::runtime_error ("The kernel CartGrid must have same d as this CartGrid to carry out convolution.");
+            }
+            if (kerneldata.size() != kernelgrid.rects.size()) {
+                throw std::runtime_error ("The kernel data vector is not the same size as the kernel CartGrid.");
+            }
+            if (this->rects.empty()) { throw std::runtime_error ("The CartGrid has no rects."); }
+
+            // The extent of the rects in index space
+            int xmin = std::numeric_limits<int>::max();
+            int xmax = std::numeric_limits<int>::min();
+            int ymin = std::numeric_limits<int>::max();
+            int ymax = std::numeric_limits<int>::min();
+            for (auto r : this->rects) {
+                xmin = std::min (xmin, r.xi); xmax = std::max (xmax, r.xi);
+                ymin = std::min (ymin, r.yi); ymax = std::max (ymax, r.yi);
+            }
+            const int nx = xmax - xmin + 1;
+            const int ny = ymax - ymin + 1;
+            if (static_cast<std::size_t>(nx) * static_cast<std::size_t>(ny) != this->rects.size()) {
+                throw std::runtime_error ("FFT convolution needs a rectangular CartGrid.");
+            }
+
+            std::vector<std::array<int, 2>> positions (this->rects.size());
+            for (auto r : this->rects) { positions[r.vi] = { r.xi - xmin, r.yi - ymin }; }
+            std::vector<std::array<int, 2>> offsets (kernelgrid.rects.size());
+            std::vector<T> weights (kernelgrid.rects.size());
+            std::size_t k = 0;
+            for (auto kr : kernelgrid.rects) {
+                offsets[k] = { kr.xi, kr.yi };
+                weights[k++] = kerneldata[kr.vi];
+            }
+
+            // An axis wraps if the rects on its far edge link back to the near edge
+            bool wrap_x = true;
+            bool wrap_y = true;
+            for (auto r : this->rects) {
+                if (r.xi == xmax && !r.has_ne()) { wrap_x = false; }
+                if (r.yi == ymax && !r.has_nn()) { wrap_y = false; }
+            }
+            return morph::fft::convolver2d<T> (nx, ny, wrap_x, wrap_y, positions, offsets, weights);
+        }
+
         /*!
          * What shape domain to set? Set this to the non-default BEFORE calling
          * CartGrid::setBoundary (const BezCurvePath& p) - that's where the domainShape
@@ -1936,6 +2033,113 @@ namespace morph {
             }
         }
 
+#ifdef CARTGRID_COMPILE_WITH_BEZCURVES
+        /*!
+         * Create rects containing just the elements inside the boundary given by bpoints. See
+         * init (float, float, std::vector<BezCoord<float>>&, float, bool).
+         */
+        void initFromBoundary (std::vector<BezCoord<float>>& bpoints, bool loffset)
+        {
+            if (bpoints.size() < 3) {
+                throw std::runtime_error ("CartGrid: The boundary needs at least 3 points");
+            }
+            this->rects.clear();
+            this->brects.clear();
+
+            this->boundaryCentroid = morph::BezCurvePath<float>::getCentroid (bpoints);
+            if (loffset) {
+                for (auto& bp : bpoints) { bp.subtract (this->boundaryCentroid); }
+                this->originalBoundaryCentroid = this->boundaryCentroid;
+                this->boundaryCentroid = { 0.0f, 0.0f };
+            }
+
+            // The extent of the boundary determines the block of elements to rasterise
+            morph::vec<float, 2> bmin = bpoints[0].coord;
+            morph::vec<float, 2> bmax = bpoints[0].coord;
+            for (auto& bp : bpoints) {
+                bmin[0] = std::min (bmin[0], bp.x());
+                bmin[1] = std::min (bmin[1], bp.y());
+                bmax[0] = std::max (bmax[0], bp.x());
+                bmax[1] = std::max (bmax[1], bp.y());
+            }
+            const int xi0 = static_cast<int>(std::floor (bmin[0] / this->d)) - 1;
+            const int xi1 = static_cast<int>(std::ceil (bmax[0] / this->d)) + 1;
+            const int yi0 = static_cast<int>(std::floor (bmin[1] / this->v)) - 1;
+            const int yi1 = static_cast<int>(std::ceil (bmax[1] / this->v)) + 1;
+            const int w = xi1 - xi0 + 1;
+            const int h = yi1 - yi0 + 1;
+
+            // Flags for each element in the block. Mark elements whose centres are inside the
+            // boundary polygon, row by row, then mark the boundary elements.
+            std::vector<unsigned int> cell (static_cast<std::size_t>(w) * h, 0U);
+#pragma omp parallel for
+            for (int row = 0; row < h; ++row) {
+                std::vector<float> xc = BezCurvePath<float>::rowCrossings (bpoints, this->v * (yi0 + row));
+                for (std::size_t k = 1; k < xc.size(); k += 2) {
+                    const int xa = static_cast<int>(std::ceil (xc[k-1] / this->d));
+                    const int xb = static_cast<int>(std::floor (xc[k] / this->d));
+                    for (int xi = xa; xi <= xb; ++xi) { cell[row * w + xi - xi0] = RECT_INSIDE_BOUNDARY; }
+                }
+            }
+            for (auto& bp : bpoints) {
+                const int xi = static_cast<int>(std::round (bp.x() / this->d));
+                const int yi = static_cast<int>(std::round (bp.y() / this->v));
+                cell[(yi - yi0) * w + xi - xi0] = RECT_IS_BOUNDARY | RECT_INSIDE_BOUNDARY;
+            }
+
+            // Create the rects in raster order, connecting each to its W and S neighbours
+            std::vector<std::list<morph::Rect>::iterator> cell_rect (static_cast<std::size_t>(w) * h, this->rects.end());
+            unsigned int vi = 0;
+            for (int c = 0; c < w * h; ++c) {
+                if (!cell[c]) { continue; }
+                const int xi = xi0 + c % w;
+                const int yi = yi0 + c / w;
+                this->rects.emplace_back (vi++, this->d, this->v, xi, yi);
+                auto ri = std::prev (this->rects.end());
+                ri->setFlag (cell[c]);
+                cell_rect[c] = ri;
+                if (xi > xi0 && cell[c - 1]) {
+                    ri->set_nw (cell_rect[c - 1]);
+                    cell_rect[c - 1]->set_ne (ri);
+                }
+                if (yi > yi0) {
+                    if (cell[c - w]) {
+                        ri->set_ns (cell_rect[c - w]);
+                        cell_rect[c - w]->set_nn (ri);
+                    }
+                    if (xi > xi0 && cell[c - w - 1]) {
+                        ri->set_nsw (cell_rect[c - w - 1]);
+                        cell_rect[c - w - 1]->set_nne (ri);
+                    }
+                    if (xi < xi1 && cell[c - w + 1]) {
+                        ri->set_nse (cell_rect[c - w + 1]);
+                        cell_rect[c - w + 1]->set_nnw (ri);
+                    }
+                }
+            }
+
+            // Check that the boundary is contiguous, starting from the last boundary point's element
+            {
+                const int xi = static_cast<int>(std::round (bpoints.back().x() / this->d));
+                const int yi = static_cast<int>(std::round (bpoints.back().y() / this->v));
+                std::list<morph::Rect>::iterator bri = cell_rect[(yi - yi0) * w + xi - xi0];
+                std::set<unsigned int> seen;
+                std::list<morph::Rect>::iterator ri = bri;
+                if (this->boundaryContiguous (bri, ri, seen, RECT_NEIGHBOUR_POS_E) == false) {
+                    throw std::runtime_error ("The constructed boundary is not a contiguous sequence of rectangular elements.");
+                }
+            }
+
+            this->x_span = bmax[0] - bmin[0];
+            this->y_span = bmax[1] - bmin[1];
+            this->x_minmax = morph::range<float>(bmin[0], bmax[0]);
+            this->y_minmax = morph::range<float>(bmin[1], bmax[1]);
+            this->renumberVectorIndices();
+            this->gridReduced = true;
+            this->populate_d_vectors();
+        }
+#endif
+
 #ifdef CARTGRID_COMPILE_WITH_BEZCURVES
         /*!
          * Starting from \a startFrom, and following nearest-neighbour relations, find
@@ -110,6 +110,31 @@ namespace morph {
             }
         }
 
+        /*!
+         * In Triangles mode there's one vertex per rect, so new data changes only the z positions
+         * and colours of the first cg->num() vertices. Update those in place. (RectInterp needs a
+         * full reinit.)
+         */
+        bool updateAttributes() override
+        {
+            if (this->cartVisMode != CartVisMode::Triangles || this->scalarData == nullptr) { return false; }
+            const unsigned int nrect = this->cg->num();
+            if (this->scalarData->size() != nrect || this->vertexPositions.size() < 3u * nrect) { return false; }
+
+            this->transformScalarData (this->dcopy, this->dcolour);
+            this->convertColours (this->dcolour);
+            for (unsigned int ri = 0; ri < nrect; ++ri) {
+                std::array<float, 3> clr = this->setColour (ri);
+                this->vertexPositions[3 * ri + 2] = this->dcopy[ri];
+                this->vertexColors[3 * ri] = clr[0];
+                this->vertexColors[3 * ri + 1] = clr[1];
+                this->vertexColors[3 * ri + 2] = clr[2];
+            }
+            this->set_dirty (this->posnVBO);
+            this->set_dirty (this->colVBO);
+            return true;
+        }
+
         // Initialize vertex buffer objects and vertex array object.
 
         //! Initialize as a minimal, triangled surface
@@ -119,12 +144,11 @@ namespace morph {
             unsigned int nrect = this->cg->num();
 
             if (this->scalarData != nullptr) {
-                this->dcopy.resize (this->scalarData->size());
-                this->zScale.transform (*(this->scalarData), dcopy);
-                this->dcolour.resize (this->scalarData->size());
-                this->colourScale.transform (*(this->scalarData), dcolour);
+                this->transformScalarData (this->dcopy, this->dcolour);
+                this->convertColours (this->dcolour);
             } else if (this->vectorData != nullptr) {
                 this->dcopy.resize (this->vectorData->size());
+                this->dcolour_rgb.clear();
                 this->dcolour.resize (this->vectorData->size());
                 this->dcolour2.resize (this->vectorData->size());
                 this->dcolour3.resize (this->vectorData->size());
@@ -187,12 +211,11 @@ namespace morph {
             this->idx = 0;
 
             if (this->scalarData != nullptr) {
-                this->dcopy.resize (this->scalarData->size());
-                this->zScale.transform (*(this->scalarData), dcopy);
-                this->dcolour.resize (this->scalarData->size());
-                this->colourScale.transform (*(this->scalarData), dcolour);
+                this->transformScalarData (this->dcopy, this->dcolour);
+                this->convertColours (this->dcolour);
             } else if (this->vectorData != nullptr) {
                 this->dcopy.resize (this->vectorData->size());
+                this->dcolour_rgb.clear();
                 this->dcolour.resize (this->vectorData->size());
                 this->dcolour2.resize (this->vectorData->size());
                 this->dcolour3.resize (this->vectorData->size());
@@ -218,20 +241,25 @@ namespace morph {
                     this->colourScale3.transform (this->dcolour3, this->dcolour3);
                 } // else assume dcolour/dcolour2/dcolour3 are all in range 0->1 (or 0-255) already
             }
-            float datumC = 0.0f;   // datum at the centre
-            float datumNE = 0.0f;  // datum at the hex to the east.
-            float datumNNE = 0.0f;
-            float datumNN = 0.0f;
-            float datumNNW = 0.0f;
-            float datumNW = 0.0f;
-            float datumNSW = 0.0f;
-            float datumNS = 0.0f;
-            float datumNSE = 0.0f;
-
-            float datum = 0.0f;
-
-            morph::vec<float> vtx_0, vtx_1, vtx_2;
-            for (unsigned int ri = 0; ri < nrect; ++ri) {
+
+            // Each rect is built independently of the others, so build() can share them out
+            // between threads
+            this->build (nrect, [&](morph::VertexArena& a, const std::size_t i)
+            {
+                const unsigned int ri = static_cast<unsigned int>(i);
+                float datumC = 0.0f;   // datum at the centre
+                float datumNE = 0.0f;  // datum at the hex to the east.
+                float datumNNE = 0.0f;
+                float datumNN = 0.0f;
+                float datumNNW = 0.0f;
+                float datumNW = 0.0f;
+                float datumNSW = 0.0f;
+                float datumNS = 0.0f;
+                float datumNSE = 0.0f;
+
+                float datum = 0.0f;
+
+                morph::vec<float> vtx_0, vtx_1, vtx_2;
 
                 // Use the linear scaled copy of the data, dcopy.
                 datumC  = dcopy[ri];
@@ -251,7 +279,7 @@ namespace morph {
                 std::array<float, 3> clr = this->setColour (ri);
 
                 // First push the 5 positions of the triangle vertices, starting with the centre
-                this->vertex_push (this->cg->d_x[ri]+centering_offset[0], this->cg->d_y[ri]+centering_offset[1], datumC, this->vertexPositions);
+                a.vertex_push (this->cg->d_x[ri]+centering_offset[0], this->cg->d_y[ri]+centering_offset[1], datumC, a.vertexPositions);
 
                 // Use the centre position as the first location for finding the normal vector
                 vtx_0 = {{this->cg->d_x[ri]+centering_offset[0], this->cg->d_y[ri]+centering_offset[1], datumC}};
@@ -270,7 +298,7 @@ namespace morph {
                 } else {
                     datum = datumC;
                 }
-                this->vertex_push (this->cg->d_x[ri]+hx+centering_offset[0], this->cg->d_y[ri]+vy+centering_offset[1], datum, this->vertexPositions);
+                a.vertex_push (this->cg->d_x[ri]+hx+centering_offset[0], this->cg->d_y[ri]+vy+centering_offset[1], datum, a.vertexPositions);
                 vtx_1 = {{this->cg->d_x[ri]+hx+centering_offset[0], this->cg->d_y[ri]+vy+centering_offset[1], datum}};
 
                 // SE vertex
@@ -287,7 +315,7 @@ namespace morph {
                 } else {
                     datum = datumC;
                 }
-                this->vertex_push (this->cg->d_x[ri]+hx+centering_offset[0], this->cg->d_y[ri]-vy+centering_offset[1], datum, this->vertexPositions);
+                a.vertex_push (this->cg->d_x[ri]+hx+centering_offset[0], this->cg->d_y[ri]-vy+centering_offset[1], datum, a.vertexPositions);
                 vtx_2 = {{this->cg->d_x[ri]+hx+centering_offset[0], this->cg->d_y[ri]-vy+centering_offset[1], datum}};
 
 
@@ -302,7 +330,7 @@ namespace morph {
                 } else {
                     datum = datumC;
                 }
-                this->vertex_push (this->cg->d_x[ri]-hx+centering_offset[0], this->cg->d_y[ri]-vy+centering_offset[1], datum, this->vertexPositions);
+                a.vertex_push (this->cg->d_x[ri]-hx+centering_offset[0], this->cg->d_y[ri]-vy+centering_offset[1], datum, a.vertexPositions);
 
                 // NW vertex
                 //datum = 0.25f * (datumC + datumNN + datumNW + datumNNW);
@@ -315,7 +343,7 @@ namespace morph {
                 } else {
                     datum = datumC;
                 }
-                this->vertex_push (this->cg->d_x[ri]-hx+centering_offset[0], this->cg->d_y[ri]+vy+centering_offset[1], datum, this->vertexPositions);
+                a.vertex_push (this->cg->d_x[ri]-hx+centering_offset[0], this->cg->d_y[ri]+vy+centering_offset[1], datum, a.vertexPositions);
 
                 // From vtx_0,1,2 compute normal. This sets the correct normal, but note
                 // that there is only one 'layer' of vertices; the back of the
@@ -326,38 +354,38 @@ namespace morph {
                 morph::vec<float> plane2 = vtx_2 - vtx_0;
                 morph::vec<float> vnorm = plane2.cross (plane1);
                 vnorm.renormalize();
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
 
                 // Five vertices with the same colour
-                this->vertex_push (clr, this->vertexColors);
-                this->vertex_push (clr, this->vertexColors);
-                this->vertex_push (clr, this->vertexColors);
-                this->vertex_push (clr, this->vertexColors);
-                this->vertex_push (clr, this->vertexColors);
+                a.vertex_push (clr, a.vertexColors);
+                a.vertex_push (clr, a.vertexColors);
+                a.vertex_push (clr, a.vertexColors);
+                a.vertex_push (clr, a.vertexColors);
+                a.vertex_push (clr, a.vertexColors);
 
                 // Define indices now to produce the 4 triangles in the hex
-                this->indices.push_back (this->idx+1);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+2);
+                a.indices.push_back (a.idx+1);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+2);
 
-                this->indices.push_back (this->idx+2);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+3);
+                a.indices.push_back (a.idx+2);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+3);
 
-                this->indices.push_back (this->idx+3);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+4);
+                a.indices.push_back (a.idx+3);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+4);
 
-                this->indices.push_back (this->idx+4);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+1);
+                a.indices.push_back (a.idx+4);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+1);
 
-                this->idx += 5; // 5 vertices (each of 3 floats for x/y/z), 15 indices.
-            }
+                a.idx += 5; // 5 vertices (each of 3 floats for x/y/z), 15 indices.
+            });
 
 #if 0
             // Show a Flat surface for the zero plane? This is expensively plotting out all the hexes...
@@ -481,6 +509,9 @@ namespace morph {
             } else if (this->cm.numDatums() == 2) {
                 // Use vectorData
                 clr = this->cm.convert (this->dcolour[ri], this->dcolour2[ri]);
+            } else if (this->dcolour_rgb.size() == 3u * this->dcolour.size()) {
+                // Colours were already converted in a batch by convertColours()
+                clr = this->colour_at (ri);
             } else {
                 clr = this->cm.convert (this->dcolour[ri]);
             }
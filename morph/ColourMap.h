@@ -6,6 +6,9 @@
 #include <morph/colourmaps_cet.h>     // Colour map tables from CET
 
 #include <string_view>
+#include <span>
+#include <vector>
+#include <array>
 #include <stdexcept>
 #include <cmath>
 #include <cstdint>
@@ -562,6 +565,31 @@ namespace morph {
         //! colour retrieved from the map.
         bool act_2d = false;
 
+        //! Number of entries in the lookup table used by the batched convert. 0 means no table.
+        unsigned int lut_size = 0u;
+        //! The lookup table, holding lut_size RGB triplets for data evenly spaced in [0,1]
+        std::vector<float> lut;
+
+        /*!
+         * Recompute the lookup table for the current map. This is called by every setter that
+         * changes the colours of the map, so the table is always up to date and the (const)
+         * batched convert only reads it, which makes it safe to call from several threads.
+         */
+        void rebuild_lut()
+        {
+            if (this->lut_size == 0u || ColourMap::numDatums (this->type, false) != 1) {
+                this->lut.clear();
+                return;
+            }
+            this->lut.resize (3u * this->lut_size);
+            for (unsigned int i = 0; i < this->lut_size; ++i) {
+                std::array<float, 3> c = this->convert_unit (static_cast<float>(i) / static_cast<float>(this->lut_size - 1u));
+                this->lut[3 * i] = c[0];
+                this->lut[3 * i + 1] = c[1];
+                this->lut[3 * i + 2] = c[2];
+            }
+        }
+
     public:
         //! Default constructor is required, but need not do anything.
         ColourMap() {}
@@ -1859,6 +1887,78 @@ namespace morph {
 
         //! Convert the scalar datum into an RGB (or BGR) colour
         std::array<float, 3> convert (T _datum) const
+        {
+            float datum = this->datum_to_unit (_datum);
+
+            // Check for nan and return a 'nan' colour for the colour map
+            if constexpr (std::is_same<std::decay_t<T>, double>::value == true
+                          || std::is_same<std::decay_t<T>, float>::value == true) {
+                if (std::isnan(datum) == true) { return ColourMap<T>::nanColour(this->type); }
+            }
+
+            return this->convert_unit (datum);
+        }
+
+        /*!
+         * Batched convert for 1D colour maps. Each element of \a data is converted into an RGB
+         * triplet, which is written into \a colours, so colours.size() must be at least 3 *
+         * data.size(). The output is laid out as the vertexColors of a VisualModel: R G B R G B...
+         *
+         * If setLUTSize() has been called with a non-zero size, the colours come from a quantised
+         * lookup table, which avoids the per-datum switch over ColourMapType (and the per-datum
+         * interpolation that some maps do). Otherwise, each datum is converted exactly, as with
+         * convert(T). The loop is parallelised with OpenMP for large inputs. The lookup table is
+         * only read here (it is built by the setters) so this may be called from several threads.
+         */
+        void convert (std::span<const T> data, std::span<float> colours) const
+        {
+            const std::int64_t n = static_cast<std::int64_t>(data.size());
+            if (colours.size() < 3 * data.size()) {
+                throw std::runtime_error ("ColourMap::convert(span, span): colours must be 3 times the size of data");
+            }
+            if (this->lut.empty() || this->numDatums() != 1) {
+#pragma omp parallel for if (n > 16384)
+                for (std::int64_t i = 0; i < n; ++i) {
+                    std::array<float, 3> c = this->convert (data[i]);
+                    colours[3 * i] = c[0];
+                    colours[3 * i + 1] = c[1];
+                    colours[3 * i + 2] = c[2];
+                }
+                return;
+            }
+
+            const float* lut_p = this->lut.data();
+            const float lut_max = static_cast<float>(this->lut_size - 1u);
+            const std::array<float, 3> nanc = ColourMap<T>::nanColour (this->type);
+#pragma omp parallel for if (n > 16384)
+            for (std::int64_t i = 0; i < n; ++i) {
+                float datum = this->datum_to_unit (data[i]);
+                const float* c = nanc.data();
+                if (!std::isnan (datum)) { c = lut_p + 3 * static_cast<std::size_t>(datum * lut_max + 0.5f); }
+                colours[3 * i] = c[0];
+                colours[3 * i + 1] = c[1];
+                colours[3 * i + 2] = c[2];
+            }
+        }
+
+        /*!
+         * Set the number of entries in the quantised lookup table that is used by the batched
+         * convert (span<const T>, span<float>). As the tabulated maps (Viridis, Batlow, the CET maps
+         * and so on) have 256 entries, a 256 entry table reproduces them exactly. For computed maps
+         * (Greyscale, Monochrome, etc) use 4096 for smoother gradients. 0 (the default) turns the
+         * lookup table off. The table is built here and rebuilt by the setters that change the type,
+         * hue, saturation or value of the map.
+         */
+        void setLUTSize (const unsigned int n)
+        {
+            this->lut_size = n == 1u ? 2u : n;
+            this->rebuild_lut();
+        }
+        unsigned int getLUTSize() const { return this->lut_size; }
+
+        //! Convert a datum of type T into a float in range [0,1] (or NaN), applying range_max for
+        //! integral types.
+        float datum_to_unit (T _datum) const
         {
             float datum = 0.0f;
 
@@ -1885,15 +1985,14 @@ namespace morph {
             } else {
                 throw std::runtime_error ("Unhandled ColourMap data type.");
             }
+            return datum;
+        }
 
+        //! Convert a datum that is already in range [0,1] into an RGB colour
+        std::array<float, 3> convert_unit (const float datum) const
+        {
             std::array<float, 3> c = {0.0f, 0.0f, 0.0f};
 
-            // Check for nan and return a 'nan' colour for the colour map
-            if constexpr (std::is_same<std::decay_t<T>, double>::value == true
-                          || std::is_same<std::decay_t<T>, float>::value == true) {
-                if (std::isnan(datum) == true) { c = ColourMap<T>::nanColour(this->type); return c; }
-            }
-
             switch (this->type) {
             case ColourMapType::Jet:
             {
@@ -2725,6 +2824,7 @@ namespace morph {
                 break;
             }
             }
+            this->rebuild_lut();
         }
 
         //! Setter that takes a string representation of the colour map type
@@ -2738,6 +2838,7 @@ namespace morph {
             }
             this->hue = 0.0f;
             this->hue2 = 0.6667f;
+            this->rebuild_lut();
         }
         //! Set Duochrome to be Blue-red
         void setHueBR()
@@ -2747,6 +2848,7 @@ namespace morph {
             }
             this->hue = 0.6667f;
             this->hue2 = 0.0f;
+            this->rebuild_lut();
         }
 
         //! Set Duochrome to be Green-Blue
@@ -2757,6 +2859,7 @@ namespace morph {
             }
             this->hue = 0.3333f;
             this->hue2 = 0.6667f;
+            this->rebuild_lut();
         }
         //! Set Duochrome to be Blue-Green
         void setHueBG()
@@ -2766,6 +2869,7 @@ namespace morph {
             }
             this->hue = 0.66667f;
             this->hue2 = 0.3333f;
+            this->rebuild_lut();
         }
 
         //! Set Duochrome to be Red-Green
@@ -2776,6 +2880,7 @@ namespace morph {
             }
             this->hue = 0.0f;
             this->hue2 = 0.3333f;
+            this->rebuild_lut();
         }
         //! Set Duochrome to be Green-Red
         void setHueGR()
@@ -2785,6 +2890,7 @@ namespace morph {
             }
             this->hue = 0.33333f;
             this->hue2 = 0.0f;
+            this->rebuild_lut();
         }
 
         //! Set up a Cyan-Magenta Duochrome colour scheme
@@ -2795,6 +2901,7 @@ namespace morph {
             }
             this->hue = 0.5f;
             this->hue2 = 0.8333f;
+            this->rebuild_lut();
         }
         //! Set up a Magenta-Cyan Duochrome colour scheme
         void setHueMC()
@@ -2804,6 +2911,7 @@ namespace morph {
             }
             this->hue = 0.83333f;
             this->hue2 = 0.5f;
+            this->rebuild_lut();
         }
 
         //! Set a ColourMapType::Duochrome map using h as the first hue and h+0.3333 as the second hue
@@ -2815,6 +2923,7 @@ namespace morph {
             this->hue = h;
             this->hue2 = h+0.3333f;
             if (hue2 > 1.0f) { hue2 -= 1.0f; }
+            this->rebuild_lut();
         }
         //! Set a ColourMapType::DuoChrome map using h as the first hue and h-0.3333 as the second hue
         void setDualAntiHue(const float& h)
@@ -2825,6 +2934,7 @@ namespace morph {
             this->hue = h;
             this->hue2 = h-0.3333f;
             if (hue2 < 0.0f) { hue2 += 1.0f; }
+            this->rebuild_lut();
         }
 
         //! Set the hue... unless you can't/shouldn't
@@ -2871,6 +2981,7 @@ namespace morph {
                 break;
             }
             }
+            this->rebuild_lut();
         }
 
         //! Set the saturation. For many colour maps, this will make little difference,
@@ -2881,6 +2992,7 @@ namespace morph {
                 throw std::runtime_error ("Only ColourMapType::Fixed ::Monochrome and ::Monoval allow setting of saturation");
             }
             this->sat = _s;
+            this->rebuild_lut();
         }
 
         //! Set just the colour's value (ColourMapType::Fixed/HSV only)
@@ -2891,6 +3003,7 @@ namespace morph {
                 throw std::runtime_error ("Only ColourMapType::Fixed ::HSV ::Monochrome and ::Monoval allow setting of value");
             }
             this->val = _v;
+            this->rebuild_lut();
         }
 
         float getHue() const { return this->hue; }
@@ -2906,6 +3019,7 @@ namespace morph {
             this->hue = h;
             this->sat = s;
             this->val = v;
+            this->rebuild_lut();
         }
 
         //! Set the colour by hue, saturation and value (defined in an array) (ColourMapType::Fixed only)
@@ -2918,6 +3032,7 @@ namespace morph {
             this->hue = hsv[0];
             this->sat = hsv[1];
             this->val = hsv[2];
+            this->rebuild_lut();
         }
 
         //! Get the hue, in its most saturated form
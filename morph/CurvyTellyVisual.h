@@ -54,11 +54,10 @@ namespace morph {
             this->idx = 0;
 
             if (this->scalarData != nullptr) {
-                this->dcopy.resize (this->scalarData->size());
-                this->zScale.transform (*(this->scalarData), this->dcopy);
-                this->dcolour.resize (this->scalarData->size());
-                this->colourScale.transform (*(this->scalarData), this->dcolour);
+                this->transformScalarData (this->dcopy, this->dcolour);
+                this->convertColours (this->dcolour);
             } else if (this->vectorData != nullptr) {
+                this->dcolour_rgb.clear();
                 this->dcopy.resize (this->vectorData->size());
                 this->dcolour.resize (this->vectorData->size());
                 this->dcolour2.resize (this->vectorData->size());
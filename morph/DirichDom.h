@@ -333,7 +333,7 @@ namespace morph {
             typename std::list<DirichVtx<Flt>>::iterator dvnext = dv;
             typename std::list<DirichVtx<Flt>>::iterator dvprev = this->vertices.end();
 
-            morph::vec<Flt, 2> Pi_best;
+            morph::vec<Flt, 2> Pi_best = { Flt{0}, Flt{0} };
 
             // Compute Pi lines for each vertex in the domain, and also (for later use) the mean
             // position of the vertices.
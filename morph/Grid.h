@@ -19,6 +19,7 @@
 #include <morph/vec.h>
 #include <morph/vvec.h>
 #include <morph/GridFeatures.h>
+#include <morph/parallel.h>
 
 namespace morph {
 
@@ -794,8 +795,8 @@ namespace morph {
             morph::vec<float, 2> params = 1.0f / (2.0f * dist_per_pix * dist_per_pix);
             morph::vec<float, 2> threesig = 3.0f * dist_per_pix;
 
-#pragma omp parallel for // parallel on this outer loop gives best result (5.8 s vs 7 s)
-            for (typename std::vector<float>::size_type xi = 0u; xi < this->v_c.size(); ++xi) {
+            // parallel on this outer loop gives best result (5.8 s vs 7 s)
+            auto resample_at = [&](const std::size_t xi) {
                 float expr = 0.0f;
                 for (unsigned int i = 0; i < csz; ++i) {
                     // Get x/y pixel coords:
@@ -810,7 +811,13 @@ namespace morph {
                     }
                 }
                 expr_resampled[xi] = expr;
-            }
+            };
+#ifdef _OPENMP
+#pragma omp parallel for
+            for (std::size_t xi = 0; xi < this->v_c.size(); ++xi) { resample_at (xi); }
+#else
+            morph::parallel::parallel_for (std::size_t{0}, this->v_c.size(), resample_at);
+#endif
 
             expr_resampled /= expr_resampled.max(); // renormalise result
             return expr_resampled;
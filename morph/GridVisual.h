@@ -68,6 +68,23 @@ namespace morph {
         // If you only need to change the colours in your GridVisual (for example, if you are
         // visualizing it flat), then it is about 4 times faster to only update the colours.
         void reinitColours()
+        {
+            if (this->colourScale.do_autoscale == true) { this->colourScale.reset(); }
+            this->updateColours();
+            this->reinit_dirty_buffers();
+        }
+
+        //! If zScale is flat, updateData() only needs to change the colours
+        bool updateAttributes() override
+        {
+            if (!this->zScaleIsFlat()) { return false; }
+            this->updateColours();
+            return true;
+        }
+
+    protected:
+        //! Recompute the colours in vertexColors from the data and mark them dirty
+        void updateColours()
         {
             if (this->grid == nullptr) {
                 throw std::runtime_error ("grid is nullptr in reinitColours()");
@@ -353,10 +370,8 @@ namespace morph {
                     throw std::runtime_error ("GridVisual error: grid size does not match scalarData size");
                 }
 
-                this->dcopy.resize (this->scalarData->size());
-                this->zScale.transform (*(this->scalarData), dcopy);
-                this->dcolour.resize (this->scalarData->size());
-                this->colourScale.transform (*(this->scalarData), dcolour);
+                this->transformScalarData (this->dcopy, this->dcolour);
+                this->convertColours (this->dcolour);
 
             } else if (this->vectorData != nullptr) {
 
@@ -366,6 +381,7 @@ namespace morph {
                 }
 
                 this->dcopy.resize (this->vectorData->size());
+                this->dcolour_rgb.clear();
                 this->dcolour.resize (this->vectorData->size());
                 this->dcolour2.resize (this->vectorData->size());
                 this->dcolour3.resize (this->vectorData->size());
@@ -749,18 +765,17 @@ namespace morph {
             this->idx = 0;
             this->setupScaling();
 
-            float datumC = 0.0f;   // datum at the centre
-            float datumNE = 0.0f;  // datum at the hex to the east.
-            float datumNN = 0.0f;
-
-            morph::vec<float> vtx_0, vtx_1, vtx_2, vtx_3, vtx_4;
-
-            for (I ri = 0; ri < this->grid->n(); ++ri) {
+            // Each pixel's column is built independently of the others, so build() can share them
+            // out between threads
+            this->build (this->grid->n(), [&](morph::VertexArena& a, const std::size_t i)
+            {
+                const I ri = static_cast<I>(i);
+                morph::vec<float> vtx_0, vtx_1, vtx_2, vtx_3, vtx_4;
 
                 // Use the linear scaled copy of the data, dcopy.
-                datumC  = dcopy[ri];
-                datumNE =  this->grid->has_ne(ri)  ? dcopy[this->grid->index_ne(ri)] : datumC;
-                datumNN =  this->grid->has_nn(ri)  ? dcopy[this->grid->index_nn(ri)] : datumC;
+                float datumC  = dcopy[ri]; // datum at the centre
+                float datumNE =  this->grid->has_ne(ri)  ? dcopy[this->grid->index_ne(ri)] : datumC; // datum at the pixel to the east
+                float datumNN =  this->grid->has_nn(ri)  ? dcopy[this->grid->index_nn(ri)] : datumC;
 
                 // Use a single colour for each rect, even though rectangle's z positions are
                 // interpolated. Do the _colour_ scaling:
@@ -775,44 +790,44 @@ namespace morph {
                 // First push the 5 positions of the pixel top face, starting with the centre
                 // Use the centre position as the first location for finding the normal vector
                 vtx_0 = { (*this->grid)[ri][0] + centering_offset[0], (*this->grid)[ri][1] + centering_offset[1], datumC };
-                this->vertex_push (vtx_0, this->vertexPositions);
+                a.vertex_push (vtx_0, a.vertexPositions);
 
                 // NE vertex
                 vtx_1 = { (*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumC };
-                this->vertex_push (vtx_1, this->vertexPositions);
+                a.vertex_push (vtx_1, a.vertexPositions);
 
                 // SE vertex
                 vtx_2 = { (*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] - vy + centering_offset[1], datumC };
-                this->vertex_push (vtx_2, this->vertexPositions);
+                a.vertex_push (vtx_2, a.vertexPositions);
 
                 // SW vertex
-                this->vertex_push ((*this->grid)[ri][0] - hx + centering_offset[0], (*this->grid)[ri][1] - vy + centering_offset[1], datumC, this->vertexPositions);
+                a.vertex_push ((*this->grid)[ri][0] - hx + centering_offset[0], (*this->grid)[ri][1] - vy + centering_offset[1], datumC, a.vertexPositions);
 
                 // NW vertex
-                this->vertex_push ((*this->grid)[ri][0] - hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumC, this->vertexPositions);
+                a.vertex_push ((*this->grid)[ri][0] - hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumC, a.vertexPositions);
 
                 // 4 Neighbour East vertices
                 // NE
-                this->vertex_push ((*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumC, this->vertexPositions);
+                a.vertex_push ((*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumC, a.vertexPositions);
                 // SE
-                this->vertex_push ((*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] - vy + centering_offset[1], datumC, this->vertexPositions);
+                a.vertex_push ((*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] - vy + centering_offset[1], datumC, a.vertexPositions);
 
                 // NE
                 vtx_3 = { (*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumNE };
-                this->vertex_push (vtx_3, this->vertexPositions);
+                a.vertex_push (vtx_3, a.vertexPositions);
                 // SE
-                this->vertex_push ((*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] - vy + centering_offset[1], datumNE, this->vertexPositions);
+                a.vertex_push ((*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] - vy + centering_offset[1], datumNE, a.vertexPositions);
 
                 // 4 Neighbour North vertices
                 // NW high
-                this->vertex_push ((*this->grid)[ri][0] - hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumC, this->vertexPositions);
+                a.vertex_push ((*this->grid)[ri][0] - hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumC, a.vertexPositions);
                 // NE high
-                this->vertex_push ((*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumC, this->vertexPositions);
+                a.vertex_push ((*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumC, a.vertexPositions);
                 // NW low
                 vtx_4 = { (*this->grid)[ri][0] - hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumNN };
-                this->vertex_push (vtx_4, this->vertexPositions);
+                a.vertex_push (vtx_4, a.vertexPositions);
                 // NE low
-                this->vertex_push ((*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumNN, this->vertexPositions);
+                a.vertex_push ((*this->grid)[ri][0] + hx + centering_offset[0], (*this->grid)[ri][1] + vy + centering_offset[1], datumNN, a.vertexPositions);
 
                 // From vtx_0,1,2 compute normal. This sets the correct normal, but note that there
                 // is only one 'layer' of vertices; the back of the GridVisual will be coloured the
@@ -833,86 +848,86 @@ namespace morph {
                 if (datumNN > datumC) { vnorm_n = -vnorm_n; }
 
                 vnorm.renormalize();
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm_e, this->vertexNormals);
-                this->vertex_push (vnorm_e, this->vertexNormals);
-                this->vertex_push (vnorm_e, this->vertexNormals);
-                this->vertex_push (vnorm_e, this->vertexNormals);
-                this->vertex_push (vnorm_n, this->vertexNormals);
-                this->vertex_push (vnorm_n, this->vertexNormals);
-                this->vertex_push (vnorm_n, this->vertexNormals);
-                this->vertex_push (vnorm_n, this->vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm_e, a.vertexNormals);
+                a.vertex_push (vnorm_e, a.vertexNormals);
+                a.vertex_push (vnorm_e, a.vertexNormals);
+                a.vertex_push (vnorm_e, a.vertexNormals);
+                a.vertex_push (vnorm_n, a.vertexNormals);
+                a.vertex_push (vnorm_n, a.vertexNormals);
+                a.vertex_push (vnorm_n, a.vertexNormals);
+                a.vertex_push (vnorm_n, a.vertexNormals);
 
                 // Five vertices with the same colour
-                this->vertex_push (clr, this->vertexColors);
-                this->vertex_push (clr, this->vertexColors);
-                this->vertex_push (clr, this->vertexColors);
-                this->vertex_push (clr, this->vertexColors);
-                this->vertex_push (clr, this->vertexColors);
+                a.vertex_push (clr, a.vertexColors);
+                a.vertex_push (clr, a.vertexColors);
+                a.vertex_push (clr, a.vertexColors);
+                a.vertex_push (clr, a.vertexColors);
+                a.vertex_push (clr, a.vertexColors);
 
                 if (this->options.test (gridvisual_flags::interpolate_colour_sides) == true) {
-                    this->vertex_push (clr, this->vertexColors);
-                    this->vertex_push (clr, this->vertexColors);
-                    this->vertex_push (clr_e, this->vertexColors);
-                    this->vertex_push (clr_e, this->vertexColors);
-
-                    this->vertex_push (clr, this->vertexColors);
-                    this->vertex_push (clr, this->vertexColors);
-                    this->vertex_push (clr_n, this->vertexColors);
-                    this->vertex_push (clr_n, this->vertexColors);
+                    a.vertex_push (clr, a.vertexColors);
+                    a.vertex_push (clr, a.vertexColors);
+                    a.vertex_push (clr_e, a.vertexColors);
+                    a.vertex_push (clr_e, a.vertexColors);
+
+                    a.vertex_push (clr, a.vertexColors);
+                    a.vertex_push (clr, a.vertexColors);
+                    a.vertex_push (clr_n, a.vertexColors);
+                    a.vertex_push (clr_n, a.vertexColors);
                 } else {
-                    this->vertex_push (this->clr_east_column, this->vertexColors);
-                    this->vertex_push (this->clr_east_column, this->vertexColors);
-                    this->vertex_push (this->clr_east_column, this->vertexColors);
-                    this->vertex_push (this->clr_east_column, this->vertexColors);
-
-                    this->vertex_push (this->clr_north_column, this->vertexColors);
-                    this->vertex_push (this->clr_north_column, this->vertexColors);
-                    this->vertex_push (this->clr_north_column, this->vertexColors);
-                    this->vertex_push (this->clr_north_column, this->vertexColors);
+                    a.vertex_push (this->clr_east_column, a.vertexColors);
+                    a.vertex_push (this->clr_east_column, a.vertexColors);
+                    a.vertex_push (this->clr_east_column, a.vertexColors);
+                    a.vertex_push (this->clr_east_column, a.vertexColors);
+
+                    a.vertex_push (this->clr_north_column, a.vertexColors);
+                    a.vertex_push (this->clr_north_column, a.vertexColors);
+                    a.vertex_push (this->clr_north_column, a.vertexColors);
+                    a.vertex_push (this->clr_north_column, a.vertexColors);
                 }
 
                 // Define indices now to produce the 4 triangles in the pixel
-                this->indices.push_back (this->idx+1);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+2);
+                a.indices.push_back (a.idx+1);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+2);
 
-                this->indices.push_back (this->idx+2);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+3);
+                a.indices.push_back (a.idx+2);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+3);
 
-                this->indices.push_back (this->idx+3);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+4);
+                a.indices.push_back (a.idx+3);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+4);
 
-                this->indices.push_back (this->idx+4);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+1);
+                a.indices.push_back (a.idx+4);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+1);
 
                 // East face
-                this->indices.push_back (this->idx + 5);
-                this->indices.push_back (this->idx + 6);
-                this->indices.push_back (this->idx + 7);
+                a.indices.push_back (a.idx + 5);
+                a.indices.push_back (a.idx + 6);
+                a.indices.push_back (a.idx + 7);
 
-                this->indices.push_back (this->idx + 6);
-                this->indices.push_back (this->idx + 8);
-                this->indices.push_back (this->idx + 7);
+                a.indices.push_back (a.idx + 6);
+                a.indices.push_back (a.idx + 8);
+                a.indices.push_back (a.idx + 7);
 
                 // North face
-                this->indices.push_back (this->idx + 9);
-                this->indices.push_back (this->idx + 10);
-                this->indices.push_back (this->idx + 11);
+                a.indices.push_back (a.idx + 9);
+                a.indices.push_back (a.idx + 10);
+                a.indices.push_back (a.idx + 11);
 
-                this->indices.push_back (this->idx + 10);
-                this->indices.push_back (this->idx + 12);
-                this->indices.push_back (this->idx + 11);
+                a.indices.push_back (a.idx + 10);
+                a.indices.push_back (a.idx + 12);
+                a.indices.push_back (a.idx + 11);
 
-                this->idx += 13;
-            }
+                a.idx += 13;
+            });
         }
 
         //! Floating pixels
@@ -1150,16 +1165,16 @@ namespace morph {
             return gridline_ht;
         }
 
-        //! Called by reinitColours when scalarData is not null
+        //! Called by updateColours when scalarData is not null
         void reinitColoursScalar (const std::size_t n_data, const std::size_t n_cvertices_per_datum)
         {
-            if (this->colourScale.do_autoscale == true) { this->colourScale.reset(); }
             this->dcolour.resize (this->scalarData->size());
             this->colourScale.transform (*(this->scalarData), dcolour);
+            this->convertColours (this->dcolour);
 
             // Replace elements of vertexColors
             for (std::size_t i = 0u; i < n_data; ++i) {
-                auto c = this->cm.convert (this->dcolour[i]);
+                auto c = this->dcolour_rgb.empty() ? this->cm.convert (this->dcolour[i]) : this->colour_at (i);
                 std::size_t d_idx = 3 * i * n_cvertices_per_datum;
                 for (std::size_t j = 0; j < n_cvertices_per_datum; ++j) {
                     this->vertexColors[d_idx + 3 * j] = c[0];
@@ -1168,14 +1183,14 @@ namespace morph {
                 }
             }
 
-            // Lastly, this call copies vertexColors (etc) into the OpenGL memory space
-            this->reinit_colour_buffer();
+            // Mark vertexColors to be copied into the OpenGL memory space
+            this->set_dirty (this->colVBO);
         }
 
-        //! Called by reinitColours when vectorData is not null (vectors are probably RGB colour)
+        //! Called by updateColours when vectorData is not null (vectors are probably RGB colour)
         void reinitColoursVector (const std::size_t n_data, const std::size_t n_cvertices_per_datum)
         {
-            if (this->colourScale.do_autoscale == true) { this->colourScale.reset(); }
+            this->dcolour_rgb.clear();
             for (unsigned int i = 0; i < this->vectorData->size(); ++i) {
                 this->dcolour[i] = (*this->vectorData)[i][0];
                 this->dcolour2[i] = (*this->vectorData)[i][1];
@@ -1199,8 +1214,8 @@ namespace morph {
                 }
             }
 
-            // Lastly, this call copies vertexColors (etc) into the OpenGL memory space
-            this->reinit_colour_buffer();
+            // Mark vertexColors to be copied into the OpenGL memory space
+            this->set_dirty (this->colVBO);
         }
 
         //! An overridable function to set the colour of rect ri
@@ -1217,6 +1232,9 @@ namespace morph {
             } else if (this->cm.numDatums() == 2) {
                 // Use vectorData
                 clr = this->cm.convert (this->dcolour[ri], this->dcolour2[ri]);
+            } else if (this->dcolour_rgb.size() == 3u * this->dcolour.size()) {
+                // Colours were already converted in a batch by convertColours()
+                clr = this->colour_at (ri);
             } else {
                 clr = this->cm.convert (this->dcolour[ri]);
             }
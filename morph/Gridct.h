@@ -17,12 +17,49 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
 #include <morph/vec.h>
 #include <morph/vvec.h>
 #include <morph/GridFeatures.h>
 
 namespace morph {
 
+    /*!
+     * A (2 * _rx + 1) by (2 * _ry + 1) stencil of weights, for use with Gridct::apply(). The weights
+     * are given row by row, starting with the northernmost row and with each row running from west
+     * to east, so that a stencil literal looks like the neighbourhood it applies to. A stencil is a
+     * structural type, so it can be a template argument:
+     *
+     *   constexpr morph::stencil<float, 1, 1> sobel_x = {{ -1, 0, 1,
+     *                                                       -2, 0, 2,
+     *                                                       -1, 0, 1 }};
+     *   grid.apply<sobel_x> (in, out);
+     *
+     * Zero weights cost nothing; they are skipped at compile time.
+     */
+    template <typename T, int _rx, int _ry>
+    struct stencil
+    {
+        static_assert (_rx >= 0 && _ry >= 0, "stencil radii can't be negative");
+        //! The stencil reaches this many elements to the east and west of the centre
+        static constexpr int rx = _rx;
+        //! The stencil reaches this many elements to the north and south of the centre
+        static constexpr int ry = _ry;
+        //! The number of weights
+        static constexpr std::size_t size = (2 * _rx + 1) * (2 * _ry + 1);
+        //! The eastward offset of weight k from the centre
+        static constexpr int ox (const std::size_t k) { return static_cast<int>(k % (2 * _rx + 1)) - _rx; }
+        //! The northward offset of weight k from the centre
+        static constexpr int oy (const std::size_t k) { return _ry - static_cast<int>(k / (2 * _rx + 1)); }
+
+        std::array<T, size> weights = {};
+    };
+
     /*!
      * \brief A grid class to define a rectangular Cartesian grid of locations
      *
@@ -316,6 +353,183 @@ namespace morph {
             return idx < n ? (*this)[idx] : morph::vec<C, 2>({std::numeric_limits<C>::max(), std::numeric_limits<C>::max()});
         }
 
+        /*
+         * Stencil operations on fields (vvecs of n values, one per element).
+         *
+         * Because the grid's size, order and wrapping are template arguments, these loops are
+         * written so that their bounds and the memory offsets of the neighbours are compile time
+         * constants. Away from the edges of the grid no neighbour index is computed and nothing is
+         * tested, so the compiler can unroll the stencil and vectorize the loop along each row.
+         * Only the elements within a stencil radius of an edge take a slower path.
+         *
+         * At an edge that does not wrap, a neighbour that would lie outside the grid is replaced by
+         * the nearest element inside it (clamp to edge). For a radius 1 stencil this is the element
+         * itself, which gives the zero flux boundary condition used in morph::RD_Base.
+         *
+         * The output field must not be the input field.
+         */
+
+        //! The neighbourhood of an element away from any edge. nb(ox, oy) is the index of the
+        //! element ox steps east and oy steps north of element i.
+        struct interior_neighbourhood
+        {
+            I i;
+            constexpr I operator() (const int ox, const int oy) const
+            {
+                constexpr std::int64_t north = order == GridOrder::bottomleft_to_topright ? std::int64_t{w} : -std::int64_t{w};
+                // In index arithmetic, so the loop over i stays affine (and vectorizable). For an
+                // unsigned I, a negative offset wraps around to the right answer.
+                return this->i + static_cast<I>(oy * north + ox);
+            }
+        };
+
+        //! The neighbourhood of the element in memory column c and row r, which is near an edge
+        struct edge_neighbourhood
+        {
+            std::int64_t c;
+            std::int64_t r;
+            constexpr I operator() (const int ox, const int oy) const
+            {
+                constexpr std::int64_t W = w;
+                constexpr std::int64_t H = h;
+                std::int64_t cc = this->c + ox;
+                std::int64_t rr = this->r + (order == GridOrder::bottomleft_to_topright ? oy : -oy);
+                if constexpr (wrap == GridDomainWrap::Horizontal || wrap == GridDomainWrap::Both) {
+                    cc = ((cc % W) + W) % W;
+                } else {
+                    cc = std::clamp (cc, std::int64_t{0}, W - 1);
+                }
+                if constexpr (wrap == GridDomainWrap::Vertical || wrap == GridDomainWrap::Both) {
+                    rr = ((rr % H) + H) % H;
+                } else {
+                    rr = std::clamp (rr, std::int64_t{0}, H - 1);
+                }
+                return static_cast<I>(rr * W + cc);
+            }
+        };
+
+        /*!
+         * Call f(i, nb) for every element i of the grid, in memory order. nb is a neighbourhood: a
+         * function object for which nb(ox, oy) is the index of the element ox steps east and oy
+         * steps north of i, for |ox| <= rx and |oy| <= ry. f must be callable with either type of
+         * neighbourhood, so write it as a generic lambda. This is the way to write stencils that
+         * aren't just weighted sums. For example, a gradient magnitude:
+         *
+         *   grid.for_each_stencil<1, 1> ([&](unsigned int i, auto nb) {
+         *       float gx = (f[nb(1, 0)] - f[nb(-1, 0)]) * 0.5f;
+         *       float gy = (f[nb(0, 1)] - f[nb(0, -1)]) * 0.5f;
+         *       out[i] = std::sqrt (gx * gx + gy * gy);
+         *   });
+         */
+        template <int rx, int ry, typename F>
+        void for_each_stencil (F&& f) const
+        {
+            static_assert (rx >= 0 && ry >= 0, "stencil radii can't be negative");
+            constexpr std::int64_t W = w;
+            constexpr std::int64_t H = h;
+            // Columns [c0, c1) of rows [r0, r1) are far enough from the edges to take the fast
+            // path. The wrapped neighbours of edge elements are not at the usual offsets, so the
+            // edges take the slow path whether or not they wrap.
+            constexpr std::int64_t c0 = std::min (std::int64_t{rx}, W);
+            constexpr std::int64_t c1 = std::max (W - rx, c0);
+            constexpr std::int64_t r0 = std::min (std::int64_t{ry}, H);
+            constexpr std::int64_t r1 = std::max (H - ry, r0);
+            for (std::int64_t r = 0; r < H; ++r) {
+                const I ri = static_cast<I>(r * W);
+                if (r < r0 || r >= r1) {
+                    for (std::int64_t c = 0; c < W; ++c) { f (static_cast<I>(ri + c), edge_neighbourhood{ c, r }); }
+                    continue;
+                }
+                for (std::int64_t c = 0; c < c0; ++c) { f (static_cast<I>(ri + c), edge_neighbourhood{ c, r }); }
+                const I i1 = static_cast<I>(ri + c1);
+                for (I i = static_cast<I>(ri + c0); i < i1; ++i) { f (i, interior_neighbourhood{ i }); }
+                for (std::int64_t c = c1; c < W; ++c) { f (static_cast<I>(ri + c), edge_neighbourhood{ c, r }); }
+            }
+        }
+
+        /*!
+         * Apply the stencil K to the field in, writing the weighted sums into out. out is resized
+         * to n elements. Throws std::runtime_error if in does not have n elements.
+         */
+        template <auto K, typename T>
+        void apply (const morph::vvec<T>& in, morph::vvec<T>& out) const
+        {
+            using K_t = decltype(K);
+            if (in.size() != static_cast<std::size_t>(n)) { throw std::runtime_error ("Gridct::apply: input field size != grid size"); }
+            out.resize (n);
+            this->for_each_stencil<K_t::rx, K_t::ry> ([&in, &out](const I i, const auto nb) {
+                out[i] = Gridct::weighted_sum<K> (in, nb, std::make_index_sequence<K_t::size>{});
+            });
+        }
+
+        //! A 5 point Laplacian stencil for this grid's element spacing
+        template <typename T>
+        static constexpr stencil<T, 1, 1> laplacian_stencil()
+        {
+            const T ax = T{1} / (static_cast<T>(dx[0]) * static_cast<T>(dx[0]));
+            const T ay = T{1} / (static_cast<T>(dx[1]) * static_cast<T>(dx[1]));
+            return stencil<T, 1, 1>{{ T{0}, ay,                     T{0},
+                                      ax,   T{-2} * ax - T{2} * ay, ax,
+                                      T{0}, ay,                     T{0} }};
+        }
+
+        //! Compute the Laplacian of the field f into lapf, with zero flux at any unwrapped edges
+        template <typename T>
+        void laplacian (const morph::vvec<T>& f, morph::vvec<T>& lapf) const
+        {
+            this->apply<Gridct::laplacian_stencil<T>()> (f, lapf);
+        }
+
+        //! A normalised binomial (approximately Gaussian) blur stencil of radius r
+        template <typename T, int r>
+        static constexpr stencil<T, r, r> blur_stencil()
+        {
+            std::array<T, 2 * r + 1> b = {};
+            b[0] = T{1};
+            for (int k = 1; k <= 2 * r; ++k) { b[k] = b[k - 1] * static_cast<T>(2 * r - k + 1) / static_cast<T>(k); }
+            T sum = T{0};
+            for (auto bk : b) { sum += bk; }
+            stencil<T, r, r> s;
+            for (int j = 0; j <= 2 * r; ++j) {
+                for (int i = 0; i <= 2 * r; ++i) { s.weights[j * (2 * r + 1) + i] = b[i] * b[j] / (sum * sum); }
+            }
+            return s;
+        }
+
+        //! Blur the field f into out with a binomial stencil of radius r (r = 1 gives [1 2 1]/4 on each axis)
+        template <int r = 1, typename T>
+        void blur (const morph::vvec<T>& f, morph::vvec<T>& out) const
+        {
+            this->apply<Gridct::blur_stencil<T, r>()> (f, out);
+        }
+
+        /*!
+         * Compute the advection term -(u . grad f) for the field f carried by the velocity field
+         * (ux, uy), using first order upwind differences, into out.
+         */
+        template <typename T>
+        void advection (const morph::vvec<T>& f, const morph::vvec<T>& ux, const morph::vvec<T>& uy,
+                        morph::vvec<T>& out) const
+        {
+            const std::size_t sz = static_cast<std::size_t>(n);
+            if (f.size() != sz || ux.size() != sz || uy.size() != sz) {
+                throw std::runtime_error ("Gridct::advection: field size != grid size");
+            }
+            out.resize (n);
+            constexpr T odx = T{1} / static_cast<T>(dx[0]);
+            constexpr T ody = T{1} / static_cast<T>(dx[1]);
+            this->for_each_stencil<1, 1> ([&](const I i, const auto nb) {
+                // Upwind: take the difference on the side that the flow comes from. Written
+                // without branches so that the row loop vectorizes.
+                const T u = ux[i];
+                const T v = uy[i];
+                const T fi = f[i];
+                const T dfdx = (std::max (u, T{0}) * (fi - f[nb (-1, 0)]) + std::min (u, T{0}) * (f[nb (1, 0)] - fi)) * odx;
+                const T dfdy = (std::max (v, T{0}) * (fi - f[nb (0, -1)]) + std::min (v, T{0}) * (f[nb (0, 1)] - fi)) * ody;
+                out[i] = -(dfdx + dfdy);
+            });
+        }
+
         /*!
          * Return the distance from the centre of the left element column to the centre of the
          * right element column
@@ -365,6 +579,19 @@ namespace morph {
         //! memory_coords is true.
         morph::vvec<C> v_x;
         morph::vvec<C> v_y;
+
+    private:
+        //! The sum over the non-zero weights of K of weight * in[neighbour], unrolled
+        template <auto K, typename T, typename N, std::size_t... k>
+        static T weighted_sum (const morph::vvec<T>& in, const N& nb, std::index_sequence<k...>)
+        {
+            T s = T{0};
+            auto term = [&]<std::size_t kk>() {
+                if constexpr (K.weights[kk] != 0) { s += static_cast<T>(K.weights[kk]) * in[nb (K.ox (kk), K.oy (kk))]; }
+            };
+            (term.template operator()<k>(), ...);
+            return s;
+        }
     };
 
 } // namespace morph
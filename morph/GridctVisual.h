@@ -94,10 +94,7 @@ namespace morph {
             this->idx = 0;
 
             if (this->scalarData != nullptr) {
-                this->dcopy.resize (this->scalarData->size());
-                this->zScale.transform (*(this->scalarData), dcopy);
-                this->dcolour.resize (this->scalarData->size());
-                this->colourScale.transform (*(this->scalarData), dcolour);
+                this->transformScalarData (this->dcopy, this->dcolour);
             } else if (this->vectorData != nullptr) {
                 this->dcopy.resize (this->vectorData->size());
                 this->dcolour.resize (this->vectorData->size());
@@ -175,10 +172,7 @@ namespace morph {
             this->idx = 0;
 
             if (this->scalarData != nullptr) {
-                this->dcopy.resize (this->scalarData->size());
-                this->zScale.transform (*(this->scalarData), dcopy);
-                this->dcolour.resize (this->scalarData->size());
-                this->colourScale.transform (*(this->scalarData), dcolour);
+                this->transformScalarData (this->dcopy, this->dcolour);
             } else if (this->vectorData != nullptr) {
                 this->dcopy.resize (this->vectorData->size());
                 this->dcolour.resize (this->vectorData->size());
@@ -0,0 +1,293 @@
+/*!
+ * \file
+ *
+ * \brief A HEALPix domain for computations on the sphere, with a precomputed neighbour table and
+ * Laplacian stencil.
+ *
+ * HealpixVisual draws HEALPix maps; this class is for computing them. Pixels are numbered in the
+ * NEST scheme, as they are in HealpixVisual.
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <morph/healpix/healpix_bare.hpp>
+#include <morph/mathconst.h>
+#include <morph/vec.h>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <utility>
+#include <stdexcept>
+
+namespace morph {
+
+    /*!
+     * A HEALPix tessellation of a sphere of radius \a radius into 12 * nside * nside equal area
+     * pixels, numbered in the NEST scheme.
+     *
+     * The 8 neighbours of every pixel are found once, on construction, and stored in a table, so
+     * that a solver need not call hp:: functions for every pixel on every step. Each pixel has
+     * neighbours to the SW, W, NW, N, NE, E, SE and S (the order used by the HEALPix library),
+     * except for 24 pixels (3 around each of the 8 points where three base faces meet) which have
+     * no W or no E neighbour. Their entries in the table are -1.
+     *
+     * laplacian() applies a Laplace-Beltrami stencil to a field on the pixels. Because HEALPix
+     * pixels are not arranged on a regular lattice, the stencil weights differ from pixel to
+     * pixel. They are found by fitting a quadratic, in geodesic coordinates centred on the pixel,
+     * through the values at its neighbours (7 or 8 of them) by least squares; the weights give the
+     * Laplacian of that quadratic. The error is second order in the pixel size over most of the
+     * sphere. Unlike a finite volume scheme, the stencil does not exactly conserve the integral of
+     * the field; the drift is also second order in the pixel size.
+     *
+     * \tparam F The floating point type of the stencil weights and of the fields passed to
+     * laplacian().
+     */
+    template <typename F = float>
+    class HealpixGrid
+    {
+    public:
+        //! The directions of the neighbours, in the order in which they appear in the table
+        enum class dirn : int { sw, w, nw, n, ne, e, se, s };
+
+        //! The largest nside for which pixel indices fit in the int32_t neighbour table
+        static constexpr std::int64_t max_nside = 8192;
+
+        /*!
+         * Construct the grid for the given \a _nside (a power of 2) on a sphere of radius \a
+         * _radius. This computes the neighbour table and the Laplacian stencil, in parallel.
+         */
+        HealpixGrid (const std::int64_t _nside, const F _radius = F{1})
+        {
+            if (_nside < 1 || (_nside & (_nside - 1)) != 0) {
+                throw std::runtime_error ("HealpixGrid: nside must be a power of 2");
+            }
+            if (_nside > max_nside) { throw std::runtime_error ("HealpixGrid: nside is too large"); }
+            this->nside = _nside;
+            this->npface = _nside * _nside;
+            this->npix = 12 * this->npface;
+            this->radius = _radius;
+            this->init_neighbours();
+            this->init_laplacian();
+        }
+
+        //! The HEALPix resolution parameter
+        std::int64_t get_nside() const { return this->nside; }
+        //! The number of pixels, 12 * nside * nside
+        std::int64_t n() const { return this->npix; }
+        //! The radius of the sphere
+        F get_radius() const { return this->radius; }
+        //! The area of one pixel
+        F pixel_area() const { return F{4} * morph::mathconst<F>::pi * this->radius * this->radius / static_cast<F>(this->npix); }
+
+        //! The 8 neighbours of pixel p (-1 where there is no neighbour)
+        const std::array<std::int32_t, 8>& neighbours (const std::int64_t p) const { return this->nbr[p]; }
+        //! The neighbour of pixel p in direction d, or -1 if p has no neighbour that way
+        std::int32_t neighbour (const std::int64_t p, const dirn d) const { return this->nbr[p][static_cast<int>(d)]; }
+        //! True if pixel p has a neighbour in direction d
+        bool has_neighbour (const std::int64_t p, const dirn d) const { return this->neighbour (p, d) != -1; }
+        //! The number of neighbours of p (7 or 8 for nside > 1)
+        int num_neighbours (const std::int64_t p) const
+        {
+            int nn = 0;
+            for (auto q : this->nbr[p]) { nn += q == -1 ? 0 : 1; }
+            return nn;
+        }
+
+        //! The location of the centre of pixel p
+        vec<F> centre (const std::int64_t p) const
+        {
+            hp::t_vec v = hp::nest2vec (this->nside, p);
+            return vec<F>{ static_cast<F>(v.x), static_cast<F>(v.y), static_cast<F>(v.z) } * this->radius;
+        }
+
+        //! The stencil weights that laplacian() applies to the neighbours of p (see neighbours())
+        const std::array<F, 8>& laplacian_weights (const std::int64_t p) const
+        {
+            return this->lap_weights[this->weight_index (p)];
+        }
+
+        /*!
+         * Compute the Laplacian of the field f (one value per pixel, in NEST order) into lapf.
+         * lapf[p] = sum over the neighbours q of p of w_q * (f[q] - f[p]).
+         */
+        void laplacian (const std::vector<F>& f, std::vector<F>& lapf) const
+        {
+            if (f.size() != static_cast<std::size_t>(this->npix) || lapf.size() != f.size()) {
+                throw std::runtime_error ("HealpixGrid::laplacian: fields must have n() elements");
+            }
+            const std::int64_t np = this->npix;
+#pragma omp parallel for schedule(static)
+            for (std::int64_t p = 0; p < np; ++p) {
+                const std::array<std::int32_t, 8>& nb = this->nbr[p];
+                const std::array<F, 8>& w = this->lap_weights[this->weight_index (p)];
+                const F f0 = f[p];
+                F sum = F{0};
+                for (int k = 0; k < 8; ++k) {
+                    if (nb[k] != -1) { sum += w[k] * (f[nb[k]] - f0); }
+                }
+                lapf[p] = sum;
+            }
+        }
+
+        /*!
+         * Find the 8 neighbours of NEST pixel p at resolution nside (-1 where there is no
+         * neighbour). This is the HEALPix library's algorithm; it is used to fill the neighbour
+         * table, which should be preferred in a computation.
+         */
+        static std::array<std::int32_t, 8> find_neighbours (const std::int64_t nside, const std::int64_t p)
+        {
+            // Steps in x and y to each neighbour
+            static constexpr int xoff[8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+            static constexpr int yoff[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+            // The face reached by stepping off face f in each of 9 directions (4 is 'no step')
+            static constexpr int facearray[9][12] = {
+                {  8,  9, 10, 11, -1, -1, -1, -1, 10, 11,  8,  9 },   // S
+                {  5,  6,  7,  4,  8,  9, 10, 11,  9, 10, 11,  8 },   // SE
+                { -1, -1, -1, -1,  5,  6,  7,  4, -1, -1, -1, -1 },   // E
+                {  4,  5,  6,  7, 11,  8,  9, 10, 11,  8,  9, 10 },   // SW
+                {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11 },   // centre
+                {  1,  2,  3,  0,  0,  1,  2,  3,  5,  6,  7,  4 },   // NE
+                { -1, -1, -1, -1,  7,  4,  5,  6, -1, -1, -1, -1 },   // W
+                {  3,  0,  1,  2,  3,  0,  1,  2,  4,  5,  6,  7 },   // NW
+                {  2,  3,  0,  1, -1, -1, -1, -1,  0,  1,  2,  3 } }; // N
+            // How x and y transform on crossing onto the new face, for each row of faces. Bit 0:
+            // reverse x, bit 1: reverse y, bit 2: swap x and y.
+            static constexpr int swaparray[9][3] = {
+                { 0, 0, 3 }, { 0, 0, 6 }, { 0, 0, 0 }, { 0, 0, 5 }, { 0, 0, 0 },
+                { 5, 0, 0 }, { 0, 0, 0 }, { 6, 0, 0 }, { 3, 0, 0 } };
+
+            std::array<std::int32_t, 8> rtn;
+            const hp::t_hpd h = hp::nest2hpd (nside, p);
+            if (h.x > 0 && h.x < nside - 1 && h.y > 0 && h.y < nside - 1) {
+                for (int i = 0; i < 8; ++i) {
+                    rtn[i] = static_cast<std::int32_t>(hp::hpd2nest (nside, hp::t_hpd{ h.x + xoff[i], h.y + yoff[i], h.f }));
+                }
+                return rtn;
+            }
+            for (int i = 0; i < 8; ++i) {
+                std::int64_t x = h.x + xoff[i];
+                std::int64_t y = h.y + yoff[i];
+                int nbnum = 4;
+                if (x < 0) { x += nside; nbnum -= 1; } else if (x >= nside) { x -= nside; nbnum += 1; }
+                if (y < 0) { y += nside; nbnum -= 3; } else if (y >= nside) { y -= nside; nbnum += 3; }
+                const int f = facearray[nbnum][h.f];
+                if (f < 0) { rtn[i] = -1; continue; }
+                const int bits = swaparray[nbnum][h.f >> 2];
+                if (bits & 1) { x = nside - x - 1; }
+                if (bits & 2) { y = nside - y - 1; }
+                if (bits & 4) { std::swap (x, y); }
+                rtn[i] = static_cast<std::int32_t>(hp::hpd2nest (nside, hp::t_hpd{ x, y, f }));
+            }
+            return rtn;
+        }
+
+    private:
+        std::int64_t nside = 1;
+        std::int64_t npface = 1;
+        std::int64_t npix = 12;
+        F radius = F{1};
+
+        //! The neighbour table, indexed by NEST pixel
+        std::vector<std::array<std::int32_t, 8>> nbr;
+
+        /*!
+         * Laplacian stencil weights. The four faces in each of the northern, equatorial and
+         * southern rows are related by rotations of 90 degrees about the polar axis, so the
+         * weights for a pixel depend only on its row of faces and its place within the face.
+         * Only 3 faces' worth are stored.
+         */
+        std::vector<std::array<F, 8>> lap_weights;
+
+        //! The index into lap_weights for pixel p
+        std::int64_t weight_index (const std::int64_t p) const
+        {
+            return ((p / this->npface) >> 2) * this->npface + (p & (this->npface - 1));
+        }
+
+        void init_neighbours()
+        {
+            this->nbr.resize (this->npix);
+            const std::int64_t np = this->npix;
+#pragma omp parallel for schedule(static)
+            for (std::int64_t p = 0; p < np; ++p) { this->nbr[p] = find_neighbours (this->nside, p); }
+        }
+
+        //! Compute the Laplacian stencil weights for the pixels of faces 0, 4 and 8
+        void init_laplacian()
+        {
+            this->lap_weights.resize (3 * this->npface);
+            const std::int64_t nw = 3 * this->npface;
+            const double r2 = static_cast<double>(this->radius) * static_cast<double>(this->radius);
+#pragma omp parallel for schedule(static)
+            for (std::int64_t i = 0; i < nw; ++i) {
+                const std::int64_t p = (i / this->npface) * 4 * this->npface + (i % this->npface);
+                std::array<double, 8> w = this->stencil_weights (p);
+                for (int k = 0; k < 8; ++k) { this->lap_weights[i][k] = static_cast<F>(w[k] / r2); }
+            }
+        }
+
+        /*!
+         * Least squares weights for the Laplacian at pixel p on the unit sphere. Each neighbour q
+         * is placed at (u,v) in geodesic (azimuthal equidistant) coordinates about the centre of
+         * p, where the Laplace-Beltrami operator at the origin is d2/du2 + d2/dv2. Fitting
+         * f(u,v) - f(0,0) = a u + b v + c u^2 + d uv + e v^2 gives the Laplacian 2c + 2e as a
+         * weighted sum of the differences f(q) - f(p).
+         */
+        std::array<double, 8> stencil_weights (const std::int64_t p) const
+        {
+            auto tovec = [](const hp::t_vec& v) { return vec<double>{ v.x, v.y, v.z }; };
+            const std::array<std::int32_t, 8>& nb = this->nbr[p];
+            const vec<double> c = tovec (hp::nest2vec (this->nside, p));
+            // A basis for the tangent plane at c
+            vec<double> e1 = (std::abs (c[2]) < 0.9 ? vec<double>{ 0.0, 0.0, 1.0 } : vec<double>{ 1.0, 0.0, 0.0 }).cross (c);
+            e1.renormalize();
+            const vec<double> e2 = c.cross (e1);
+
+            // Rows of the design matrix and the normal equations
+            std::array<std::array<double, 5>, 8> rows = {};
+            std::array<std::array<double, 5>, 5> m = {};
+            for (int k = 0; k < 8; ++k) {
+                if (nb[k] == -1) { continue; }
+                const vec<double> q = tovec (hp::nest2vec (this->nside, nb[k]));
+                const double d = std::atan2 (c.cross (q).length(), c.dot (q)); // geodesic distance
+                vec<double> t = q - c * q.dot (c);
+                t.renormalize();
+                const double u = d * t.dot (e1);
+                const double v = d * t.dot (e2);
+                rows[k] = { u, v, u * u, u * v, v * v };
+                for (int i = 0; i < 5; ++i) {
+                    for (int j = 0; j < 5; ++j) { m[i][j] += rows[k][i] * rows[k][j]; }
+                }
+            }
+            // The weights are rows * g, where m g = (0, 0, 2, 0, 2). Solve by Gaussian elimination
+            // with partial pivoting.
+            std::array<double, 5> g = { 0.0, 0.0, 2.0, 0.0, 2.0 };
+            for (int i = 0; i < 5; ++i) {
+                int piv = i;
+                for (int r = i + 1; r < 5; ++r) { if (std::abs (m[r][i]) > std::abs (m[piv][i])) { piv = r; } }
+                std::swap (m[i], m[piv]);
+                std::swap (g[i], g[piv]);
+                for (int r = i + 1; r < 5; ++r) {
+                    const double fac = m[r][i] / m[i][i];
+                    for (int j = i; j < 5; ++j) { m[r][j] -= fac * m[i][j]; }
+                    g[r] -= fac * g[i];
+                }
+            }
+            for (int i = 4; i >= 0; --i) {
+                for (int j = i + 1; j < 5; ++j) { g[i] -= m[i][j] * g[j]; }
+                g[i] /= m[i][i];
+            }
+            std::array<double, 8> w = {};
+            for (int k = 0; k < 8; ++k) {
+                if (nb[k] == -1) { continue; }
+                for (int i = 0; i < 5; ++i) { w[k] += rows[k][i] * g[i]; }
+            }
+            return w;
+        }
+    };
+
+} // namespace morph
@@ -15,8 +15,11 @@
 #include <morph/BezCoord.h>
 #include <morph/mathconst.h>
 #include <morph/MathAlgo.h>
+#include <morph/distance_transform.h>
 #include <morph/debug.h>
 #include <morph/mat22.h>
+#include <morph/parallel.h>
+#include <morph/fft.h>
 
 // If the HexGrid::save and HexGrid::load methods are required, define
 // HEXGRID_COMPILE_LOAD_AND_SAVE. A link to libhdf5 will be required in your program.
@@ -36,6 +39,9 @@
 #include <vector>
 #include <stdexcept>
 #include <limits>
+#include <algorithm>
+#include <utility>
+#include <iterator>
 
 namespace morph {
 
@@ -455,6 +461,18 @@ namespace morph {
             this->init();
         }
 
+        /*!
+         * Construct a HexGrid with a hex to hex distance of @a d_ that contains only the hexes
+         * that lie inside the boundary @a p. This gives the same grid as constructing a HexGrid
+         * and then calling setBoundary (p, loffset) but without first creating, then discarding,
+         * all the hexes that lie outside the boundary (see init (float, std::vector<BezCoord<float>>&,
+         * float, bool)).
+         */
+        HexGrid (float d_, const BezCurvePath<float>& p, float z_ = 0.0f, bool loffset = true)
+        {
+            this->init (d_, p, z_, loffset);
+        }
+
         /*!
          * Initialise with the passed-in parameters; a hex to hex distance of @a d_
          * (centre to centre) and approximate diameter of @a x_span_. Set z to @a z_
@@ -470,6 +488,44 @@ namespace morph {
             this->init();
         }
 
+        /*!
+         * Initialise a grid with a hex to hex distance of @a d_ containing only the hexes inside
+         * the boundary @a p. Points on @a p are computed with a step of d_/2, as they are in
+         * setBoundary (const BezCurvePath<float>&, bool).
+         */
+        void init (float d_, const BezCurvePath<float>& p, float z_ = 0.0f, bool loffset = true)
+        {
+            this->boundary = p;
+            if (this->boundary.isNull()) {
+                throw std::runtime_error ("HexGrid::init: The boundary path is null");
+            }
+            this->d = d_;
+            this->boundary.computePoints (this->d/2.0f, true);
+            std::vector<morph::BezCoord<float>> bpoints = this->boundary.getPoints();
+            this->init (d_, bpoints, z_, loffset);
+        }
+
+        /*!
+         * Initialise a grid with a hex to hex distance of @a d_ containing only the hexes inside
+         * the boundary given by the closed sequence of points @a bpoints. As in setBoundary
+         * (std::vector<BezCoord<float>>&, bool), @a bpoints is translated so that its centroid
+         * is at (0,0) unless @a loffset is false.
+         *
+         * Rather than building a hexagon of hexes and then finding and discarding those outside
+         * the boundary, each row of the hex lattice is intersected with the boundary polygon to
+         * find the hexes whose centres lie inside it (the rows are processed in parallel). The
+         * hexes closest to each point in @a bpoints are marked as boundary hexes, as they are by
+         * setBoundary. Only these hexes are then created. They are ordered in hexen just as they
+         * would be after setBoundary, so the resulting grid is the same.
+         */
+        void init (float d_, std::vector<BezCoord<float>>& bpoints, float z_ = 0.0f, bool loffset = true)
+        {
+            this->d = d_;
+            this->v = this->d * morph::mathconst<float>::root_3_over_2;
+            this->z = z_;
+            this->initFromBoundary (bpoints, loffset);
+        }
+
         /*!
          * Compute the centroid of the passed in list of Hexes.
          */
@@ -1149,35 +1205,23 @@ namespace morph {
         }
 
         /*!
-         * Run through all the hexes and compute the distance to the nearest boundary
-         * hex.
+         * Compute the distance from each hex to the nearest boundary hex, writing the result
+         * into d_distToBoundary and into each Hex's distToBoundary attribute. Boundary hexes have
+         * distance 0 and hexes outside the boundary are given the dummy value -100.
+         *
+         * The distances are found by propagating outwards from the boundary over the d_ne, d_nne
+         * (and so on) neighbour relations, which takes time proportional to the number of hexes.
+         * With the default distance_metric::euclidean, the distance is the exact Euclidean
+         * distance to the nearest boundary hex, the same as an exhaustive search would give (see
+         * distance_transform::from_boundary).
          */
-        void computeDistanceToBoundary()
+        void computeDistanceToBoundary (const distance_metric metric = distance_metric::euclidean)
         {
-            std::list<morph::Hex>::iterator h = this->hexen.begin();
-            while (h != this->hexen.end()) {
-                if (h->testFlags(HEX_IS_BOUNDARY) == true) {
-                    h->distToBoundary = 0.0f;
-                } else {
-                    if (h->testFlags(HEX_INSIDE_BOUNDARY) == false) {
-                        // Set to a dummy, negative value
-                        h->distToBoundary = -100.0;
-                    } else {
-                        // Not a boundary hex, but inside boundary
-                        std::list<morph::Hex>::iterator bh = this->hexen.begin();
-                        while (bh != this->hexen.end()) {
-                            if (bh->testFlags(HEX_IS_BOUNDARY) == true) {
-                                float delta = h->distanceFrom (*bh);
-                                if (delta < h->distToBoundary || h->distToBoundary < 0.0f) {
-                                    h->distToBoundary = delta;
-                                }
-                            }
-                            ++bh;
-                        }
-                    }
-                }
-                ++h;
-            }
+            if (this->d_x.size() != this->hexen.size()) { this->populate_d_vectors(); }
+            std::array<const std::vector<int>*, 6> nbrs = { &this->d_ne, &this->d_nne, &this->d_nnw, &this->d_nw, &this->d_nsw, &this->d_nse };
+            distance_transform::from_boundary (this->d_x, this->d_y, this->d_flags, HEX_IS_BOUNDARY, HEX_INSIDE_BOUNDARY,
+                                               nbrs, this->d_distToBoundary, metric);
+            for (auto& h : this->hexen) { h.distToBoundary = this->d_distToBoundary[h.di]; }
         }
 
         /*!
@@ -1441,6 +1485,60 @@ namespace morph {
             }
         }
 
+        /*!
+         * Make an FFT convolver which applies the kernel \a kerneldata (on \a kernelgrid) to
+         * data on this HexGrid, giving the same result as convolve(). The convolution is
+         * carried out in the (r,g) index space of the hexes, so the HexGrid must be a
+         * complete parallelogram (see setParallelogramBoundary). If it has been wrapped with
+         * setParallelogramWrap, the convolution is circular. The kernel is transformed once,
+         * here, so each call of the convolver's convolve() method costs O(N log N).
+         */
+        template<typename T>
+        morph::fft::convolver2d<T> fft_convolver (const HexGrid& kernelgrid, const std::vector<T>& kerneldata) const
+        {
+            if (kernelgrid.getd() != this->d) {
+                throw std::runtime_error ("The kernel HexGrid must have same d as this HexGrid to carry out convolution.");
+            }
+            if (kerneldata.size() != kernelgrid.hexen.size()) {
+                throw std::runtime_error ("The kernel data vector is not the same size as the kernel HexGrid.");
+            }
+            if (this->hexen.empty()) { throw std::runtime_error ("The HexGrid has no hexes."); }
+
+            // The extent of the hexes in (r,g) index space
+            int rmin = std::numeric_limits<int>::max();
+            int rmax = std::numeric_limits<int>::min();
+            int gmin = std::numeric_limits<int>::max();
+            int gmax = std::numeric_limits<int>::min();
+            for (auto h : this->hexen) {
+                rmin = std::min (rmin, h.ri); rmax = std::max (rmax, h.ri);
+                gmin = std::min (gmin, h.gi); gmax = std::max (gmax, h.gi);
+            }
+            const int nr = rmax - rmin + 1;
+            const int ng = gmax - gmin + 1;
+            if (static_cast<std::size_t>(nr) * static_cast<std::size_t>(ng) != this->hexen.size()) {
+                throw std::runtime_error ("FFT convolution needs a parallelogram shaped HexGrid.");
+            }
+
+            std::vector<std::array<int, 2>> positions (this->hexen.size());
+            // An axis wraps if the hexes on its far edge link back to the near edge
+            bool wrap_r = true;
+            bool wrap_g = true;
+            for (auto h : this->hexen) {
+                positions[h.vi] = { h.ri - rmin, h.gi - gmin };
+                if (h.ri == rmax && !h.has_ne()) { wrap_r = false; }
+                if (h.gi == gmax && !h.has_nne()) { wrap_g = false; }
+            }
+            std::vector<std::array<int, 2>> offsets (kernelgrid.hexen.size());
+            std::vector<T> weights (kernelgrid.hexen.size());
+            std::size_t k = 0;
+            for (auto kh : kernelgrid.hexen) {
+                offsets[k] = { kh.ri, kh.gi };
+                weights[k++] = kerneldata[kh.vi];
+            }
+
+            return morph::fft::convolver2d<T> (nr, ng, wrap_r, wrap_g, positions, offsets, weights);
+        }
+
         /*!
          * Resampling function (monochrome).
          *
@@ -1491,8 +1589,8 @@ namespace morph {
             morph::vec<float, 2> params = 1.0f / (2.0f * dist_per_pix * dist_per_pix);
             morph::vec<float, 2> threesig = 3.0f * dist_per_pix;
 
-#pragma omp parallel for // parallel on this outer loop gives best result (5.8 s vs 7 s)
-            for (typename std::vector<float>::size_type xi = 0u; xi < this->d_x.size(); ++xi) {
+            // parallel on this outer loop gives best result (5.8 s vs 7 s)
+            auto resample_at = [&](const std::size_t xi) {
                 float expr = 0.0f;
                 for (unsigned int i = 0; i < csz; ++i) {
                     // Get x/y pixel coords:
@@ -1508,7 +1606,13 @@ namespace morph {
                     }
                 }
                 expr_resampled[xi] = expr;
-            }
+            };
+#ifdef _OPENMP
+#pragma omp parallel for
+            for (std::size_t xi = 0; xi < this->d_x.size(); ++xi) { resample_at (xi); }
+#else
+            morph::parallel::parallel_for (std::size_t{0}, this->d_x.size(), resample_at);
+#endif
 
             expr_resampled /= expr_resampled.max(); // renormalise result
             return expr_resampled;
@@ -3249,6 +3353,164 @@ namespace morph {
             // "Finished creating " << this->hexen.size() << " hexes in " << maxRing << " rings."
         }
 
+        /*!
+         * The position of the hex at (ri, gi) in the spiral order in which init() creates hexes
+         * (which is the order of hexen after a boundary has been applied to the initial grid).
+         */
+        static unsigned int spiralIndex (const int ri, const int gi)
+        {
+            const int k = std::max (std::abs (ri), std::max (std::abs (gi), std::abs (ri + gi)));
+            if (k == 0) { return 0U; }
+            // Position of this hex within ring k, which starts at (-k, k) and is walked in six
+            // sides of k hexes each (see init())
+            int j = 0;
+            if (gi == k && ri < 0) {
+                j = ri + k;
+            } else if (ri >= 0 && ri + gi == k && gi > 0) {
+                j = k + ri;
+            } else if (ri == k && gi <= 0 && gi > -k) {
+                j = 2 * k - gi;
+            } else if (gi == -k && ri > 0) {
+                j = 4 * k - ri;
+            } else if (ri <= 0 && ri + gi == -k && gi < 0) {
+                j = 4 * k - ri;
+            } else { // ri == -k, 0 <= gi < k
+                j = 5 * k + gi;
+            }
+            return static_cast<unsigned int>(1 + 3 * k * (k - 1) + j);
+        }
+
+        //! The ri,gi indices of the hex on the (infinite) hex lattice which contains the point (x,y)
+        std::array<int, 2> latticeIndex (const float x, const float y) const
+        {
+            // Fractional cube coordinates, then round to the nearest hex
+            const float gf = y / this->v;
+            const float rf = x / this->d - gf / 2.0f;
+            const float bf = -rf - gf;
+            int ri = static_cast<int>(std::round (rf));
+            int gi = static_cast<int>(std::round (gf));
+            const int bi = static_cast<int>(std::round (bf));
+            const float dr = std::abs (ri - rf);
+            const float dg = std::abs (gi - gf);
+            const float db = std::abs (bi - bf);
+            if (dr > dg && dr > db) {
+                ri = -gi - bi;
+            } else if (dg > db) {
+                gi = -ri - bi;
+            }
+            return { ri, gi };
+        }
+
+        /*!
+         * Create hexen containing just the hexes inside the boundary given by bpoints. See
+         * init (float, std::vector<BezCoord<float>>&, float, bool).
+         */
+        void initFromBoundary (std::vector<BezCoord<float>>& bpoints, bool loffset)
+        {
+            if (bpoints.size() < 3) {
+                throw std::runtime_error ("HexGrid: The boundary needs at least 3 points");
+            }
+            this->hexen.clear();
+            this->bhexen.clear();
+
+            this->boundaryCentroid = morph::BezCurvePath<float>::getCentroid (bpoints);
+            if (loffset) {
+                for (auto& bp : bpoints) { bp.subtract (this->boundaryCentroid); }
+                this->originalBoundaryCentroid = this->boundaryCentroid;
+                this->boundaryCentroid = {0.0f, 0.0f};
+            }
+
+            // The extent of the boundary determines the block of the ri,gi lattice to rasterise
+            morph::vec<float, 2> bmin = bpoints[0].coord;
+            morph::vec<float, 2> bmax = bpoints[0].coord;
+            for (auto& bp : bpoints) {
+                bmin[0] = std::min (bmin[0], bp.x());
+                bmin[1] = std::min (bmin[1], bp.y());
+                bmax[0] = std::max (bmax[0], bp.x());
+                bmax[1] = std::max (bmax[1], bp.y());
+            }
+            this->x_span = bmax[0] - bmin[0];
+            const int gi0 = static_cast<int>(std::floor (bmin[1] / this->v)) - 1;
+            const int gi1 = static_cast<int>(std::ceil (bmax[1] / this->v)) + 1;
+            const int ri0 = static_cast<int>(std::floor (bmin[0] / this->d - gi1 / 2.0f)) - 1;
+            const int ri1 = static_cast<int>(std::ceil (bmax[0] / this->d - gi0 / 2.0f)) + 1;
+            const int w = ri1 - ri0 + 1;
+            const int h = gi1 - gi0 + 1;
+
+            // Flags for each lattice position in the block. Mark the hexes whose centres are
+            // inside the boundary polygon, row by row.
+            std::vector<unsigned int> cell (static_cast<std::size_t>(w) * h, 0U);
+#pragma omp parallel for
+            for (int row = 0; row < h; ++row) {
+                const int gi = gi0 + row;
+                std::vector<float> xc = BezCurvePath<float>::rowCrossings (bpoints, this->v * gi);
+                for (std::size_t k = 1; k < xc.size(); k += 2) {
+                    // Hex centres on this row are at x = d * (ri + gi/2)
+                    const int ra = static_cast<int>(std::ceil (xc[k-1] / this->d - gi / 2.0f));
+                    const int rb = static_cast<int>(std::floor (xc[k] / this->d - gi / 2.0f));
+                    for (int ri = ra; ri <= rb; ++ri) { cell[row * w + ri - ri0] = HEX_INSIDE_BOUNDARY; }
+                }
+            }
+            // The hex closest to each boundary point is a boundary hex
+            for (auto& bp : bpoints) {
+                std::array<int, 2> rg = this->latticeIndex (bp.x(), bp.y());
+                cell[(rg[1] - gi0) * w + rg[0] - ri0] = HEX_IS_BOUNDARY | HEX_INSIDE_BOUNDARY;
+            }
+
+            // Create the hexes, in the same order as init() would have created them
+            std::vector<std::pair<unsigned int, int>> order; // spiral index, cell index
+            for (int c = 0; c < w * h; ++c) {
+                if (cell[c]) { order.emplace_back (spiralIndex (ri0 + c % w, gi0 + c / w), c); }
+            }
+            std::sort (order.begin(), order.end());
+            std::vector<int> cell_hex (static_cast<std::size_t>(w) * h, -1);
+            std::vector<std::list<morph::Hex>::iterator> hexits;
+            hexits.reserve (order.size());
+            unsigned int vi = 0;
+            for (auto o : order) {
+                cell_hex[o.second] = static_cast<int>(vi);
+                this->hexen.emplace_back (vi++, this->d, ri0 + o.second % w, gi0 + o.second / w);
+                this->hexen.back().setFlag (cell[o.second]);
+                hexits.push_back (std::prev (this->hexen.end()));
+            }
+
+            // Connect neighbours (each relation is set from both sides, so only look E and N)
+            for (auto hi : hexits) {
+                const int c = (hi->gi - gi0) * w + hi->ri - ri0;
+                const int c_ne = c + 1;
+                const int c_nne = c + w;
+                const int c_nnw = c + w - 1;
+                if (hi->ri + 1 <= ri1 && cell_hex[c_ne] >= 0) {
+                    hi->set_ne (hexits[cell_hex[c_ne]]);
+                    hexits[cell_hex[c_ne]]->set_nw (hi);
+                }
+                if (hi->gi + 1 <= gi1 && cell_hex[c_nne] >= 0) {
+                    hi->set_nne (hexits[cell_hex[c_nne]]);
+                    hexits[cell_hex[c_nne]]->set_nsw (hi);
+                }
+                if (hi->gi + 1 <= gi1 && hi->ri - 1 >= ri0 && cell_hex[c_nnw] >= 0) {
+                    hi->set_nnw (hexits[cell_hex[c_nnw]]);
+                    hexits[cell_hex[c_nnw]]->set_nse (hi);
+                }
+            }
+
+            // Check that the boundary is contiguous, starting from the last boundary point's hex
+            {
+                std::array<int, 2> rg = this->latticeIndex (bpoints.back().x(), bpoints.back().y());
+                std::list<morph::Hex>::iterator bhi = hexits[cell_hex[(rg[1] - gi0) * w + rg[0] - ri0]];
+                std::set<unsigned int> seen;
+                std::list<morph::Hex>::iterator hi = bhi;
+                if (this->boundaryContiguous (bhi, hi, seen) == false) {
+                    throw std::runtime_error ("The constructed boundary is not a contiguous sequence of hexes.");
+                }
+            }
+
+            this->renumberVectorIndices();
+            // There is no initial hexagonal grid, so vertexE, etc are not valid
+            this->gridReduced = true;
+            this->populate_d_vectors();
+        }
+
         /*!
          * Starting from \a startFrom, and following nearest-neighbour relations, find
          * the closest Hex in hexen to the coordinate point \a point, and set its
@@ -106,12 +106,13 @@ namespace morph {
             if (this->scalarData != nullptr) {
                 // What do these scaling operations do to any NaNs in scalarData? They should remain
                 // NaN. Then in dcopy, might want to make them 0.
-                this->zScale.transform (*(this->scalarData), this->dcopy);
+                this->transformScalarData (this->dcopy, this->dcolour);
                 dcopy.replace_nan_with (this->zScale.transform_one(0.0f));
-                this->colourScale.transform (*(this->scalarData), this->dcolour);
+                this->convertColours (this->dcolour);
 
             } else if (this->vectorData != nullptr) {
 
+                this->dcolour_rgb.clear();
                 this->dcolour2.resize (this->datasize);
                 this->dcolour3.resize (this->datasize);
                 std::vector<float> veclens(this->dcopy);
@@ -183,28 +184,27 @@ namespace morph {
         // This locally defined reinit function knows that we don't want to clear vertexPositions/vertexNormals
         void reinit_on_update()
         {
-            if (this->setContext != nullptr) { this->setContext (this->parentVis); }
-            // No need to set idx to 0 on an update, or clear/empty vertex/indices containers
-            this->initializeVertices (true); // true for 'update' not 'initial build'
-            this->reinit_buffers(); // could potentially be 'reinit_position_color_buffers_only()'
+            if (!this->updateAttributes()) {
+                VisualDataModel<T,glver>::reinit();
+                return;
+            }
+            this->reinit_dirty_buffers();
         }
 
-        // Override the updateData method
-        void updateData (const std::vector<T>* _data)
+        /*!
+         * In Triangles mode, there's one vertex per hex, so a data update only changes the z
+         * positions and colours of the existing vertices. These are recomputed in place and only
+         * the position and colour buffers are re-uploaded. HexInterp mode needs a full reinit().
+         */
+        bool updateAttributes() override
         {
-            this->scalarData = _data;
-            switch (this->hexVisMode) {
-            case HexVisMode::Triangles:
-            {
-                this->reinit_on_update(); // instead of VisualDataModel<T,glver>::reinit().
-                break;
-            }
-            default:
-            {
-                VisualDataModel<T,glver>::reinit();
-                break;
-            }
-            }
+            if (this->hexVisMode != HexVisMode::Triangles) { return false; }
+            if (this->vertexPositions.size() < 3u * this->hg->num()) { return false; }
+            // No need to set idx to 0 on an update, or clear/empty vertex/indices containers
+            this->initializeVertices (true); // true for 'update' not 'initial build'
+            this->set_dirty (this->posnVBO);
+            this->set_dirty (this->colVBO);
+            return true;
         }
 
         // Initialize vertex buffer objects and vertex array object.
@@ -324,32 +324,50 @@ namespace morph {
 
             this->setupScaling();
 
-            // x and y coords on the HexGrid. May be replaced if dataCoords has been set.
-            float _x = 0.0f;
-            float _y = 0.0f;
-            // These Ts are all floats, right?
-            float datumC = 0.0f;   // datum at the centre
-            float datumNE = 0.0f;  // datum at the hex to the east.
-            float datumNNE = 0.0f; // etc
-            float datumNNW = 0.0f;
-            float datumNW = 0.0f;
-            float datumNSW = 0.0f;
-            float datumNSE = 0.0f;
-
-            float datum = 0.0f;
-            float third = 0.3333333f;
-            float half = 0.5f;
-            morph::vec<float> vtx_0, vtx_1, vtx_2, vtx_tmp;
-
-            morph::vec<float> coordC = { 0.0f, 0.0f, 0.0f };
-            morph::vec<float> coordNE = coordC;
-            morph::vec<float> coordNNE = coordC;
-            morph::vec<float> coordNNW = coordC;
-            morph::vec<float> coordNW = coordC;
-            morph::vec<float> coordNSW = coordC;
-            morph::vec<float> coordNSE = coordC;
+            // Mark the boundary and centre hexes first, because each hex's mark is read as it is built
+            if (this->showboundary || this->showcentre) {
+                for (unsigned int hi = 0; hi < nhex; ++hi) {
+                    float _x = this->dataCoords == nullptr ? this->hg->d_x[hi] : (*this->dataCoords)[hi][0];
+                    float _y = this->dataCoords == nullptr ? this->hg->d_y[hi] : (*this->dataCoords)[hi][1];
+                    if (this->showboundary && (this->hg->vhexen[hi])->boundaryHex() == true) {
+                        this->markHex (hi);
+                    }
+                    if (this->showcentre && _x == 0.0f && _y == 0.0f) {
+                        this->markHex (hi);
+                    }
+                }
+            }
 
-            for (unsigned int hi = 0; hi < nhex; ++hi) {
+            // Each hex is built independently of the others, so build() can share them out
+            // between threads
+            this->build (nhex, [&](morph::VertexArena& a, const std::size_t i)
+            {
+                const unsigned int hi = static_cast<unsigned int>(i);
+
+                // x and y coords on the HexGrid. May be replaced if dataCoords has been set.
+                float _x = 0.0f;
+                float _y = 0.0f;
+                // These Ts are all floats, right?
+                float datumC = 0.0f;   // datum at the centre
+                float datumNE = 0.0f;  // datum at the hex to the east.
+                float datumNNE = 0.0f; // etc
+                float datumNNW = 0.0f;
+                float datumNW = 0.0f;
+                float datumNSW = 0.0f;
+                float datumNSE = 0.0f;
+
+                float datum = 0.0f;
+                float third = 0.3333333f;
+                float half = 0.5f;
+                morph::vec<float> vtx_0, vtx_1, vtx_2, vtx_tmp;
+
+                morph::vec<float> coordC = { 0.0f, 0.0f, 0.0f };
+                morph::vec<float> coordNE = coordC;
+                morph::vec<float> coordNNE = coordC;
+                morph::vec<float> coordNNW = coordC;
+                morph::vec<float> coordNW = coordC;
+                morph::vec<float> coordNSW = coordC;
+                morph::vec<float> coordNSE = coordC;
 
                 if (this->dataCoords == nullptr) {
                     _x = this->hg->d_x[hi];
@@ -387,19 +405,13 @@ namespace morph {
                 // Use a single colour for each hex, even though hex z positions are
                 // interpolated. Do the _colour_ scaling:
                 std::array<float, 3> clr = this->setColour (hi);
-                if (this->showboundary && (this->hg->vhexen[hi])->boundaryHex() == true) {
-                    this->markHex (hi);
-                }
-                if (this->showcentre && _x == 0.0f && _y == 0.0f) {
-                    this->markHex (hi);
-                }
                 std::array<float, 3> blkclr = {0,0,0};
 
                 // First push the 7 positions of the triangle vertices, starting with the centre
 
                 // Use the centre position as the first location for finding the normal vector
                 vtx_0 = this->dataCoords == nullptr ? morph::vec<float>{ _x, _y, datumC } : coordC;
-                this->vertex_push (this->zoom * vtx_0, this->vertexPositions);
+                a.vertex_push (this->zoom * vtx_0, a.vertexPositions);
 
                 // NE vertex
                 if (this->dataCoords == nullptr) {
@@ -431,7 +443,7 @@ namespace morph {
                         vtx_1 = coordC;
                     }
                 }
-                this->vertex_push (this->zoom * vtx_1, this->vertexPositions);
+                a.vertex_push (this->zoom * vtx_1, a.vertexPositions);
 
 
                 // SE vertex
@@ -461,7 +473,7 @@ namespace morph {
                         vtx_2 = coordC;
                     }
                 }
-                this->vertex_push (this->zoom * vtx_2, this->vertexPositions);
+                a.vertex_push (this->zoom * vtx_2, a.vertexPositions);
 
 
                 // S
@@ -491,7 +503,7 @@ namespace morph {
                         vtx_tmp = coordC;
                     }
                 }
-                this->vertex_push (this->zoom * vtx_tmp, this->vertexPositions);
+                a.vertex_push (this->zoom * vtx_tmp, a.vertexPositions);
 
                 // SW
                 if (this->dataCoords == nullptr) {
@@ -520,7 +532,7 @@ namespace morph {
                         vtx_tmp = coordC;
                     }
                 }
-                this->vertex_push (this->zoom * vtx_tmp, this->vertexPositions);
+                a.vertex_push (this->zoom * vtx_tmp, a.vertexPositions);
 
                 // NW
                 if (this->dataCoords == nullptr) {
@@ -549,7 +561,7 @@ namespace morph {
                         vtx_tmp = coordC;
                     }
                 }
-                this->vertex_push (this->zoom * vtx_tmp, this->vertexPositions);
+                a.vertex_push (this->zoom * vtx_tmp, a.vertexPositions);
 
                 // N
                 if (this->dataCoords == nullptr) {
@@ -578,7 +590,7 @@ namespace morph {
                         vtx_tmp = coordC;
                     }
                 }
-                this->vertex_push (this->zoom * vtx_tmp, this->vertexPositions);
+                a.vertex_push (this->zoom * vtx_tmp, a.vertexPositions);
 
                 // From vtx_0,1,2 compute normal. This sets the correct normal, but note
                 // that there is only one 'layer' of vertices; the back of the
@@ -589,76 +601,76 @@ namespace morph {
                 morph::vec<float> plane2 = vtx_2 - vtx_0;
                 morph::vec<float> vnorm = plane2.cross (plane1);
                 vnorm.renormalize();
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
-                this->vertex_push (vnorm, this->vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
+                a.vertex_push (vnorm, a.vertexNormals);
 
                 // Usually seven vertices with the same colour, but if the hex is
                 // marked, then three of the vertices are given the colour black,
                 // marking the hex out visually.
                 if (std::isnan(dcolour[hi])) {
-                    this->vertex_push (clr, this->vertexColors);
-                    this->vertex_push (blkclr, this->vertexColors);
-                    this->vertex_push (blkclr, this->vertexColors);
-                    this->vertex_push (blkclr, this->vertexColors);
-                    this->vertex_push (blkclr, this->vertexColors);
-                    this->vertex_push (blkclr, this->vertexColors);
-                    this->vertex_push (blkclr, this->vertexColors);
+                    a.vertex_push (clr, a.vertexColors);
+                    a.vertex_push (blkclr, a.vertexColors);
+                    a.vertex_push (blkclr, a.vertexColors);
+                    a.vertex_push (blkclr, a.vertexColors);
+                    a.vertex_push (blkclr, a.vertexColors);
+                    a.vertex_push (blkclr, a.vertexColors);
+                    a.vertex_push (blkclr, a.vertexColors);
                 } else {
-                    this->vertex_push (clr, this->vertexColors);
+                    a.vertex_push (clr, a.vertexColors);
                     if (this->markedHexes.count(hi)) {
-                        this->vertex_push (blkclr, this->vertexColors);
+                        a.vertex_push (blkclr, a.vertexColors);
                     } else {
-                        this->vertex_push (clr, this->vertexColors);
+                        a.vertex_push (clr, a.vertexColors);
                     }
 
-                    this->vertex_push (clr, this->vertexColors);
+                    a.vertex_push (clr, a.vertexColors);
 
                     if (this->markedHexes.count(hi)) {
-                        this->vertex_push (blkclr, this->vertexColors);
+                        a.vertex_push (blkclr, a.vertexColors);
                     } else {
-                        this->vertex_push (clr, this->vertexColors);
+                        a.vertex_push (clr, a.vertexColors);
                     }
-                    this->vertex_push (clr, this->vertexColors);
+                    a.vertex_push (clr, a.vertexColors);
                     if (this->markedHexes.count(hi)) {
-                        this->vertex_push (blkclr, this->vertexColors);
+                        a.vertex_push (blkclr, a.vertexColors);
                     } else {
-                        this->vertex_push (clr, this->vertexColors);
+                        a.vertex_push (clr, a.vertexColors);
                     }
-                    this->vertex_push (clr, this->vertexColors);
+                    a.vertex_push (clr, a.vertexColors);
                 }
 
                 // Define indices now to produce the 6 triangles in the hex
-                this->indices.push_back (this->idx+1);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+2);
+                a.indices.push_back (a.idx+1);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+2);
 
-                this->indices.push_back (this->idx+2);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+3);
+                a.indices.push_back (a.idx+2);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+3);
 
-                this->indices.push_back (this->idx+3);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+4);
+                a.indices.push_back (a.idx+3);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+4);
 
-                this->indices.push_back (this->idx+4);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+5);
+                a.indices.push_back (a.idx+4);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+5);
 
-                this->indices.push_back (this->idx+5);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+6);
+                a.indices.push_back (a.idx+5);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+6);
 
-                this->indices.push_back (this->idx+6);
-                this->indices.push_back (this->idx);
-                this->indices.push_back (this->idx+1);
+                a.indices.push_back (a.idx+6);
+                a.indices.push_back (a.idx);
+                a.indices.push_back (a.idx+1);
 
-                this->idx += 7; // 7 vertices (each of 3 floats for x/y/z), 18 indices.
-            }
+                a.idx += 7; // 7 vertices (each of 3 floats for x/y/z), 18 indices.
+            });
         }
 
         // Show a Flat surface for the zero plane. Currently, this is expensively
@@ -1126,7 +1138,15 @@ namespace morph {
         HexVisMode hexVisMode = HexVisMode::HexInterp;
 
     protected:
-        //! An overridable function to set the colour of hex hi
+        /*!
+         * An overridable function to set the colour of hex hi.
+         *
+         * In HexInterp mode the hexes are built with VertexArena::build(), which calls this from
+         * several threads at once (each with a different hi). An override must therefore be thread
+         * safe: it may read shared state, but must not modify it (no caching, counters or
+         * colour map setters). If your override can't be made thread safe, set parallel_build to
+         * false to build on one thread.
+         */
         virtual std::array<float, 3> setColour (unsigned int hi)
         {
             std::array<float, 3> clr = { 0.0f, 0.0f, 0.0f };
@@ -1141,6 +1161,9 @@ namespace morph {
             } else if (this->cm.numDatums() == 2) {
                 // Use vectorData
                 clr = this->cm.convert (this->dcolour[hi], this->dcolour2[hi]);
+            } else if (this->dcolour_rgb.size() == 3u * this->dcolour.size()) {
+                // Colours were already converted in a batch in setupScaling()
+                clr = this->colour_at (hi);
             } else {
                 clr = this->cm.convert (this->dcolour[hi]);
             }
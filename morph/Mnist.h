@@ -43,6 +43,8 @@
 #include <stdexcept>
 #include <morph/vec.h>
 #include <morph/vvec.h>
+#include <morph/idx.h>
+#include <span>
 
 namespace morph {
 
@@ -75,65 +77,46 @@ namespace morph {
         void load_data (const std::string& tag,
                         std::multimap<unsigned char, std::pair<int, morph::vvec<float>>>& vecFloats)
         {
-            // Ifstreams for images and labels.
-            std::ifstream img_f;
-            std::ifstream lbl_f;
-
             std::string img_p = basepath + tag + "-images-idx3-ubyte";
             std::string lbl_p = basepath + tag + "-labels-idx1-ubyte";
-            img_f.open (img_p.c_str(), std::ios::in | std::ios::binary);
-            lbl_f.open (lbl_p.c_str(), std::ios::in | std::ios::binary);
 
-            if (!img_f.is_open() || !lbl_f.is_open()) {
+            // Map the files into memory, rather than reading them a byte at a time
+            morph::idx_file img_f;
+            morph::idx_file lbl_f;
+            try {
+                img_f.open (img_p);
+                lbl_f.open (lbl_p);
+            } catch (const std::exception& e) {
                 std::stringstream ee;
                 ee << "Mnist: File access error opening MNIST data files: "
-                   << img_p << " (images) and " << lbl_p << " (labels)";
+                   << img_p << " (images) and " << lbl_p << " (labels): " << e.what();
                 throw std::runtime_error (ee.str());
             }
 
-            // Process training data magic number, stuff
-            char buf[4];
-            img_f.read (buf, 4);
-            int magic_imgs = chars_to_int (buf);
-            img_f.read (buf, 4);
-            int n_imgs = (buf[3]&0xff) | (buf[2]&0xff)<<8 | (buf[1]&0xff)<<16 | (buf[0]&0xff)<<24;
-            img_f.read (buf, 4);
-            this->nr = (buf[3]&0xff) | (buf[2]&0xff)<<8 | (buf[1]&0xff)<<16 | (buf[0]&0xff)<<24;
-            img_f.read (buf, 4);
-            this->nc = (buf[3]&0xff) | (buf[2]&0xff)<<8 | (buf[1]&0xff)<<16 | (buf[0]&0xff)<<24;
+            // Check images magic number (idx3, unsigned byte) and labels magic number (idx1)
+            if (img_f.shape().size() != 3) { throw std::runtime_error ("Mnist: data, images magic number is wrong"); }
+            if (lbl_f.shape().size() != 1) { throw std::runtime_error ("Mnist: data, labels magic number is wrong"); }
 
+            int n_imgs = static_cast<int>(img_f.count());
+            this->nr = static_cast<int>(img_f.shape()[1]);
+            this->nc = static_cast<int>(img_f.shape()[2]);
             if (nr * nc != mnlen) { throw std::runtime_error ("Mnist: Expecting 28x28 images in Mnist!"); }
 
-            // Check images magic number
-            if (magic_imgs != 2051) { throw std::runtime_error ("Mnist: data, images magic number is wrong"); }
-
-            // Process labels magic number etc
-            lbl_f.read (buf, 4);
-            int magic_lbls = (buf[3]&0xff) | (buf[2]&0xff)<<8 | (buf[1]&0xff)<<16 | (buf[0]&0xff)<<24;
-            lbl_f.read (buf, 4);
-            int n_lbls = (buf[3]&0xff) | (buf[2]&0xff)<<8 | (buf[1]&0xff)<<16 | (buf[0]&0xff)<<24;
-
-            // Check labels magic number
-            if (magic_lbls != 2049) { throw std::runtime_error ("Mnist: data, labels magic number is wrong"); }
-
             // Check reported number of images == number of labels
+            int n_lbls = static_cast<int>(lbl_f.count());
             if (n_lbls != n_imgs) {
                 throw std::runtime_error ("Mnist: Training data, num labels != num images");
             }
 
-            // Should now be able to read through each file, pulling in the data.
-            char cbuf[1];
+            // Should now be able to read through each image, pulling in the data.
+            std::span<const unsigned char> lbls = lbl_f.data();
             for (int inum = 0; inum < n_imgs; ++inum) {
                 morph::vvec<float> ar(nr*nc, 0.0f);
-                // Read one label...
-                lbl_f.read (cbuf, 1);
-                unsigned char lbl = static_cast<unsigned char>(cbuf[0]);
+                unsigned char lbl = lbls[inum];
+                std::span<const unsigned char> img = img_f.item (inum);
                 for (int r = 0; r < this->nr; ++r) {
                     for (int c = 0; c < this->nc; ++c) {
-                        // Read pixel and stick it in the array
-                        img_f.read (cbuf, 1);
-                        unsigned char uc = static_cast<unsigned char>(cbuf[0]);
-                        float numf = (float)uc/256.0f;
+                        float numf = (float)img[r * this->nc + c]/256.0f;
                         // Fill array as cartgrids are displayed: bottom row first.
                         ar[(this->nr-r-1)*28+c] = numf;
                     }
@@ -5,6 +5,11 @@
  * objective function is is left entirely to the client code. What the client code should do next is
  * stored in NM_Simplex::state.
  *
+ * Alternatively, set NM_Simplex::objective and call run(). If the objective is thread-safe, set
+ * NM_Simplex::parallel and run() will evaluate independent points concurrently (with OpenMP). To
+ * carry out several independent optimizations from different starting simplexes at once, call
+ * run_multistart().
+ *
  * Author: Seb James
  * Date: September 2019
  */
@@ -12,6 +17,7 @@
 
 #include <cstdint>
 #include <vector>
+#include <array>
 #include <functional>
 #include <morph/MathAlgo.h>
 #include <morph/vvec.h>
@@ -126,6 +132,27 @@ namespace morph {
         //! Store the reason the algorithm entered the state NM_Simple_State::ReadyToStop
         NM_Simplex_Stop_Reason stopreason = NM_Simplex_Stop_Reason::None;
 
+        /*!
+         * If true, step() evaluates the objective at independent points concurrently: all the
+         * vertices in NeedToComputeThenOrder (which includes the re-evaluation after a shrink)
+         * and, if speculate is also true, the reflected, expanded and contracted points
+         * together. Only set this if your objective function is thread-safe and it is
+         * expensive enough to be worth running on several threads.
+         */
+        bool parallel = false;
+
+        /*!
+         * If true (and parallel is true), then when the reflected point xr is needed, the
+         * expanded and contracted points that would follow it are computed and evaluated at the
+         * same time, so that the next step does not have to wait for a further evaluation. The
+         * path taken by the algorithm is the same as without speculation, but more objective
+         * evaluations are made in total.
+         */
+        bool speculate = false;
+
+        //! The number of times the objective function has been evaluated by step()
+        unsigned long long int evaluation_count = 0ULL;
+
     public:
         // Constructors
 
@@ -178,6 +205,8 @@ namespace morph {
         {
             this->stopreason = NM_Simplex_Stop_Reason::None;
             this->operation_count = 0ULL;
+            this->evaluation_count = 0ULL;
+            this->speculated = false;
             this->n = initial_vertices.size() - 1;
             this->allocate();
             unsigned int i = 0U;
@@ -201,21 +230,36 @@ namespace morph {
         void step()
         {
             if (this->state == NM_Simplex_State::NeedToComputeThenOrder) {
-                for (unsigned int i = 0; i <= this->n; ++i) {
+                const int nv = static_cast<int>(this->n) + 1;
+#pragma omp parallel for schedule(dynamic) if (this->parallel)
+                for (int i = 0; i < nv; ++i) {
                     this->values[i] = this->objective (this->vertices[i]);
                 }
+                this->evaluation_count += nv;
                 this->order();
             } else if (this->state == NM_Simplex_State::NeedToOrder) {
                 this->order();
             } else if (this->state == NM_Simplex_State::NeedToComputeReflection) {
-                T val = this->objective (this->xr);
-                this->apply_reflection (val);
+                if (this->parallel && this->speculate) {
+                    this->evaluate_speculatively();
+                } else {
+                    this->speculated = false;
+                    this->xr_value = this->objective (this->xr);
+                    this->evaluation_count++;
+                }
+                this->apply_reflection (this->xr_value);
             } else if (this->state == NM_Simplex_State::NeedToComputeExpansion) {
-                T val = this->objective (this->xe);
-                this->apply_expansion (val);
+                if (!this->speculated) {
+                    this->xe_value = this->objective (this->xe);
+                    this->evaluation_count++;
+                }
+                this->apply_expansion (this->xe_value);
             } else if (this->state == NM_Simplex_State::NeedToComputeContraction) {
-                T val = this->objective (this->xc);
-                this->apply_contraction (val);
+                if (!this->speculated) {
+                    this->xc_value = this->objective (this->xc);
+                    this->evaluation_count++;
+                }
+                this->apply_contraction (this->xc_value);
             }
         }
 
@@ -229,10 +273,48 @@ namespace morph {
             return true;
         }
 
+        /*!
+         * Run one optimization for each of the initial simplexes in \a starts, in parallel
+         * (with OpenMP). Each run is a copy of this NM_Simplex, with the same parameters and
+         * objective function, reset() to one of the starting simplexes. The objective function
+         * must be thread-safe. Inside each run, points are evaluated serially (unless nested
+         * OpenMP parallelism has been enabled).
+         *
+         * Afterwards, *this holds the run that found the best value. The best value found by
+         * each run is written into \a run_values, if it is non-null.
+         *
+         * \return The index in \a starts of the best run, or -1 if there was no objective.
+         */
+        int run_multistart (const std::vector<morph::vvec<morph::vvec<T>>>& starts,
+                            morph::vvec<T>* run_values = nullptr)
+        {
+            if (!this->objective || starts.empty()) { return -1; }
+            const int nruns = static_cast<int>(starts.size());
+            std::vector<NM_Simplex<T>> runs (nruns, *this);
+#pragma omp parallel for schedule(dynamic)
+            for (int k = 0; k < nruns; ++k) {
+                runs[k].reset (starts[k]);
+                runs[k].run();
+            }
+            int best = 0;
+            for (int k = 1; k < nruns; ++k) {
+                if ((this->downhill && runs[k].best_value() < runs[best].best_value())
+                    || (!this->downhill && runs[k].best_value() > runs[best].best_value())) {
+                    best = k;
+                }
+            }
+            if (run_values != nullptr) {
+                run_values->resize (nruns);
+                for (int k = 0; k < nruns; ++k) { (*run_values)[k] = runs[k].best_value(); }
+            }
+            *this = runs[best];
+            return best;
+        }
+
         //! Return the location of the best approximation, given the values of the vertices.
-        morph::vvec<T> best_vertex() { return this->vertices[this->vertex_order[0]]; }
+        morph::vvec<T> best_vertex() const { return this->vertices[this->vertex_order[0]]; }
         //! Return the value of the best approximation, given the values of the vertices.
-        T best_value() { return this->values[this->vertex_order[0]]; }
+        T best_value() const { return this->values[this->vertex_order[0]]; }
 
         //! Order the vertices.
         void order()
@@ -266,6 +348,30 @@ namespace morph {
         }
 
     private:
+        //! Set true when xe and xc (and their values) were computed along with xr
+        bool speculated = false;
+
+        /*!
+         * Evaluate the reflected point along with the expanded and contracted points that
+         * apply_reflection() might go on to request. These are computed with the same
+         * expressions that expand() and contract() use, so that the results are unchanged.
+         */
+        void evaluate_speculatively()
+        {
+            unsigned int worst = this->vertex_order[this->n];
+            this->xe = this->x0 + (this->xr - this->x0) * this->gamma;
+            this->xc = this->x0 + (this->vertices[worst] - this->x0) * this->rho;
+            std::array<const morph::vvec<T>*, 3> pts = { &this->xr, &this->xe, &this->xc };
+            std::array<T, 3> vals;
+#pragma omp parallel for
+            for (int i = 0; i < 3; ++i) { vals[i] = this->objective (*pts[i]); }
+            this->xr_value = vals[0];
+            this->xe_value = vals[1];
+            this->xc_value = vals[2];
+            this->evaluation_count += 3;
+            this->speculated = true;
+        }
+
         //! Find the reflected point, xr, which is the reflection of the worst point about the
         //! centroid of the simplex.
         void reflect()
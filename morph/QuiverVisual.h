@@ -103,25 +103,26 @@ namespace morph {
             // normalized lengths multiplied by a user-settable quiver_length_gain.
             vvec<float> lfactor = nrmlzedlengths/dlengths * this->quiver_length_gain;
 
-            vec<Flt> half = { Flt{0.5}, Flt{0.5}, Flt{0.5} };
-            vec<Flt> vectorData_i, halfquiv;
-            vec<float> start, end, coords_i;
-            std::array<float, 3> clr;
-            for (unsigned int i = 0; i < ncoords; ++i) {
-
-                coords_i = (*this->dataCoords)[i];
+            // Each quiver is built independently of the others, so build() can share them out
+            // between threads
+            const vec<Flt> half = { Flt{0.5}, Flt{0.5}, Flt{0.5} };
+            this->build (ncoords, [&](morph::VertexArena& a, const std::size_t i)
+            {
+                vec<Flt> vectorData_i, halfquiv;
+                vec<float> start, end;
+                vec<float> coords_i = (*this->dataCoords)[i];
 
                 float len = nrmlzedlengths[i] * this->quiver_length_gain;
                 if ((std::isnan(dlengths[i]) || dlengths[i] == Flt{0}) && this->show_zero_vectors) {
                     // NaNs denote zero vectors when the lengths have been log scaled.
-                    this->computeSphere (coords_i, zero_vector_colour, this->zero_vector_marker_size * quiver_thickness_gain);
-                    continue;
+                    a.computeSphere (coords_i, zero_vector_colour, this->zero_vector_marker_size * quiver_thickness_gain);
+                    return;
                 }
 
                 vectorData_i = (*this->vectorData)[i];
                 vectorData_i *= lfactor[i];
 
-                clr = this->cm.convert (lengthcolours[i]);
+                std::array<float, 3> clr = this->cm.convert (lengthcolours[i]);
 
                 if (this->qgoes == QuiverGoes::FromCoord) {
                     start = coords_i;
@@ -144,17 +145,17 @@ namespace morph {
                 vec<float> arrow_line = end - start;
                 vec<float> cone_start = arrow_line.shorten (len*quiver_arrowhead_prop);
                 cone_start += start;
-                this->computeTube (start, cone_start, clr, clr, quiv_thick, shapesides);
+                a.computeTube (start, cone_start, clr, clr, quiv_thick, shapesides);
                 float conelen = (end-cone_start).length();
                 if (arrow_line.length() > conelen) {
-                    this->computeCone (cone_start, end, 0.0f, clr, quiv_thick*2.0f, shapesides);
+                    a.computeCone (cone_start, end, 0.0f, clr, quiv_thick*2.0f, shapesides);
                 }
 
                 if (this->show_coordinate_sphere == true) {
                     // Draw a sphere on the coordinate:
-                    this->computeSphere (coords_i, clr, quiv_thick*2.0f, shapesides/2, shapesides);
+                    a.computeSphere (coords_i, clr, quiv_thick*2.0f, shapesides/2, shapesides);
                 }
-            }
+            });
         }
 
         //! An enumerated type to say whether we draw quivers with coord at mid point; start point or end point
@@ -2,16 +2,20 @@
 
 #include <morph/tools.h>
 #include <morph/Random.h>
+#include <morph/philox.h>
 #include <morph/ReadCurves.h>
 #define HEXGRID_COMPILE_LOAD_AND_SAVE 1
 #include <morph/HexGrid.h>
 #include <morph/HdfData.h>
+#include <morph/parallel.h>
 #include <memory>
 #include <sstream>
 #include <vector>
 #include <array>
 #include <iomanip>
 #include <cmath>
+#include <cstdint>
+#include <span>
 #include <hdf5.h>
 
 /*
@@ -94,6 +98,15 @@ namespace morph {
          */
         alignas(Flt) Flt boundaryFalloffDist = Flt{0.02}; // 0.02 default
 
+        /*!
+         * If non-zero, the seed for the noise generated by
+         * noiseify_vector_variable. Each call uses the next stream of the
+         * generator, so successive variables get different noise.
+         */
+        std::uint64_t noise_seed = 0;
+        //! The stream to use for the next call to noiseify_vector_variable
+        std::uint64_t noise_stream = 0;
+
     protected:
         /*!
          * Our choice of dt.
@@ -349,16 +362,20 @@ namespace morph {
          *
          * I apply a sigmoid to the boundary hexes, so that the noise
          * drops away towards the edge of the domain.
+         *
+         * The noise is generated in one bulk (parallel) fill. Set
+         * noise_seed to a non-zero value to make it reproducible.
          */
         void noiseify_vector_variable (std::vector<Flt>& v, Flt offset, Flt gain)
         {
-            morph::RandUniform<Flt> rng;
+            morph::philox4x32 gen;
+            if (this->noise_seed != 0) { gen = morph::philox4x32 (this->noise_seed, this->noise_stream++); }
+            gen.fill_uniform (std::span<Flt>(v.data(), this->hg->num()), offset, offset + gain);
             for (auto h : this->hg->hexen) {
                 // boundarySigmoid. Jumps sharply (100, larger is
                 // sharper) over length scale 0.05 to 1. So if
                 // distance from boundary > 0.05, noise has normal
                 // value. Close to boundary, noise is less.
-                v[h.vi] = rng.get() * gain + offset;
                 if (h.distToBoundary > -0.5) { // It's possible that distToBoundary is set to -1.0
                     Flt bSig = Flt{1} / ( Flt{1} + std::exp (-Flt{100}*(h.distToBoundary-this->boundaryFalloffDist)) );
                     v[h.vi] = v[h.vi] * bSig;
@@ -595,8 +612,7 @@ namespace morph {
         void spacegrad2D (std::vector<Flt>& f, std::array<std::vector<Flt>, 2>& gradf) {
 
             // Note - East is positive x; North is positive y.
-#pragma omp parallel for schedule(static)
-            for (unsigned int hi=0; hi<this->nhex; ++hi) {
+            auto grad_at = [&](const unsigned int hi) {
 
                 // Find x gradient
                 if (HAS_NE(hi) && HAS_NW(hi)) {
@@ -628,7 +644,13 @@ namespace morph {
                     // Leave grady at 0
                     gradf[1][hi] = Flt{0};
                 }
-            }
+            };
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+            for (unsigned int hi = 0; hi < this->nhex; ++hi) { grad_at (hi); }
+#else
+            morph::parallel::parallel_for (0u, this->nhex, grad_at);
+#endif
         }
 
         /*!
@@ -638,8 +660,7 @@ namespace morph {
 
             Flt norm  = Flt{2} / (Flt{3.0} * this->d * this->d);
 
-#pragma omp parallel for schedule(static)
-            for (unsigned int hi=0; hi<this->nhex; ++hi) {
+            auto lap_at = [&](const unsigned int hi) {
 
                 // 1. The D Del^2 term
 
@@ -677,7 +698,13 @@ namespace morph {
                 }
 
                 lapF[hi] = norm * thesum;
-            }
+            };
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+            for (unsigned int hi = 0; hi < this->nhex; ++hi) { lap_at (hi); }
+#else
+            morph::parallel::parallel_for (0u, this->nhex, lap_at);
+#endif
         }
 
     }; // RD_Base
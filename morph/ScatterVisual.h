@@ -46,26 +46,27 @@ namespace morph {
             };
         }
 
-        void marker (const morph::vec<float> coord, const std::array<float, 3>& clr, const Flt size)
+        //! Add a marker at \a coord to the vertices in \a a (which may be this model)
+        void marker (morph::VertexArena& a, const morph::vec<float> coord, const std::array<float, 3>& clr, const Flt size)
         {
             if (this->markers == morph::markerstyle::rod) {
                 // Draw a rod. markerdirn gives length and dirn. Radius from size
                 morph::vec<float> hr = this->markerdirn * 0.5f; // half rod
                 morph::vec<float> rs = coord + hr;
                 morph::vec<float> re = coord - hr;
-                this->computeTube (rs, re, clr, clr, size, 12);
+                a.computeTube (rs, re, clr, clr, size, 12);
             } else if (this->markers == morph::markerstyle::sphere) {
                 if constexpr (draw_spheres_as_geodesics) {
                     // Slower than regular computeSphere(). 2 iterations gives 320 faces
-                    this->template computeSphereGeoFast<float, 2> (coord, clr, size);
+                    a.computeSphereGeoFast<float, 2> (coord, clr, size);
                 } else {
                     // (16+2) * 20 gives 360 faces
-                    this->computeSphere (coord, clr, size, 16, 20);
+                    a.computeSphere (coord, clr, size, 16, 20);
                 }
             } else if (this->markers == morph::markerstyle::cube) {
-                this->computeCuboid (this->make_vcube(size) + coord, clr);
+                a.computeCuboid (this->make_vcube(size) + coord, clr);
             } else if (this->markers == morph::markerstyle::tetrahedron) {
-                this->computeTetrahedron (coord, size, clr);
+                a.computeTetrahedron (coord, size, clr);
             } else {
                 throw std::runtime_error ("ScatterVisual: Unhandled marker type");
             }
@@ -75,7 +76,7 @@ namespace morph {
         void add (morph::vec<float> coord, Flt value)
         {
             std::array<float, 3> clr = this->cm.convert (this->colourScale.transform_one (value));
-            this->marker (coord, clr, this->radiusFixed);
+            this->marker (*this, coord, clr, this->radiusFixed);
             this->reinit_buffers();
         }
 
@@ -83,7 +84,7 @@ namespace morph {
         void add (morph::vec<float> coord, Flt value, Flt size)
         {
             std::array<float, 3> clr = this->cm.convert (this->colourScale.transform_one (value));
-            this->marker (coord, clr, size);
+            this->marker (*this, coord, clr, size);
             this->reinit_buffers();
         }
 
@@ -142,11 +143,18 @@ namespace morph {
 
             } // else no scaling required - spheres will be one colour
 
-            for (unsigned int i = 0; i < ncoords; ++i) {
+            this->dcolour_rgb.clear();
+            if constexpr (std::is_same<std::decay_t<Flt>, float>::value == true) {
+                if (ndata && !nvdata) { this->convertColours (dcopy); }
+            }
+
+            // The markers are independent of each other, so build() can share them out between threads
+            this->build (ncoords, [&](morph::VertexArena& a, const std::size_t i)
+            {
                 // Scale colour (or use single colour)
                 std::array<float, 3> clr = this->cm.getHueRGB();
                 if (ndata && !nvdata) {
-                    clr = this->cm.convert (dcopy[i]);
+                    clr = this->dcolour_rgb.empty() ? this->cm.convert (dcopy[i]) : this->colour_at (i);
                 } else if (nvdata) {
                     // Combine colour from two values. vdcopy1, vdcopy2? OR just do RGB for now?
                     // ColourMap in 'dual hue' (or triple hue) mode.
@@ -155,16 +163,52 @@ namespace morph {
                 }
 
                 if (this->sizeFactor == Flt{0}) {
-                    this->marker ((*this->dataCoords)[i], clr, this->radiusFixed);
+                    this->marker (a, (*this->dataCoords)[i], clr, this->radiusFixed);
                 } else {
-                    this->marker ((*this->dataCoords)[i], clr, dcopy[i] * this->sizeFactor);
+                    this->marker (a, (*this->dataCoords)[i], clr, dcopy[i] * this->sizeFactor);
                 }
+            });
 
-                if (this->labelIndices == true) {
-                    // Draw an index label...
+            if (this->labelIndices == true) {
+                // Draw index labels. Text models are added one at a time, on this thread.
+                for (unsigned int i = 0; i < ncoords; ++i) {
                     this->addLabel (std::to_string (i), (*this->dataCoords)[i] + labelOffset, morph::TextFeatures(labelSize) );
                 }
             }
+            // Record the marker size in vertices, so that updateAttributes() can recolour markers
+            // in place (if their sizes depend on the data, the model has to be rebuilt instead)
+            this->marker_vertices = this->sizeFactor == Flt{0} ? this->idx / ncoords : 0u;
+        }
+
+        /*!
+         * When the markers have a fixed size, new scalar data only changes their colours, so
+         * recolour the existing marker vertices in place.
+         */
+        bool updateAttributes() override
+        {
+            if (this->sizeFactor != Flt{0} || this->marker_vertices == 0u
+                || this->scalarData == nullptr || this->vectorData != nullptr || this->dataCoords == nullptr) {
+                return false;
+            }
+            const std::size_t ncoords = this->dataCoords->size();
+            const std::size_t nv = this->marker_vertices;
+            if (this->scalarData->size() != ncoords || this->vertexColors.size() < 3u * nv * ncoords) { return false; }
+
+            std::vector<Flt> dcopy (ncoords);
+            this->colourScale.transform (*this->scalarData, dcopy);
+            this->dcolour_rgb.clear();
+            if constexpr (std::is_same<std::decay_t<Flt>, float>::value == true) { this->convertColours (dcopy); }
+
+            for (std::size_t i = 0; i < ncoords; ++i) {
+                std::array<float, 3> clr = this->dcolour_rgb.empty() ? this->cm.convert (dcopy[i]) : this->colour_at (i);
+                for (std::size_t j = 3u * nv * i; j < 3u * nv * (i + 1u); j += 3u) {
+                    this->vertexColors[j] = clr[0];
+                    this->vertexColors[j + 1] = clr[1];
+                    this->vertexColors[j + 2] = clr[2];
+                }
+            }
+            this->set_dirty (this->colVBO);
+            return true;
         }
 
         // The constexpr, unordered geodesic code is no slower than the regular
@@ -199,6 +243,10 @@ namespace morph {
 
         morph::vec<float, 3> labelOffset = { 0.04f, 0.0f, 0.0f };
         float labelSize = 0.03f;
+
+    protected:
+        //! The number of vertices in each marker (0 if they vary)
+        unsigned int marker_vertices = 0u;
     };
 
 } // namespace morph
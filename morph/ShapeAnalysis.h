@@ -7,10 +7,12 @@
 #pragma once
 
 #include <vector>
+#include <array>
 #include <list>
 #include <set>
 #include <map>
 #include <limits>
+#include <algorithm>
 #include <stdexcept>
 #include <morph/Hex.h>
 #include <morph/HexGrid.h>
@@ -1036,6 +1038,246 @@ namespace morph {
             return sum_delta_j/sum_areas;
         }
 
+        /*!
+         * A connected region of hexes which share one identity value, f. Found, along with its
+         * contours and Dirichlet vertices, by hex_regions().
+         */
+        struct hexregion
+        {
+            //! The identity of the region (the value of f in each of its hexes)
+            Flt f = Flt{0};
+            //! The number of hexes in the region
+            unsigned int hexcount = 0u;
+            //! The area of the region
+            Flt area = Flt{0};
+            //! The mean location of the centres of the region's hexes
+            morph::vec<Flt, 2> centroid = { Flt{0}, Flt{0} };
+            //! True if the region meets the edge of the HexGrid
+            bool onBoundary = false;
+            /*!
+             * The closed contours that trace the edge of the region along the sides of its
+             * hexes. The outer contour comes first and runs anticlockwise; the contours of any
+             * holes in the region follow it, running clockwise.
+             */
+            std::vector<std::vector<morph::vec<Flt, 2>>> contours;
+            /*!
+             * The Dirichlet vertices of the region, in order around its outer contour. These are
+             * the hex vertices at which the region meets two others (or one other and the edge of
+             * the HexGrid).
+             */
+            std::vector<morph::vec<Flt, 2>> vertices;
+        };
+
+        /*!
+         * Label the connected regions of equal \a f on the HexGrid \a hg, by union-find over the
+         * d_ neighbour arrays. Returns the label of each hex. Labels run from 0 to nregions-1, in
+         * order of the lowest hex index in each region.
+         */
+        static std::vector<int> label_regions (const HexGrid* hg, const std::vector<Flt>& f, int& nregions)
+        {
+            const int n = static_cast<int>(hg->num());
+            if (f.size() < static_cast<std::size_t>(n)) {
+                throw std::runtime_error ("ShapeAnalysis::label_regions: f is smaller than the HexGrid");
+            }
+            // Every region's tree is rooted at its lowest hex index
+            std::vector<int> parent (n);
+            for (int h = 0; h < n; ++h) { parent[h] = h; }
+            auto find_root = [&parent](int i) {
+                while (parent[i] != i) { parent[i] = parent[parent[i]]; i = parent[i]; }
+                return i;
+            };
+            // Joining each hex to its E, NE and NW neighbours covers every adjacent pair
+            for (int h = 0; h < n; ++h) {
+                for (const std::vector<int>* d : { &hg->d_ne, &hg->d_nne, &hg->d_nnw }) {
+                    const int m = (*d)[h];
+                    if (m < 0 || f[m] != f[h]) { continue; }
+                    const int a = find_root (h);
+                    const int b = find_root (m);
+                    if (a != b) { parent[std::max (a, b)] = std::min (a, b); }
+                }
+            }
+            std::vector<int> label (n);
+            nregions = 0;
+            for (int h = 0; h < n; ++h) {
+                const int root = find_root (h);
+                label[h] = (root == h) ? nregions++ : label[root];
+            }
+            return label;
+        }
+
+        /*!
+         * Find every connected region of equal \a f on \a hg, with its area, centroid, contours
+         * and Dirichlet vertices, in one pass.
+         *
+         * The regions are labelled by label_regions(). The contours are then traced for all the
+         * regions at once by "marching hexagons": each hex side that separates two regions (or a
+         * region from the outside of the grid) is a directed edge with its own region on the left,
+         * and the next edge around the same contour is found from the two hexes at the edge's end
+         * vertex alone. Each edge is visited once. A vertex at which the region on the right of
+         * the contour changes is a Dirichlet vertex.
+         *
+         * If \a domains is non-null, it is filled with a DirichDom for each region which does not
+         * meet the edge of the grid and has at least one vertex, ready for dirichlet_analyse(). This
+         * replaces the vertex search and boundary walks of dirichlet_vertices() and the area count
+         * of DirichDom::compute_area().
+         */
+        static std::vector<hexregion>
+        hex_regions (HexGrid* hg, const std::vector<Flt>& f, std::list<DirichDom<Flt>>* domains = nullptr)
+        {
+            int nreg = 0;
+            const std::vector<int> label = ShapeAnalysis<Flt>::label_regions (hg, f, nreg);
+            const int n = static_cast<int>(label.size());
+
+            std::vector<hexregion> regions (nreg);
+            const Flt hexarea = static_cast<Flt>(hg->getHexArea());
+            for (int h = 0; h < n; ++h) {
+                hexregion& r = regions[label[h]];
+                r.f = f[h];
+                r.hexcount += 1u;
+                r.centroid[0] += hg->d_x[h];
+                r.centroid[1] += hg->d_y[h];
+            }
+            for (hexregion& r : regions) {
+                r.area = hexarea * r.hexcount;
+                r.centroid /= static_cast<Flt>(r.hexcount);
+            }
+
+            // Neighbours in direction k, 0 to 5 being E, NE, NW, W, SW and SE. Vertex k of a hex
+            // (Hex::get_vertex_coord) lies between its neighbours in directions k and k+1.
+            const std::array<const std::vector<int>*, 6> nb = { &hg->d_ne, &hg->d_nne, &hg->d_nnw,
+                                                                &hg->d_nw, &hg->d_nsw, &hg->d_nse };
+            std::vector<std::list<Hex>::iterator> hexits (n);
+            for (auto hi = hg->hexen.begin(); hi != hg->hexen.end(); ++hi) { hexits[hi->vi] = hi; }
+
+            // Edge e = 6h + k is the side of hex h that faces direction k. It runs anticlockwise
+            // around h from vertex k-1 to vertex k. across() is the label on its right: -1 for
+            // the outside of the grid, -2 if the side lies within a region and so is not an edge.
+            auto across = [&](int e) {
+                const int h = e / 6;
+                const int m = (*nb[e % 6])[h];
+                return m < 0 ? -1 : (label[m] == label[h] ? -2 : label[m]);
+            };
+            // The next edge of the contour, which begins at the end vertex of edge e. If hex h's
+            // neighbour beyond that vertex is in the same region, the contour turns onto it.
+            auto next_edge = [&](int e) {
+                const int h = e / 6;
+                const int k1 = (e % 6 + 1) % 6;
+                const int m = (*nb[k1])[h];
+                return (m >= 0 && label[m] == label[h]) ? 6 * m + (k1 + 4) % 6 : 6 * h + k1;
+            };
+            auto end_vertex = [&](int e) {
+                morph::vec<float, 2> c = hexits[e / 6]->get_vertex_coord (e % 6);
+                return morph::vec<Flt, 2>({ static_cast<Flt>(c[0]), static_cast<Flt>(c[1]) });
+            };
+            auto is_vertex = [&](int e) { return across (e) != across (next_edge (e)); };
+
+            // Trace every contour. For each edge, also record (in ahead) the first edge at or
+            // after it on its contour which ends at a Dirichlet vertex.
+            std::vector<char> visited (6 * n, 0);
+            std::vector<int> ahead (6 * n, -1);
+            std::vector<std::vector<int>> outer (nreg); // the edges of each region's outer contour
+            std::vector<int> loop;
+            for (int e0 = 0; e0 < 6 * n; ++e0) {
+                if (visited[e0] || across (e0) == -2) { continue; }
+                loop.clear();
+                int e = e0;
+                do {
+                    visited[e] = 1;
+                    loop.push_back (e);
+                    e = next_edge (e);
+                } while (e != e0);
+
+                hexregion& r = regions[label[e0 / 6]];
+                std::vector<morph::vec<Flt, 2>> contour (loop.size());
+                Flt area2 = Flt{0};
+                int lastvtx = -1;
+                for (std::size_t i = 0; i < loop.size(); ++i) {
+                    contour[i] = end_vertex (loop[i]);
+                    if (i > 0) { area2 += contour[i-1][0] * contour[i][1] - contour[i][0] * contour[i-1][1]; }
+                    if (across (loop[i]) == -1) { r.onBoundary = true; }
+                    if (is_vertex (loop[i])) { lastvtx = static_cast<int>(i); }
+                }
+                area2 += contour.back()[0] * contour.front()[1] - contour.front()[0] * contour.back()[1];
+
+                if (lastvtx >= 0) {
+                    const int ls = static_cast<int>(loop.size());
+                    int cur = loop[lastvtx];
+                    for (int s = 0; s < ls; ++s) {
+                        const int le = loop[(lastvtx - s + ls) % ls];
+                        if (is_vertex (le)) { cur = le; }
+                        ahead[le] = cur;
+                    }
+                }
+
+                if (area2 > Flt{0}) {
+                    r.contours.insert (r.contours.begin(), std::move (contour));
+                    outer[label[e0 / 6]] = loop;
+                    for (int le : loop) { if (is_vertex (le)) { r.vertices.push_back (end_vertex (le)); } }
+                } else {
+                    r.contours.push_back (std::move (contour));
+                }
+            }
+
+            if (domains == nullptr) { return regions; }
+
+            // Build the Dirichlet domains from the outer contours
+            domains->clear();
+            const Flt d = static_cast<Flt>(hg->getd());
+            auto f_across = [&](int e) { const int a = across (e); return a < 0 ? Flt{-1} : regions[a].f; };
+            // The corners passed along the contour from the end of edge e to the end of edge e_end
+            auto corners = [&](int e, int e_end, std::list<morph::vec<Flt, 2>>& path) {
+                path.push_back (end_vertex (e));
+                while (e != e_end) {
+                    e = next_edge (e);
+                    path.push_back (end_vertex (e));
+                }
+            };
+            for (int ri = 0; ri < nreg; ++ri) {
+                const hexregion& r = regions[ri];
+                if (r.onBoundary || r.vertices.empty()) { continue; }
+                DirichDom<Flt> dom;
+                dom.f = r.f;
+                dom.area = r.area;
+                for (int e : outer[ri]) {
+                    if (!is_vertex (e)) { continue; }
+                    const int en = next_edge (e);
+                    const int h = e / 6;
+                    const int k = e % 6;
+                    DirichVtx<Flt> v (end_vertex (e), d, r.f, { f_across (en), f_across (e) });
+                    v.hi = hexits[h];
+                    // From the vertex, the edge between the two neighbouring regions leads to the
+                    // vertex neighbour. It is the side of the hex beyond the vertex that faces the
+                    // hex across edge e.
+                    const int m = (*nb[(k + 1) % 6])[h];
+                    if (m >= 0 && across (e) >= 0) {
+                        const int t = 6 * m + (k + 5) % 6;
+                        v.vn = end_vertex (ahead[t]);
+                        v.pathto_neighbour.push_back (v.v);
+                        corners (t, ahead[t], v.pathto_neighbour);
+                    } else {
+                        v.onBoundary = true;
+                    }
+                    v.pathto_next.push_back (v.v);
+                    corners (en, ahead[en], v.pathto_next);
+                    dom.vertices.push_back (v);
+                }
+                dom.compute_edge_deviation();
+                domains->push_back (dom);
+            }
+            return regions;
+        }
+
+        /*!
+         * Find the Dirichlet domains in \a f on the HexGrid \a hg. This is the one-pass
+         * equivalent of dirichlet_vertices(); the results can be passed to dirichlet_analyse().
+         */
+        static std::list<DirichDom<Flt>> dirichlet_domains (HexGrid* hg, const std::vector<Flt>& f)
+        {
+            std::list<DirichDom<Flt>> doms;
+            ShapeAnalysis<Flt>::hex_regions (hg, f, &doms);
+            return doms;
+        }
+
     }; // ShapeAnalysis
 
 } // namespace morph
@@ -32,6 +32,8 @@
 #include <memory>
 #include <functional>
 #include <cstddef>
+#include <cstdint>
+#include <chrono>
 
 #include <morph/VisualDefaultShaders.h>
 
@@ -55,7 +57,9 @@ namespace morph {
         //! When true, rotations about the third axis are possible.
         rotateModMode,
         //! When true, cursor movements induce translation of scene
-        translateMode
+        translateMode,
+        //! Set when the scene has changed since it was last rendered (see visual_options::renderOnDemand)
+        sceneDirty
     };
 
     //! Boolean options - similar to state, but more likely to be modified by client code
@@ -72,7 +76,9 @@ namespace morph {
         //! Set true to output some user information to stdout (e.g. user requested quit)
         userInfoStdout,
         //! If true, output morph version to stdout
-        versionStdout
+        versionStdout,
+        //! If true, render() only draws the scene if it has changed since the last frame
+        renderOnDemand
     };
 
     //! Whether to render with perspective or orthographic (or even a cylindrical projection)
@@ -149,6 +155,8 @@ namespace morph {
         static void set_context (morph::VisualBase<glver>* _v) { _v->setContext(); };
         // A callback friendly wrapper for releaseContext
         static void release_context (morph::VisualBase<glver>* _v) { _v->releaseContext(); };
+        // A callback friendly wrapper for markDirty
+        static void mark_dirty (morph::VisualBase<glver>* _v) { _v->markDirty(); };
 
         // Public init that is given a context (window or widget) and then sets up the
         // VisualResource, shaders and so on.
@@ -180,6 +188,7 @@ namespace morph {
             model->get_shaderprogs = &morph::VisualBase<glver>::get_shaderprogs;
             model->get_gprog = &morph::VisualBase<glver>::get_gprog;
             model->get_tprog = &morph::VisualBase<glver>::get_tprog;
+            model->markDirty = &morph::VisualBase<glver>::mark_dirty;
         }
 
         /*!
@@ -191,6 +200,7 @@ namespace morph {
         {
             std::unique_ptr<morph::VisualModel<glver>> vmp = std::move(model);
             this->vm.push_back (std::move(vmp));
+            this->markDirty();
             unsigned int rtn = (this->vm.size()-1);
             return rtn;
         }
@@ -203,6 +213,7 @@ namespace morph {
         {
             std::unique_ptr<morph::VisualModel<glver>> vmp = std::move(model);
             this->vm.push_back (std::move(vmp));
+            this->markDirty();
             return static_cast<T*>(this->vm.back().get());
         }
 
@@ -232,7 +243,11 @@ namespace morph {
         morph::VisualModel<glver>* getVisualModel (unsigned int modelId) { return (this->vm[modelId].get()); }
 
         //! Remove the VisualModel with ID \a modelId from the scene.
-        void removeVisualModel (unsigned int modelId) { this->vm.erase (this->vm.begin() + modelId); }
+        void removeVisualModel (unsigned int modelId)
+        {
+            this->vm.erase (this->vm.begin() + modelId);
+            this->markDirty();
+        }
 
         //! Remove the VisualModel whose pointer matches the VisualModel* vmp
         void removeVisualModel (morph::VisualModel<glver>* vmp)
@@ -245,7 +260,10 @@ namespace morph {
                     break;
                 }
             }
-            if (found_model == true) { this->vm.erase (this->vm.begin() + modelId); }
+            if (found_model == true) {
+                this->vm.erase (this->vm.begin() + modelId);
+                this->markDirty();
+            }
         }
 
         void set_cursorpos (double _x, double _y) { this->cursorpos = {static_cast<float>(_x), static_cast<float>(_y)}; }
@@ -256,6 +274,34 @@ namespace morph {
         //! Render the scene
         virtual void render() noexcept = 0;
 
+        /*!
+         * Mark the scene as changed, so that it is drawn on the next call to render() even if
+         * visual_options::renderOnDemand is set. VisualModels call this when their vertices,
+         * view, alpha or visibility change (through their member functions), as do the mouse,
+         * key, scroll and window size callbacks and the scene setters below. If you modify a
+         * public member such as bgcolour or VisualModel::hide directly, call this yourself.
+         */
+        void markDirty() { this->state.set (visual_state::sceneDirty); }
+
+        //! If true, render() skips drawing (and leaves the last frame on display) when nothing in
+        //! the scene has changed since the last frame.
+        void renderOnDemand (const bool val) { this->options.set (visual_options::renderOnDemand, val); }
+
+        /*!
+         * If greater than 0, render() draws at most this many frames per second. A call to
+         * render() that comes sooner than 1/max_frame_rate s after the last frame returns at once,
+         * without drawing, so that a simulation loop can call render() after every step and
+         * spend most of its time stepping rather than drawing. The scene stays dirty, so its
+         * latest state is drawn by the next call that falls due. (While a capture is in progress
+         * every call to render() draws a frame.)
+         */
+        double max_frame_rate = 0.0;
+
+        //! The number of frames drawn by render()
+        std::uint64_t frames_rendered = 0;
+        //! The number of calls to render() that returned without drawing
+        std::uint64_t frames_skipped = 0;
+
         //! Compute a translation vector for text position, using Visual::text_z.
         morph::vec<float, 3> textPosition (const morph::vec<float, 2> p0_coord)
         {
@@ -334,10 +380,11 @@ namespace morph {
             this->coordArrows->setViewRotation (this->rotation);
         }
 
-        // state defaults. All state is false by default
+        // state defaults. All state is false by default, except that there is a scene to draw
         constexpr morph::flags<visual_state> state_defaults()
         {
             morph::flags<visual_state> _state;
+            _state.set (visual_state::sceneDirty);
             return _state;
         }
 
@@ -370,13 +417,13 @@ namespace morph {
         float fov = 30.0f;
 
         //! Setter for visual_options::showCoordArrows
-        void showCoordArrows (const bool val) { this->options.set (visual_options::showCoordArrows, val); }
+        void showCoordArrows (const bool val) { this->options.set (visual_options::showCoordArrows, val); this->markDirty(); }
 
         //! If true, then place the coordinate arrows at the origin of the scene, rather than offset.
-        void coordArrowsInScene (const bool val) { this->options.set (visual_options::coordArrowsInScene, val); }
+        void coordArrowsInScene (const bool val) { this->options.set (visual_options::coordArrowsInScene, val); this->markDirty(); }
 
         //! Set to true to show the title text within the scene
-        void showTitle (const bool val) { this->options.set (visual_options::showTitle, val); }
+        void showTitle (const bool val) { this->options.set (visual_options::showTitle, val); this->markDirty(); }
 
         //! Set true to output some user information to stdout (e.g. user requested quit)
         void userInfoStdout (const bool val) { this->options.set (visual_options::userInfoStdout, val); }
@@ -404,9 +451,9 @@ namespace morph {
          */
 
         //! Set a white background colour for the Visual scene
-        void backgroundWhite() { this->bgcolour = { 1.0f, 1.0f, 1.0f, 0.5f }; }
+        void backgroundWhite() { this->bgcolour = { 1.0f, 1.0f, 1.0f, 0.5f }; this->markDirty(); }
         //! Set a black background colour for the Visual scene
-        void backgroundBlack() { this->bgcolour = { 0.0f, 0.0f, 0.0f, 0.0f }; }
+        void backgroundBlack() { this->bgcolour = { 0.0f, 0.0f, 0.0f, 0.0f }; this->markDirty(); }
 
         //! Set the scene's x and y values at the same time.
         void setSceneTransXY (const float _x, const float _y)
@@ -415,11 +462,12 @@ namespace morph {
             this->scenetrans[1] = _y;
             this->scenetrans_default[0] = _x;
             this->scenetrans_default[1] = _y;
+            this->markDirty();
         }
         //! Set the scene's y value. Use this to shift your scene objects left or right
-        void setSceneTransX (const float _x) { this->scenetrans[0] = _x; this->scenetrans_default[0] = _x; }
+        void setSceneTransX (const float _x) { this->scenetrans[0] = _x; this->scenetrans_default[0] = _x; this->markDirty(); }
         //! Set the scene's y value. Use this to shift your scene objects up and down
-        void setSceneTransY (const float _y) { this->scenetrans[1] = _y; this->scenetrans_default[1] = _y; }
+        void setSceneTransY (const float _y) { this->scenetrans[1] = _y; this->scenetrans_default[1] = _y; this->markDirty(); }
         //! Set the scene's z value. Use this to bring the 'camera' closer to your scene
         //! objects (that is, your morph::VisualModel objects).
         void setSceneTransZ (const float _z)
@@ -429,6 +477,7 @@ namespace morph {
             }
             this->scenetrans[2] = _z;
             this->scenetrans_default[2] = _z;
+            this->markDirty();
         }
         void setSceneTrans (float _x, float _y, float _z)
         {
@@ -441,6 +490,7 @@ namespace morph {
             this->scenetrans_default[1] = _y;
             this->scenetrans[2] = _z;
             this->scenetrans_default[2] = _z;
+            this->markDirty();
         }
         void setSceneTrans (const morph::vec<float, 3>& _xyz)
         {
@@ -449,18 +499,21 @@ namespace morph {
             }
             this->scenetrans = _xyz;
             this->scenetrans_default = _xyz;
+            this->markDirty();
         }
 
         void setSceneRotation (const morph::quaternion<float>& _rotn)
         {
             this->rotation = _rotn;
             this->rotation_default = _rotn;
+            this->markDirty();
         }
 
         void lightingEffects (const bool effects_on = true)
         {
             this->ambient_intensity = effects_on ? 0.4f : 1.0f;
             this->diffuse_intensity = effects_on ? 0.6f : 0.0f;
+            this->markDirty();
         }
 
         //! Save all the VisualModels in this Visual out to a GLTF format file
@@ -605,6 +658,37 @@ namespace morph {
 
     protected:
 
+        /*!
+         * Called at the start of render() to decide whether to draw a frame. Returns false if
+         * renderOnDemand is set and the scene is unchanged, or if the last frame was drawn less
+         * than 1/max_frame_rate s ago.
+         */
+        bool frame_due()
+        {
+            if (this->options.test (visual_options::renderOnDemand) && !this->state.test (visual_state::sceneDirty)) {
+                ++this->frames_skipped;
+                return false;
+            }
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (this->max_frame_rate > 0.0 && now - this->last_frame_time < std::chrono::duration<double>(1.0 / this->max_frame_rate)) {
+                ++this->frames_skipped;
+                return false;
+            }
+            this->last_frame_time = now;
+            return true;
+        }
+
+        //! Called at the end of render(). Models that render() itself moved have re-dirtied the
+        //! scene, so the flag is cleared only once the frame is complete.
+        void frame_done()
+        {
+            this->state.reset (visual_state::sceneDirty);
+            ++this->frames_rendered;
+        }
+
+        //! When the last frame was drawn (see max_frame_rate)
+        std::chrono::steady_clock::time_point last_frame_time = {};
+
         //! Set up a perspective projection based on window width and height. Not public.
         void setPerspective()
         {
@@ -954,6 +1038,9 @@ namespace morph {
 
             this->key_callback_extra (_key, scancode, action, mods);
 
+            // key_callback_extra may have changed anything, so any key press dirties the scene
+            if (needs_render || action != keyaction::release) { this->markDirty(); }
+
             return needs_render;
         }
 
@@ -1068,6 +1155,7 @@ namespace morph {
                 needs_render = true; // updates viewproj; uses this->scenetrans
             }
 
+            if (needs_render) { this->markDirty(); }
             return needs_render;
         }
 
@@ -1103,6 +1191,7 @@ namespace morph {
         {
             this->window_w = width;
             this->window_h = height;
+            this->markDirty();
             return true; // needs_render
         }
 
@@ -1147,6 +1236,7 @@ namespace morph {
                 sceneview_rotn.rotate (this->rotation);
                 this->cyl_cam_pos += sceneview_rotn * scroll_move_y;
             }
+            this->markDirty();
             return true; // needs_render
         }
 
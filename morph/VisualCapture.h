@@ -0,0 +1,379 @@
+/*!
+ * \file
+ *
+ * Asynchronous frame capture for morph::Visual movie output.
+ *
+ * VisualCapture is the CPU side of the frame capture pipeline. It contains no GL code. A
+ * VisualOwnable[MX] reads back each rendered frame into a ring of pixel buffer objects and, once a
+ * frame's pixels have arrived in CPU memory, copies them into one of the preallocated buffers
+ * obtained from VisualCapture::acquire(). The buffer is then passed back with
+ * VisualCapture::submit() (or, if the frame could not be read, with VisualCapture::release()). Row flipping, alpha removal and encoding (to numbered PNG files, or as a
+ * raw RGBA or YUV4MPEG2 stream to a file or to the stdin of an encoder such as ffmpeg) happen on a
+ * small pool of worker threads, so that the render thread is not held up.
+ *
+ * Typical use is via the Visual:
+ *
+ * \code
+ *   morph::capture_options co;
+ *   co.format = morph::capture_format::y4m;
+ *   co.pipe_command = "ffmpeg -y -i - -c:v libx264 -pix_fmt yuv420p movie.mp4";
+ *   v.startCapture (co);
+ *   while (simulating) { step(); v.render(); } // each render() is captured
+ *   v.stopCapture();
+ * \endcode
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+// Use Lode Vandevenne's PNG encoder (as in VisualBase.h)
+#define LODEPNG_NO_COMPILE_DECODER 1
+#define LODEPNG_NO_COMPILE_ANCILLARY_CHUNKS 1
+#include <morph/lodepng.h>
+
+namespace morph {
+
+    //! The output format for a VisualCapture
+    enum class capture_format
+    {
+        //! One PNG file per frame, named filename_stem + zero padded frame number + ".png"
+        png,
+        //! A stream of raw RGBA frames (for e.g. ffmpeg -f rawvideo -pix_fmt rgba -s WxH -i -)
+        raw,
+        //! A YUV4MPEG2 stream with 4:4:4 chroma (self describing, so ffmpeg -i - is sufficient)
+        y4m
+    };
+
+    //! Options that configure a frame capture
+    struct capture_options
+    {
+        capture_format format = capture_format::png;
+        //! For png output, the path prefix for each frame. "frames/movie_" gives frames/movie_00000.png etc
+        std::string filename_stem = "frame_";
+        //! Number of digits in the frame number for png output
+        unsigned int filename_digits = 5;
+        //! For raw/y4m output, a file to write the stream into
+        std::string output_path = "capture.y4m";
+        //! For raw/y4m output, if non-empty, a command to popen() and write the stream into, instead
+        //! of output_path
+        std::string pipe_command = "";
+        //! Frame rate written into the y4m header
+        unsigned int fps = 60;
+        //! If false, then the alpha channel is forced to 255 (as in saveImage)
+        bool transparent_bg = false;
+        //! How many worker threads flip/encode frames. 0 means use hardware_concurrency - 1
+        unsigned int num_threads = 0;
+        //! How many preallocated frame buffers there are. When all are in use, acquire() blocks.
+        unsigned int num_buffers = 8;
+        //! How many pixel buffer objects are in the GL side readback ring
+        unsigned int num_pbos = 3;
+    };
+
+    /*!
+     * A pool of preallocated frame buffers and worker threads which flip and encode captured
+     * frames. Frames are numbered in the order in which they are submitted and stream outputs
+     * (raw/y4m) are always written in that order, whichever worker finishes first.
+     */
+    class VisualCapture
+    {
+        // One preallocated frame
+        struct slot
+        {
+            std::vector<unsigned char> pixels; // As read from GL (bottom row first)
+            std::vector<unsigned char> output; // Flipped and (for y4m) converted to planar YUV
+            std::uint64_t seq = 0;
+            bool ready = false;                // true when output is ready to be written
+        };
+
+    public:
+        /*!
+         * Create a capture for frames of width _w and height _h (in pixels). This allocates all
+         * frame buffers, opens any output stream and starts the worker threads. Throws
+         * std::runtime_error if the output can't be opened.
+         */
+        VisualCapture (const capture_options& _opts, const int _w, const int _h)
+            : opts(_opts), w(_w), h(_h)
+        {
+            if (this->w <= 0 || this->h <= 0) { throw std::runtime_error ("VisualCapture: frame has zero size"); }
+            if (this->opts.num_buffers < 1) { this->opts.num_buffers = 1; }
+
+            const std::size_t npix = static_cast<std::size_t>(this->w) * static_cast<std::size_t>(this->h);
+            const std::size_t outbytes = this->opts.format == capture_format::y4m ? npix * 3 : npix * 4;
+            this->slots.resize (this->opts.num_buffers);
+            for (unsigned int i = 0; i < this->opts.num_buffers; ++i) {
+                this->slots[i].pixels.resize (npix * 4);
+                this->slots[i].output.resize (outbytes);
+                this->free_slots.push_back (i);
+            }
+
+            this->open_output();
+
+            unsigned int nt = this->opts.num_threads;
+            if (nt == 0) {
+                unsigned int hc = std::thread::hardware_concurrency();
+                nt = hc > 1 ? hc - 1 : 1;
+            }
+            for (unsigned int i = 0; i < nt; ++i) {
+                this->workers.emplace_back (&VisualCapture::worker_loop, this);
+            }
+        }
+
+        ~VisualCapture() { this->finish(); }
+
+        VisualCapture (const VisualCapture&) = delete;
+        VisualCapture& operator= (const VisualCapture&) = delete;
+
+        /*!
+         * Obtain a free buffer index. Write w * h * 4 bytes of RGBA (as returned by glReadPixels) to
+         * pixels(idx) and then call submit(idx). Blocks if all buffers are in flight.
+         */
+        unsigned int acquire()
+        {
+            std::unique_lock<std::mutex> lk (this->m);
+            this->cv_free.wait (lk, [this]{ return !this->free_slots.empty(); });
+            unsigned int idx = this->free_slots.front();
+            this->free_slots.pop_front();
+            return idx;
+        }
+
+        //! Access the pixel memory of the buffer with index idx
+        unsigned char* pixels (const unsigned int idx) { return this->slots[idx].pixels.data(); }
+
+        //! Queue the buffer idx for flipping and encoding. Frame numbers are assigned here.
+        void submit (const unsigned int idx)
+        {
+            {
+                std::lock_guard<std::mutex> lk (this->m);
+                this->slots[idx].seq = this->next_seq++;
+                this->slots[idx].ready = false;
+                this->jobs.push_back (idx);
+            }
+            this->cv_jobs.notify_one();
+        }
+
+        //! Return the buffer idx, obtained from acquire(), without submitting it. Use this when a
+        //! frame could not be read back, so that no frame number is used up.
+        void release (const unsigned int idx)
+        {
+            {
+                std::lock_guard<std::mutex> lk (this->m);
+                this->free_slots.push_back (idx);
+            }
+            this->cv_free.notify_one();
+        }
+
+        //! Wait until all submitted frames have been written, stop the workers and close output.
+        void finish()
+        {
+            {
+                std::lock_guard<std::mutex> lk (this->m);
+                if (this->finished) { return; }
+                this->finished = true;
+            }
+            this->cv_jobs.notify_all();
+            for (auto& t : this->workers) { if (t.joinable()) { t.join(); } }
+            this->workers.clear();
+            this->close_output();
+        }
+
+        //! The number of frames fully written out
+        std::uint64_t frames_written() const { return this->n_written.load(); }
+        //! Frame width
+        int width() const { return this->w; }
+        //! Frame height
+        int height() const { return this->h; }
+        //! The options with which this capture was created
+        const capture_options& options() const { return this->opts; }
+
+        /*!
+         * Flip the rows of the w x h RGBA image in_bits (as read from GL, bottom row first) into
+         * out_bits. If transparent_bg is false, set alpha to 255. Shared with VisualOwnable::saveImage.
+         */
+        static void flip_rows (const unsigned char* in_bits, unsigned char* out_bits,
+                               const int _w, const int _h, const bool transparent_bg)
+        {
+            const std::size_t rowbytes = static_cast<std::size_t>(_w) * 4u;
+            for (int i = 0; i < _h; ++i) {
+                const unsigned char* src = in_bits + static_cast<std::size_t>(i) * rowbytes;
+                unsigned char* dst = out_bits + static_cast<std::size_t>(_h - i - 1) * rowbytes;
+                std::memcpy (dst, src, rowbytes);
+                if (!transparent_bg) {
+                    for (std::size_t j = 3; j < rowbytes; j += 4) { dst[j] = 255; }
+                }
+            }
+        }
+
+        /*!
+         * Convert the w x h RGBA image in_bits (bottom row first) to top-row-first planar YUV
+         * 4:4:4 (BT.601, studio swing) in out_yuv, which must hold w * h * 3 bytes.
+         */
+        static void rgba_to_yuv444 (const unsigned char* in_bits, unsigned char* out_yuv, const int _w, const int _h)
+        {
+            const std::size_t npix = static_cast<std::size_t>(_w) * static_cast<std::size_t>(_h);
+            unsigned char* yp = out_yuv;
+            unsigned char* up = out_yuv + npix;
+            unsigned char* vp = out_yuv + 2 * npix;
+            for (int i = 0; i < _h; ++i) {
+                const unsigned char* src = in_bits + static_cast<std::size_t>(_h - i - 1) * _w * 4;
+                const std::size_t o = static_cast<std::size_t>(i) * _w;
+                for (int j = 0; j < _w; ++j) {
+                    const int r = src[4 * j];
+                    const int g = src[4 * j + 1];
+                    const int b = src[4 * j + 2];
+                    // Integer BT.601 coefficients (scaled by 256)
+                    yp[o + j] = static_cast<unsigned char>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                    up[o + j] = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+                    vp[o + j] = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+                }
+            }
+        }
+
+    private:
+        void open_output()
+        {
+            if (this->opts.format == capture_format::png) { return; }
+            if (!this->opts.pipe_command.empty()) {
+#ifdef _WIN32
+                this->fp = _popen (this->opts.pipe_command.c_str(), "wb");
+#else
+                this->fp = popen (this->opts.pipe_command.c_str(), "w");
+#endif
+                this->fp_is_pipe = true;
+            } else {
+                this->fp = std::fopen (this->opts.output_path.c_str(), "wb");
+            }
+            if (this->fp == nullptr) {
+                throw std::runtime_error ("VisualCapture: Failed to open capture output stream");
+            }
+            if (this->opts.format == capture_format::y4m) {
+                std::stringstream hdr;
+                hdr << "YUV4MPEG2 W" << this->w << " H" << this->h << " F" << this->opts.fps
+                    << ":1 Ip A1:1 C444\n";
+                std::string hs = hdr.str();
+                std::fwrite (hs.data(), 1, hs.size(), this->fp);
+            }
+        }
+
+        void close_output()
+        {
+            if (this->fp == nullptr) { return; }
+            if (this->fp_is_pipe) {
+#ifdef _WIN32
+                _pclose (this->fp);
+#else
+                pclose (this->fp);
+#endif
+            } else {
+                std::fclose (this->fp);
+            }
+            this->fp = nullptr;
+        }
+
+        // Convert a frame into its output form (and for png, write it out)
+        void process (slot& s)
+        {
+            if (this->opts.format == capture_format::y4m) {
+                VisualCapture::rgba_to_yuv444 (s.pixels.data(), s.output.data(), this->w, this->h);
+            } else {
+                VisualCapture::flip_rows (s.pixels.data(), s.output.data(), this->w, this->h, this->opts.transparent_bg);
+            }
+            if (this->opts.format == capture_format::png) {
+                std::stringstream fn;
+                fn << this->opts.filename_stem;
+                fn.width (this->opts.filename_digits);
+                fn.fill ('0');
+                fn << s.seq << ".png";
+                unsigned int error = lodepng::encode (fn.str(), s.output.data(), this->w, this->h);
+                if (error) {
+                    std::cerr << "VisualCapture: encoder error " << error << ": " << lodepng_error_text (error) << std::endl;
+                }
+            }
+        }
+
+        // Stream frames must be written strictly in order. Called with the lock held; writes every
+        // consecutive ready frame, returning their slots to the free list.
+        void write_ready_frames (std::unique_lock<std::mutex>& lk)
+        {
+            if (this->writing) { return; } // another worker is already writing; it will pick these up
+            this->writing = true;
+            bool progressed = true;
+            while (progressed) {
+                progressed = false;
+                for (unsigned int i = 0; i < this->slots.size(); ++i) {
+                    slot& s = this->slots[i];
+                    if (!s.ready || s.seq != this->next_write) { continue; }
+                    lk.unlock();
+                    static constexpr char frame_hdr[] = "FRAME\n";
+                    if (this->opts.format == capture_format::y4m) { std::fwrite (frame_hdr, 1, 6, this->fp); }
+                    std::fwrite (s.output.data(), 1, s.output.size(), this->fp);
+                    lk.lock();
+                    s.ready = false;
+                    ++this->next_write;
+                    this->n_written++;
+                    this->free_slots.push_back (i);
+                    this->cv_free.notify_one();
+                    progressed = true;
+                }
+            }
+            this->writing = false;
+        }
+
+        void worker_loop()
+        {
+            std::unique_lock<std::mutex> lk (this->m);
+            while (true) {
+                this->cv_jobs.wait (lk, [this]{ return !this->jobs.empty() || this->finished; });
+                if (this->jobs.empty()) { break; } // finished and drained
+                unsigned int idx = this->jobs.front();
+                this->jobs.pop_front();
+                lk.unlock();
+                this->process (this->slots[idx]);
+                lk.lock();
+                if (this->opts.format == capture_format::png) {
+                    this->n_written++;
+                    this->free_slots.push_back (idx);
+                    this->cv_free.notify_one();
+                } else {
+                    this->slots[idx].ready = true;
+                    this->write_ready_frames (lk);
+                }
+            }
+        }
+
+        capture_options opts;
+        int w = 0;
+        int h = 0;
+        std::vector<slot> slots;
+        std::deque<unsigned int> free_slots;
+        std::deque<unsigned int> jobs;
+        std::vector<std::thread> workers;
+        std::mutex m;
+        std::condition_variable cv_free;
+        std::condition_variable cv_jobs;
+        std::uint64_t next_seq = 0;
+        std::uint64_t next_write = 0;
+        std::atomic<std::uint64_t> n_written = 0;
+        bool writing = false;
+        bool finished = false;
+        std::FILE* fp = nullptr;
+        bool fp_is_pipe = false;
+    };
+
+} // namespace morph
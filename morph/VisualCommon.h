@@ -11,11 +11,64 @@
 #include <stdexcept>
 #include <iostream>
 #include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <algorithm>
 
 namespace morph {
 
     namespace visgl {
 
+#ifdef MORPH_GL_DEBUG
+        //! Check for GL errors after each model is rendered or its buffers updated. Each check
+        //! makes the CPU wait for the GL, so they are made only if MORPH_GL_DEBUG is defined.
+        constexpr bool debug_gl = true;
+#else
+        constexpr bool debug_gl = false;
+#endif
+
+        /*!
+         * The locations of the uniforms that morph::Visual and its VisualModels set in a shader
+         * program. These are looked up once, when the program is loaded, rather than on every
+         * frame for every model. -1 means that the program has no such active uniform (which is
+         * the case for uniforms that the program declares in the morph_frame uniform block).
+         */
+        struct uniform_locations
+        {
+            int alpha = -1;
+            int v_matrix = -1;
+            int m_matrix = -1;
+            int p_matrix = -1;
+            int light_colour = -1;
+            int ambient_intensity = -1;
+            int diffuse_position = -1;
+            int diffuse_intensity = -1;
+            int cyl_cam_pos = -1;
+            int cyl_radius = -1;
+            int cyl_height = -1;
+            int textColor = -1;
+            int oct_normals = -1;
+        };
+
+        //! The uniform buffer binding point of the morph_frame uniform block
+        constexpr unsigned int frame_block_binding = 0;
+
+        /*!
+         * The per-frame data that a morph::Visual passes to all of its shader programs. This is
+         * the std140 layout of the morph_frame uniform block that the default shaders declare
+         * (see shaders/Visual.vert.glsl). It is written to one uniform buffer, once per frame.
+         */
+        struct frame_uniforms
+        {
+            float p_matrix[16];
+            float light_colour[3];
+            float ambient_intensity;
+            float diffuse_position[3];
+            float diffuse_intensity;
+        };
+        static_assert (sizeof(frame_uniforms) == 96, "frame_uniforms must match the std140 layout of morph_frame");
+
         // A container struct for the shader program identifiers used in a morph::Visual. Separate
         // from morph::Visual so that it can be used in morph::VisualModel as well, which does not
         // #include morph/Visual.h.
@@ -25,6 +78,10 @@ namespace morph {
             unsigned int /*GLuint*/ gprog = 0;
             //! A text shader program, which uses textures to draw text on quads.
             unsigned int /*GLuint*/ tprog = 0;
+            //! The uniform locations in gprog
+            uniform_locations gloc;
+            //! The uniform locations in tprog
+            uniform_locations tloc;
         };
 
         // This defines different graphics shader types, as used in morph::Visual. The essential
@@ -41,6 +98,70 @@ namespace morph {
         //! morph::Visual GLSL programs
         enum AttribLocn { posnLoc = 0, normLoc = 1, colLoc = 2, textureLoc = 3 };
 
+        /*!
+         * How a VisualModel lays out its vertices on the GPU. 'separate' uses one buffer of
+         * floats for each of the positions, normals and colours (36 bytes per vertex) and 32 bit
+         * indices. 'packed' interleaves the attributes in one buffer of packed_vertex (20 bytes
+         * per vertex) and uses 16 bit indices if the model has no more than 65536 vertices.
+         */
+        enum class vertex_format { separate, packed };
+
+        /*!
+         * One vertex in the packed vertex format. The normal is octahedral-encoded into two
+         * normalized shorts (see oct_encode) and decoded in the vertex shader; the colour is
+         * RGBA8.
+         */
+        struct packed_vertex
+        {
+            float position[3];
+            std::int16_t normal[2];
+            std::uint8_t colour[4];
+        };
+        static_assert (sizeof(packed_vertex) == 20, "packed_vertex should have no padding");
+
+        /*!
+         * Encode the unit vector (x,y,z) as two snorm16 values by projecting it onto the octahedron
+         * |x|+|y|+|z|=1 and folding the lower half (z<0) over the upper half. The error in the
+         * decoded direction is less than 0.01 degrees.
+         */
+        inline std::array<std::int16_t, 2> oct_encode (const float x, const float y, const float z)
+        {
+            const float l1 = std::abs (x) + std::abs (y) + std::abs (z);
+            if (l1 == 0.0f) { return { 0, 0 }; }
+            float u = x / l1;
+            float v = y / l1;
+            if (z < 0.0f) {
+                const float fu = (1.0f - std::abs (v)) * (u >= 0.0f ? 1.0f : -1.0f);
+                v = (1.0f - std::abs (u)) * (v >= 0.0f ? 1.0f : -1.0f);
+                u = fu;
+            }
+            // Round to nearest (u and v are already in [-1,1]); faster than std::round
+            u *= 32767.0f;
+            v *= 32767.0f;
+            return { static_cast<std::int16_t>(u + (u >= 0.0f ? 0.5f : -0.5f)),
+                     static_cast<std::int16_t>(v + (v >= 0.0f ? 0.5f : -0.5f)) };
+        }
+
+        //! Decode a normal encoded by oct_encode (as the vertex shaders do)
+        inline morph::vec<float, 3> oct_decode (const std::array<std::int16_t, 2>& e)
+        {
+            morph::vec<float, 3> n = { std::max (e[0] / 32767.0f, -1.0f), std::max (e[1] / 32767.0f, -1.0f), 0.0f };
+            n[2] = 1.0f - std::abs (n[0]) - std::abs (n[1]);
+            if (n[2] < 0.0f) {
+                const float fx = (1.0f - std::abs (n[1])) * (n[0] >= 0.0f ? 1.0f : -1.0f);
+                n[1] = (1.0f - std::abs (n[0])) * (n[1] >= 0.0f ? 1.0f : -1.0f);
+                n[0] = fx;
+            }
+            n.renormalize();
+            return n;
+        }
+
+        //! Quantise a colour component in [0,1] to 8 bits
+        inline std::uint8_t unorm8 (const float c)
+        {
+            return static_cast<std::uint8_t>(std::clamp (c, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
         //! A struct to hold information about font glyph properties
         struct CharInfo
         {
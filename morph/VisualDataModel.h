@@ -4,6 +4,8 @@
 #pragma once
 
 #include <vector>
+#include <array>
+#include <span>
 #include <morph/vec.h>
 #include <morph/VisualModel.h>
 #include <morph/ColourMap.h>
@@ -81,7 +83,7 @@ namespace morph {
         virtual void updateData (const std::vector<T>* _data)
         {
             this->scalarData = _data;
-            this->reinit();
+            this->reinitData();
         }
 
         //! Update the scalar data with an associated z-scaling
@@ -89,7 +91,7 @@ namespace morph {
         {
             this->scalarData = _data;
             this->zScale = zscale;
-            this->reinit();
+            this->reinitData();
         }
 
         //! Update the scalar data, along with both the z-scaling and the colour-scaling
@@ -98,7 +100,7 @@ namespace morph {
             this->scalarData = _data;
             this->zScale = zscale;
             this->colourScale = cscale;
-            this->reinit();
+            this->reinitData();
         }
 
         //! Update coordinate data and scalar data along with z-scaling for scalar data
@@ -133,7 +135,7 @@ namespace morph {
         void updateData (const std::vector<vec<T>>* _vectors)
         {
             this->vectorData = _vectors;
-            this->reinit();
+            this->reinitData();
         }
 
         //! Update both coordinate and vector data
@@ -178,6 +180,84 @@ namespace morph {
         //! graph, quiver plot). Note fixed type of float, which is suitable for
         //! OpenGL coordinates. Not const as child code may resize or update content.
         std::vector<vec<float>>* dataCoords = nullptr;
+
+        /*!
+         * Update, in place, those vertex attributes that depend on the data values, without
+         * rebuilding the model, and mark the buffers that changed with set_dirty(). Return false if
+         * this isn't possible, in which case updateData() falls back to a full reinit().
+         *
+         * The default returns false. Override this in a VisualDataModel whose geometry (number of
+         * vertices, normals and indices) does not depend on the data values, so that updateData()
+         * only has to recompute and re-upload (say) z positions and colours.
+         */
+        virtual bool updateAttributes() { return false; }
+
+        /*!
+         * Re-create the model after the data (but not the data coordinates) has changed. Calls
+         * updateAttributes() and then copies just the dirty buffers to the GPU or, if the model
+         * can't be updated in place, calls reinit().
+         */
+        void reinitData()
+        {
+            if (this->vertexPositions.empty() || !this->updateAttributes()) {
+                this->reinit();
+                return;
+            }
+            this->reinit_dirty_buffers();
+        }
+
+    protected:
+        /*!
+         * True if zScale maps every datum to the same z, so that z positions don't depend on the
+         * data and only colours need to change when the data changes.
+         */
+        bool zScaleIsFlat()
+        {
+            return this->zScale.do_autoscale == false && this->zScale.ready() && this->zScale.getParams(0) == 0.0f;
+        }
+
+        /*!
+         * Scale scalarData with zScale into zdata and with colourScale into cdata. Both outputs
+         * are resized to match scalarData. For scalar T this reads scalarData just once (see
+         * scale::transform_pair) and, if both scales autoscale, finds the data range just once.
+         */
+        template <typename ZContainer, typename CContainer>
+        void transformScalarData (ZContainer& zdata, CContainer& cdata)
+        {
+            zdata.resize (this->scalarData->size());
+            cdata.resize (this->scalarData->size());
+            if constexpr (morph::number_type<T>::value == 1) {
+                this->zScale.transform_pair (*this->scalarData, zdata, this->colourScale, cdata);
+            } else {
+                this->zScale.transform (*this->scalarData, zdata);
+                this->colourScale.transform (*this->scalarData, cdata);
+            }
+        }
+
+        /*!
+         * Convert colour data, already scaled into [0,1] by colourScale, into RGB triplets in
+         * dcolour_rgb, using the batched ColourMap::convert. This is parallel and, if
+         * cm.setLUTSize() has been called, uses the colour map's lookup table. If cm is not a
+         * single datum map, dcolour_rgb is cleared and colours should be converted per-element.
+         */
+        void convertColours (const std::vector<float>& dcol)
+        {
+            if (this->cm.numDatums() != 1) {
+                this->dcolour_rgb.clear();
+                return;
+            }
+            this->dcolour_rgb.resize (3u * dcol.size());
+            this->cm.convert (std::span<const float>{dcol}, std::span<float>{this->dcolour_rgb});
+        }
+
+        //! Return the colour for element i from dcolour_rgb
+        std::array<float, 3> colour_at (const std::size_t i) const
+        {
+            return { this->dcolour_rgb[3 * i], this->dcolour_rgb[3 * i + 1], this->dcolour_rgb[3 * i + 2] };
+        }
+
+        //! RGB colours computed by convertColours(), three floats per datum
+        std::vector<float> dcolour_rgb;
     };
 
 } // namespace morph
@@ -97,13 +97,36 @@ OpenGL 4.5
 
 namespace morph {
 
+    // The per-frame uniform block, shared by all the morph::Visual shader programs. Its layout is
+    // mirrored by morph::visgl::frame_uniforms.
+    const char* defaultFrameBlock = "layout(std140) uniform morph_frame\n"
+    "{\n"
+    "    mat4 p_matrix;\n"
+    "    vec3 light_colour;\n"
+    "    float ambient_intensity;\n"
+    "    vec3 diffuse_position;\n"
+    "    float diffuse_intensity;\n"
+    "};\n";
+
+    // Decodes the octahedral-packed normals of VisualModels that use the packed vertex format.
+    // See Visual.vert.glsl.
+    const char* defaultNormalUnpack = "uniform int oct_normals;\n"
+    "vec4 unpack_normal (vec4 n)\n"
+    "{\n"
+    "    if (oct_normals == 0) { return n; }\n"
+    "    vec3 v = vec3(n.x, n.y, 1.0 - abs(n.x) - abs(n.y));\n"
+    "    if (v.z < 0.0) {\n"
+    "        v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);\n"
+    "    }\n"
+    "    return vec4(normalize(v), 1.0);\n"
+    "}\n";
+
     // The default vertex shader. To study this GLSL, see Visual.vert.glsl, which has
     // some code comments.
     const char* defaultVtxShader = "uniform mat4 mvp_matrix;\n"
     "uniform mat4 vp_matrix;\n"
     "uniform mat4 m_matrix;\n"
     "uniform mat4 v_matrix;\n"
-    "uniform mat4 p_matrix;\n"
     "uniform float alpha;\n"
     "layout(location = 0) in vec4 position;\n"
     "layout(location = 1) in vec4 normalin;\n"
@@ -119,13 +142,15 @@ namespace morph {
     "    gl_Position = (p_matrix * v_matrix * m_matrix * position);\n"
     "    vertex.color = vec4(color, alpha);\n"
     "    vertex.fragpos = vec3(m_matrix * position);\n"
-    "    vertex.normal = normalin;\n"
+    "    vertex.normal = unpack_normal (normalin);\n"
     "}\n";
 
     std::string getDefaultVtxShader (const int glver)
     {
         std::string shdr;
         shdr += morph::gl::version::shaderpreamble (glver);
+        shdr += defaultFrameBlock;
+        shdr += defaultNormalUnpack;
         shdr += defaultVtxShader;
         return shdr;
     }
@@ -137,10 +162,6 @@ namespace morph {
     "    vec4 color;\n"
     "    vec3 fragpos;\n"
     "} vertex;\n"
-    "uniform vec3 light_colour;\n"
-    "uniform float ambient_intensity;\n"
-    "uniform vec3 diffuse_position;\n"
-    "uniform float diffuse_intensity;\n"
     "out vec4 finalcolor;\n"
     "void main()\n"
     "{\n"
@@ -157,6 +178,7 @@ namespace morph {
     {
         std::string shdr;
         shdr += morph::gl::version::shaderpreamble (glver);
+        shdr += defaultFrameBlock;
         shdr += defaultFragShader;
         return shdr;
     }
@@ -164,7 +186,6 @@ namespace morph {
     // Default text vertex shader. See VisText.vert.glsl
     const char* defaultTextVtxShader = "uniform mat4 m_matrix;\n"
     "uniform mat4 v_matrix;\n"
-    "uniform mat4 p_matrix;\n"
     "layout(location = 0) in vec4 position;\n"
     "layout(location = 1) in vec4 vnormal;\n"
     "layout(location = 2) in vec4 vcolor;\n"
@@ -180,6 +201,7 @@ namespace morph {
     {
         std::string shdr;
         shdr += morph::gl::version::shaderpreamble (glver);
+        shdr += defaultFrameBlock;
         shdr += defaultTextVtxShader;
         return shdr;
     }
@@ -207,7 +229,6 @@ namespace morph {
     "uniform mat4 vp_matrix;\n"
     "uniform mat4 m_matrix;\n"
     "uniform mat4 v_matrix;\n"
-    "uniform mat4 p_matrix;\n"
     "uniform float alpha;\n"
     "uniform float cyl_radius = 0.005;\n"
     "uniform float cyl_height = 0.01;\n"
@@ -243,12 +264,12 @@ namespace morph {
     "        gl_Position = vec4(x_s, y_s, -1.0, 1.0);\n"
     "        vertex.color = vec4(color, alpha);\n"
     "        vertex.fragpos = vec3(m_matrix * position);\n"
-    "        vertex.normal = normalin;\n"
+    "        vertex.normal = unpack_normal (normalin);\n"
     "    } else {\n"
     "        gl_Position = vec4(0.0, 0.0, -100.0, 1.0);\n"
     "        vertex.color = vec4(color, 0.0);\n"
     "        vertex.fragpos = vec3(m_matrix * position);\n"
-    "        vertex.normal = normalin;\n"
+    "        vertex.normal = unpack_normal (normalin);\n"
     "    }\n"
     "}\n";
 
@@ -256,6 +277,8 @@ namespace morph {
     {
         std::string shdr;
         shdr += morph::gl::version::shaderpreamble (glver);
+        shdr += defaultFrameBlock;
+        shdr += defaultNormalUnpack;
         shdr += defaultCylShader;
         return shdr;
     }
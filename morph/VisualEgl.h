@@ -0,0 +1,139 @@
+/*!
+ * \file
+ *
+ * Singleton to manage init/deinit of a headless EGL display, from which offscreen OpenGL contexts
+ * can be created for morph::VisualOffscreen. This is the EGL analogue of morph::VisualGlfw.
+ *
+ * The Mesa 'surfaceless' platform is preferred, because it needs neither a window system nor
+ * access to a DRM render node (and on a machine without a GPU it gives you the llvmpipe software
+ * renderer). If that platform is unavailable, the default EGL display is used.
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <morph/gl/version.h>
+
+namespace morph {
+
+    //! The 'window' of an offscreen Visual. It holds the EGL context only, as rendering happens
+    //! into a framebuffer object rather than to an EGL surface.
+    struct egl_context
+    {
+        EGLContext ctx = EGL_NO_CONTEXT;
+    };
+
+    //! Singleton resource class that owns the EGLDisplay for offscreen morph::Visual scenes.
+    template<int glver>
+    class VisualEgl
+    {
+    private:
+        VisualEgl()
+        {
+            const char* client_exts = eglQueryString (EGL_NO_DISPLAY, EGL_EXTENSIONS);
+            if (client_exts != nullptr && std::strstr (client_exts, "EGL_MESA_platform_surfaceless") != nullptr) {
+                this->dpy = eglGetPlatformDisplay (EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            }
+            if (this->dpy == EGL_NO_DISPLAY) { this->dpy = eglGetDisplay (EGL_DEFAULT_DISPLAY); }
+            if (this->dpy == EGL_NO_DISPLAY) {
+                throw std::runtime_error ("VisualEgl: Failed to get an EGL display for headless GL");
+            }
+            if (eglInitialize (this->dpy, nullptr, nullptr) == EGL_FALSE) {
+                throw std::runtime_error ("VisualEgl: Failed to eglInitialize display for headless GL");
+            }
+            const char* exts = eglQueryString (this->dpy, EGL_EXTENSIONS);
+            if (exts == nullptr || std::strstr (exts, "EGL_KHR_surfaceless_context") == nullptr) {
+                throw std::runtime_error ("VisualEgl: EGL display lacks EGL_KHR_surfaceless_context");
+            }
+            this->no_config = std::strstr (exts, "EGL_KHR_no_config_context") != nullptr;
+        }
+        ~VisualEgl() { eglTerminate (this->dpy); }
+
+        //! The EGL display. One per program.
+        EGLDisplay dpy = EGL_NO_DISPLAY;
+        //! True if contexts can be created without an EGLConfig
+        bool no_config = false;
+        //! eglCreateContext/eglDestroyContext are called from any thread that creates a Visual
+        std::mutex ctx_mutex;
+
+    public:
+        //! The client API that our contexts use
+        static constexpr EGLenum api() { return morph::gl::version::gles (glver) ? EGL_OPENGL_ES_API : EGL_OPENGL_API; }
+
+        EGLDisplay display() const { return this->dpy; }
+
+        //! Create a new OpenGL context of the version given by glver. Nothing is made current.
+        EGLContext create_context()
+        {
+            std::lock_guard<std::mutex> lk (this->ctx_mutex);
+            if (eglBindAPI (api()) == EGL_FALSE) {
+                throw std::runtime_error ("VisualEgl: Failed to eglBindAPI for headless GL");
+            }
+            EGLConfig cfg = EGL_NO_CONFIG_KHR;
+            if (!this->no_config) {
+                const EGLint config_attribs[] = {
+                    EGL_RENDERABLE_TYPE, (morph::gl::version::gles (glver) ? EGL_OPENGL_ES3_BIT_KHR : EGL_OPENGL_BIT),
+                    EGL_NONE
+                };
+                EGLint count = 0;
+                if (eglChooseConfig (this->dpy, config_attribs, &cfg, 1, &count) == EGL_FALSE || count < 1) {
+                    throw std::runtime_error ("VisualEgl: Failed to eglChooseConfig for headless GL");
+                }
+            }
+            EGLint attribs[] = {
+                EGL_CONTEXT_MAJOR_VERSION, morph::gl::version::major (glver),
+                EGL_CONTEXT_MINOR_VERSION, morph::gl::version::minor (glver),
+                EGL_NONE, EGL_NONE,
+                EGL_NONE
+            };
+            if constexpr (morph::gl::version::gles (glver) == false) {
+                attribs[4] = EGL_CONTEXT_OPENGL_PROFILE_MASK;
+                attribs[5] = EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT;
+            }
+            EGLContext ctx = eglCreateContext (this->dpy, cfg, EGL_NO_CONTEXT, attribs);
+            if (ctx == EGL_NO_CONTEXT) {
+                throw std::runtime_error ("VisualEgl: Failed to eglCreateContext for headless GL");
+            }
+            return ctx;
+        }
+
+        void destroy_context (EGLContext ctx)
+        {
+            std::lock_guard<std::mutex> lk (this->ctx_mutex);
+            if (ctx != EGL_NO_CONTEXT) { eglDestroyContext (this->dpy, ctx); }
+        }
+
+        //! Make ctx current on the calling thread (with no surface). Return false on failure. Does
+        //! not throw, as it is called from Visual::render(), which is noexcept.
+        bool make_current (EGLContext ctx) noexcept
+        {
+            // The bound API is per-thread state, so bind it on whichever thread we are called from
+            eglBindAPI (api());
+            return eglMakeCurrent (this->dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx) == EGL_TRUE;
+        }
+
+        //! Release whatever context is current on the calling thread
+        void release_current() noexcept { eglMakeCurrent (this->dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT); }
+
+        VisualEgl(const VisualEgl<glver>&) = delete;
+        VisualEgl& operator=(const VisualEgl<glver> &) = delete;
+        VisualEgl(VisualEgl<glver> &&) = delete;
+        VisualEgl & operator=(VisualEgl<glver> &&) = delete;
+
+        //! C++11 magic statics (N2660) instance public function.
+        static auto& i()
+        {
+            static VisualEgl instance;
+            return instance;
+        }
+    };
+
+} // namespace morph
@@ -171,6 +171,7 @@ namespace morph {
         {
             model->setContext = &morph::VisualBase<glver>::set_context;
             model->releaseContext = &morph::VisualBase<glver>::release_context;
+            model->markDirty = &morph::VisualBase<glver>::mark_dirty;
             model->get_glfn = &morph::VisualOwnableMX<glver>::get_glfn;
         }
 
@@ -245,6 +246,7 @@ namespace morph {
             glfwSetWindowSizeCallback (this->window, window_size_callback_dispatch);
             glfwSetWindowCloseCallback (this->window, window_close_callback_dispatch);
             glfwSetScrollCallback (this->window, scroll_callback_dispatch);
+            glfwSetWindowRefreshCallback (this->window, window_refresh_callback_dispatch);
 
             glfwMakeContextCurrent (this->window);
 
@@ -296,6 +298,13 @@ namespace morph {
                 self->render();
             }
         }
+        static void window_refresh_callback_dispatch (GLFWwindow* _window)
+        {
+            // The window system needs the contents of the window to be drawn again
+            VisualMX<glver>* self = static_cast<VisualMX<glver>*>(glfwGetWindowUserPointer (_window));
+            self->markDirty();
+            self->render();
+        }
 
 
     public:
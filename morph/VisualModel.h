@@ -33,7 +33,7 @@ namespace morph {
      * The base and implementation classes underlying class VisualModel contain some common 'object
      * primitives' code, such as computeSphere and computeCone, which compute the vertices that will
      * make up sphere and cone, respectively. If you need to see the primitives, look at
-     * morph/VisualModelBase.h
+     * morph/VertexArena.h
      *
      * Note on morph::gl::multicontext. This is defined as a static constexpr int with the value 1
      * or 0 in <morph/VisualOwnableNoMX.h> or <morph/VisualOwnableMX.h>, one or other of which must have
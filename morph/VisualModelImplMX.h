@@ -16,6 +16,8 @@
 #endif
 
 #include <type_traits>
+#include <cstddef>
+#include <cstdint>
 
 #include <morph/VisualModelBase.h>
 
@@ -63,6 +65,7 @@ namespace morph {
             model->get_shaderprogs = &morph::VisualBase<glver>::get_shaderprogs;
             model->get_gprog = &morph::VisualBase<glver>::get_gprog;
             model->get_tprog = &morph::VisualBase<glver>::get_tprog;
+            model->markDirty = &morph::VisualBase<glver>::mark_dirty;
 
             model->get_glfn = &morph::VisualOwnableMX<glver>::get_glfn;
 
@@ -89,22 +92,19 @@ namespace morph {
             }
 
             // Set up the indices buffer - bind and buffer the data in this->indices
-            _glfn->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vbos[this->idxVBO]);
-
-            std::size_t sz = this->indices.size() * sizeof(GLuint);
-            _glfn->BufferData(GL_ELEMENT_ARRAY_BUFFER, sz, this->indices.data(), GL_STATIC_DRAW);
+            this->setupIndices();
 
             // Binds data from the "C++ world" to the OpenGL shader world for
             // "position", "normalin" and "color"
             // (bind, buffer and set vertex array object attribute)
-            this->setupVBO (this->vbos[this->posnVBO], this->vertexPositions, visgl::posnLoc);
-            this->setupVBO (this->vbos[this->normVBO], this->vertexNormals, visgl::normLoc);
-            this->setupVBO (this->vbos[this->colVBO], this->vertexColors, visgl::colLoc);
+            this->setupVertexVBOs();
 
             // Unbind only the vertex array (not the buffers, that causes GL_INVALID_ENUM errors)
             _glfn->BindVertexArray(0); // carefully unbind and rebind
             morph::gl::Util::checkError (__FILE__, __LINE__, _glfn);
 
+            this->dirty_vbos.reset();
+            this->parent_dirty();
             this->postVertexInitRequired = false;
         }
 
@@ -122,16 +122,13 @@ namespace morph {
             if (this->postVertexInitRequired == true) { this->postVertexInit(); }
             // Now re-set up the VBOs
             _glfn->BindVertexArray (this->vao);                                    // carefully unbind and rebind
-            _glfn->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vbos[this->idxVBO]);  // carefully unbind and rebind
-
-            std::size_t sz = this->indices.size() * sizeof(GLuint);
-            _glfn->BufferData(GL_ELEMENT_ARRAY_BUFFER, sz, this->indices.data(), GL_STATIC_DRAW);
-            this->setupVBO (this->vbos[this->posnVBO], this->vertexPositions, visgl::posnLoc);
-            this->setupVBO (this->vbos[this->normVBO], this->vertexNormals, visgl::normLoc);
-            this->setupVBO (this->vbos[this->colVBO], this->vertexColors, visgl::colLoc);
+            this->setupIndices();
+            this->setupVertexVBOs();
 
             _glfn->BindVertexArray(0);                                // carefully unbind and rebind
-            morph::gl::Util::checkError (__FILE__, __LINE__, _glfn);  // carefully unbind and rebind
+            if constexpr (morph::visgl::debug_gl) { morph::gl::Util::checkError (__FILE__, __LINE__, _glfn); }
+            this->dirty_vbos.reset();
+            this->parent_dirty();
         }
 
         //! reinit ONLY vertexColors buffer
@@ -142,9 +139,50 @@ namespace morph {
             GladGLContext* _glfn = this->get_glfn(this->parentVis);
             // Now re-set up the VBOs
             _glfn->BindVertexArray (this->vao);  // carefully unbind and rebind
-            this->setupVBO (this->vbos[this->colVBO], this->vertexColors, visgl::colLoc);
+            if (this->vertex_format == morph::visgl::vertex_format::packed) {
+                this->setupPackedVBO(); // The colours are interleaved with the other attributes
+            } else {
+                this->setupVBO (this->colVBO, this->vertexColors, visgl::colLoc);
+            }
             _glfn->BindVertexArray(0);  // carefully unbind and rebind
-            morph::gl::Util::checkError (__FILE__, __LINE__, _glfn);
+            if constexpr (morph::visgl::debug_gl) { morph::gl::Util::checkError (__FILE__, __LINE__, _glfn); }
+            this->dirty_vbos.reset (this->colVBO);
+            this->parent_dirty();
+        }
+
+        /*!
+         * Copy to the GPU only those buffers marked with set_dirty(). Usually called after a
+         * VisualModel has updated some of its vertex attributes in place (see
+         * VisualDataModel::updateAttributes).
+         */
+        void reinit_dirty_buffers() final
+        {
+            if (!this->dirty_vbos) { return; }
+            if (this->setContext != nullptr) { this->setContext (this->parentVis); }
+            // postVertexInit() copies all the buffers (and resets dirty_vbos)
+            if (this->postVertexInitRequired == true) { this->postVertexInit(); return; }
+            GladGLContext* _glfn = this->get_glfn(this->parentVis);
+            _glfn->BindVertexArray (this->vao);
+            const bool packed = this->vertex_format == morph::visgl::vertex_format::packed;
+            // In the packed format, the index type depends on the number of vertices
+            const bool idx16 = this->vertexPositions.size() / 3 <= this->packed_index_limit;
+            if (this->dirty_vbos.test (this->idxVBO) || (packed && (this->index_type == GL_UNSIGNED_SHORT) != idx16)) {
+                this->setupIndices();
+            }
+            if (packed) {
+                if (this->dirty_vbos.test (this->posnVBO) || this->dirty_vbos.test (this->normVBO)
+                    || this->dirty_vbos.test (this->colVBO)) {
+                    this->setupPackedVBO();
+                }
+            } else {
+                if (this->dirty_vbos.test (this->posnVBO)) { this->setupVBO (this->posnVBO, this->vertexPositions, visgl::posnLoc); }
+                if (this->dirty_vbos.test (this->normVBO)) { this->setupVBO (this->normVBO, this->vertexNormals, visgl::normLoc); }
+                if (this->dirty_vbos.test (this->colVBO)) { this->setupVBO (this->colVBO, this->vertexColors, visgl::colLoc); }
+            }
+            _glfn->BindVertexArray(0);
+            if constexpr (morph::visgl::debug_gl) { morph::gl::Util::checkError (__FILE__, __LINE__, _glfn); }
+            this->dirty_vbos.reset();
+            this->parent_dirty();
         }
 
         void clearTexts() { this->texts.clear(); }
@@ -159,12 +197,12 @@ namespace morph {
             // Execute post-vertex init at render, as GL should be available.
             if (this->postVertexInitRequired == true) { this->postVertexInit(); }
 
-            GLint prev_shader = 0;
-
+            // The Visual looked up the uniform locations when it loaded its shader programs. Its
+            // graphics program is left in use afterwards, so there is no need to query and
+            // restore the current program (GetIntegerv can make the CPU wait for the GL).
             GladGLContext* _glfn = this->get_glfn (this->parentVis);
-            _glfn->GetIntegerv (GL_CURRENT_PROGRAM, &prev_shader);
-            // Ensure the correct program is in play for this VisualModel
-            _glfn->UseProgram (this->get_gprog(this->parentVis));
+            const morph::visgl::visual_shaderprogs progs = this->get_shaderprogs (this->parentVis);
+            _glfn->UseProgram (progs.gprog);
 
             if (!this->indices.empty()) {
                 // It is only necessary to bind the vertex array object before rendering
@@ -172,15 +210,19 @@ namespace morph {
                 _glfn->BindVertexArray (this->vao);
 
                 // Pass this->float to GLSL so the model can have an alpha value.
-                GLint loc_a = _glfn->GetUniformLocation (this->get_gprog(this->parentVis), static_cast<const GLchar*>("alpha"));
-                if (loc_a != -1) { _glfn->Uniform1f (loc_a, this->alpha); }
+                if (progs.gloc.alpha != -1) { _glfn->Uniform1f (progs.gloc.alpha, this->alpha); }
 
-                GLint loc_v = _glfn->GetUniformLocation (this->get_gprog(this->parentVis), static_cast<const GLchar*>("v_matrix"));
-                if (loc_v != -1) { _glfn->UniformMatrix4fv (loc_v, 1, GL_FALSE, this->scenematrix.mat.data()); }
+                if (progs.gloc.v_matrix != -1) { _glfn->UniformMatrix4fv (progs.gloc.v_matrix, 1, GL_FALSE, this->scenematrix.mat.data()); }
 
                 // Should be able to apply scaling to the model matrix
-                GLint loc_m = _glfn->GetUniformLocation (this->get_gprog(this->parentVis), static_cast<const GLchar*>("m_matrix"));
-                if (loc_m != -1) { _glfn->UniformMatrix4fv (loc_m, 1, GL_FALSE, (this->model_scaling * this->viewmatrix).mat.data()); }
+                if (progs.gloc.m_matrix != -1) {
+                    _glfn->UniformMatrix4fv (progs.gloc.m_matrix, 1, GL_FALSE, (this->model_scaling * this->viewmatrix).mat.data());
+                }
+
+                // Tell the vertex shader whether the normals are octahedral-packed
+                if (progs.gloc.oct_normals != -1) {
+                    _glfn->Uniform1i (progs.gloc.oct_normals, this->vertex_format == morph::visgl::vertex_format::packed ? 1 : 0);
+                }
 
                 if constexpr (debug_render) {
                     std::cout << "VisualModel::render: scenematrix:\n" << this->scenematrix << std::endl;
@@ -188,19 +230,27 @@ namespace morph {
                 }
 
                 // Draw the triangles
-                _glfn->DrawElements (GL_TRIANGLES, static_cast<unsigned int>(this->indices.size()), GL_UNSIGNED_INT, 0);
+                if (this->draw_ranges.empty()) {
+                    _glfn->DrawElements (GL_TRIANGLES, static_cast<unsigned int>(this->indices.size()), this->index_type, 0);
+                } else {
+                    const std::size_t isz = this->index_type == GL_UNSIGNED_SHORT ? sizeof(std::uint16_t) : sizeof(GLuint);
+                    float ralpha = this->alpha;
+                    for (auto r : this->draw_ranges) {
+                        if (r.alpha != ralpha && progs.gloc.alpha != -1) { _glfn->Uniform1f (progs.gloc.alpha, r.alpha); }
+                        ralpha = r.alpha;
+                        _glfn->DrawElements (GL_TRIANGLES, static_cast<unsigned int>(r.count), this->index_type,
+                                             reinterpret_cast<const void*>(r.first * isz));
+                    }
+                }
 
                 // Unbind the VAO
                 _glfn->BindVertexArray(0);
             }
-            morph::gl::Util::checkError (__FILE__, __LINE__, _glfn);
+            if constexpr (morph::visgl::debug_gl) { morph::gl::Util::checkError (__FILE__, __LINE__, _glfn); }
 
-            // Now render any VisualTextModels
+            // Now render any VisualTextModels (which switch back to the graphics program when done)
             auto ti = this->texts.begin();
             while (ti != this->texts.end()) { (*ti)->render(); ti++; }
-
-            _glfn->UseProgram (prev_shader);
-            morph::gl::Util::checkError (__FILE__, __LINE__, _glfn);
         }
 
 
@@ -340,19 +390,89 @@ namespace morph {
         std::vector<std::unique_ptr<morph::VisualTextModel<glver>>> texts;
 
         //! Set up a vertex buffer object - bind, buffer and set vertex array object attribute
-        void setupVBO (GLuint& buf, std::vector<float>& dat, unsigned int bufferAttribPosition) final
+        void setupVBO (const typename morph::VisualModelBase<glver>::VBOPos vbo, std::vector<float>& dat, unsigned int bufferAttribPosition) final
         {
-            std::size_t sz = dat.size() * sizeof(float);
-
             GladGLContext* _glfn = this->get_glfn(this->parentVis);
-            _glfn->BindBuffer (GL_ARRAY_BUFFER, buf);
-            morph::gl::Util::checkError (__FILE__, __LINE__, _glfn);
-            _glfn->BufferData (GL_ARRAY_BUFFER, sz, dat.data(), GL_STATIC_DRAW);
-            morph::gl::Util::checkError (__FILE__, __LINE__, _glfn);
+            _glfn->BindBuffer (GL_ARRAY_BUFFER, this->vbos[vbo]);
+            this->buffer_upload (GL_ARRAY_BUFFER, vbo, dat.size() * sizeof(float), dat.data());
             _glfn->VertexAttribPointer (bufferAttribPosition, 3, GL_FLOAT, GL_FALSE, 0, (void*)(0));
-            morph::gl::Util::checkError (__FILE__, __LINE__, _glfn);
             _glfn->EnableVertexAttribArray (bufferAttribPosition);
-            morph::gl::Util::checkError (__FILE__, __LINE__, _glfn);
+            if constexpr (morph::visgl::debug_gl) { morph::gl::Util::checkError (__FILE__, __LINE__, _glfn); }
+        }
+
+        //! Set up the index buffer with indices, as 16 bit indices if the packed vertex_format allows
+        void setupIndices()
+        {
+            GladGLContext* _glfn = this->get_glfn(this->parentVis);
+            _glfn->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, this->vbos[this->idxVBO]);
+            this->index_type = GL_UNSIGNED_INT;
+            if (this->vertex_format == morph::visgl::vertex_format::packed) { this->index_type = this->pack_indices(); }
+            if (this->index_type == GL_UNSIGNED_SHORT) {
+                this->buffer_upload (GL_ELEMENT_ARRAY_BUFFER, this->idxVBO, this->packed_indices.size() * sizeof(std::uint16_t), this->packed_indices.data());
+            } else {
+                this->buffer_upload (GL_ELEMENT_ARRAY_BUFFER, this->idxVBO, this->indices.size() * sizeof(GLuint), this->indices.data());
+            }
+        }
+
+        //! Set up the position, normal and colour attributes in the model's vertex_format
+        void setupVertexVBOs()
+        {
+            if (this->vertex_format == morph::visgl::vertex_format::packed) {
+                this->setupPackedVBO();
+            } else {
+                this->setupVBO (this->posnVBO, this->vertexPositions, visgl::posnLoc);
+                this->setupVBO (this->normVBO, this->vertexNormals, visgl::normLoc);
+                this->setupVBO (this->colVBO, this->vertexColors, visgl::colLoc);
+            }
+        }
+
+        /*!
+         * Pack the vertices and upload them into the posnVBO buffer, then point the position,
+         * normal and colour attributes at their offsets within each packed_vertex.
+         */
+        void setupPackedVBO()
+        {
+            GladGLContext* _glfn = this->get_glfn(this->parentVis);
+            this->pack_vertices();
+            _glfn->BindBuffer (GL_ARRAY_BUFFER, this->vbos[this->posnVBO]);
+            this->buffer_upload (GL_ARRAY_BUFFER, this->posnVBO,
+                                 this->packed_vertices.size() * sizeof(morph::visgl::packed_vertex), this->packed_vertices.data());
+            constexpr GLsizei stride = sizeof(morph::visgl::packed_vertex);
+            _glfn->VertexAttribPointer (visgl::posnLoc, 3, GL_FLOAT, GL_FALSE, stride, (void*)(offsetof(morph::visgl::packed_vertex, position)));
+            _glfn->VertexAttribPointer (visgl::normLoc, 2, GL_SHORT, GL_TRUE, stride, (void*)(offsetof(morph::visgl::packed_vertex, normal)));
+            _glfn->VertexAttribPointer (visgl::colLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)(offsetof(morph::visgl::packed_vertex, colour)));
+            _glfn->EnableVertexAttribArray (visgl::posnLoc);
+            _glfn->EnableVertexAttribArray (visgl::normLoc);
+            _glfn->EnableVertexAttribArray (visgl::colLoc);
+            if constexpr (morph::visgl::debug_gl) { morph::gl::Util::checkError (__FILE__, __LINE__, _glfn); }
+        }
+
+        /*!
+         * Copy sz bytes from dat into the buffer bound to target, which is this->vbos[vbo]. The
+         * buffer only grows; if it is already big enough, it keeps its capacity and dat is written
+         * with glBufferSubData. A buffer is first allocated as GL_STATIC_DRAW. The first time it is
+         * updated it is reallocated (once) as GL_DYNAMIC_DRAW, as it will probably be updated
+         * again. After that, the old storage is only orphaned before an update if
+         * orphan_on_update is set.
+         */
+        void buffer_upload (const GLenum target, const typename morph::VisualModelBase<glver>::VBOPos vbo,
+                            const std::size_t sz, const void* dat)
+        {
+            GladGLContext* _glfn = this->get_glfn(this->parentVis);
+            if (sz > this->vbo_capacity[vbo]) {
+                // A buffer that has to grow after it was first set up is being updated
+                if (this->vbo_capacity[vbo] > 0) { this->vbo_dynamic[vbo] = true; }
+                _glfn->BufferData (target, sz, dat, this->vbo_dynamic[vbo] ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+                this->vbo_capacity[vbo] = sz;
+            } else if (sz > 0) {
+                // On the first update, re-specify the storage as dynamic
+                if (!this->vbo_dynamic[vbo] || this->orphan_on_update) {
+                    _glfn->BufferData (target, this->vbo_capacity[vbo], nullptr, GL_DYNAMIC_DRAW);
+                    this->vbo_dynamic[vbo] = true;
+                }
+                _glfn->BufferSubData (target, 0, sz, dat);
+            }
+            if constexpr (morph::visgl::debug_gl) { morph::gl::Util::checkError (__FILE__, __LINE__, _glfn); }
         }
     };
 
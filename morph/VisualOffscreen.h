@@ -0,0 +1,208 @@
+/*!
+ * \file
+ *
+ * A headless morph::Visual. This derives from morph::VisualOwnableMX and, instead of opening a GLFW
+ * window, creates an EGL context with no surface and renders into a framebuffer object of the
+ * requested size. Use it to make figures on a machine with no display (a cluster node, a CI runner
+ * or over ssh) with exactly the same VisualModel code that you would use with morph::Visual.
+ * saveImage() and startCapture() work as they do for a windowed Visual.
+ *
+ * Because each VisualOffscreen has its own context (and each context has its own GLAD function
+ * table) you can create and render several of them in parallel, one per thread. Without a GPU,
+ * Mesa's llvmpipe software renderer is used.
+ *
+ * Include this header *instead* of morph/Visual.h. As with the Qt and wx Visuals, morph::win_t is
+ * defined here, so you can't also include morph/Visual.h in the same translation unit.
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+#pragma once
+
+#include <morph/VisualEgl.h>
+
+namespace morph {
+    // An offscreen Visual's 'window' is just its EGL context
+    using win_t = morph::egl_context;
+}
+
+#include <morph/VisualOwnableMX.h>
+
+namespace morph {
+
+    /*!
+     * Offscreen Visual scene class
+     *
+     * Renders a scene into a colour + depth framebuffer object of size width x height in an EGL
+     * context that has no window. There are no mouse or keyboard events. Call render() to draw the
+     * scene, then saveImage() to write it to a PNG file (or use startCapture() to record a
+     * sequence of frames).
+     *
+     * \tparam glver The OpenGL version, encoded as a single int (see morph::gl::version)
+     */
+    template <int glver = morph::gl::version_4_1>
+    class VisualOffscreen : public morph::VisualOwnableMX<glver>
+    {
+    public:
+        /*!
+         * Construct a new offscreen visualiser with a new OpenGL context. The context is not
+         * current on return, so you can construct in one thread and render in another.
+         */
+        VisualOffscreen (const int _width, const int _height, const std::string& _title = "morph::VisualOffscreen",
+                         const bool _version_stdout = false)
+        {
+            this->window_w = _width;
+            this->window_h = _height;
+            this->title = _title;
+            this->options.set (visual_options::versionStdout, _version_stdout);
+
+            this->init_resources();
+            this->init_gl();
+
+            // Special tasks: re-bind coordArrows and title text
+            this->bindextra (this->coordArrows);
+            this->bindextra (this->textModel);
+            this->releaseContext();
+        }
+
+        //! Deconstructor frees the framebuffer, deregisters access to VisualResources and destroys
+        //! the EGL context
+        ~VisualOffscreen()
+        {
+            this->setContext();
+            this->delete_framebuffer();
+            this->deconstructCommon();
+            this->releaseContext();
+            morph::VisualEgl<glver>::i().destroy_context (this->ectx.ctx);
+            this->ectx.ctx = EGL_NO_CONTEXT;
+            this->window = nullptr;
+        }
+
+        // Do one-time init of the Visual's resources. This creates the EGL context, loads the GL
+        // functions, creates the framebuffer and initializes the freetype code.
+        void init_resources()
+        {
+            this->ectx.ctx = morph::VisualEgl<glver>::i().create_context();
+            this->window = &this->ectx;
+            this->setContext();
+            this->init_glad (reinterpret_cast<GLADloadfunc>(eglGetProcAddress));
+            if (!this->glfn) { throw std::runtime_error ("VisualOffscreen: Failed to load GL functions"); }
+            this->create_framebuffer();
+            // VisualResources provides font management. Ensure it exists in memory.
+            morph::VisualResourcesMX<glver>::i().create();
+            this->freetype_init();
+        }
+
+        //! There's no display to synchronise with
+        void setSwapInterval() final {}
+
+        //! Make this Visual's context current on the calling thread. The framebuffer binding is
+        //! context state, so the FBO stays bound.
+        void setContext() final
+        {
+            if (this->ectx.ctx == EGL_NO_CONTEXT) { return; }
+            if (!morph::VisualEgl<glver>::i().make_current (this->ectx.ctx)) {
+                std::cerr << "VisualOffscreen: Failed to make EGL context current\n";
+            }
+        }
+
+        //! Release the context from the calling thread
+        void releaseContext() final { morph::VisualEgl<glver>::i().release_current(); }
+
+        //! No buffers to swap; just make sure the GL commands get issued.
+        void swapBuffers() final { this->glfn->Flush(); }
+
+        //! True if this Visual's context is current on the calling thread
+        bool checkContext()
+        {
+            return this->ectx.ctx == EGL_NO_CONTEXT ? false : (eglGetCurrentContext() == this->ectx.ctx);
+        }
+
+        //! The size of the framebuffer in pixels
+        int fb_width() const { return static_cast<int>(this->window_w * morph::retinaScale); }
+        int fb_height() const { return static_cast<int>(this->window_h * morph::retinaScale); }
+
+        //! Change the size of the offscreen framebuffer (and so of the images that you save).
+        void resize (const int _width, const int _height)
+        {
+            this->setContext();
+            this->window_w = _width;
+            this->window_h = _height;
+            this->delete_framebuffer();
+            this->create_framebuffer();
+            this->releaseContext();
+        }
+
+        /*!
+         * Set up the passed-in VisualModel (or indeed, VisualTextModel) with functions that need
+         * access to Visual attributes.
+         */
+        template <typename T>
+        void bindmodel (std::unique_ptr<T>& model)
+        {
+            morph::VisualBase<glver>::template bindmodel<T> (model); // base class binds
+            model->setContext = &morph::VisualBase<glver>::set_context;
+            model->releaseContext = &morph::VisualBase<glver>::release_context;
+            model->get_glfn = &morph::VisualOwnableMX<glver>::get_glfn;
+        }
+
+        template <typename T>
+        void bindextra (std::unique_ptr<T>& model)
+        {
+            model->setContext = &morph::VisualBase<glver>::set_context;
+            model->releaseContext = &morph::VisualBase<glver>::release_context;
+            model->markDirty = &morph::VisualBase<glver>::mark_dirty;
+            model->get_glfn = &morph::VisualOwnableMX<glver>::get_glfn;
+        }
+
+    private:
+        //! (Re)create the colour and depth renderbuffers at the current size and leave the
+        //! framebuffer bound. This framebuffer is the only one the context ever uses, so render(),
+        //! saveImage() and the capture readback all see it without knowing it's there.
+        void create_framebuffer()
+        {
+            const GLsizei w = this->fb_width();
+            const GLsizei h = this->fb_height();
+
+            this->glfn->GenFramebuffers (1, &this->fbo);
+            this->glfn->BindFramebuffer (GL_FRAMEBUFFER, this->fbo);
+
+            this->glfn->GenRenderbuffers (1, &this->rbo_colour);
+            this->glfn->BindRenderbuffer (GL_RENDERBUFFER, this->rbo_colour);
+            this->glfn->RenderbufferStorage (GL_RENDERBUFFER, GL_RGBA8, w, h);
+            this->glfn->FramebufferRenderbuffer (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, this->rbo_colour);
+
+            this->glfn->GenRenderbuffers (1, &this->rbo_depth);
+            this->glfn->BindRenderbuffer (GL_RENDERBUFFER, this->rbo_depth);
+            this->glfn->RenderbufferStorage (GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, w, h);
+            this->glfn->FramebufferRenderbuffer (GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, this->rbo_depth);
+
+            if (this->glfn->CheckFramebufferStatus (GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                throw std::runtime_error ("VisualOffscreen: Framebuffer is not complete");
+            }
+            this->glfn->BindRenderbuffer (GL_RENDERBUFFER, 0);
+            morph::gl::Util::checkError (__FILE__, __LINE__, this->glfn);
+        }
+
+        void delete_framebuffer()
+        {
+            if (this->fbo) {
+                this->glfn->BindFramebuffer (GL_FRAMEBUFFER, 0);
+                this->glfn->DeleteFramebuffers (1, &this->fbo);
+                this->fbo = 0;
+            }
+            if (this->rbo_colour) { this->glfn->DeleteRenderbuffers (1, &this->rbo_colour); }
+            if (this->rbo_depth) { this->glfn->DeleteRenderbuffers (1, &this->rbo_depth); }
+            this->rbo_colour = 0;
+            this->rbo_depth = 0;
+        }
+
+        //! The EGL context, which this->window points to
+        morph::egl_context ectx;
+        //! The framebuffer object and its colour and depth/stencil renderbuffers
+        GLuint fbo = 0;
+        GLuint rbo_colour = 0;
+        GLuint rbo_depth = 0;
+    };
+
+} // namespace morph
@@ -31,6 +31,7 @@ namespace morph { namespace gl { static constexpr int multicontext = 1; } }
 #include <morph/VisualResourcesMX.h>
 #include <morph/VisualTextModel.h>
 #include <morph/VisualBase.h>
+#include <morph/VisualCapture.h>
 #include <morph/gl/loadshaders_mx.h>
 
 namespace morph {
@@ -72,6 +73,7 @@ namespace morph {
         //! Deconstruct gl memory/context
         void deconstructCommon()
         {
+            this->stopCapture();
             // Explicitly deconstruct any owned VisualModels
             this->vm.clear();
             // Explicitly deconstruct coordArrows, textModel and texts here
@@ -88,6 +90,10 @@ namespace morph {
                 this->glfn->DeleteProgram (this->shaders.tprog);
                 this->shaders.tprog = 0;
             }
+            if (this->frame_ubo) {
+                this->glfn->DeleteBuffers (1, &this->frame_ubo);
+                this->frame_ubo = 0;
+            }
             this->free_gladgl_context (this->glfn);
 
             // Free up the Fonts associated with this morph::Visual
@@ -140,19 +146,8 @@ namespace morph {
             this->glfn->PixelStorei (GL_PACK_SKIP_PIXELS, 0);
             this->glfn->ReadPixels (0, 0, dims[0], dims[1], GL_RGBA, GL_UNSIGNED_BYTE, bits.get());
 
-            for (int i = 0; i < dims[1]; ++i) {
-                int rev_line = (dims[1] - i - 1) * 4 * dims[0];
-                int for_line = i * 4 * dims[0];
-                if (transparent_bg) {
-                    for (int j = 0; j < 4 * dims[0]; ++j) {
-                        rbits[rev_line + j] = bits[for_line + j];
-                    }
-                } else {
-                    for (int j = 0; j < 4 * dims[0]; ++j) {
-                        rbits[rev_line + j] = (j % 4 == 3) ? 255 : bits[for_line + j];
-                    }
-                }
-            }
+            morph::VisualCapture::flip_rows (bits.get(), rbits.get(), dims[0], dims[1], transparent_bg);
+
             unsigned int error = lodepng::encode (img_filename, rbits.get(), dims[0], dims[1]);
             if (error) {
                 std::cerr << "encoder error " << error << ": " << lodepng_error_text (error) << std::endl;
@@ -162,21 +157,80 @@ namespace morph {
             return dims;
         }
 
+        /*!
+         * Start asynchronous capture of every subsequently rendered frame. Frames are read back
+         * through a ring of pixel buffer objects so that render() does not wait on the GPU, and are
+         * flipped and encoded on worker threads by a morph::VisualCapture. See VisualCapture.h for
+         * the output options. Call stopCapture() to flush all frames to their output.
+         */
+        void startCapture (const morph::capture_options& opts)
+        {
+            this->stopCapture();
+            this->setContext();
+            this->capture_w = static_cast<int>(this->window_w * morph::retinaScale);
+            this->capture_h = static_cast<int>(this->window_h * morph::retinaScale);
+            this->capture = std::make_unique<morph::VisualCapture> (opts, this->capture_w, this->capture_h);
+
+            const GLsizeiptr nbytes = static_cast<GLsizeiptr>(this->capture_w) * this->capture_h * 4;
+            const unsigned int npbo = opts.num_pbos > 0 ? opts.num_pbos : 1;
+            this->capture_pbos.assign (npbo, 0);
+            this->capture_fences.assign (npbo, nullptr);
+            this->glfn->GenBuffers (npbo, this->capture_pbos.data());
+            for (auto pbo : this->capture_pbos) {
+                this->glfn->BindBuffer (GL_PIXEL_PACK_BUFFER, pbo);
+                this->glfn->BufferData (GL_PIXEL_PACK_BUFFER, nbytes, nullptr, GL_STREAM_READ);
+            }
+            this->glfn->BindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+            this->capture_head = 0;
+            this->capture_inflight = 0;
+            morph::gl::Util::checkError (__FILE__, __LINE__, this->glfn);
+        }
+
+        //! Finish capturing. Frames still in the PBO ring are read back and all frames are written.
+        void stopCapture()
+        {
+            if (!this->capture) { return; }
+            this->setContext();
+            const unsigned int npbo = this->capture_pbos.size();
+            // Retire in-flight frames oldest first
+            while (this->capture_inflight > 0) {
+                unsigned int oldest = (this->capture_head + npbo - this->capture_inflight) % npbo;
+                this->capture_retire (oldest);
+            }
+            this->glfn->DeleteBuffers (npbo, this->capture_pbos.data());
+            this->capture_pbos.clear();
+            this->capture_fences.clear();
+            this->capture->finish();
+            this->capture.reset (nullptr);
+        }
+
+        //! True while a capture is in progress
+        bool capturing() const { return this->capture != nullptr; }
+
+        //! The number of frames written out by the current capture
+        std::uint64_t captureFramesWritten() const { return this->capture ? this->capture->frames_written() : 0; }
+
         //! Render the scene
         void render() noexcept final
         {
+            // Skip the frame if the scene is unchanged or the frame rate limit says it's too soon.
+            // The last frame stays on display.
+            if (!this->capturing() && !this->frame_due()) { return; }
+
             this->setContext();
 
             if (this->ptype == perspective_type::orthographic || this->ptype == perspective_type::perspective) {
                 if (this->active_gprog != morph::visgl::graphics_shader_type::projection2d) {
                     if (this->shaders.gprog) { this->glfn->DeleteProgram (this->shaders.gprog); }
                     this->shaders.gprog = morph::gl::LoadShadersMX (this->proj2d_shader_progs, this->glfn);
+                    this->shaders.gloc = this->get_uniform_locations (this->shaders.gprog);
                     this->active_gprog = morph::visgl::graphics_shader_type::projection2d;
                 }
             } else if (this->ptype == perspective_type::cylindrical) {
                 if (this->active_gprog != morph::visgl::graphics_shader_type::cylindrical) {
                     if (this->shaders.gprog) { this->glfn->DeleteProgram (this->shaders.gprog); }
                     this->shaders.gprog = morph::gl::LoadShadersMX (this->cyl_shader_progs, this->glfn);
+                    this->shaders.gloc = this->get_uniform_locations (this->shaders.gprog);
                     this->active_gprog = morph::visgl::graphics_shader_type::cylindrical;
                 }
             }
@@ -191,12 +245,10 @@ namespace morph {
                 this->setPerspective();
             } else if (this->ptype == perspective_type::cylindrical) {
                 // Set cylindrical-specific uniforms
-                GLint loc_campos = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("cyl_cam_pos"));
-                if (loc_campos != -1) { this->glfn->Uniform4fv (loc_campos, 1, this->cyl_cam_pos.data()); }
-                GLint loc_cyl_radius = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("cyl_radius"));
-                if (loc_cyl_radius != -1) { this->glfn->Uniform1f (loc_cyl_radius, this->cyl_radius); }
-                GLint loc_cyl_height = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("cyl_height"));
-                if (loc_cyl_height != -1) { this->glfn->Uniform1f (loc_cyl_height, this->cyl_height); }
+                const morph::visgl::uniform_locations& gloc = this->shaders.gloc;
+                if (gloc.cyl_cam_pos != -1) { this->glfn->Uniform4fv (gloc.cyl_cam_pos, 1, this->cyl_cam_pos.data()); }
+                if (gloc.cyl_radius != -1) { this->glfn->Uniform1f (gloc.cyl_radius, this->cyl_radius); }
+                if (gloc.cyl_height != -1) { this->glfn->Uniform1f (gloc.cyl_height, this->cyl_height); }
             } else {
                 // unknown projection
                 return;
@@ -217,32 +269,31 @@ namespace morph {
             // Set the background colour:
             this->glfn->ClearBufferfv (GL_COLOR, 0, this->bgcolour.data());
 
-            // Lighting shader variables
-            //
-            // Ambient light colour
-            GLint loc_lightcol = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("light_colour"));
-            if (loc_lightcol != -1) { this->glfn->Uniform3fv (loc_lightcol, 1, this->light_colour.data()); }
-            // Ambient light intensity
-            GLint loc_ai = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("ambient_intensity"));
-            if (loc_ai != -1) { this->glfn->Uniform1f (loc_ai, this->ambient_intensity); }
-            // Diffuse light position
-            GLint loc_dp = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("diffuse_position"));
-            if (loc_dp != -1) { this->glfn->Uniform3fv (loc_dp, 1, this->diffuse_position.data()); }
-            // Diffuse light intensity
-            GLint loc_di = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("diffuse_intensity"));
-            if (loc_di != -1) { this->glfn->Uniform1f (loc_di, this->diffuse_intensity); }
-
-            // Switch to text shader program and set the projection matrix
-            this->glfn->UseProgram (this->shaders.tprog);
-            GLint loc_p = this->glfn->GetUniformLocation (this->shaders.tprog, static_cast<const GLchar*>("p_matrix"));
-            if (loc_p != -1) { this->glfn->UniformMatrix4fv (loc_p, 1, GL_FALSE, this->projection.mat.data()); }
-
-            // Switch back to the regular shader prog and render the VisualModels.
-            this->glfn->UseProgram (this->shaders.gprog);
-
-            // Set the projection matrix just once
-            loc_p = this->glfn->GetUniformLocation (this->shaders.gprog, static_cast<const GLchar*>("p_matrix"));
-            if (loc_p != -1) { this->glfn->UniformMatrix4fv (loc_p, 1, GL_FALSE, this->projection.mat.data()); }
+            // The projection and lighting are the same for every model, so they go in the
+            // morph_frame uniform block, which all the shader programs share, once per frame.
+            morph::visgl::frame_uniforms fu;
+            std::copy (this->projection.mat.begin(), this->projection.mat.end(), fu.p_matrix);
+            std::copy (this->light_colour.begin(), this->light_colour.end(), fu.light_colour);
+            fu.ambient_intensity = this->ambient_intensity;
+            std::copy (this->diffuse_position.begin(), this->diffuse_position.end(), fu.diffuse_position);
+            fu.diffuse_intensity = this->diffuse_intensity;
+            this->glfn->BindBuffer (GL_UNIFORM_BUFFER, this->frame_ubo);
+            this->glfn->BufferSubData (GL_UNIFORM_BUFFER, 0, sizeof(fu), &fu);
+            this->glfn->BindBufferBase (GL_UNIFORM_BUFFER, morph::visgl::frame_block_binding, this->frame_ubo);
+            this->glfn->BindBuffer (GL_UNIFORM_BUFFER, 0);
+
+            // Shader programs loaded from files may declare these as ordinary uniforms instead
+            const morph::visgl::uniform_locations& gloc = this->shaders.gloc;
+            if (gloc.light_colour != -1) { this->glfn->Uniform3fv (gloc.light_colour, 1, this->light_colour.data()); }
+            if (gloc.ambient_intensity != -1) { this->glfn->Uniform1f (gloc.ambient_intensity, this->ambient_intensity); }
+            if (gloc.diffuse_position != -1) { this->glfn->Uniform3fv (gloc.diffuse_position, 1, this->diffuse_position.data()); }
+            if (gloc.diffuse_intensity != -1) { this->glfn->Uniform1f (gloc.diffuse_intensity, this->diffuse_intensity); }
+            if (gloc.p_matrix != -1) { this->glfn->UniformMatrix4fv (gloc.p_matrix, 1, GL_FALSE, this->projection.mat.data()); }
+            if (this->shaders.tloc.p_matrix != -1) {
+                this->glfn->UseProgram (this->shaders.tprog);
+                this->glfn->UniformMatrix4fv (this->shaders.tloc.p_matrix, 1, GL_FALSE, this->projection.mat.data());
+                this->glfn->UseProgram (this->shaders.gprog);
+            }
 
             if ((this->ptype == perspective_type::orthographic || this->ptype == perspective_type::perspective)
                 && this->options.test(visual_options::showCoordArrows)) {
@@ -289,7 +340,10 @@ namespace morph {
                 ++ti;
             }
 
+            if (this->capture) { this->capture_readback(); }
+
             this->swapBuffers();
+            this->frame_done();
         }
 
         //! Glad MX specific callback
@@ -334,6 +388,7 @@ namespace morph {
             model->get_shaderprogs = &morph::VisualBase<glver>::get_shaderprogs;
             model->get_gprog = &morph::VisualBase<glver>::get_gprog;
             model->get_tprog = &morph::VisualBase<glver>::get_tprog;
+            model->markDirty = &morph::VisualBase<glver>::mark_dirty;
             model->get_glfn = &morph::VisualOwnableMX<glver>::get_glfn;
         }
 
@@ -424,6 +479,14 @@ namespace morph {
                 {GL_FRAGMENT_SHADER, "VisText.frag.glsl" , morph::getDefaultTextFragShader(glver), 0 }
             };
             this->shaders.tprog = morph::gl::LoadShadersMX (this->text_shader_progs, this->glfn);
+            this->shaders.gloc = this->get_uniform_locations (this->shaders.gprog);
+            this->shaders.tloc = this->get_uniform_locations (this->shaders.tprog);
+
+            // The uniform buffer for the morph_frame block
+            this->glfn->GenBuffers (1, &this->frame_ubo);
+            this->glfn->BindBuffer (GL_UNIFORM_BUFFER, this->frame_ubo);
+            this->glfn->BufferData (GL_UNIFORM_BUFFER, sizeof(morph::visgl::frame_uniforms), nullptr, GL_DYNAMIC_DRAW);
+            this->glfn->BindBuffer (GL_UNIFORM_BUFFER, 0);
 
             // OpenGL options
             this->glfn->Enable (GL_DEPTH_TEST);
@@ -475,6 +538,112 @@ namespace morph {
             this->releaseContext();
         }
 
+        /*!
+         * Look up the locations of the uniforms in the shader program prog, and bind its
+         * morph_frame uniform block (if it declares one) to the frame uniform buffer.
+         */
+        morph::visgl::uniform_locations get_uniform_locations (const GLuint prog)
+        {
+            morph::visgl::uniform_locations loc;
+            if (prog == 0) { return loc; }
+            auto getloc = [this, prog](const char* name) { return this->glfn->GetUniformLocation (prog, static_cast<const GLchar*>(name)); };
+            loc.alpha = getloc ("alpha");
+            loc.v_matrix = getloc ("v_matrix");
+            loc.m_matrix = getloc ("m_matrix");
+            loc.p_matrix = getloc ("p_matrix");
+            loc.light_colour = getloc ("light_colour");
+            loc.ambient_intensity = getloc ("ambient_intensity");
+            loc.diffuse_position = getloc ("diffuse_position");
+            loc.diffuse_intensity = getloc ("diffuse_intensity");
+            loc.cyl_cam_pos = getloc ("cyl_cam_pos");
+            loc.cyl_radius = getloc ("cyl_radius");
+            loc.cyl_height = getloc ("cyl_height");
+            loc.textColor = getloc ("textColor");
+            loc.oct_normals = getloc ("oct_normals");
+            GLuint blk = this->glfn->GetUniformBlockIndex (prog, static_cast<const GLchar*>("morph_frame"));
+            if (blk != GL_INVALID_INDEX) { this->glfn->UniformBlockBinding (prog, blk, morph::visgl::frame_block_binding); }
+            return loc;
+        }
+
+        //! Issue an asynchronous read of the back buffer into the next PBO of the ring. If that PBO
+        //! still holds an earlier frame, retire it first (by then its transfer is usually done).
+        void capture_readback()
+        {
+            const unsigned int npbo = this->capture_pbos.size();
+            const int cur_w = static_cast<int>(this->window_w * morph::retinaScale);
+            const int cur_h = static_cast<int>(this->window_h * morph::retinaScale);
+            if (cur_w != this->capture_w || cur_h != this->capture_h) {
+                std::cerr << "Window size changed during capture; frame not captured\n";
+                return;
+            }
+            if (this->capture_inflight == npbo) { this->capture_retire (this->capture_head); }
+
+            this->glfn->PixelStorei (GL_PACK_ALIGNMENT, 1);
+            this->glfn->PixelStorei (GL_PACK_ROW_LENGTH, 0);
+            this->glfn->PixelStorei (GL_PACK_SKIP_ROWS, 0);
+            this->glfn->PixelStorei (GL_PACK_SKIP_PIXELS, 0);
+            this->glfn->BindBuffer (GL_PIXEL_PACK_BUFFER, this->capture_pbos[this->capture_head]);
+            this->glfn->ReadPixels (0, 0, this->capture_w, this->capture_h, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            this->capture_fences[this->capture_head] = this->glfn->FenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            this->glfn->BindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+
+            this->capture_head = (this->capture_head + 1) % npbo;
+            ++this->capture_inflight;
+        }
+
+        /*!
+         * Wait for the PBO at ring index i, copy its pixels into a VisualCapture buffer and submit. If
+         * the readback doesn't complete, or the PBO can't be mapped, the frame is skipped (with a
+         * warning) and its buffer is released unused, rather than passing on unfilled pixels.
+         */
+        void capture_retire (const unsigned int i)
+        {
+            // Acquire first; this applies back pressure if the encoders fall behind
+            unsigned int buf = this->capture->acquire();
+            GLenum wait = this->glfn->ClientWaitSync (this->capture_fences[i], GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64{1000000000});
+            this->glfn->DeleteSync (this->capture_fences[i]);
+            this->capture_fences[i] = nullptr;
+            --this->capture_inflight;
+            if (wait == GL_TIMEOUT_EXPIRED || wait == GL_WAIT_FAILED) {
+                std::cerr << "Frame capture: readback " << (wait == GL_WAIT_FAILED ? "failed" : "timed out") << "; frame skipped\n";
+                this->capture->release (buf);
+                return;
+            }
+            const std::size_t nbytes = static_cast<std::size_t>(this->capture_w) * this->capture_h * 4;
+            this->glfn->BindBuffer (GL_PIXEL_PACK_BUFFER, this->capture_pbos[i]);
+            void* p = this->glfn->MapBufferRange (GL_PIXEL_PACK_BUFFER, 0, nbytes, GL_MAP_READ_BIT);
+            bool ok = p != nullptr;
+            if (ok) {
+                std::memcpy (this->capture->pixels (buf), p, nbytes);
+                // GL_FALSE means the buffer's contents were corrupted while it was mapped
+                ok = this->glfn->UnmapBuffer (GL_PIXEL_PACK_BUFFER) == GL_TRUE;
+            }
+            this->glfn->BindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+            if (!ok) {
+                std::cerr << "Frame capture: could not read the pixel buffer; frame skipped\n";
+                this->capture->release (buf);
+                return;
+            }
+            this->capture->submit (buf);
+        }
+
+        //! The uniform buffer holding the morph_frame uniform block
+        GLuint frame_ubo = 0;
+
+        //! Encoder side of an active frame capture (nullptr if not capturing)
+        std::unique_ptr<morph::VisualCapture> capture;
+        //! The ring of pixel pack buffer objects used for asynchronous readback
+        std::vector<GLuint> capture_pbos;
+        //! One fence per PBO, signalled when its glReadPixels has completed
+        std::vector<GLsync> capture_fences;
+        //! Ring index of the next PBO to read into
+        unsigned int capture_head = 0;
+        //! Number of PBOs holding frames that have not yet been retired
+        unsigned int capture_inflight = 0;
+        //! Frame size of the active capture
+        int capture_w = 0;
+        int capture_h = 0;
+
         //! A VisualTextModel for a title text.
         std::unique_ptr<morph::VisualTextModel<glver>> textModel = nullptr;
         //! Text models for labels
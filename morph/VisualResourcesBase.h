@@ -15,6 +15,7 @@
 #include <set>
 #include <stdexcept>
 #include <memory>
+#include <mutex>
 #include <morph/gl/version.h>
 #include <morph/VisualFont.h>
 // FreeType for text rendering
@@ -45,6 +46,11 @@ namespace morph {
         //! FreeType library object
         std::map<morph::VisualBase<glver>*, FT_Library> freetypes;
 
+        //! Guards freetypes and faces, so that Visuals (each with their own context) may be
+        //! created, used and destroyed in separate threads. Recursive because freetype_deinit
+        //! calls clearVisualFaces.
+        std::recursive_mutex resources_mutex;
+
     public:
         VisualResourcesBase(const VisualResourcesBase<glver>&) = delete;
         VisualResourcesBase& operator=(const VisualResourcesBase<glver> &) = delete;
@@ -61,6 +67,7 @@ namespace morph {
         //! deinitialized.
         void freetype_deinit (morph::VisualBase<glver>* _vis)
         {
+            std::lock_guard<std::recursive_mutex> lk (this->resources_mutex);
             // First clear the faces associated with VisualBase<>* _vis
             this->clearVisualFaces (_vis);
             // Second, clean up the FreeType library instance and erase from this->freetypes
@@ -47,6 +47,7 @@ namespace morph {
         //! assumption that I'd only need one FT_Library.
         void freetype_init (morph::VisualBase<glver>* _vis, GladGLContext* glfn = nullptr)
         {
+            std::lock_guard<std::recursive_mutex> lk (this->resources_mutex);
             FT_Library freetype = nullptr;
             try {
                 freetype = this->freetypes.at (_vis);
@@ -81,6 +82,7 @@ namespace morph {
                                                    morph::VisualBase<glver>* _vis, GladGLContext* glfn)
         {
             morph::visgl::VisualFaceMX* rtn = nullptr;
+            std::lock_guard<std::recursive_mutex> lk (this->resources_mutex);
             auto key = std::make_tuple(font, fontpixels, _vis);
             try {
                 rtn = this->faces.at(key).get();
@@ -100,6 +102,7 @@ namespace morph {
         //! Loop through this->faces clearing out those associated with the given morph::Visual
         void clearVisualFaces (morph::VisualBase<glver>* _vis) final
         {
+            std::lock_guard<std::recursive_mutex> lk (this->resources_mutex);
             auto f = this->faces.begin();
             while (f != this->faces.end()) {
                 // f->first is a key. If its third, Visual<>* element == _vis, then delete and erase
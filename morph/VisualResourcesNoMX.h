@@ -61,6 +61,7 @@ namespace morph {
         //! assumption that I'd only need one FT_Library.
         void freetype_init (morph::VisualBase<glver>* _vis)
         {
+            std::lock_guard<std::recursive_mutex> lk (this->resources_mutex);
             FT_Library freetype = nullptr;
             try {
                 freetype = this->freetypes.at (_vis);
@@ -83,6 +84,7 @@ namespace morph {
         morph::visgl::VisualFaceNoMX* getVisualFace (morph::VisualFont font, unsigned int fontpixels, morph::VisualBase<glver>* _vis)
         {
             morph::visgl::VisualFaceNoMX* rtn = nullptr;
+            std::lock_guard<std::recursive_mutex> lk (this->resources_mutex);
             auto key = std::make_tuple(font, fontpixels, _vis);
             try {
                 rtn = this->faces.at(key).get();
@@ -101,6 +103,7 @@ namespace morph {
         //! Loop through this->faces clearing out those associated with the given morph::Visual
         void clearVisualFaces (morph::VisualBase<glver>* _vis) final
         {
+            std::lock_guard<std::recursive_mutex> lk (this->resources_mutex);
             auto f = this->faces.begin();
             while (f != this->faces.end()) {
                 // f->first is a key. If its third, Visual<>* element == _vis, then delete and erase
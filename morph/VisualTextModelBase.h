@@ -245,6 +245,8 @@ namespace morph {
         std::function<void(morph::VisualBase<glver>*)> setContext;
         //! Release OpenGL context. Should call parentVis->releaseContext().
         std::function<void(morph::VisualBase<glver>*)> releaseContext;
+        //! Tell the parent that the scene has changed. Should call parentVis->markDirty().
+        std::function<void(morph::VisualBase<glver>*)> markDirty;
 
         //! Setter for the parent pointer, parentVis
         void set_parent (morph::VisualBase<glver>* _vis)
@@ -52,25 +52,20 @@ namespace morph {
         {
             if (this->hide == true) { return; }
 
-            GLint prev_shader;
-            GLuint tshaderprog = this->get_tprog (this->parentVis);
-
             auto _glfn = this->get_glfn (this->parentVis);
 
-            _glfn->GetIntegerv (GL_CURRENT_PROGRAM, &prev_shader);
+            // Uniform locations were looked up when the Visual loaded the text program
+            const morph::visgl::visual_shaderprogs progs = this->get_shaderprogs (this->parentVis);
+            const morph::visgl::uniform_locations& loc = progs.tloc;
 
             // Ensure the correct program is in play for this VisualModel
-            _glfn->UseProgram (tshaderprog);
+            _glfn->UseProgram (progs.tprog);
 
             // Set uniforms
-            GLint loc_tc = _glfn->GetUniformLocation (tshaderprog, static_cast<const GLchar*>("textColor"));
-            if (loc_tc != -1) { _glfn->Uniform3f (loc_tc, this->clr_text[0], this->clr_text[1], this->clr_text[2]); }
-            GLint loc_a = _glfn->GetUniformLocation (tshaderprog, static_cast<const GLchar*>("alpha"));
-            if (loc_a != -1) { _glfn->Uniform1f (loc_a, this->alpha); }
-            GLint loc_v = _glfn->GetUniformLocation (tshaderprog, static_cast<const GLchar*>("v_matrix"));
-            if (loc_v != -1) { _glfn->UniformMatrix4fv (loc_v, 1, GL_FALSE, this->scenematrix.mat.data()); }
-            GLint loc_m = _glfn->GetUniformLocation (tshaderprog, static_cast<const GLchar*>("m_matrix"));
-            if (loc_m != -1) { _glfn->UniformMatrix4fv (loc_m, 1, GL_FALSE, this->viewmatrix.mat.data()); }
+            if (loc.textColor != -1) { _glfn->Uniform3f (loc.textColor, this->clr_text[0], this->clr_text[1], this->clr_text[2]); }
+            if (loc.alpha != -1) { _glfn->Uniform1f (loc.alpha, this->alpha); }
+            if (loc.v_matrix != -1) { _glfn->UniformMatrix4fv (loc.v_matrix, 1, GL_FALSE, this->scenematrix.mat.data()); }
+            if (loc.m_matrix != -1) { _glfn->UniformMatrix4fv (loc.m_matrix, 1, GL_FALSE, this->viewmatrix.mat.data()); }
 
             _glfn->ActiveTexture (GL_TEXTURE0);
 
@@ -90,9 +85,10 @@ namespace morph {
             }
 
             _glfn->BindVertexArray(0);
-            _glfn->UseProgram (prev_shader);
+            // Text is rendered between the Visual's graphical models, so return to their program
+            _glfn->UseProgram (progs.gprog);
 
-            morph::gl::Util::checkError (__FILE__, __LINE__, _glfn);
+            if constexpr (morph::visgl::debug_gl) { morph::gl::Util::checkError (__FILE__, __LINE__, _glfn); }
         }
 
         //! Compute the geometry for a sample text.
@@ -288,6 +284,9 @@ namespace morph {
             // Possibly release (unbind) the vertex buffers, but have to unbind vertex
             // array object first.
             _glfn->BindVertexArray(0); // carefully unbind
+
+            // The text has changed, so the scene has to be drawn again
+            if (this->markDirty) { this->markDirty (this->parentVis); }
         }
 
     public:
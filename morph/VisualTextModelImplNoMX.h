@@ -51,23 +51,18 @@ namespace morph {
         {
             if (this->hide == true) { return; }
 
-            GLint prev_shader;
-            GLuint tshaderprog = this->get_tprog (this->parentVis);
-
-            glGetIntegerv (GL_CURRENT_PROGRAM, &prev_shader);
+            // Uniform locations were looked up when the Visual loaded the text program
+            const morph::visgl::visual_shaderprogs progs = this->get_shaderprogs (this->parentVis);
+            const morph::visgl::uniform_locations& loc = progs.tloc;
 
             // Ensure the correct program is in play for this VisualModel
-            glUseProgram (tshaderprog);
+            glUseProgram (progs.tprog);
 
             // Set uniforms
-            GLint loc_tc = glGetUniformLocation (tshaderprog, static_cast<const GLchar*>("textColor"));
-            if (loc_tc != -1) { glUniform3f (loc_tc, this->clr_text[0], this->clr_text[1], this->clr_text[2]); }
-            GLint loc_a = glGetUniformLocation (tshaderprog, static_cast<const GLchar*>("alpha"));
-            if (loc_a != -1) { glUniform1f (loc_a, this->alpha); }
-            GLint loc_v = glGetUniformLocation (tshaderprog, static_cast<const GLchar*>("v_matrix"));
-            if (loc_v != -1) { glUniformMatrix4fv (loc_v, 1, GL_FALSE, this->scenematrix.mat.data()); }
-            GLint loc_m = glGetUniformLocation (tshaderprog, static_cast<const GLchar*>("m_matrix"));
-            if (loc_m != -1) { glUniformMatrix4fv (loc_m, 1, GL_FALSE, this->viewmatrix.mat.data()); }
+            if (loc.textColor != -1) { glUniform3f (loc.textColor, this->clr_text[0], this->clr_text[1], this->clr_text[2]); }
+            if (loc.alpha != -1) { glUniform1f (loc.alpha, this->alpha); }
+            if (loc.v_matrix != -1) { glUniformMatrix4fv (loc.v_matrix, 1, GL_FALSE, this->scenematrix.mat.data()); }
+            if (loc.m_matrix != -1) { glUniformMatrix4fv (loc.m_matrix, 1, GL_FALSE, this->viewmatrix.mat.data()); }
 
             glActiveTexture (GL_TEXTURE0);
 
@@ -87,9 +82,10 @@ namespace morph {
             }
 
             glBindVertexArray(0);
-            glUseProgram (prev_shader);
+            // Text is rendered between the Visual's graphical models, so return to their program
+            glUseProgram (progs.gprog);
 
-            morph::gl::Util::checkError (__FILE__, __LINE__);
+            if constexpr (morph::visgl::debug_gl) { morph::gl::Util::checkError (__FILE__, __LINE__); }
         }
 
         //! Compute the geometry for a sample text.
@@ -279,6 +275,9 @@ namespace morph {
             this->setupVBO (this->vbos[this->textureVBO], this->vertexTextures, visgl::textureLoc);
 
             glBindVertexArray(0); // carefully unbind
+
+            // The text has changed, so the scene has to be drawn again
+            if (this->markDirty) { this->markDirty (this->parentVis); }
         }
 
         //! A face for this text. The face is specfied by tfeatures.font
@@ -347,7 +347,6 @@ namespace morph {
 
         void reinitColoursScalar()
         {
-            if (this->colourScale.do_autoscale == true) { this->colourScale.reset(); }
             this->dcolour.resize (this->scalarData->size());
             this->colourScale.transform (*(this->scalarData), dcolour);
 
@@ -365,17 +364,13 @@ namespace morph {
                 tcounts += this->triangle_counts[i];
             }
 
-            // Lastly, this call copies vertexColors (etc) into the OpenGL memory space
-            this->reinit_colour_buffer();
+            // Mark vertexColors to be copied into the OpenGL memory space
+            this->set_dirty (this->colVBO);
         }
 
-        //! Called by reinitColours when vectorData is not null (vectors are probably RGB colour)
+        //! Called by updateColours when vectorData is not null (vectors are probably RGB colour)
         void reinitColoursVector()
         {
-            if (this->colourScale.do_autoscale == true) { this->colourScale.reset(); }
-            if (this->colourScale2.do_autoscale == true) { this->colourScale.reset(); }
-            if (this->colourScale3.do_autoscale == true) { this->colourScale.reset(); }
-
             for (unsigned int i = 0; i < this->vectorData->size(); ++i) {
                 this->dcolour[i] = (*this->vectorData)[i][0];
                 this->dcolour2[i] = (*this->vectorData)[i][1];
@@ -401,11 +396,34 @@ namespace morph {
                 tcounts += this->triangle_counts[i];
             }
 
-            // Lastly, this call copies vertexColors (etc) into the OpenGL memory space
-            this->reinit_colour_buffer();
+            // Mark vertexColors to be copied into the OpenGL memory space
+            this->set_dirty (this->colVBO);
         }
 
         void reinitColours()
+        {
+            if (this->colourScale.do_autoscale == true) { this->colourScale.reset(); }
+            if (this->vectorData != nullptr) {
+                if (this->colourScale2.do_autoscale == true) { this->colourScale.reset(); }
+                if (this->colourScale3.do_autoscale == true) { this->colourScale.reset(); }
+            }
+            this->updateColours();
+            this->reinit_dirty_buffers();
+        }
+
+        //! If zScale is flat, updateData() only needs to change the colours of the cells
+        bool updateAttributes() override
+        {
+            if (!this->zScaleIsFlat() || this->dataCoords == nullptr) { return false; }
+            const std::size_t n = this->scalarData != nullptr ? this->scalarData->size()
+                                  : (this->vectorData != nullptr ? this->vectorData->size() : 0u);
+            if (n != this->dataCoords->size()) { return false; }
+            this->updateColours();
+            return true;
+        }
+
+        //! Recompute the cell colours in vertexColors from the data and mark them dirty
+        void updateColours()
         {
             if (this->vertexColors.size() < this->triangle_count_sum * 3) {
                 throw std::runtime_error ("vertexColors is not big enough to reinitColours()");
@@ -1,6 +1,12 @@
 /*
  * Compute statistics using the bootstrap method.
  *
+ * The statistics are computed by resample_statistics(), which streams the resamples: each one
+ * is drawn into a per-thread buffer, reduced to its statistic and discarded, so that memory use
+ * is O(N + B) rather than O(N B). Resamples are spread across threads with OpenMP. Resample i
+ * draws its indices from its own generator, seeded from the seed and i, so results are
+ * reproducible for a given seed, whatever the number of threads.
+ *
  * Author: Seb James
  * Date: July 2023
  */
@@ -8,6 +14,10 @@
 #pragma once
 
 #include <vector>
+#include <random>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
 #include <morph/vec.h>
 #include <morph/vvec.h>
 
@@ -18,61 +28,81 @@ namespace morph {
 
         static constexpr bool debug_bstrap = false;
 
-        // Resample B sets from data and place them in resamples
+        // Resample B sets from data and place them in resamples. This holds all B resamples in
+        // memory; to compute a statistic of the resamples, use resample_statistics() instead.
         static void resample_with_replacement (const morph::vvec<T>& data,
-                                               std::vector<morph::vvec<T>>& resamples, const unsigned int B)
+                                               std::vector<morph::vvec<T>>& resamples, const unsigned int B,
+                                               std::uint64_t seed = 0)
         {
-            unsigned int data_n = data.size();
+            seed = bootstrap<T>::make_seed (seed);
             resamples.resize (B);
             for (unsigned int i = 0; i < B; ++i) {
-                morph::vvec<T> resample (data_n);
-                morph::vvec<unsigned int> randindices (data_n);
-                randindices.randomize (0, data_n - 1);
-                for (unsigned int j = 0; j < data_n; ++j) {
-                    resample[j] = data[randindices[j]];
+                resamples[i].resize (data.size());
+                bootstrap<T>::draw_resample (data, resamples[i], seed, i);
+            }
+        }
+
+        /*!
+         * Draw B resamples (with replacement) of data, apply reducer to each and return the B
+         * results. Each resample is drawn into a buffer that is reused for the next one, so
+         * memory use is one buffer of data.size() per thread, plus the results.
+         *
+         * The reducer is any callable taking a morph::vvec<T>& (the resample) and returning the
+         * statistic, for example [](morph::vvec<T>& r) { return r.mean(); }. It may modify the
+         * resample (to find a median with std::nth_element, say). It is called concurrently from
+         * several threads, so it must be thread-safe.
+         *
+         * If seed is 0, a seed is taken from std::random_device. Otherwise, the results depend
+         * only on the data, B and the seed.
+         */
+        template <typename R>
+        static auto resample_statistics (const morph::vvec<T>& data, const unsigned int B, R reducer,
+                                         std::uint64_t seed = 0)
+        {
+            using S = std::decay_t<std::invoke_result_t<R&, morph::vvec<T>&>>;
+            seed = bootstrap<T>::make_seed (seed);
+            morph::vvec<S> stats (B);
+            const int nB = static_cast<int>(B);
+#pragma omp parallel if (static_cast<std::size_t>(B) * data.size() > 65536)
+            {
+                morph::vvec<T> resample (data.size());
+#pragma omp for schedule(static)
+                for (int i = 0; i < nB; ++i) {
+                    bootstrap<T>::draw_resample (data, resample, seed, static_cast<std::uint64_t>(i));
+                    stats[i] = reducer (resample);
                 }
-                resamples[i] = resample;
             }
+            return stats;
         }
 
         // Compute a bootstapped standard error of the mean of the data with B resamples
-        static T error_of_mean (const morph::vvec<T>& data, const unsigned int B)
+        static T error_of_mean (const morph::vvec<T>& data, const unsigned int B, std::uint64_t seed = 0)
         {
-            std::vector<morph::vvec<T>> resamples;
-            morph::bootstrap<T>::resample_with_replacement (data, resamples, B);
-            morph::vvec<T> r_mean (B, T{0});
-            for (unsigned int i = 0; i < B; ++i) {
-                r_mean[i] = resamples[i].mean();
-            }
+            morph::vvec<T> r_mean = bootstrap<T>::resample_statistics (data, B, [](morph::vvec<T>& r) { return r.mean(); }, seed);
             // Standard error is the standard deviation of the resample means
             return r_mean.std();
         }
         // std::vector version of error_of_mean
-        static T error_of_mean (const std::vector<T>& data, const unsigned int B)
+        static T error_of_mean (const std::vector<T>& data, const unsigned int B, std::uint64_t seed = 0)
         {
             morph::vvec<T> vdata;
             vdata.set_from (data);
-            return bootstrap<T>::error_of_mean (vdata, B);
+            return bootstrap<T>::error_of_mean (vdata, B, seed);
         }
 
         // Compute a bootstapped standard error of the SD of the data with B resamples
-        static T error_of_std (const morph::vvec<T>& data, const unsigned int B)
+        static T error_of_std (const morph::vvec<T>& data, const unsigned int B, std::uint64_t seed = 0)
         {
-            std::vector<morph::vvec<T>> resamples;
-            morph::bootstrap<T>::resample_with_replacement (data, resamples, B);
-            morph::vvec<T> r_std (B, T{0});
-            for (unsigned int i = 0; i < B; ++i) {
-                r_std[i] = resamples[i].std();
-            }
+            morph::vvec<T> r_std = bootstrap<T>::resample_statistics (data, B, [](morph::vvec<T>& r) { return r.std(); }, seed);
             // Standard error of the statistic is the standard deviation of the resampled statistic
             return r_std.std();
         }
         // std::vector version of error_of_std
-        static T error_of_std (const std::vector<T>& data, const unsigned int B)
+        static T error_of_std (const std::vector<T>& data, const unsigned int B, std::uint64_t seed = 0)
         {
             morph::vvec<T> vdata;
             vdata.set_from (data);
-            return bootstrap<T>::error_of_std (vdata, B);
+            return bootstrap<T>::error_of_std (vdata, B, seed);
         }
 
         // Compute a bootstrapped two sample t statistic as per algorithm 16.2
@@ -98,7 +128,8 @@ namespace morph {
         // Cognitive and Developmental Systems, vol. 10, no. 3, pp. 823-836, Sept. 2018, doi:
         // 10.1109/TCDS.2018.2797426.
         static morph::vec<T, 2> ttest_equalityofmeans (const morph::vvec<T>& _zdata,
-                                                       const morph::vvec<T>& _ydata, const unsigned int B)
+                                                       const morph::vvec<T>& _ydata, const unsigned int B,
+                                                       std::uint64_t seed = 0)
         {
             // Ensure that the group which we name zdata is the larger one.
             morph::vvec<T> zdata = _zdata;
@@ -138,35 +169,33 @@ namespace morph {
                 std::cout << "ytilda mean: " << ytilda.mean() << std::endl;
             }
 
-            // Resample from the shifted (tilda) distributions:
-            std::vector<morph::vvec<T>> zstar;
-            bootstrap<T>::resample_with_replacement (ztilda, zstar, B);
-            if constexpr (debug_bstrap) {
-                std::cout << "zstar size after resample: " << zstar.size() << std::endl;
-            }
-            std::vector<morph::vvec<T>> ystar;
-            bootstrap<T>::resample_with_replacement (ytilda, ystar, B);
+            // Resample from the shifted (tilda) distributions, reducing each resample to its mean
+            // and variance. The y resamples use a different seed from the z resamples.
+            auto mean_and_var = [](morph::vvec<T>& r) {
+                T rmean = r.mean();
+                T ss = T{0};
+                for (auto ri : r) { ss += (ri - rmean) * (ri - rmean); }
+                return morph::vec<T, 2>({ rmean, ss / (r.size() - 1) });
+            };
+            seed = bootstrap<T>::make_seed (seed);
+            morph::vvec<morph::vec<T, 2>> zstar = bootstrap<T>::resample_statistics (ztilda, B, mean_and_var, seed);
+            morph::vvec<morph::vec<T, 2>> ystar = bootstrap<T>::resample_statistics (ytilda, B, mean_and_var, seed + 1);
 
-            // Create vectors of the means of these resamples:
+            // Create vectors of the means and variances of these resamples:
             morph::vvec<T> zstarmeans (B, T{0});
             morph::vvec<T> ystarmeans (B, T{0});
-
+            morph::vvec<T> zvariances (B, T{0});
+            morph::vvec<T> yvariances (B, T{0});
             for (unsigned int i = 0; i < B; ++i) {
-                zstarmeans[i] = zstar[i].mean();
-                ystarmeans[i] = ystar[i].mean();
+                zstarmeans[i] = zstar[i][0];
+                ystarmeans[i] = ystar[i][0];
+                zvariances[i] = zstar[i][1];
+                yvariances[i] = ystar[i][1];
             }
 
             if constexpr (debug_bstrap) {
                 std::cout << "zstarmeans of size " << zstarmeans.size() << " and content: " << zstarmeans << std::endl;
             }
-
-            // Compute the variances.
-            morph::vvec<T> zvariances (B, T{0});
-            morph::vvec<T> yvariances (B, T{0});
-            for (unsigned int i = 0; i < B; ++i) {
-                zvariances[i] = (zstar[i]-zstarmeans[i]).pow(2).sum() / (n-1);
-                yvariances[i] = (ystar[i]-ystarmeans[i]).pow(2).sum() / (m-1);
-            }
             if constexpr (debug_bstrap) {
                 std::cout << "zvariances: " << zvariances << std::endl;
             }
@@ -191,13 +220,38 @@ namespace morph {
         }
         // std::vector version of ttest_equalityofmeans()
         static morph::vec<T, 2> ttest_equalityofmeans (const std::vector<T>& _zdata,
-                                                       const std::vector<T>& _ydata, const unsigned int B)
+                                                       const std::vector<T>& _ydata, const unsigned int B,
+                                                       std::uint64_t seed = 0)
         {
             morph::vvec<T> vzdata;
             vzdata.set_from (_zdata);
             morph::vvec<T> vydata;
             vydata.set_from (_ydata);
-            return bootstrap<T>::ttest_equalityofmeans (vzdata, vydata, B);
+            return bootstrap<T>::ttest_equalityofmeans (vzdata, vydata, B, seed);
+        }
+
+    private:
+        // Return seed, or if it is 0, a non-zero seed from std::random_device
+        static std::uint64_t make_seed (std::uint64_t seed)
+        {
+            std::random_device rd;
+            while (seed == 0) { seed = (static_cast<std::uint64_t>(rd()) << 32) | rd(); }
+            return seed;
+        }
+
+        // Draw resample number i of data into resample (which must be the same size as data)
+        // from its own generator. The generator's seed mixes seed and i with the splitmix64
+        // finaliser so that neighbouring resamples get unrelated streams.
+        static void draw_resample (const morph::vvec<T>& data, morph::vvec<T>& resample,
+                                   std::uint64_t seed, std::uint64_t i)
+        {
+            std::uint64_t z = seed + (i + 1) * 0x9e3779b97f4a7c15ULL;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            z = z ^ (z >> 31);
+            std::mt19937_64 gen (z);
+            std::uniform_int_distribution<std::size_t> dist (0, data.size() - 1);
+            for (std::size_t j = 0; j < data.size(); ++j) { resample[j] = data[dist (gen)]; }
         }
     };
 }
@@ -0,0 +1,288 @@
+/*!
+ * \file
+ *
+ * A distance-to-boundary transform for grids of elements that know the indices of their
+ * neighbours, such as HexGrid and CartGrid with their d_ne, d_nne (and so on) vectors.
+ *
+ * The distances are found by propagating a wavefront out from the boundary elements over the
+ * neighbour graph, so that the work is proportional to the number of elements, rather than to
+ * (elements x boundary elements) as it is for an exhaustive search. Each pass over the wavefront
+ * is a loop over independent elements which is parallelised with OpenMP, if it's available.
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <cstddef>
+
+namespace morph {
+
+    //! How should distance_transform measure distance?
+    enum class distance_metric
+    {
+        //! Exact Euclidean distance to the nearest boundary element
+        euclidean,
+        //! Euclidean distance via nearest-boundary-site propagation alone, which is occasionally
+        //! a little too long (see distance_transform::from_boundary)
+        euclidean_approx,
+        //! Length of the shortest path to the boundary that steps from neighbour to neighbour
+        path
+    };
+
+    struct distance_transform
+    {
+        /*!
+         * Compute the distance from each element of a grid to its nearest boundary element.
+         *
+         * \param x The x coordinates of the element centres.
+         *
+         * \param y The y coordinates of the element centres.
+         *
+         * \param flags The flags for each element.
+         *
+         * \param boundary_flag An element is a boundary element if (flags[i] & boundary_flag).
+         *
+         * \param inside_flag An element that is not a boundary element is inside the boundary if
+         * (flags[i] & inside_flag).
+         *
+         * \param nbrs Pointers to N vectors of neighbour indices (with -1 for 'no neighbour').
+         *
+         * \param dist Output. Resized to the number of elements. Boundary elements are set to
+         * 0, elements outside the boundary to -100 and elements inside the boundary to their
+         * distance from the boundary. With distance_metric::euclidean_approx and
+         * distance_metric::path, elements with no path to any boundary element are set to -1.
+         *
+         * \param metric distance_metric::euclidean (the default) gives the straight line
+         * distance to the nearest boundary element, exactly as an exhaustive search would.
+         * distance_metric::euclidean_approx carries the index of the nearest boundary element
+         * outwards from the boundary, so that each element takes the nearest of the boundary
+         * elements held by its neighbours. That is usually, but not always, the true nearest
+         * (the error is then a small fraction of the element spacing). distance_metric::euclidean
+         * starts from this estimate and checks it with a k-d tree search of the boundary
+         * elements, which the estimate keeps short. distance_metric::path gives the length of
+         * the shortest path to the boundary through the centres of neighbouring elements.
+         */
+        template <std::size_t N>
+        static void from_boundary (const std::vector<float>& x, const std::vector<float>& y,
+                                   const std::vector<unsigned int>& flags,
+                                   const unsigned int boundary_flag, const unsigned int inside_flag,
+                                   const std::array<const std::vector<int>*, N>& nbrs,
+                                   std::vector<float>& dist,
+                                   const distance_metric metric = distance_metric::euclidean)
+        {
+            const std::size_t n = x.size();
+            dist.assign (n, -1.0f);
+            // The boundary element that is nearest to each element, as found so far
+            std::vector<int> site (n, -1);
+
+            // The wavefront starts at the boundary. Elements outside get a dummy, negative value
+            std::vector<int> front;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (flags[i] & boundary_flag) {
+                    dist[i] = 0.0f;
+                    site[i] = static_cast<int>(i);
+                    front.push_back (static_cast<int>(i));
+                } else if (!(flags[i] & inside_flag)) {
+                    dist[i] = -100.0f;
+                }
+            }
+
+            // Elements adjacent to the wavefront, which may be improved in this pass
+            std::vector<int> cands;
+            // Avoid adding an element to cands twice in one pass by stamping it with the pass number
+            std::vector<int> stamp (n, -1);
+            // The new site and distance for each candidate. Results are written here, then
+            // committed after the parallel loop, so that no thread reads a value that another
+            // thread is writing.
+            std::vector<int> cand_site;
+            std::vector<float> cand_dist;
+            std::vector<char> improved;
+
+            for (int pass = 0; !front.empty(); ++pass) {
+
+                cands.clear();
+                for (int f : front) {
+                    for (std::size_t k = 0; k < N; ++k) {
+                        const int j = (*nbrs[k])[f];
+                        if (j < 0 || stamp[j] == pass) { continue; }
+                        if ((flags[j] & boundary_flag) || !(flags[j] & inside_flag)) { continue; }
+                        stamp[j] = pass;
+                        cands.push_back (j);
+                    }
+                }
+
+                const int nc = static_cast<int>(cands.size());
+                cand_site.resize (nc);
+                cand_dist.resize (nc);
+                improved.assign (nc, 0);
+
+#pragma omp parallel for if (nc > 4096)
+                for (int c = 0; c < nc; ++c) {
+                    const int j = cands[c];
+                    int best_site = site[j];
+                    float best = best_site < 0 ? std::numeric_limits<float>::max() : dist[j];
+                    for (std::size_t k = 0; k < N; ++k) {
+                        const int nb = (*nbrs[k])[j];
+                        if (nb < 0 || site[nb] < 0) { continue; }
+                        float d = 0.0f;
+                        if (metric != distance_metric::path) {
+                            const float dx = x[j] - x[site[nb]];
+                            const float dy = y[j] - y[site[nb]];
+                            d = std::sqrt (dx * dx + dy * dy);
+                        } else {
+                            const float dx = x[j] - x[nb];
+                            const float dy = y[j] - y[nb];
+                            d = dist[nb] + std::sqrt (dx * dx + dy * dy);
+                        }
+                        if (d < best) {
+                            best = d;
+                            best_site = site[nb];
+                        }
+                    }
+                    cand_site[c] = best_site;
+                    cand_dist[c] = best;
+                    improved[c] = best_site >= 0 && (site[j] < 0 || best < dist[j]) ? 1 : 0;
+                }
+
+                // Commit the improvements; the improved elements form the next wavefront
+                front.clear();
+                for (int c = 0; c < nc; ++c) {
+                    if (!improved[c]) { continue; }
+                    site[cands[c]] = cand_site[c];
+                    dist[cands[c]] = cand_dist[c];
+                    front.push_back (cands[c]);
+                }
+            }
+
+            if (metric == distance_metric::path) { return; }
+
+            if (metric == distance_metric::euclidean) {
+                // Find the nearest boundary element to each inside element with a k-d tree. The
+                // site from the wavefront is an upper bound which prunes most of the tree.
+                site_tree tree (x, y, boundary_sites (flags, boundary_flag));
+                if (tree.empty()) { return; }
+                const int ni = static_cast<int>(n);
+#pragma omp parallel for schedule(dynamic, 256) if (ni > 4096)
+                for (int i = 0; i < ni; ++i) {
+                    if ((flags[i] & boundary_flag) || !(flags[i] & inside_flag)) { continue; }
+                    float best2 = std::numeric_limits<float>::max();
+                    if (site[i] >= 0) {
+                        const float dx = x[i] - x[site[i]];
+                        const float dy = y[i] - y[site[i]];
+                        best2 = dx * dx + dy * dy;
+                    }
+                    tree.nearest (x[i], y[i], best2);
+                    dist[i] = std::sqrt (best2);
+                }
+                return;
+            }
+
+            // The wavefront can leave an element with a site that is not the nearest if the
+            // nearest site was not carried by any of its neighbours. Polish by also considering
+            // the sites carried by the neighbours of neighbours.
+            const int ni = static_cast<int>(n);
+#pragma omp parallel for if (ni > 4096)
+            for (int i = 0; i < ni; ++i) {
+                if (site[i] < 0 || dist[i] == 0.0f) { continue; }
+                float best = dist[i];
+                for (std::size_t k = 0; k < N; ++k) {
+                    const int nb = (*nbrs[k])[i];
+                    if (nb < 0) { continue; }
+                    for (std::size_t l = 0; l < N; ++l) {
+                        const int nb2 = (*nbrs[l])[nb];
+                        if (nb2 < 0 || site[nb2] < 0) { continue; }
+                        const float dx = x[i] - x[site[nb2]];
+                        const float dy = y[i] - y[site[nb2]];
+                        best = std::min (best, std::sqrt (dx * dx + dy * dy));
+                    }
+                }
+                dist[i] = best;
+            }
+        }
+
+    private:
+        //! The indices of the boundary elements
+        static std::vector<int> boundary_sites (const std::vector<unsigned int>& flags, const unsigned int boundary_flag)
+        {
+            std::vector<int> sites;
+            for (std::size_t i = 0; i < flags.size(); ++i) {
+                if (flags[i] & boundary_flag) { sites.push_back (static_cast<int>(i)); }
+            }
+            return sites;
+        }
+
+        /*!
+         * A 2D k-d tree of the boundary elements, stored implicitly: the node for the range
+         * [b, e) of the (reordered) sites is the median, m = (b + e) / 2, which splits the range
+         * on x at even depths and on y at odd depths.
+         */
+        struct site_tree
+        {
+            //! Ranges this short are searched exhaustively
+            static constexpr int leaf = 8;
+
+            site_tree (const std::vector<float>& x, const std::vector<float>& y, const std::vector<int>& sites)
+            {
+                this->pts.resize (sites.size());
+                for (std::size_t k = 0; k < sites.size(); ++k) { this->pts[k] = { x[sites[k]], y[sites[k]] }; }
+                this->build (0, static_cast<int>(this->pts.size()), 0);
+            }
+
+            bool empty() const { return this->pts.empty(); }
+
+            //! Reduce best2 to the squared distance from (px, py) to the nearest site, if nearer
+            void nearest (const float px, const float py, float& best2) const
+            {
+                this->search (0, static_cast<int>(this->pts.size()), 0, px, py, best2);
+            }
+
+        private:
+            void build (const int b, const int e, const int axis)
+            {
+                if (e - b <= leaf) { return; }
+                const int m = (b + e) / 2;
+                std::nth_element (this->pts.begin() + b, this->pts.begin() + m, this->pts.begin() + e,
+                                  [axis](const std::array<float, 2>& p, const std::array<float, 2>& q) { return p[axis] < q[axis]; });
+                this->build (b, m, 1 - axis);
+                this->build (m + 1, e, 1 - axis);
+            }
+
+            void test (const int k, const float px, const float py, float& best2) const
+            {
+                // The same arithmetic as an exhaustive search, so that the results are identical
+                const float dx = px - this->pts[k][0];
+                const float dy = py - this->pts[k][1];
+                const float d2 = dx * dx + dy * dy;
+                best2 = d2 < best2 ? d2 : best2;
+            }
+
+            void search (const int b, const int e, const int axis, const float px, const float py, float& best2) const
+            {
+                if (e - b <= leaf) {
+                    for (int k = b; k < e; ++k) { this->test (k, px, py, best2); }
+                    return;
+                }
+                const int m = (b + e) / 2;
+                this->test (m, px, py, best2);
+                const float diff = (axis == 0 ? px : py) - this->pts[m][axis];
+                // The near side first, then the far side if the splitting line is near enough
+                if (diff < 0.0f) {
+                    this->search (b, m, 1 - axis, px, py, best2);
+                    if (diff * diff < best2) { this->search (m + 1, e, 1 - axis, px, py, best2); }
+                } else {
+                    this->search (m + 1, e, 1 - axis, px, py, best2);
+                    if (diff * diff < best2) { this->search (b, m, 1 - axis, px, py, best2); }
+                }
+            }
+
+            std::vector<std::array<float, 2>> pts;
+        };
+    };
+
+} // namespace morph
@@ -0,0 +1,333 @@
+/*!
+ * \file
+ *
+ * Fast Fourier transforms and FFT-based 2D convolution.
+ *
+ * This is a small, self-contained FFT so that morphologica needs no FFT library. Transforms of
+ * power of 2 length use an iterative radix-2 algorithm with precomputed twiddle factors. Other
+ * lengths use Bluestein's algorithm, which re-expresses the transform as a convolution of power
+ * of 2 length, so every length is O(n log n).
+ *
+ * fft::convolver2d applies a fixed kernel to fields on a rectangular lattice. It transforms the
+ * kernel once, when it is constructed, so each application costs one forward and one inverse
+ * 2D transform. Axes that wrap are convolved circularly; on other axes the field is zero padded,
+ * so that values beyond the edge of the domain contribute nothing. CartGrid::fft_convolver() and
+ * HexGrid::fft_convolver() make convolvers that give the same results as their convolve()
+ * methods.
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <complex>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+#include <morph/mathconst.h>
+#include <morph/parallel.h>
+
+namespace morph::fft {
+
+    //! The smallest power of 2 that is >= n
+    inline std::size_t next_pow2 (const std::size_t n)
+    {
+        std::size_t m = 1;
+        while (m < n) { m <<= 1; }
+        return m;
+    }
+
+    /*!
+     * A one dimensional discrete Fourier transform of length n. Forward transforms are not
+     * normalised; inverse transforms are scaled by 1/n.
+     */
+    template <typename T>
+    class plan
+    {
+        static_assert (std::is_floating_point_v<T>, "fft::plan needs a floating point type");
+
+    public:
+        explicit plan (const std::size_t _n) : n(_n)
+        {
+            if (this->n == 0) { throw std::runtime_error ("fft::plan: can't transform zero elements"); }
+            this->m = (this->n & (this->n - 1)) == 0 ? this->n : next_pow2 (2 * this->n - 1);
+            this->init_radix2();
+            if (this->m != this->n) { this->init_bluestein(); }
+        }
+
+        std::size_t size() const { return this->n; }
+
+        //! The length of the work vector that transform() needs
+        std::size_t work_size() const { return this->m == this->n ? 0 : this->m; }
+
+        //! Transform the n elements at a in place. work must have work_size() elements.
+        void transform (std::complex<T>* a, const bool inverse, std::complex<T>* work) const
+        {
+            if (inverse) { for (std::size_t k = 0; k < this->n; ++k) { a[k] = std::conj (a[k]); } }
+            if (this->m == this->n) {
+                this->radix2 (a);
+            } else {
+                this->bluestein (a, work);
+            }
+            if (inverse) {
+                const T s = T{1} / static_cast<T>(this->n);
+                for (std::size_t k = 0; k < this->n; ++k) { a[k] = std::conj (a[k]) * s; }
+            }
+        }
+
+    private:
+        void init_radix2()
+        {
+            std::size_t bits = 0;
+            while ((std::size_t{1} << bits) < this->m) { ++bits; }
+            this->rev.resize (this->m);
+            for (std::size_t i = 0; i < this->m; ++i) {
+                std::size_t r = 0;
+                for (std::size_t b = 0; b < bits; ++b) { r |= ((i >> b) & 1u) << (bits - 1 - b); }
+                this->rev[i] = r;
+            }
+            // Twiddles are computed in double, whatever T is
+            this->tw.resize (this->m / 2);
+            for (std::size_t k = 0; k < this->m / 2; ++k) {
+                const double a = -morph::mathconst<double>::two_pi * static_cast<double>(k) / static_cast<double>(this->m);
+                this->tw[k] = std::complex<T>(static_cast<T>(std::cos (a)), static_cast<T>(std::sin (a)));
+            }
+        }
+
+        void init_bluestein()
+        {
+            // chirp[k] = exp(-i pi k^2 / n). k^2 is reduced mod 2n to keep the angle accurate.
+            this->chirp.resize (this->n);
+            for (std::size_t k = 0; k < this->n; ++k) {
+                const std::size_t k2 = (k * k) % (2 * this->n);
+                const double a = -morph::mathconst<double>::pi * static_cast<double>(k2) / static_cast<double>(this->n);
+                this->chirp[k] = std::complex<T>(static_cast<T>(std::cos (a)), static_cast<T>(std::sin (a)));
+            }
+            // The transform of the conjugate chirp, wrapped to length m
+            this->chirp_f.assign (this->m, std::complex<T>{});
+            this->chirp_f[0] = std::conj (this->chirp[0]);
+            for (std::size_t k = 1; k < this->n; ++k) {
+                this->chirp_f[k] = std::conj (this->chirp[k]);
+                this->chirp_f[this->m - k] = std::conj (this->chirp[k]);
+            }
+            this->radix2 (this->chirp_f.data());
+        }
+
+        //! In place, unnormalised, forward radix-2 transform of length m
+        void radix2 (std::complex<T>* a) const
+        {
+            for (std::size_t i = 0; i < this->m; ++i) {
+                if (i < this->rev[i]) { std::swap (a[i], a[this->rev[i]]); }
+            }
+            for (std::size_t len = 2; len <= this->m; len <<= 1) {
+                const std::size_t half = len / 2;
+                const std::size_t step = this->m / len;
+                for (std::size_t i = 0; i < this->m; i += len) {
+                    for (std::size_t j = 0; j < half; ++j) {
+                        const std::complex<T> t = this->tw[j * step] * a[i + j + half];
+                        a[i + j + half] = a[i + j] - t;
+                        a[i + j] += t;
+                    }
+                }
+            }
+        }
+
+        //! Forward transform of length n by Bluestein's algorithm, using work (m elements)
+        void bluestein (std::complex<T>* a, std::complex<T>* work) const
+        {
+            for (std::size_t k = 0; k < this->n; ++k) { work[k] = a[k] * this->chirp[k]; }
+            std::fill (work + this->n, work + this->m, std::complex<T>{});
+            this->radix2 (work);
+            for (std::size_t k = 0; k < this->m; ++k) { work[k] = std::conj (work[k] * this->chirp_f[k]); }
+            this->radix2 (work); // conj, forward, conj is an inverse (without the 1/m)
+            const T s = T{1} / static_cast<T>(this->m);
+            for (std::size_t k = 0; k < this->n; ++k) { a[k] = std::conj (work[k]) * s * this->chirp[k]; }
+        }
+
+        std::size_t n = 0;
+        //! The radix-2 length: n if n is a power of 2, else the Bluestein convolution length
+        std::size_t m = 0;
+        std::vector<std::size_t> rev;
+        std::vector<std::complex<T>> tw;
+        std::vector<std::complex<T>> chirp;
+        std::vector<std::complex<T>> chirp_f;
+    };
+
+    /*!
+     * A 2D transform of an nx by ny array stored row by row (element (x, y) at y * nx + x). Rows,
+     * then columns, are transformed on the threads of morph::parallel.
+     */
+    template <typename T>
+    class plan2d
+    {
+    public:
+        plan2d (const std::size_t _nx, const std::size_t _ny) : nx(_nx), ny(_ny), px(_nx), py(_ny) {}
+
+        std::size_t size_x() const { return this->nx; }
+        std::size_t size_y() const { return this->ny; }
+
+        void transform (std::complex<T>* a, const bool inverse) const
+        {
+            morph::parallel::parallel_for_chunks (std::size_t{0}, this->ny, [&](const std::size_t y0, const std::size_t y1) {
+                std::vector<std::complex<T>> work (this->px.work_size());
+                for (std::size_t y = y0; y < y1; ++y) { this->px.transform (a + y * this->nx, inverse, work.data()); }
+            });
+            morph::parallel::parallel_for_chunks (std::size_t{0}, this->nx, [&](const std::size_t x0, const std::size_t x1) {
+                std::vector<std::complex<T>> work (this->py.work_size());
+                std::vector<std::complex<T>> col (this->ny);
+                for (std::size_t x = x0; x < x1; ++x) {
+                    for (std::size_t y = 0; y < this->ny; ++y) { col[y] = a[y * this->nx + x]; }
+                    this->py.transform (col.data(), inverse, work.data());
+                    for (std::size_t y = 0; y < this->ny; ++y) { a[y * this->nx + x] = col[y]; }
+                }
+            });
+        }
+
+    private:
+        std::size_t nx = 0;
+        std::size_t ny = 0;
+        plan<T> px;
+        plan<T> py;
+    };
+
+    /*!
+     * Convolution of fields on an nx by ny lattice with a fixed kernel, by FFT.
+     *
+     * Each element i of a field lies at the lattice position positions[i] = {x, y}. The kernel
+     * is a list of lattice offsets with a weight for each. The result at element i is the sum,
+     * over the kernel, of weight * field[element at positions[i] + offset]. An offset that leaves
+     * the lattice wraps around on an axis that wraps, and otherwise contributes nothing. (This is
+     * a correlation, as computed by CartGrid::convolve() and HexGrid::convolve().)
+     */
+    template <typename T>
+    class convolver2d
+    {
+        static_assert (std::is_floating_point_v<T>, "fft::convolver2d needs a floating point type");
+
+    public:
+        convolver2d (const int nx, const int ny, const bool wrap_x, const bool wrap_y,
+                     const std::vector<std::array<int, 2>>& _positions,
+                     const std::vector<std::array<int, 2>>& kernel_offsets, const std::vector<T>& kernel_weights)
+            : positions(_positions)
+            , tx(transform_length (nx, wrap_x, kernel_offsets, 0))
+            , ty(transform_length (ny, wrap_y, kernel_offsets, 1))
+            , p(tx, ty)
+        {
+            if (kernel_offsets.size() != kernel_weights.size()) {
+                throw std::runtime_error ("fft::convolver2d: kernel offsets and weights differ in number");
+            }
+            for (auto ps : this->positions) {
+                if (ps[0] < 0 || ps[0] >= nx || ps[1] < 0 || ps[1] >= ny) {
+                    throw std::runtime_error ("fft::convolver2d: a position lies outside the lattice");
+                }
+            }
+            // The correlation with k is the convolution with k reflected, k'(q) = k(-q)
+            this->kernel_f.assign (this->tx * this->ty, std::complex<T>{});
+            const std::int64_t mx = static_cast<std::int64_t>(this->tx);
+            const std::int64_t my = static_cast<std::int64_t>(this->ty);
+            for (std::size_t k = 0; k < kernel_offsets.size(); ++k) {
+                // On an axis that doesn't wrap, an offset as long as the axis never lands in the domain
+                if ((!wrap_x && std::abs (kernel_offsets[k][0]) >= nx) || (!wrap_y && std::abs (kernel_offsets[k][1]) >= ny)) {
+                    continue;
+                }
+                const std::int64_t qx = ((-kernel_offsets[k][0] % mx) + mx) % mx;
+                const std::int64_t qy = ((-kernel_offsets[k][1] % my) + my) % my;
+                this->kernel_f[qy * mx + qx] += kernel_weights[k];
+            }
+            this->p.transform (this->kernel_f.data(), false);
+            this->buf.resize (this->kernel_f.size());
+        }
+
+        //! The number of elements in the fields that this convolver applies to
+        std::size_t size() const { return this->positions.size(); }
+
+        //! The dimensions of the transforms this convolver makes (after any zero padding)
+        std::array<std::size_t, 2> transform_size() const { return { this->tx, this->ty }; }
+
+        //! Convolve data with the kernel, writing into result (which is resized to size()).
+        void convolve (const std::vector<T>& data, std::vector<T>& result)
+        {
+            this->check_size (data);
+            std::fill (this->buf.begin(), this->buf.end(), std::complex<T>{});
+            for (std::size_t i = 0; i < this->positions.size(); ++i) { this->buf[this->at (i)] = data[i]; }
+            this->apply();
+            result.resize (this->positions.size());
+            for (std::size_t i = 0; i < this->positions.size(); ++i) { result[i] = this->buf[this->at (i)].real(); }
+        }
+
+        /*!
+         * Convolve two fields with the kernel at once, for the cost of one. data1 goes in the real
+         * part of the transform and data2 in the imaginary part; since the kernel is real, the
+         * two results come out separately in the real and imaginary parts.
+         */
+        void convolve (const std::vector<T>& data1, const std::vector<T>& data2,
+                       std::vector<T>& result1, std::vector<T>& result2)
+        {
+            this->check_size (data1);
+            this->check_size (data2);
+            std::fill (this->buf.begin(), this->buf.end(), std::complex<T>{});
+            for (std::size_t i = 0; i < this->positions.size(); ++i) {
+                this->buf[this->at (i)] = std::complex<T>(data1[i], data2[i]);
+            }
+            this->apply();
+            result1.resize (this->positions.size());
+            result2.resize (this->positions.size());
+            for (std::size_t i = 0; i < this->positions.size(); ++i) {
+                result1[i] = this->buf[this->at (i)].real();
+                result2[i] = this->buf[this->at (i)].imag();
+            }
+        }
+
+    private:
+        /*!
+         * The transform length for an axis of n lattice points. A wrapped axis is transformed at
+         * its own length. An unwrapped axis is zero padded to a power of 2 long enough that no
+         * kernel offset can reach around the padding and back into the domain.
+         */
+        static std::size_t transform_length (const int n, const bool wrap, const std::vector<std::array<int, 2>>& offsets,
+                                             const std::size_t axis)
+        {
+            if (n <= 0) { throw std::runtime_error ("fft::convolver2d: lattice has zero size"); }
+            if (wrap) { return static_cast<std::size_t>(n); }
+            int reach = 0;
+            for (auto o : offsets) { reach = std::max (reach, std::abs (o[axis])); }
+            // Offsets of n or more contribute nothing, and are left out of the kernel
+            reach = std::min (reach, n - 1);
+            return next_pow2 (static_cast<std::size_t>(n + reach));
+        }
+
+        void check_size (const std::vector<T>& data) const
+        {
+            if (data.size() != this->positions.size()) {
+                throw std::runtime_error ("fft::convolver2d: the data is not the same size as the domain");
+            }
+        }
+
+        std::size_t at (const std::size_t i) const
+        {
+            return static_cast<std::size_t>(this->positions[i][1]) * this->tx + static_cast<std::size_t>(this->positions[i][0]);
+        }
+
+        //! Multiply the transform of buf by the kernel's transform and transform back
+        void apply()
+        {
+            this->p.transform (this->buf.data(), false);
+            for (std::size_t k = 0; k < this->buf.size(); ++k) { this->buf[k] *= this->kernel_f[k]; }
+            this->p.transform (this->buf.data(), true);
+        }
+
+        std::vector<std::array<int, 2>> positions;
+        std::size_t tx = 0;
+        std::size_t ty = 0;
+        plan2d<T> p;
+        std::vector<std::complex<T>> kernel_f;
+        std::vector<std::complex<T>> buf;
+    };
+
+} // namespace morph::fft
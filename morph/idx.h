@@ -0,0 +1,321 @@
+/*!
+ * \file
+ *
+ * \brief Read IDX format files, such as those that hold the MNIST database.
+ *
+ * An IDX file starts with a 4 byte magic number: two zero bytes, a byte giving the data type
+ * (0x08 for unsigned char) and a byte giving the number of dimensions. There then follows a
+ * big-endian 32 bit integer for the size of each dimension, then the data.
+ *
+ * idx_file maps a file into memory (or, where mmap is not available, reads it in one go) and
+ * provides access to its dimensions and to its unsigned byte data without copying.
+ *
+ * idx_dataset pairs an images file with a labels file. It converts the images into one
+ * contiguous, row-major N x (rows * cols) array of floats (one row per example) in parallel,
+ * and provides the labels, the indices of the examples with each label and shuffled
+ * mini-batches of example indices. Examples are accessed as std::spans into the contiguous
+ * array, so iterating through mini-batches does not copy any image data. Alternatively, the
+ * conversion can be left until each example is needed (idx_convert::lazy), in which case the
+ * only memory used for the images is the mapped file.
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+#pragma once
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <stdexcept>
+#include <span>
+#include <numeric>
+#include <functional>
+#include <algorithm>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+#include <morph/vvec.h>
+
+#ifndef _MSC_VER
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+namespace morph {
+
+    //! A read-only IDX file of unsigned bytes, mapped into memory.
+    class idx_file
+    {
+    public:
+        idx_file() {}
+        idx_file (const std::string& path) { this->open (path); }
+        ~idx_file() { this->close(); }
+
+        // The mapping is owned, so no copying
+        idx_file (const idx_file&) = delete;
+        idx_file& operator= (const idx_file&) = delete;
+
+        //! Open the file at \a path and read its header. Throws on error.
+        void open (const std::string& path)
+        {
+            this->close();
+#ifndef _MSC_VER
+            int fd = ::open (path.c_str(), O_RDONLY);
+            if (fd < 0) { throw std::runtime_error ("idx_file: Failed to open " + path); }
+            struct stat sb;
+            if (fstat (fd, &sb) != 0) {
+                ::close (fd);
+                throw std::runtime_error ("idx_file: Failed to stat " + path);
+            }
+            this->len = static_cast<std::size_t>(sb.st_size);
+            if (this->len > 0) {
+                void* m = mmap (nullptr, this->len, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (m == MAP_FAILED) {
+                    ::close (fd);
+                    throw std::runtime_error ("idx_file: Failed to mmap " + path);
+                }
+                this->mapped = static_cast<const unsigned char*>(m);
+                this->base = this->mapped;
+            }
+            ::close (fd); // The mapping stays valid after the descriptor is closed
+#else
+            std::ifstream f (path, std::ios::in | std::ios::binary | std::ios::ate);
+            if (!f.is_open()) { throw std::runtime_error ("idx_file: Failed to open " + path); }
+            this->len = static_cast<std::size_t>(f.tellg());
+            this->buffer.resize (this->len);
+            f.seekg (0);
+            f.read (reinterpret_cast<char*>(this->buffer.data()), this->len);
+            this->base = this->buffer.data();
+#endif
+            this->read_header (path);
+        }
+
+        //! Release the mapping
+        void close()
+        {
+#ifndef _MSC_VER
+            if (this->mapped != nullptr) { munmap (const_cast<unsigned char*>(this->mapped), this->len); }
+            this->mapped = nullptr;
+#else
+            this->buffer.clear();
+#endif
+            this->base = nullptr;
+            this->len = 0;
+            this->dims.clear();
+            this->data_offset = 0;
+        }
+
+        //! The size of each dimension, as given in the file header
+        const std::vector<std::size_t>& shape() const { return this->dims; }
+
+        //! The number of items (the size of the first dimension)
+        std::size_t count() const { return this->dims.empty() ? 0 : this->dims[0]; }
+
+        //! The number of bytes in each item (the product of the remaining dimensions)
+        std::size_t item_size() const
+        {
+            if (this->dims.empty()) { return 0; }
+            return std::accumulate (this->dims.begin() + 1, this->dims.end(), std::size_t{1}, std::multiplies<std::size_t>());
+        }
+
+        //! The data of item \a i, without copying
+        std::span<const unsigned char> item (std::size_t i) const
+        {
+            const std::size_t isz = this->item_size();
+            return std::span<const unsigned char>(this->base + this->data_offset + i * isz, isz);
+        }
+
+        //! All the data, without copying
+        std::span<const unsigned char> data() const
+        {
+            return std::span<const unsigned char>(this->base + this->data_offset, this->count() * this->item_size());
+        }
+
+    private:
+        //! Decode a big-endian 32 bit integer at byte offset \a o
+        std::uint32_t be32 (std::size_t o) const
+        {
+            return static_cast<std::uint32_t>(this->base[o]) << 24 | static_cast<std::uint32_t>(this->base[o + 1]) << 16
+            | static_cast<std::uint32_t>(this->base[o + 2]) << 8 | static_cast<std::uint32_t>(this->base[o + 3]);
+        }
+
+        void read_header (const std::string& path)
+        {
+            if (this->len < 4 || this->base[0] != 0 || this->base[1] != 0) {
+                throw std::runtime_error ("idx_file: " + path + " is not an IDX file");
+            }
+            if (this->base[2] != 0x08) {
+                throw std::runtime_error ("idx_file: " + path + " does not contain unsigned byte data");
+            }
+            const std::size_t ndims = this->base[3];
+            this->data_offset = 4 + 4 * ndims;
+            if (ndims == 0 || this->len < this->data_offset) {
+                throw std::runtime_error ("idx_file: " + path + " has a bad header");
+            }
+            for (std::size_t d = 0; d < ndims; ++d) { this->dims.push_back (this->be32 (4 + 4 * d)); }
+            if (this->len < this->data_offset + this->count() * this->item_size()) {
+                std::stringstream ee;
+                ee << "idx_file: " << path << " is too short for its " << this->count() << " items";
+                throw std::runtime_error (ee.str());
+            }
+        }
+
+        //! Start of the file's bytes
+        const unsigned char* base = nullptr;
+        //! Length of the file in bytes
+        std::size_t len = 0;
+        //! Where the data starts
+        std::size_t data_offset = 0;
+        //! Dimensions from the header
+        std::vector<std::size_t> dims;
+#ifndef _MSC_VER
+        const unsigned char* mapped = nullptr;
+#else
+        std::vector<unsigned char> buffer;
+#endif
+    };
+
+    //! When should idx_dataset convert its image bytes to floats?
+    enum class idx_convert { eager, lazy };
+
+    /*!
+     * A set of labelled examples from an IDX images file and an IDX labels file, such as the
+     * MNIST training or test set. The images are held in one contiguous array of floats.
+     */
+    struct idx_dataset
+    {
+        idx_dataset() {}
+
+        /*!
+         * Load from the images file \a img_path and the labels file \a lbl_path. Pixel values
+         * are scaled by \a scale (Mnist uses 1/256). If \a flip_rows is true, the image rows
+         * are stored bottom row first, which is how morph::Mnist stores them for display on a
+         * CartGrid. With idx_convert::lazy, the images file stays mapped and examples are
+         * converted by example_into().
+         */
+        idx_dataset (const std::string& img_path, const std::string& lbl_path,
+                     const float _scale = 1.0f / 256.0f, const bool _flip_rows = true,
+                     const idx_convert conv = idx_convert::eager)
+        {
+            this->load (img_path, lbl_path, _scale, _flip_rows, conv);
+        }
+
+        void load (const std::string& img_path, const std::string& lbl_path,
+                   const float _scale = 1.0f / 256.0f, const bool _flip_rows = true,
+                   const idx_convert conv = idx_convert::eager)
+        {
+            this->scale = _scale;
+            this->flip_rows = _flip_rows;
+            idx_file& imgs = this->images;
+            imgs.open (img_path);
+            idx_file lbls (lbl_path);
+            if (imgs.shape().size() != 3) { throw std::runtime_error ("idx_dataset: images file should have 3 dimensions"); }
+            if (lbls.shape().size() != 1) { throw std::runtime_error ("idx_dataset: labels file should have 1 dimension"); }
+            if (imgs.count() != lbls.count()) { throw std::runtime_error ("idx_dataset: num labels != num images"); }
+
+            this->n = imgs.count();
+            this->rows = imgs.shape()[1];
+            this->cols = imgs.shape()[2];
+            const std::size_t sz = this->rows * this->cols;
+
+            std::span<const unsigned char> lb = lbls.data();
+            this->labels.assign (lb.begin(), lb.end());
+            this->by_label.clear();
+            for (std::size_t i = 0; i < this->n; ++i) {
+                if (this->labels[i] >= this->by_label.size()) { this->by_label.resize (this->labels[i] + 1); }
+                this->by_label[this->labels[i]].push_back (i);
+            }
+
+            this->order.resize (this->n);
+            std::iota (this->order.begin(), this->order.end(), std::size_t{0});
+
+            if (conv == idx_convert::lazy) {
+                this->data.clear();
+                return;
+            }
+
+            // Convert the images, one image per loop iteration, then release the mapping
+            this->data.resize (this->n * sz);
+            float* dst = this->data.data();
+            const long long nn = static_cast<long long>(this->n);
+#pragma omp parallel for if (nn > 1000)
+            for (long long i = 0; i < nn; ++i) { this->convert (i, dst + i * sz); }
+            imgs.close();
+        }
+
+        //! Convert example \a i from the mapped file into the example_size() floats at \a dst
+        void example_into (std::size_t i, float* dst) const
+        {
+            if (this->data.empty()) {
+                this->convert (i, dst);
+            } else {
+                std::copy_n (this->data.data() + i * this->example_size(), this->example_size(), dst);
+            }
+        }
+
+        //! The number of examples
+        std::size_t size() const { return this->n; }
+
+        //! The number of floats in each example (rows * cols)
+        std::size_t example_size() const { return this->rows * this->cols; }
+
+        //! Example \a i, without copying. Not available with idx_convert::lazy.
+        std::span<const float> example (std::size_t i) const
+        {
+            if (this->data.empty()) { throw std::runtime_error ("idx_dataset: example() needs idx_convert::eager"); }
+            return std::span<const float>(this->data.data() + i * this->example_size(), this->example_size());
+        }
+
+        //! Shuffle the order in which batch() returns examples
+        template <typename R>
+        void shuffle (R& rng) { std::shuffle (this->order.begin(), this->order.end(), rng); }
+
+        //! The number of whole mini-batches of size \a batch_size
+        std::size_t num_batches (std::size_t batch_size) const { return this->n / batch_size; }
+
+        //! The indices of the examples in mini-batch \a b of size \a batch_size, in shuffled order.
+        std::span<const std::size_t> batch (std::size_t b, std::size_t batch_size) const
+        {
+            return std::span<const std::size_t>(this->order.data() + b * batch_size, batch_size);
+        }
+
+        //! The number of examples
+        std::size_t n = 0;
+        //! Number of rows in each image
+        std::size_t rows = 0;
+        //! Number of columns in each image
+        std::size_t cols = 0;
+        //! The images, row-major, n x (rows * cols)
+        morph::vvec<float> data;
+        //! The label of each example
+        std::vector<unsigned char> labels;
+        //! by_label[l] holds the indices of the examples that have label l
+        std::vector<std::vector<std::size_t>> by_label;
+        //! The order in which batch() returns examples; shuffle() permutes this.
+        std::vector<std::size_t> order;
+        //! The scaling from byte value to float
+        float scale = 1.0f / 256.0f;
+        //! Are image rows stored bottom row first?
+        bool flip_rows = true;
+
+    private:
+        //! Convert image \a i from the mapped images file into floats at \a dst
+        void convert (std::size_t i, float* dst) const
+        {
+            std::span<const unsigned char> s = this->images.item (i);
+            const std::size_t nr = this->rows;
+            const std::size_t nc = this->cols;
+            for (std::size_t r = 0; r < nr; ++r) {
+                float* drow = dst + (this->flip_rows ? (nr - r - 1) : r) * nc;
+                for (std::size_t c = 0; c < nc; ++c) { drow[c] = static_cast<float>(s[r * nc + c]) * this->scale; }
+            }
+        }
+
+        //! The images file. Stays mapped for idx_convert::lazy.
+        idx_file images;
+    };
+
+} // namespace morph
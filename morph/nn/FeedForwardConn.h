@@ -10,10 +10,14 @@
 #pragma once
 
 #include <morph/vvec.h>
+#include <morph/nn/gemm.h>
 #include <iostream>
 #include <sstream>
 #include <ostream>
 #include <vector>
+#include <numeric>
+#include <cmath>
+#include <stdexcept>
 
 namespace morph {
     namespace nn {
@@ -94,6 +98,15 @@ namespace morph {
             //! z = sum(w.in) + b. Final output written into *out is the sigmoid(z). Size N.
             morph::vvec<T> z;
 
+            //! The number of examples in a mini-batch, for the batched methods. 0 until setBatch() is called.
+            unsigned int batch_size = 0U;
+            //! Batched input layers. ins_batch[i] holds batch_size rows of ins[i]->size() activations.
+            std::vector<morph::vvec<T>*> ins_batch;
+            //! Batched output layer of batch_size rows of N activations.
+            morph::vvec<T>* out_batch = nullptr;
+            //! The errors in the input layers for each example in the mini-batch. batch_size rows of m_i.
+            std::vector<morph::vvec<T>> deltas_batch;
+
             //! Output as a string
             std::string str() const
             {
@@ -136,18 +149,14 @@ namespace morph {
 
                 // Loop over input populations:
                 for (unsigned int i = 0; i < this->ins.size(); ++i) {
-                    // A morph::vvec for a 'part of w'
                     morph::vvec<T>* _in = this->ins[i];
                     unsigned int m = _in->size();// Size m[i]
-                    morph::vvec<T> wpart(m);
-                    // Get weights, outputs and biases iterators
+                    // Get weights iterator
                     auto witer = this->ws[i].begin();
                     // Carry out an N sized for loop computing each output
                     for (unsigned int j = 0; j < this->N; ++j) { // Each output
-                        // Copy part of weights to wpart (M elements):
-                        std::copy (witer, witer+m, wpart.begin());
-                        // Compute/accumulate dot product with input
-                        this->z[j] += wpart.dot (*ins[i]);
+                        // Compute/accumulate dot product of the jth row of weights (m elements) with input
+                        this->z[j] += std::inner_product (witer, witer + m, _in->begin(), T{0});
                         // Move to the next part of the weight matrix for the next loop
                         witer += m;
                     }
@@ -255,6 +264,119 @@ namespace morph {
                     }
                 }
             }
+
+            /*!
+             * Set up the connection for mini-batches of \a _batch_size examples. \a _ins_b
+             * must correspond to ins and each must have _batch_size x ins[i]->size()
+             * elements. \a _out_b must have _batch_size x N elements. The vectors are not
+             * owned by the connection.
+             */
+            void setBatch (std::vector<morph::vvec<T>*> _ins_b, morph::vvec<T>* _out_b, unsigned int _batch_size)
+            {
+                if (_ins_b.size() != this->ins.size()) {
+                    throw std::runtime_error ("setBatch: Need one batched input for each input layer");
+                }
+                this->batch_size = _batch_size;
+                this->ins_batch = _ins_b;
+                this->out_batch = _out_b;
+                this->deltas_batch.resize (this->ins.size());
+                for (unsigned int i = 0; i < this->ins.size(); ++i) {
+                    this->deltas_batch[i].resize (this->batch_size * this->ins[i]->size(), T{0});
+                }
+            }
+
+            /*!
+             * Batched feed-forward compute. For every example, s, in the mini-batch,
+             * out_batch(s,:) = sigmoid (ins_batch(s,:) w^T + b). This is one matrix-matrix
+             * product per input layer, rather than batch_size matrix-vector products.
+             */
+            void feedforward_batch()
+            {
+                const int bs = static_cast<int>(this->batch_size);
+                const int n = static_cast<int>(this->N);
+                T* o = this->out_batch->data();
+                for (unsigned int i = 0; i < this->ins.size(); ++i) {
+                    const int m = static_cast<int>(this->ins[i]->size());
+                    morph::nn::gemm::nt (this->ins_batch[i]->data(), this->ws[i].data(), o, bs, n, m, i > 0);
+                }
+                // Add the biases and apply the sigmoid transfer function
+                for (int s = 0; s < bs; ++s) {
+                    T* orow = o + static_cast<std::size_t>(s) * n;
+                    for (int j = 0; j < n; ++j) {
+                        orow[j] = T{1} / (T{1} + std::exp(-(orow[j] + this->b[j])));
+                    }
+                }
+            }
+
+            //! Batched backprop, finding the relevant errors in \a conn_nxt, as for backprop(const FeedForwardConn&)
+            void backprop_batch (const FeedForwardConn& conn_nxt, const bool compute_deltas = true)
+            {
+                unsigned int idx = 0;
+                unsigned int idx_max = conn_nxt.ins.size();
+                for (unsigned int i = 0; i < idx_max; ++i) {
+                    if (conn_nxt.ins[i] == this->out) {
+                        idx = i;
+                        break;
+                    }
+                }
+                this->backprop_batch (conn_nxt.deltas_batch[idx], compute_deltas);
+            }
+
+            /*!
+             * Batched backprop. \a delta_l_nxt_batch holds batch_size rows of the N output
+             * errors. Sets nabla_ws and nabla_b to the *mean* gradients over the mini-batch
+             * and, if \a compute_deltas is true, deltas_batch to the errors in the input
+             * layers for each example. The deltas are not needed for the connection from the
+             * network's input layer.
+             */
+            void backprop_batch (const morph::vvec<T>& delta_l_nxt_batch, const bool compute_deltas = true)
+            {
+                if (delta_l_nxt_batch.size() != this->batch_size * this->N) {
+                    std::stringstream ee;
+                    ee << "backprop_batch: Mismatched size. delta_l_nxt_batch size: "
+                       << delta_l_nxt_batch.size() << ", batch_size x N: " << this->batch_size * this->N;
+                    throw std::runtime_error (ee.str());
+                }
+                const int bs = static_cast<int>(this->batch_size);
+                const int n = static_cast<int>(this->N);
+                const T* dnxt = delta_l_nxt_batch.data();
+                const T one_over_bs = T{1} / static_cast<T>(this->batch_size);
+
+                for (unsigned int idx = 0; idx < this->ins.size(); ++idx) {
+                    const int m = static_cast<int>(this->ins[idx]->size());
+                    const T* in_b = this->ins_batch[idx]->data();
+                    if (compute_deltas) {
+                        // deltas = (delta_l_nxt w) * sigmoid_prime(z^l), where sigmoid(z^l) is the input
+                        T* d = this->deltas_batch[idx].data();
+                        morph::nn::gemm::nn (dnxt, this->ws[idx].data(), d, bs, m, n);
+                        const std::size_t sz = this->deltas_batch[idx].size();
+                        for (std::size_t k = 0; k < sz; ++k) { d[k] *= in_b[k] * (T{1} - in_b[k]); }
+                    }
+                    // nabla_w = delta_l_nxt^T in, summed over the mini-batch, then divided by the batch size
+                    morph::nn::gemm::tn (dnxt, in_b, this->nabla_ws[idx].data(), n, m, bs);
+                    this->nabla_ws[idx] *= one_over_bs;
+                }
+
+                // nabla_b is the mean of delta_l_nxt over the mini-batch
+                this->nabla_b.zero();
+                for (int s = 0; s < bs; ++s) {
+                    const T* drow = dnxt + static_cast<std::size_t>(s) * n;
+                    for (int j = 0; j < n; ++j) { this->nabla_b[j] += drow[j]; }
+                }
+                this->nabla_b *= one_over_bs;
+            }
+
+            //! Gradient descent step. w -> w - eta nabla_w and b -> b - eta nabla_b, in place.
+            void update (const T eta)
+            {
+                for (unsigned int idx = 0; idx < this->ws.size(); ++idx) {
+                    T* w = this->ws[idx].data();
+                    const T* nw = this->nabla_ws[idx].data();
+                    const std::size_t sz = this->ws[idx].size();
+                    for (std::size_t k = 0; k < sz; ++k) { w[k] -= eta * nw[k]; }
+                }
+                for (unsigned int j = 0; j < this->N; ++j) { this->b[j] -= eta * this->nabla_b[j]; }
+            }
         };
 
         //! Stream operator
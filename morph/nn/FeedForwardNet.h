@@ -18,6 +18,8 @@
 #include <ostream>
 #include <map>
 #include <limits>
+#include <algorithm>
+#include <stdexcept>
 
 namespace morph {
     namespace nn {
@@ -174,6 +176,86 @@ namespace morph {
                 return this->cost;
             }
 
+            /*!
+             * Allocate the buffers for batched training with mini-batches of \a _batch_size
+             * examples. Each layer of neurons gets a batched counterpart in neurons_batch,
+             * which holds one row of activations per example, and the connections are pointed
+             * at these.
+             */
+            void setBatchSize (unsigned int _batch_size)
+            {
+                this->batch_size = _batch_size;
+                this->neurons_batch.clear();
+                for (auto& nl : this->neurons) {
+                    this->neurons_batch.emplace_back (this->batch_size * nl.size(), T{0});
+                }
+                auto nb = this->neurons_batch.begin();
+                for (auto& c : this->connections) {
+                    auto nb_in = nb++;
+                    c.setBatch ({&*nb_in}, &*nb, this->batch_size);
+                }
+                this->desiredOutput_batch.resize (this->batch_size * this->neurons.back().size(), T{0});
+                this->delta_out_batch.resize (this->batch_size * this->neurons.back().size(), T{0});
+            }
+
+            //! Copy an input and desired output into row \a s of the mini-batch
+            void setBatchInput (unsigned int s, const morph::vvec<T>& theInput, const morph::vvec<T>& theOutput)
+            {
+                const std::size_t m = this->neurons.front().size();
+                const std::size_t n = this->neurons.back().size();
+                if (s >= this->batch_size || theInput.size() != m || theOutput.size() != n) {
+                    throw std::runtime_error ("setBatchInput: Wrong size input/output or s >= batch_size");
+                }
+                std::copy (theInput.begin(), theInput.end(), this->neurons_batch.front().begin() + s * m);
+                std::copy (theOutput.begin(), theOutput.end(), this->desiredOutput_batch.begin() + s * n);
+            }
+
+            //! Update the network's batched outputs from its batched inputs
+            void feedforward_batch()
+            {
+                for (auto& c : this->connections) { c.feedforward_batch(); }
+            }
+
+            /*!
+             * Compute delta_out_batch for the mini-batch and return the mean cost of the
+             * examples in the mini-batch.
+             */
+            T computeCost_batch()
+            {
+                const morph::vvec<T>& o = this->neurons_batch.back();
+                T c = T{0};
+                for (std::size_t k = 0; k < o.size(); ++k) {
+                    const T e = o[k] - this->desiredOutput_batch[k];
+                    this->delta_out_batch[k] = e * o[k] * (T{1} - o[k]);
+                    c += e * e;
+                }
+                this->cost = T{0.5} * c / static_cast<T>(this->batch_size);
+                return this->cost;
+            }
+
+            /*!
+             * Batched backpropagation. After this, the nabla_ws and nabla_b of each connection
+             * hold the gradients of the cost, averaged over the mini-batch. NB: Call
+             * computeCost_batch() first.
+             */
+            void backprop_batch()
+            {
+                auto citer = this->connections.end();
+                --citer; // Now points at output layer
+                citer->backprop_batch (this->delta_out_batch, citer != this->connections.begin());
+                for (;citer != this->connections.begin();) {
+                    auto citer_closertooutput = citer--;
+                    // The errors in the network's input layer are not needed
+                    citer->backprop_batch (citer_closertooutput->deltas_batch[0], citer != this->connections.begin());
+                }
+            }
+
+            //! Apply the gradient descent step with learning rate \a eta to every connection
+            void update (const T eta)
+            {
+                for (auto& c : this->connections) { c.update (eta); }
+            }
+
             // Return the min activation in all the neurons
             T min_neuron_activation() const
             {
@@ -205,6 +287,15 @@ namespace morph {
             morph::vvec<T> delta_out;
             //! The desired output of the network
             morph::vvec<T> desiredOutput;
+
+            //! The number of examples in a mini-batch for the batched methods. Set with setBatchSize().
+            unsigned int batch_size = 0U;
+            //! The batched neuron layers. Each holds batch_size rows of activations for its layer.
+            std::list<morph::vvec<T>> neurons_batch;
+            //! The desired outputs for the mini-batch; batch_size rows
+            morph::vvec<T> desiredOutput_batch;
+            //! The errors of the output layer for each example in the mini-batch; batch_size rows
+            morph::vvec<T> delta_out_batch;
         };
 
         template <typename T>
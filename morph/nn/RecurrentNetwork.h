@@ -6,9 +6,13 @@
  * \author Stuart Wilson
  * \date 2020
  */
+#pragma once
 
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <string>
+#include <stdexcept>
 #include <morph/rngd.h> // for morph::randDouble()
 
 namespace morph {
@@ -68,16 +72,19 @@ namespace morph {
                 // dtOverTauW - dt / tau_w (where tau_w is the time constant for the weight change)
                 // Pre - vector of pre-synaptic node identities (should be same length as Post)
                 // Post - vector of post-synaptic node identities (should be same length as Pre)
-                // zero - useful for resetting the matrix of pointers Wptr
                 // divergenceThreshold - threshold below which time-differences in total error signal convergence to a (point) attractor state
-                // Wptr - pointers into the weight vector W, useful for efficiently constructing an N x N sparse weight matrix, for convenient inspection / saving
+                // PostStart, PostK, PostPre - the connections in compressed sparse row form, grouped by post-synaptic node, set up in setNet(). The connections onto node i are PostK[PostStart[i]] to PostK[PostStart[i+1]-1] (indices into W), from the nodes PostPre[PostStart[i]] and so on
+                // PreStart, PreK, PrePost - the connections in compressed sparse column form, grouped by pre-synaptic node, similarly
 
                 int N, Nweight, Nplus1, maxConvergenceSteps;
                 std::vector<double> W, X, Input, U, Wbest, Y, F, V, Fprime, J;
                 double dt, dtOverTauX, dtOverTauY, dtOverTauW;
                 std::vector<int> Pre, Post;
-                double zero, divergenceThreshold;
-                std::vector<double*> Wptr;
+                double divergenceThreshold;
+                std::vector<int> PostStart, PostK, PostPre, PreStart, PreK, PrePost;
+
+                //! Loops over nodes or weights are only run in parallel (with OpenMP) if there are at least this many
+                static constexpr int parallelThreshold = 4096;
 
                 RecurrentNetwork(void){
 
@@ -99,7 +106,6 @@ namespace morph {
                     Nplus1 = N; // overwrite if bias
                     this->divergenceThreshold= divergenceThreshold * N;
                     this->maxConvergenceSteps= maxConvergenceSteps;
-                    zero = 0.0;
                     this->dt = dt;
                     dtOverTauW = dt/tauW;
                     dtOverTauX = dt/tauX;
@@ -142,20 +148,52 @@ namespace morph {
                 void randomizeWeights(double weightMin, double weightMax){
 
                     double weightRange = weightMax-weightMin;
-                    for(int i=0;i<W.size();i++){
+                    for(int i=0;i<static_cast<int>(W.size());i++){
                         W[i] = morph::randDouble()*weightRange+weightMin;
                     }
                 }
 
-                //! Register the number of connection weights and obtain pointers to them
-                //! once all connections have been set.
+                //! Register the number of connection weights once all connections have been
+                //! set, and compile the connections into the compressed sparse row (by post)
+                //! and column (by pre) forms used by forward() and backward(). Throws if any
+                //! connection refers to a node outside the network (post must be in 0 to N-1
+                //! and pre in 0 to Nplus1-1, which includes the bias node if there is one).
                 void setNet(void){
 
+                    for(int k=0;k<static_cast<int>(Pre.size());k++){
+                        if(Post[k]<0 || Post[k]>=N || Pre[k]<0 || Pre[k]>=Nplus1){
+                            throw std::runtime_error ("RecurrentNetwork::setNet: connection " + std::to_string(k)
+                                                      + " (pre " + std::to_string(Pre[k]) + ", post "
+                                                      + std::to_string(Post[k]) + ") is out of range");
+                        }
+                    }
                     Nweight = W.size();
                     Wbest = W;
-                    Wptr.resize(Nplus1*Nplus1,&zero);
-                    for(int i=0;i<Nweight;i++){
-                        Wptr[Pre[i]*Nplus1+Post[i]] = &W[i];
+                    compress(Post, Pre, N, PostStart, PostK, PostPre);
+                    compress(Pre, Post, Nplus1, PreStart, PreK, PrePost);
+                }
+
+                /*!
+                 * Counting sort of the connections by their node in \a by (which has values in
+                 * the range 0 to n-1). On return, the connections of node i are at positions
+                 * start[i] to start[i+1]-1 of idx (their index into W) and other (their node at
+                 * the other end of the connection). The sort is stable, so each node's
+                 * connections remain in the order that they were made.
+                 */
+                static void compress(const std::vector<int>& by, const std::vector<int>& other, int n,
+                                     std::vector<int>& start, std::vector<int>& idx, std::vector<int>& oth){
+
+                    int nw = by.size();
+                    start.assign(n+1,0);
+                    for(int k=0;k<nw;k++){ start[by[k]+1]++; }
+                    for(int i=0;i<n;i++){ start[i+1] += start[i]; }
+                    idx.resize(nw);
+                    oth.resize(nw);
+                    std::vector<int> pos(start.begin(), start.end()-1);
+                    for(int k=0;k<nw;k++){
+                        int p = pos[by[k]]++;
+                        idx[p] = k;
+                        oth[p] = other[k];
                     }
                 }
 
@@ -180,18 +218,20 @@ namespace morph {
                 //! external input to input nodes.
                 void forward(void){
 
-                    std::fill(U.begin(),U.end(),0.);
-
-                    // Don't OMP this loop - buggy!
-                    for(int k=0;k<Nweight;k++){
-                        U[Post[k]] += X[Pre[k]] * W[k];
-                    }
-                    //#pragma omp parallel for
+                    // Each node sums the inputs onto it (a row of the CSR form), so that no two
+                    // threads write to the same element of U. F must be computed for every
+                    // node before any X is updated.
+#pragma omp parallel for if (Nweight >= parallelThreshold)
                     for(int i=0;i<N;i++){
-                        F[i] = 1./(1.+exp(-U[i]));
+                        double u = 0.;
+                        for(int e=PostStart[i];e<PostStart[i+1];e++){
+                            u += X[PostPre[e]] * W[PostK[e]];
+                        }
+                        U[i] = u;
+                        F[i] = 1./(1.+exp(-u));
                     }
 
-                    //#pragma omp parallel for
+#pragma omp parallel for if (N >= parallelThreshold)
                     for(int i=0;i<N;i++){
                         X[i] +=dtOverTauX* ( -X[i] + F[i] + Input[i] );
                     }
@@ -204,7 +244,7 @@ namespace morph {
                 void setError(std::vector<int> oID, std::vector<double> targetOutput){
 
                     std::fill(J.begin(),J.end(),0.);
-                    for(int i=0;i<oID.size();i++){
+                    for(int i=0;i<static_cast<int>(oID.size());i++){
                         J[oID[i]] = targetOutput[i]-X[oID[i]];
                     }
                 }
@@ -214,19 +254,23 @@ namespace morph {
                 //! sigmoid, and J_i=target_i-x_i is the discrepancy to be minimised
                 void backward(void){
 
-                    //#pragma omp parallel for
+#pragma omp parallel for if (N >= parallelThreshold)
                     for(int i=0;i<N;i++){
                         Fprime[i] = F[i]*(1.0-F[i]);
                     }
 
-                    std::fill(V.begin(), V.end()-1,0.);
-
-                    //#pragma omp parallel for
-                    for(int k=0;k<Nweight;k++){
-                        V[Pre[k]] += Fprime[Post[k]] * W[k] * Y[Post[k]];
+                    // Each node sums over the connections out of it (a column of the CSC form).
+                    // V for the bias node is not used.
+#pragma omp parallel for if (Nweight >= parallelThreshold)
+                    for(int i=0;i<N;i++){
+                        double v = 0.;
+                        for(int e=PreStart[i];e<PreStart[i+1];e++){
+                            v += Fprime[PrePost[e]] * W[PreK[e]] * Y[PrePost[e]];
+                        }
+                        V[i] = v;
                     }
 
-                    //#pragma omp parallel for
+#pragma omp parallel for if (N >= parallelThreshold)
                     for(int i=0;i<N;i++){
                         Y[i] +=dtOverTauY * (V[i] - Y[i] + J[i]);
                     }
@@ -242,10 +286,9 @@ namespace morph {
                  */
                 void weightUpdate(void){
 
-                    //#pragma omp parallel for
-                    double delta;
+#pragma omp parallel for if (Nweight >= parallelThreshold)
                     for(int k=0;k<Nweight;k++){
-                        delta = (X[Pre[k]] * Y[Post[k]] * Fprime[Post[k]]);
+                        double delta = (X[Pre[k]] * Y[Post[k]] * Fprime[Post[k]]);
                         if(delta<-1.0){
                             W[k] -= dtOverTauW;
                         } else if (delta>1.0) {
@@ -267,13 +310,14 @@ namespace morph {
 
                 }
 
-                //! returns a 1D vector of N**2 doubles (for saving) corresponding to the
-                //! flattened NxN weight matrix
+                //! returns a 1D vector of Nplus1**2 doubles (for saving) corresponding to the
+                //! flattened weight matrix, with element pre*Nplus1+post holding the weight
+                //! from pre to post (or 0 if they are not connected)
                 std::vector<double> getWeightMatrix(void){
 
-                    std::vector<double> flatweightmat(Wptr.size());
-                    for(int i=0;i<Wptr.size();i++){
-                        flatweightmat[i] = *Wptr[i];
+                    std::vector<double> flatweightmat(Nplus1*Nplus1,0.);
+                    for(int k=0;k<Nweight;k++){
+                        flatweightmat[Pre[k]*Nplus1+Post[k]] = W[k];
                     }
                     return flatweightmat;
                 }
@@ -0,0 +1,136 @@
+/*!
+ * \file
+ *
+ * Small, dependency-free general matrix multiplication (GEMM) kernels for the batched
+ * training of the networks in morph::nn. All matrices are dense and row-major, stored in
+ * contiguous memory (usually the data() of a morph::vvec).
+ *
+ * The kernels are blocked over the inner dimension so that the rows being read stay in cache,
+ * their innermost loops are written so that the compiler can vectorise them and their outer
+ * loops are parallelised with OpenMP, if it's available.
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+namespace morph {
+    namespace nn {
+
+        struct gemm
+        {
+            //! The inner dimension is processed in blocks of this many elements
+            static constexpr int k_block = 256;
+            //! Don't start up OpenMP threads for matrix products with fewer multiply-adds than this
+            static constexpr std::size_t parallel_threshold = 32768;
+
+            /*!
+             * C = A B^T (or C += A B^T if \a accumulate is true).
+             *
+             * A is M x K, B is N x K and C is M x N. Each element of C is the dot product of a
+             * row of A with a row of B, so both operands are read along contiguous rows. This is
+             * the form of the forward pass, z = in w^T, for weights stored with one row per
+             * output neuron.
+             */
+            template <typename T>
+            static void nt (const T* A, const T* B, T* C, const int M, const int N, const int K,
+                            const bool accumulate = false)
+            {
+                if (!accumulate) { std::fill (C, C + static_cast<std::size_t>(M) * N, T{0}); }
+                const bool par = static_cast<std::size_t>(M) * N * K > parallel_threshold;
+#pragma omp parallel for if (par)
+                for (int i = 0; i < M; ++i) {
+                    const T* a = A + static_cast<std::size_t>(i) * K;
+                    T* c = C + static_cast<std::size_t>(i) * N;
+                    for (int k0 = 0; k0 < K; k0 += k_block) {
+                        const int k1 = std::min (K, k0 + k_block);
+                        int j = 0;
+                        // Four rows of B at a time, so that each element of a is loaded once for four outputs
+                        for (; j + 3 < N; j += 4) {
+                            const T* b0 = B + static_cast<std::size_t>(j) * K;
+                            const T* b1 = b0 + K;
+                            const T* b2 = b1 + K;
+                            const T* b3 = b2 + K;
+                            T s0 = T{0}, s1 = T{0}, s2 = T{0}, s3 = T{0};
+#pragma omp simd reduction(+:s0,s1,s2,s3)
+                            for (int k = k0; k < k1; ++k) {
+                                s0 += a[k] * b0[k];
+                                s1 += a[k] * b1[k];
+                                s2 += a[k] * b2[k];
+                                s3 += a[k] * b3[k];
+                            }
+                            c[j] += s0;
+                            c[j + 1] += s1;
+                            c[j + 2] += s2;
+                            c[j + 3] += s3;
+                        }
+                        for (; j < N; ++j) {
+                            const T* b0 = B + static_cast<std::size_t>(j) * K;
+                            T s0 = T{0};
+#pragma omp simd reduction(+:s0)
+                            for (int k = k0; k < k1; ++k) { s0 += a[k] * b0[k]; }
+                            c[j] += s0;
+                        }
+                    }
+                }
+            }
+
+            /*!
+             * C = A B (or C += A B if \a accumulate is true).
+             *
+             * A is M x K, B is K x N and C is M x N. Each row of C is accumulated as a sum of
+             * the rows of B, weighted by the elements of a row of A. This is the form of the
+             * backpropagation of errors, delta_in = delta_out w.
+             */
+            template <typename T>
+            static void nn (const T* A, const T* B, T* C, const int M, const int N, const int K,
+                            const bool accumulate = false)
+            {
+                if (!accumulate) { std::fill (C, C + static_cast<std::size_t>(M) * N, T{0}); }
+                const bool par = static_cast<std::size_t>(M) * N * K > parallel_threshold;
+#pragma omp parallel for if (par)
+                for (int i = 0; i < M; ++i) {
+                    const T* a = A + static_cast<std::size_t>(i) * K;
+                    T* c = C + static_cast<std::size_t>(i) * N;
+                    for (int k = 0; k < K; ++k) {
+                        const T aik = a[k];
+                        if (aik == T{0}) { continue; }
+                        const T* b = B + static_cast<std::size_t>(k) * N;
+#pragma omp simd
+                        for (int j = 0; j < N; ++j) { c[j] += aik * b[j]; }
+                    }
+                }
+            }
+
+            /*!
+             * C = A^T B (or C += A^T B if \a accumulate is true).
+             *
+             * A is K x M, B is K x N and C is M x N. Row i of C is a sum over k of the rows of
+             * B, weighted by A(k,i). This is the form of the weight gradient, nabla_w = delta^T
+             * in, summed over the examples in a mini-batch.
+             */
+            template <typename T>
+            static void tn (const T* A, const T* B, T* C, const int M, const int N, const int K,
+                            const bool accumulate = false)
+            {
+                if (!accumulate) { std::fill (C, C + static_cast<std::size_t>(M) * N, T{0}); }
+                const bool par = static_cast<std::size_t>(M) * N * K > parallel_threshold;
+#pragma omp parallel for if (par)
+                for (int i = 0; i < M; ++i) {
+                    T* c = C + static_cast<std::size_t>(i) * N;
+                    for (int k = 0; k < K; ++k) {
+                        const T aki = A[static_cast<std::size_t>(k) * M + i];
+                        if (aki == T{0}) { continue; }
+                        const T* b = B + static_cast<std::size_t>(k) * N;
+#pragma omp simd
+                        for (int j = 0; j < N; ++j) { c[j] += aki * b[j]; }
+                    }
+                }
+            }
+        };
+
+    } // namespace nn
+} // namespace morph
@@ -0,0 +1,423 @@
+/*!
+ * \file
+ *
+ * A small work-stealing thread pool with parallel_for, parallel_reduce and task groups.
+ *
+ * morph's numerical code has used '#pragma omp parallel for' on its hot loops, which does
+ * nothing when the compiler is not given OpenMP flags. The functions here use std::thread
+ * instead, so they run in parallel in any build that links with the threads library (in CMake,
+ * target_link_libraries(yourprog Threads::Threads)).
+ *
+ * There is one pool per program, made the first time it is used, with num_threads() - 1 workers;
+ * the thread that calls parallel_for works too. Each worker has its own deque of tasks. It takes
+ * work from the back of its own deque and, when that is empty, steals from the front of the
+ * others. A thread that waits for a task group runs queued tasks while it waits, so parallel
+ * loops can be nested without deadlock.
+ *
+ * Migrating an OpenMP loop:
+ *
+ *   #pragma omp parallel for
+ *   for (std::int64_t i = 0; i < n; ++i) { out[i] = f (in[i]); }
+ *
+ * becomes
+ *
+ *   morph::parallel::parallel_for (std::int64_t{0}, n, [&](std::int64_t i) { out[i] = f (in[i]); });
+ *
+ * Chunking: a loop of n iterations is split into chunks of 'grain' iterations, which the threads
+ * take in turn. With grain = 0 the chunk size is chosen from n and the number of threads.
+ * parallel_reduce combines the results of its chunks in chunk order and by default uses a fixed
+ * grain, so a floating point reduction gives the same answer whatever the number of threads.
+ *
+ * The number of threads is hardware_concurrency(), or the value of the environment variable
+ * MORPH_NUM_THREADS if that is set. In a program compiled with OpenMP it is instead
+ * omp_get_max_threads(), so that the pool respects OMP_NUM_THREADS (and the job's OpenMP limit)
+ * like the program's OpenMP loops do. Change it with set_num_threads(). With one thread, the loops
+ * run serially on the calling thread and no threads are started.
+ *
+ * morph's own kernels keep their OpenMP loops in OpenMP builds, and use parallel_for only when
+ * OpenMP is not available, so that an OpenMP program doesn't run two sets of threads at once.
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <type_traits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+namespace morph::parallel {
+
+    //! parallel_reduce uses chunks of this many iterations unless told otherwise
+    static constexpr std::size_t default_reduce_grain = 4096;
+
+    /*!
+     * A pool of worker threads, each with its own deque of tasks. A pool of size n has n - 1
+     * workers, as the thread which waits on the work is expected to help with it.
+     */
+    class thread_pool
+    {
+    public:
+        using task = std::function<void()>;
+
+        explicit thread_pool (const unsigned int n)
+        {
+            const unsigned int nw = n > 1 ? n - 1 : 0;
+            // One deque per worker and one, the last, for tasks submitted from other threads
+            for (unsigned int i = 0; i <= nw; ++i) { this->queues.push_back (std::make_unique<task_queue>()); }
+            for (unsigned int i = 0; i < nw; ++i) {
+                this->workers.emplace_back (&thread_pool::worker_loop, this, i);
+            }
+        }
+
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lk (this->sleep_m);
+                this->stopping = true;
+            }
+            this->sleep_cv.notify_all();
+            for (auto& t : this->workers) { if (t.joinable()) { t.join(); } }
+        }
+
+        thread_pool (const thread_pool&) = delete;
+        thread_pool& operator= (const thread_pool&) = delete;
+
+        //! The number of threads that work on the pool's tasks: the workers and one waiting thread
+        unsigned int size() const { return static_cast<unsigned int>(this->workers.size()) + 1; }
+
+        //! Queue t. From a worker, t goes on the worker's own deque, else on the shared deque.
+        void submit (task t)
+        {
+            task_queue& q = *this->queues[this->my_queue()];
+            // Count the task before it's visible, so that a thief's decrement can't come first
+            this->pending.fetch_add (1);
+            {
+                std::lock_guard<std::mutex> lk (q.m);
+                q.tasks.push_back (std::move (t));
+            }
+            {
+                // Taking the lock orders this notify after any worker's check of pending
+                std::lock_guard<std::mutex> lk (this->sleep_m);
+            }
+            this->sleep_cv.notify_one();
+        }
+
+        //! Run one queued task, if there is one. Returns false if there was nothing to do.
+        bool run_one()
+        {
+            task t;
+            if (!this->take (this->my_queue(), t)) { return false; }
+            t();
+            return true;
+        }
+
+    private:
+        struct task_queue
+        {
+            std::mutex m;
+            std::deque<task> tasks;
+        };
+
+        //! Which pool (if any) the current thread works for, and its index in that pool
+        struct worker_id
+        {
+            const thread_pool* pool = nullptr;
+            std::size_t index = 0;
+        };
+        static worker_id& this_thread_id()
+        {
+            static thread_local worker_id id;
+            return id;
+        }
+
+        //! The deque that belongs to the calling thread (the shared one for non-workers)
+        std::size_t my_queue() const
+        {
+            const worker_id& id = this_thread_id();
+            return id.pool == this ? id.index : this->queues.size() - 1;
+        }
+
+        //! Pop from the back of deque qi, or steal from the front of any of the others
+        bool take (const std::size_t qi, task& t)
+        {
+            if (this->pending.load() == 0) { return false; }
+            const std::size_t nq = this->queues.size();
+            for (std::size_t k = 0; k < nq; ++k) {
+                task_queue& q = *this->queues[(qi + k) % nq];
+                std::lock_guard<std::mutex> lk (q.m);
+                if (q.tasks.empty()) { continue; }
+                if (k == 0) {
+                    t = std::move (q.tasks.back());
+                    q.tasks.pop_back();
+                } else {
+                    t = std::move (q.tasks.front());
+                    q.tasks.pop_front();
+                }
+                this->pending.fetch_sub (1);
+                return true;
+            }
+            return false;
+        }
+
+        void worker_loop (const std::size_t i)
+        {
+            this_thread_id() = worker_id{ this, i };
+            task t;
+            while (true) {
+                if (this->take (i, t)) {
+                    t();
+                    t = nullptr;
+                    continue;
+                }
+                std::unique_lock<std::mutex> lk (this->sleep_m);
+                this->sleep_cv.wait (lk, [this]{ return this->stopping || this->pending.load() > 0; });
+                if (this->stopping && this->pending.load() == 0) { break; }
+            }
+        }
+
+        std::vector<std::unique_ptr<task_queue>> queues;
+        std::vector<std::thread> workers;
+        //! The number of queued tasks that no thread has taken yet
+        std::atomic<std::size_t> pending = 0;
+        std::mutex sleep_m;
+        std::condition_variable sleep_cv;
+        bool stopping = false;
+    };
+
+    namespace detail {
+        inline std::mutex& pool_mutex() { static std::mutex m; return m; }
+        inline std::unique_ptr<thread_pool>& pool_ptr() { static std::unique_ptr<thread_pool> p; return p; }
+        inline unsigned int& thread_setting() { static unsigned int n = 0; return n; }
+    }
+
+    /*!
+     * The value of MORPH_NUM_THREADS if that is set to a positive number, otherwise
+     * omp_get_max_threads() in an OpenMP build, otherwise hardware_concurrency()
+     */
+    inline unsigned int default_num_threads()
+    {
+        if (const char* e = std::getenv ("MORPH_NUM_THREADS")) {
+            const unsigned long n = std::strtoul (e, nullptr, 10);
+            if (n > 0) { return static_cast<unsigned int>(n); }
+        }
+#ifdef _OPENMP
+        const int omp_n = omp_get_max_threads();
+        if (omp_n > 0) { return static_cast<unsigned int>(omp_n); }
+#endif
+        const unsigned int hc = std::thread::hardware_concurrency();
+        return hc > 0 ? hc : 1;
+    }
+
+    //! The number of threads that parallel loops will use
+    inline unsigned int num_threads()
+    {
+        std::lock_guard<std::mutex> lk (detail::pool_mutex());
+        unsigned int& n = detail::thread_setting();
+        if (n == 0) { n = default_num_threads(); }
+        return n;
+    }
+
+    /*!
+     * Set the number of threads that parallel loops will use. 0 means default_num_threads(). The
+     * pool is remade on its next use, so don't call this while parallel work is in progress.
+     */
+    inline void set_num_threads (const unsigned int n)
+    {
+        std::lock_guard<std::mutex> lk (detail::pool_mutex());
+        detail::thread_setting() = n > 0 ? n : default_num_threads();
+        detail::pool_ptr().reset();
+    }
+
+    //! The program's thread pool, made with num_threads() threads on first use
+    inline thread_pool& pool()
+    {
+        const unsigned int n = num_threads();
+        std::lock_guard<std::mutex> lk (detail::pool_mutex());
+        std::unique_ptr<thread_pool>& p = detail::pool_ptr();
+        if (!p) { p = std::make_unique<thread_pool> (n); }
+        return *p;
+    }
+
+    /*!
+     * A set of tasks that can be waited on together. Tasks may run on any thread of the pool
+     * (including the one that calls wait()). If tasks throw, wait() rethrows the first exception.
+     *
+     *   morph::parallel::task_group g;
+     *   g.run ([&]{ left.sort(); });
+     *   g.run ([&]{ right.sort(); });
+     *   g.wait();
+     */
+    class task_group
+    {
+    public:
+        task_group() : p(pool()) {}
+        explicit task_group (thread_pool& _p) : p(_p) {}
+        ~task_group() { this->wait_all(); }
+
+        task_group (const task_group&) = delete;
+        task_group& operator= (const task_group&) = delete;
+
+        template <typename F>
+        void run (F&& f)
+        {
+            this->outstanding.fetch_add (1);
+            this->p.submit ([this, f = std::forward<F>(f)]() mutable {
+                try {
+                    f();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lk (this->err_m);
+                    if (!this->err) { this->err = std::current_exception(); }
+                }
+                this->outstanding.fetch_sub (1);
+            });
+        }
+
+        //! Wait for all the tasks that have been run, helping with queued work while waiting
+        void wait()
+        {
+            this->wait_all();
+            std::exception_ptr e = nullptr;
+            {
+                std::lock_guard<std::mutex> lk (this->err_m);
+                std::swap (e, this->err);
+            }
+            if (e) { std::rethrow_exception (e); }
+        }
+
+    private:
+        void wait_all()
+        {
+            while (this->outstanding.load() > 0) {
+                if (!this->p.run_one()) { std::this_thread::yield(); }
+            }
+        }
+
+        thread_pool& p;
+        std::atomic<std::size_t> outstanding = 0;
+        std::mutex err_m;
+        std::exception_ptr err = nullptr;
+    };
+
+    namespace detail {
+        //! Call body(c) for each c in [0, nchunks), sharing the chunks out between the pool's threads
+        template <typename F>
+        void run_chunks (const std::size_t nchunks, F&& body)
+        {
+            thread_pool& p = pool();
+            const std::size_t nt = std::min (static_cast<std::size_t>(p.size()), nchunks);
+            if (nt <= 1) {
+                for (std::size_t c = 0; c < nchunks; ++c) { body (c); }
+                return;
+            }
+            std::atomic<std::size_t> next = 0;
+            auto work = [&next, &body, nchunks]() {
+                try {
+                    for (std::size_t c = next.fetch_add (1); c < nchunks; c = next.fetch_add (1)) { body (c); }
+                } catch (...) {
+                    next.store (nchunks); // stop the other threads taking new chunks
+                    throw;
+                }
+            };
+            task_group g (p);
+            for (std::size_t t = 1; t < nt; ++t) { g.run (work); }
+            try {
+                work();
+            } catch (...) {
+                try { g.wait(); } catch (...) {}
+                throw;
+            }
+            g.wait();
+        }
+
+        template <typename I>
+        std::size_t span (const I begin, const I end)
+        {
+            return end > begin ? static_cast<std::size_t>(end - begin) : 0;
+        }
+
+        //! The chunk size to use for n iterations if grain is 0
+        inline std::size_t auto_grain (const std::size_t n)
+        {
+            const std::size_t nt = num_threads();
+            return nt <= 1 ? std::max (n, std::size_t{1}) : std::max (n / (8 * nt), std::size_t{1});
+        }
+    }
+
+    /*!
+     * Call f(i0, i1) for consecutive sub-ranges [i0, i1) of [begin, end), each of grain iterations
+     * (except maybe the last), on the pool's threads. Use this form when the loop body has set-up
+     * that can be shared by a whole chunk.
+     */
+    template <typename I, typename F>
+    void parallel_for_chunks (const I begin, const I end, F&& f, std::size_t grain = 0)
+    {
+        static_assert (std::is_integral_v<I>, "parallel_for needs an integral index type");
+        const std::size_t n = detail::span (begin, end);
+        if (n == 0) { return; }
+        if (grain == 0) { grain = detail::auto_grain (n); }
+        const std::size_t nchunks = (n + grain - 1) / grain;
+        detail::run_chunks (nchunks, [&](const std::size_t c) {
+            const I i0 = static_cast<I>(begin + static_cast<I>(c * grain));
+            const I i1 = static_cast<I>(begin + static_cast<I>(std::min (n, (c + 1) * grain)));
+            f (i0, i1);
+        });
+    }
+
+    //! Call f(i) for each i in [begin, end) on the pool's threads. The order of calls is unspecified.
+    template <typename I, typename F>
+    void parallel_for (const I begin, const I end, F&& f, const std::size_t grain = 0)
+    {
+        parallel_for_chunks (begin, end, [&f](const I i0, const I i1) { for (I i = i0; i < i1; ++i) { f (i); } }, grain);
+    }
+
+    /*!
+     * Reduce over [begin, end). map(i0, i1) returns the result for the chunk [i0, i1); the chunk
+     * results are then folded from the left, in chunk order, with combine, starting from
+     * identity. As the chunks depend only on grain, not on the number of threads, the result is
+     * the same however many threads run it. For example, a sum of squares:
+     *
+     *   double sos = morph::parallel::parallel_reduce (std::size_t{0}, v.size(), 0.0,
+     *       [&v](std::size_t i0, std::size_t i1) {
+     *           double s = 0.0;
+     *           for (std::size_t i = i0; i < i1; ++i) { s += v[i] * v[i]; }
+     *           return s;
+     *       },
+     *       [](double a, double b) { return a + b; });
+     */
+    template <typename I, typename R, typename Map, typename Combine>
+    R parallel_reduce (const I begin, const I end, const R identity, Map&& map, Combine&& combine,
+                       std::size_t grain = default_reduce_grain)
+    {
+        static_assert (std::is_integral_v<I>, "parallel_reduce needs an integral index type");
+        static_assert (!std::is_same_v<R, bool>, "parallel_reduce can't reduce to bool (std::vector<bool> isn't thread safe)");
+        const std::size_t n = detail::span (begin, end);
+        if (n == 0) { return identity; }
+        if (grain == 0) { grain = default_reduce_grain; }
+        const std::size_t nchunks = (n + grain - 1) / grain;
+        std::vector<R> partial (nchunks, identity);
+        detail::run_chunks (nchunks, [&](const std::size_t c) {
+            const I i0 = static_cast<I>(begin + static_cast<I>(c * grain));
+            const I i1 = static_cast<I>(begin + static_cast<I>(std::min (n, (c + 1) * grain)));
+            partial[c] = map (i0, i1);
+        });
+        R result = identity;
+        for (const R& r : partial) { result = combine (result, r); }
+        return result;
+    }
+
+} // namespace morph::parallel
@@ -0,0 +1,327 @@
+/*!
+ * \file
+ *
+ * Reductions over contiguous arrays of scalars (sums, extrema and fused statistics) that are
+ * written to vectorize and, for large arrays, to run on several threads. These are used by
+ * morph::vvec's sum(), mean(), variance(), max() and friends.
+ *
+ * Each reduction keeps 8 independent accumulators ('lanes'), so the compiler can hold them in
+ * SIMD registers without reassociating floating point operations. Sums are pairwise: blocks of
+ * 1024 elements are summed in lanes and the block sums are added in a binary tree, giving an
+ * error that grows with log(n) rather than n. The array is divided into chunks of a fixed size
+ * which are shared out between threads when the array is large; because the chunks don't depend
+ * on the number of threads, nor on whether threads are used at all, the results are the same
+ * whichever way they are computed.
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <morph/range.h>
+
+namespace morph::reduce {
+
+    //! The number of independent accumulators
+    static constexpr std::size_t lanes = 8;
+    //! Pairwise summation adds up blocks of this many elements in lanes
+    static constexpr std::size_t block = 1024;
+    //! Arrays are reduced in chunks of this many elements, one chunk per thread at a time
+    static constexpr std::size_t chunk = 65536;
+    //! Arrays with at least this many elements are reduced on several threads (if OpenMP is used)
+    static constexpr std::size_t parallel_threshold = 1048576;
+
+    namespace detail {
+
+        //! Sum op(d[i]) for n <= block elements, in lanes
+        template <typename Sy, typename S, typename Op>
+        Sy block_sum (const S* d, const std::size_t n, Op op)
+        {
+            Sy acc[lanes] = {};
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                for (std::size_t k = 0; k < lanes; ++k) { acc[k] += op (d[i + k]); }
+            }
+            for (std::size_t k = 0; i < n; ++i, ++k) { acc[k] += op (d[i]); }
+            return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+        }
+
+        //! Pairwise sum of op(d[i]) for i in [0, n). Subarrays are split on block boundaries.
+        template <typename Sy, typename S, typename Op>
+        Sy pairwise_sum (const S* d, const std::size_t n, Op op)
+        {
+            if (n <= block) { return block_sum<Sy> (d, n, op); }
+            const std::size_t h = ((n + block - 1) / block / 2) * block;
+            return pairwise_sum<Sy> (d, h, op) + pairwise_sum<Sy> (d + h, n - h, op);
+        }
+
+        //! Apply f (first, count) to each chunk of an n element array, on several threads if n is large
+        template <typename R, typename F>
+        std::vector<R> per_chunk (const std::size_t n, F f)
+        {
+            const std::int64_t nc = static_cast<std::int64_t>((n + chunk - 1) / chunk);
+            std::vector<R> r (nc);
+#pragma omp parallel for schedule(static) if (n >= parallel_threshold)
+            for (std::int64_t c = 0; c < nc; ++c) {
+                const std::size_t c0 = static_cast<std::size_t>(c) * chunk;
+                r[c] = f (c0, std::min (chunk, n - c0));
+            }
+            return r;
+        }
+
+        //! Pairwise sum of op(d[i]), chunk by chunk
+        template <typename Sy, typename S, typename Op>
+        Sy chunked_sum (const S* d, const std::size_t n, Op op)
+        {
+            if (n <= chunk) { return pairwise_sum<Sy> (d, n, op); }
+            std::vector<Sy> sums = per_chunk<Sy> (n, [d, op](std::size_t c0, std::size_t cn) { return pairwise_sum<Sy> (d + c0, cn, op); });
+            return pairwise_sum<Sy> (sums.data(), sums.size(), [](Sy s) { return s; });
+        }
+
+        /*!
+         * The index of the first minimum (if max is false) or maximum of d[0..n), n > 0. NaNs are
+         * passed over; if every element is NaN, 0 is returned.
+         */
+        template <bool max, typename S>
+        std::size_t argext (const S* d, const std::size_t n)
+        {
+            auto better = [](const S a, const S b) { if constexpr (max) { return b < a; } else { return a < b; } };
+            // Seed the lanes with the first value that isn't NaN. A NaN is never better than it,
+            // so the extreme is a value that is present in d and the search below finds it.
+            std::size_t f = 0;
+            while (f < n && d[f] != d[f]) { ++f; }
+            if (f == n) { return 0; }
+            // Find the extreme value in lanes...
+            S ext[lanes];
+            for (std::size_t k = 0; k < lanes; ++k) { ext[k] = d[f]; }
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                for (std::size_t k = 0; k < lanes; ++k) { ext[k] = better (d[i + k], ext[k]) ? d[i + k] : ext[k]; }
+            }
+            for (std::size_t k = 0; i < n; ++i, ++k) { ext[k] = better (d[i], ext[k]) ? d[i] : ext[k]; }
+            S e = ext[0];
+            for (std::size_t k = 1; k < lanes; ++k) { e = better (ext[k], e) ? ext[k] : e; }
+            // ...then its first index. The chunk is still in cache.
+            for (i = 0; i < n; ++i) { if (d[i] == e) { break; } }
+            return i;
+        }
+
+        /*!
+         * Like argext, over all of d[0..n), chunk by chunk. The result is that of
+         * std::max_element (or std::min_element): 0 if d[0] is NaN (because nothing compares
+         * better than it), otherwise the first extreme among the elements that aren't NaN.
+         */
+        template <bool max, typename S>
+        std::size_t chunked_argext (const S* d, const std::size_t n)
+        {
+            if (n == 0 || d[0] != d[0]) { return 0; }
+            if (n <= chunk) { return argext<max> (d, n); }
+            std::vector<std::size_t> idx = per_chunk<std::size_t> (n, [d](std::size_t c0, std::size_t cn) { return c0 + argext<max> (d + c0, cn); });
+            // d[0] isn't NaN, so d[idx[0]] isn't either. A chunk that is all NaN never wins.
+            std::size_t best = idx[0];
+            for (std::size_t c = 1; c < idx.size(); ++c) {
+                // Chunks are in order, so on a tie the earlier index stays
+                if constexpr (max) { if (d[best] < d[idx[c]]) { best = idx[c]; } } else { if (d[idx[c]] < d[best]) { best = idx[c]; } }
+            }
+            return best;
+        }
+
+    } // namespace detail
+
+    //! The sum of d[0..n), accumulated in type Sy
+    template <typename Sy, typename S>
+    Sy sum (const S* d, const std::size_t n)
+    {
+        return detail::chunked_sum<Sy> (d, n, [](const S x) { return static_cast<Sy>(x); });
+    }
+
+    //! The sum of the squares of d[0..n), accumulated in type Sy
+    template <typename Sy, typename S>
+    Sy sos (const S* d, const std::size_t n)
+    {
+        return detail::chunked_sum<Sy> (d, n, [](const S x) { const Sy y = static_cast<Sy>(x); return y * y; });
+    }
+
+    //! The product of d[0..n), accumulated in type Sy. Returns 0 for an empty array.
+    template <typename Sy, typename S>
+    Sy product (const S* d, const std::size_t n)
+    {
+        if (n == 0) { return Sy{0}; }
+        auto block_product = [d](const std::size_t c0, const std::size_t cn) {
+            Sy acc[lanes];
+            for (std::size_t k = 0; k < lanes; ++k) { acc[k] = Sy{1}; }
+            std::size_t i = 0;
+            for (; i + lanes <= cn; i += lanes) {
+                for (std::size_t k = 0; k < lanes; ++k) { acc[k] *= static_cast<Sy>(d[c0 + i + k]); }
+            }
+            for (std::size_t k = 0; i < cn; ++i, ++k) { acc[k] *= static_cast<Sy>(d[c0 + i]); }
+            return ((acc[0] * acc[1]) * (acc[2] * acc[3])) * ((acc[4] * acc[5]) * (acc[6] * acc[7]));
+        };
+        if (n <= chunk) { return block_product (0, n); }
+        std::vector<Sy> p = detail::per_chunk<Sy> (n, block_product);
+        Sy rtn = Sy{1};
+        for (auto pc : p) { rtn *= pc; }
+        return rtn;
+    }
+
+    //! The index of the first maximum element of d[0..n) (0 if n is 0)
+    template <typename S>
+    std::size_t argmax (const S* d, const std::size_t n) { return detail::chunked_argext<true> (d, n); }
+
+    //! The index of the first minimum element of d[0..n) (0 if n is 0)
+    template <typename S>
+    std::size_t argmin (const S* d, const std::size_t n) { return detail::chunked_argext<false> (d, n); }
+
+    //! The minimum and maximum of d[0..n) (both 0 if n is 0)
+    template <typename S>
+    morph::range<S> minmax (const S* d, const std::size_t n)
+    {
+        if (n == 0) { return morph::range<S>{}; }
+        auto chunk_minmax = [d](const std::size_t c0, const std::size_t cn) {
+            S mn[lanes];
+            S mx[lanes];
+            for (std::size_t k = 0; k < lanes; ++k) { mn[k] = mx[k] = d[c0]; }
+            std::size_t i = 0;
+            for (; i + lanes <= cn; i += lanes) {
+                for (std::size_t k = 0; k < lanes; ++k) {
+                    const S x = d[c0 + i + k];
+                    mn[k] = x < mn[k] ? x : mn[k];
+                    mx[k] = mx[k] < x ? x : mx[k];
+                }
+            }
+            for (std::size_t k = 0; i < cn; ++i, ++k) {
+                const S x = d[c0 + i];
+                mn[k] = x < mn[k] ? x : mn[k];
+                mx[k] = mx[k] < x ? x : mx[k];
+            }
+            morph::range<S> r (mn[0], mx[0]);
+            for (std::size_t k = 1; k < lanes; ++k) {
+                r.min = mn[k] < r.min ? mn[k] : r.min;
+                r.max = r.max < mx[k] ? mx[k] : r.max;
+            }
+            return r;
+        };
+        if (n <= chunk) { return chunk_minmax (0, n); }
+        std::vector<morph::range<S>> rs = detail::per_chunk<morph::range<S>> (n, chunk_minmax);
+        morph::range<S> r = rs[0];
+        for (auto rc : rs) {
+            r.min = rc.min < r.min ? rc.min : r.min;
+            r.max = r.max < rc.max ? rc.max : r.max;
+        }
+        return r;
+    }
+
+    /*!
+     * Count, mean, sum of squared deviations from the mean (m2), minimum and maximum of a set of
+     * values. Two sets of stats can be merged (Chan et al.'s parallel form of Welford's
+     * algorithm), which is how the stats of a large array are built up from those of its blocks.
+     */
+    template <typename Sy>
+    struct stats
+    {
+        std::size_t n = 0;
+        Sy mean = Sy{0};
+        Sy m2 = Sy{0};
+        Sy min = Sy{0};
+        Sy max = Sy{0};
+
+        //! The sample variance (dividing by n - 1)
+        Sy variance() const { return this->m2 / static_cast<Sy>(this->n - 1); }
+        //! The sample standard deviation
+        Sy std() const { return std::sqrt (this->variance()); }
+        //! The sum of the values
+        Sy sum() const { return this->mean * static_cast<Sy>(this->n); }
+
+        //! Combine the stats of another set of values into these
+        void merge (const stats<Sy>& o)
+        {
+            if (o.n == 0) { return; }
+            if (this->n == 0) { *this = o; return; }
+            const Sy na = static_cast<Sy>(this->n);
+            const Sy nb = static_cast<Sy>(o.n);
+            const Sy nab = na + nb;
+            const Sy delta = o.mean - this->mean;
+            this->mean += delta * nb / nab;
+            this->m2 += o.m2 + delta * delta * na * nb / nab;
+            this->min = o.min < this->min ? o.min : this->min;
+            this->max = this->max < o.max ? o.max : this->max;
+            this->n += o.n;
+        }
+    };
+
+    namespace detail {
+
+        //! Stats for n <= block elements. The block is read twice (for the mean, then for the
+        //! deviations from it) but the second pass is from cache.
+        template <typename Sy, typename S>
+        stats<Sy> block_stats (const S* d, const std::size_t n)
+        {
+            stats<Sy> s;
+            if (n == 0) { return s; }
+            s.n = n;
+            s.mean = block_sum<Sy> (d, n, [](const S x) { return static_cast<Sy>(x); }) / static_cast<Sy>(n);
+            const Sy mean = s.mean;
+            Sy m2[lanes] = {};
+            Sy mn[lanes];
+            Sy mx[lanes];
+            for (std::size_t k = 0; k < lanes; ++k) { mn[k] = mx[k] = static_cast<Sy>(d[0]); }
+            std::size_t i = 0;
+            for (; i + lanes <= n; i += lanes) {
+                for (std::size_t k = 0; k < lanes; ++k) {
+                    const Sy x = static_cast<Sy>(d[i + k]);
+                    m2[k] += (x - mean) * (x - mean);
+                    mn[k] = x < mn[k] ? x : mn[k];
+                    mx[k] = mx[k] < x ? x : mx[k];
+                }
+            }
+            for (std::size_t k = 0; i < n; ++i, ++k) {
+                const Sy x = static_cast<Sy>(d[i]);
+                m2[k] += (x - mean) * (x - mean);
+                mn[k] = x < mn[k] ? x : mn[k];
+                mx[k] = mx[k] < x ? x : mx[k];
+            }
+            s.m2 = ((m2[0] + m2[1]) + (m2[2] + m2[3])) + ((m2[4] + m2[5]) + (m2[6] + m2[7]));
+            s.min = mn[0];
+            s.max = mx[0];
+            for (std::size_t k = 1; k < lanes; ++k) {
+                s.min = mn[k] < s.min ? mn[k] : s.min;
+                s.max = s.max < mx[k] ? mx[k] : s.max;
+            }
+            return s;
+        }
+
+        //! Stats for one chunk, merged block by block
+        template <typename Sy, typename S>
+        stats<Sy> chunk_stats (const S* d, const std::size_t n)
+        {
+            stats<Sy> s;
+            for (std::size_t b0 = 0; b0 < n; b0 += block) { s.merge (block_stats<Sy> (d + b0, std::min (block, n - b0))); }
+            return s;
+        }
+
+    } // namespace detail
+
+    /*!
+     * Count, mean, m2, min and max of d[0..n) in a single pass through memory. Sy should be a
+     * floating point type.
+     */
+    template <typename Sy, typename S>
+    stats<Sy> welford (const S* d, const std::size_t n)
+    {
+        static_assert (std::is_floating_point_v<Sy>, "morph::reduce::welford: Sy must be a floating point type");
+        if (n <= chunk) { return detail::chunk_stats<Sy> (d, n); }
+        std::vector<stats<Sy>> cs = detail::per_chunk<stats<Sy>> (n, [d](std::size_t c0, std::size_t cn) { return detail::chunk_stats<Sy> (d + c0, cn); });
+        stats<Sy> s;
+        for (auto& c : cs) { s.merge (c); }
+        return s;
+    }
+
+} // namespace morph::reduce
@@ -41,8 +41,12 @@
 #include <stdexcept>
 #include <cmath>
 #include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <span>
 #include <string>
 #include <sstream>
+#include <limits>
 #include <morph/MathAlgo.h>
 #include <morph/trait_tests.h>
 #include <morph/vvec.h>
@@ -163,9 +167,47 @@ namespace morph {
             } else if (this->do_autoscale == false && !this->ready()) {
                 throw std::runtime_error ("scale_impl_base::transform(): Params are not set and do_autoscale is set false. Can't transform.");
             }
-            typename Container::const_iterator di = data.begin();
-            typename OContainer::iterator oi = output.begin();
-            while (di != data.end()) { *oi++ = this->transform_one (*di++); }
+            if constexpr (is_contiguous_of<Container, T>()
+                          && is_contiguous_of<OContainer, S>()) {
+                // Contiguous memory: hand the whole lot to the (possibly vectorised) block kernel
+                this->transform_block (std::data (data), std::data (output), dsize);
+            } else {
+                typename Container::const_iterator di = data.begin();
+                typename OContainer::iterator oi = output.begin();
+                while (di != data.end()) { *oi++ = this->transform_one (*di++); }
+            }
+        }
+
+        /*!
+         * \brief Autoscale and then transform a container of scalars or vectors.
+         *
+         * Unlike transform(), this always recomputes the scaling parameters from \a data (whether
+         * or not this->ready() is true and regardless of #do_autoscale). It makes two passes over
+         * the data; the first finds the min and max, the second applies the scaling.
+         */
+        template <typename Container, typename OContainer=Container>
+        std::enable_if_t<morph::is_copyable_container<Container>::value
+                         && morph::is_copyable_container<OContainer>::value, void>
+        autoscale_transform (const Container& data, OContainer& output)
+        {
+            if (output.size() != data.size()) {
+                throw std::runtime_error ("scale_impl_base::autoscale_transform(): Ensure data.size()==output.size()");
+            }
+            this->compute_scaling_from_data<Container> (data);
+            this->transform (data, output);
+        }
+
+        /*!
+         * \brief Transform \a n values from \a data into \a output.
+         *
+         * This is called by transform() when both containers hold their elements in contiguous
+         * memory. This default just calls transform_one() for each element; the scalar scale_impl
+         * overrides it with a loop which chooses the scaling function once for the whole block.
+         * \a data and \a output may be the same memory.
+         */
+        virtual void transform_block (const T* data, S* output, const std::size_t n) const
+        {
+            for (std::size_t i = 0; i < n; ++i) { output[i] = this->transform_one (data[i]); }
         }
 
         /*!
@@ -278,6 +320,15 @@ namespace morph {
         virtual void reset() = 0;
 
     protected:
+        //! True if C stores elements of type E in contiguous memory (std::vector, std::array,
+        //! morph::vvec, morph::vec, etc)
+        template <typename C, typename E>
+        static constexpr bool is_contiguous_of()
+        {
+            return std::contiguous_iterator<typename C::const_iterator>
+            && std::is_same_v<std::remove_cv_t<typename C::value_type>, E>;
+        }
+
         /*!
          * What type of scaling function is in use? Intended for future implementations when scale
          * could carry out logarithmic (or other) scalings, in addition to linear transforms.
@@ -517,6 +568,113 @@ namespace morph {
         //! The output range required. Change if you want to scale to something other than [0, 1]
         morph::range<S> output_range = morph::range<S>(S{0}, S{1});
 
+        // Bring the container transform()s into scope alongside the std::span overload below
+        using scale_impl_base<T, S>::transform;
+
+        /*!
+         * \brief Transform \a data held in contiguous memory (a raw buffer, say) into \a output.
+         *
+         * Behaves like the container transform(), autoscaling first if #do_autoscale is set and
+         * the params have not yet been computed.
+         */
+        void transform (std::span<const T> data, std::span<S> output)
+        {
+            if (output.size() != data.size()) {
+                throw std::runtime_error ("scale_impl<1=scalar>::transform(): Ensure data.size()==output.size()");
+            }
+            if (this->do_autoscale == true && !this->ready()) {
+                morph::range<T> mm (std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest());
+                for (const T& v : data) {
+                    mm.max = v > mm.max ? v : mm.max;
+                    mm.min = v < mm.min ? v : mm.min;
+                }
+                this->compute_scaling (mm.min, mm.max);
+            } else if (this->do_autoscale == false && !this->ready()) {
+                throw std::runtime_error ("scale_impl<1=scalar>::transform(): Params are not set and do_autoscale is set false. Can't transform.");
+            }
+            this->transform_block (data.data(), output.data(), data.size());
+        }
+
+        /*!
+         * \brief Transform \a data with this scale into \a output and with \a other into \a
+         * other_output in a single pass over \a data.
+         *
+         * VisualDataModels usually scale the same data twice, once for z and once for colour.
+         * This does both jobs while reading the input once. If either scale is set to autoscale
+         * (and is not yet ready) the data min/max is found once and used for both.
+         */
+        template <typename Container, typename OContainer=Container, typename OContainer2=OContainer>
+        std::enable_if_t<morph::is_copyable_container<Container>::value
+                         && morph::is_copyable_container<OContainer>::value
+                         && morph::is_copyable_container<OContainer2>::value, void>
+        transform_pair (const Container& data, OContainer& output,
+                        scale_impl<1, T, S>& other, OContainer2& other_output)
+        {
+            std::size_t dsize = data.size();
+            if (output.size() != dsize || other_output.size() != dsize) {
+                throw std::runtime_error ("scale_impl<1=scalar>::transform_pair(): Ensure data.size()==output.size()==other_output.size()");
+            }
+            if ((this->do_autoscale == false && !this->ready()) || (other.do_autoscale == false && !other.ready())) {
+                throw std::runtime_error ("scale_impl<1=scalar>::transform_pair(): Params are not set and do_autoscale is set false. Can't transform.");
+            }
+            if (!this->ready() || !other.ready()) {
+                morph::range<typename Container::value_type> mm = MathAlgo::maxmin (data);
+                if (!this->ready()) { this->compute_scaling (mm.min, mm.max); }
+                if (!other.ready()) { other.compute_scaling (mm.min, mm.max); }
+            }
+
+            if constexpr (scale_impl_base<T, S>::template is_contiguous_of<Container, T>()
+                          && scale_impl_base<T, S>::template is_contiguous_of<OContainer, S>()
+                          && scale_impl_base<T, S>::template is_contiguous_of<OContainer2, S>()) {
+                if (this->type == scaling_function::Linear && other.type == scaling_function::Linear) {
+                    const T* d = std::data (data);
+                    S* o1 = std::data (output);
+                    S* o2 = std::data (other_output);
+                    const S m1 = this->params[0];
+                    const S c1 = this->params[1];
+                    const S m2 = other.params[0];
+                    const S c2 = other.params[1];
+                    for (std::size_t i = 0; i < dsize; ++i) {
+                        const T x = d[i];
+                        o1[i] = x * m1 + c1;
+                        o2[i] = x * m2 + c2;
+                    }
+                } else {
+                    // log is the expensive part here; no gain from sharing the pass
+                    this->transform_block (std::data (data), std::data (output), dsize);
+                    other.transform_block (std::data (data), std::data (other_output), dsize);
+                }
+            } else {
+                this->transform (data, output);
+                other.transform (data, other_output);
+            }
+        }
+
+        /*!
+         * Transform a block of n values. The scaling function is chosen once and the params are
+         * copied into locals so that the linear loop is a simple multiply-add over the array, which
+         * the compiler can vectorise.
+         */
+        void transform_block (const T* data, S* output, const std::size_t n) const override
+        {
+            if (this->params.size() < 2) {
+                throw std::runtime_error ("scale_impl<1=scalar>::transform_block(): (scalar) scaling params not set");
+            }
+            const S m = this->params[0];
+            const S c = this->params[1];
+            if (this->type == scaling_function::Linear) {
+                for (std::size_t i = 0; i < n; ++i) { output[i] = data[i] * m + c; }
+            } else if (this->type == scaling_function::Logarithmic) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    // As transform_one_log(), the log is taken in the input type
+                    const T lnx = std::log (data[i]);
+                    output[i] = lnx * m + c;
+                }
+            } else {
+                throw std::runtime_error ("scale_impl<1=scalar>::transform_block(): Unknown scaling");
+            }
+        }
+
         S transform_one (const T& datum) const
         {
             S rtn = S{0};
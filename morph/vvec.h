@@ -21,7 +21,9 @@
 #include <functional>
 #include <cstddef>
 #include <morph/Random.h>
+#include <morph/philox.h>
 #include <morph/range.h>
+#include <morph/reduce.h>
 #include <morph/trait_tests.h>
 
 namespace morph {
@@ -73,6 +75,14 @@ namespace morph {
         //! Should a function treat a kernel as symmetric and centralize it?
         enum class centre_kernel { no, yes };
 
+        /*!
+         * True if reductions (sum, mean, max and so on) of a vvec of S, accumulated in type Sy,
+         * can use the vectorized, multi-threaded functions in morph/reduce.h. vvec<bool> can't,
+         * as std::vector<bool> has no data().
+         */
+        template <typename Sy>
+        static constexpr bool reducible = std::is_arithmetic_v<S> && !std::is_same_v<S, bool> && std::is_arithmetic_v<Sy>;
+
         //! \return the first component of the vector
         S x() const noexcept { return (*this)[0]; }
         //! \return the second component of the vector
@@ -408,12 +418,18 @@ namespace morph {
          * numbers drawn from a uniform distribution between 0 and 1 if S is a
          * floating point type or to integers between std::numeric_limits<S>::min()
          * and std::numeric_limits<S>::max() if S is an integral type (See
-         * morph::RandUniform for details).
+         * morph::RandUniform for details). Floating point elements are generated in
+         * bulk (and in parallel, for large vectors) by morph::philox4x32.
          */
         void randomize()
         {
-            RandUniform<S> ru;
-            for (auto& i : *this) { i = ru.get(); }
+            if constexpr (std::is_floating_point_v<S>) {
+                philox4x32 gen;
+                gen.fill_uniform (std::span<S>(this->data(), this->size()));
+            } else {
+                RandUniform<S> ru;
+                for (auto& i : *this) { i = ru.get(); }
+            }
         }
 
         /*!
@@ -425,8 +441,13 @@ namespace morph {
          */
         void randomize (S min, S max)
         {
-            RandUniform<S> ru (min, max);
-            for (auto& i : *this) { i = ru.get(); }
+            if constexpr (std::is_floating_point_v<S>) {
+                philox4x32 gen;
+                gen.fill_uniform (std::span<S>(this->data(), this->size()), min, max);
+            } else {
+                RandUniform<S> ru (min, max);
+                for (auto& i : *this) { i = ru.get(); }
+            }
         }
 
         /*!
@@ -438,8 +459,13 @@ namespace morph {
          */
         void randomizeN (S _mean, S _sd)
         {
-            RandNormal<S> rn (_mean, _sd);
-            for (auto& i : *this) { i = rn.get(); }
+            if constexpr (std::is_floating_point_v<S>) {
+                philox4x32 gen;
+                gen.fill_normal (std::span<S>(this->data(), this->size()), _mean, _sd);
+            } else {
+                RandNormal<S> rn (_mean, _sd);
+                for (auto& i : *this) { i = rn.get(); }
+            }
         }
 
         /*!
@@ -562,11 +588,17 @@ namespace morph {
         Sy length() const noexcept
         {
             auto add_squared = [](Sy a, S b) { return a + b * b; };
+            Sy _sos = Sy{0};
+            if constexpr (reducible<Sy>) {
+                _sos = morph::reduce::sos<Sy> (this->data(), this->size());
+            } else {
+                _sos = std::accumulate (this->begin(), this->end(), Sy{0}, add_squared);
+            }
             // Add check on whether return type Sy is integral or float. If integral, then std::round then cast the result of std::sqrt()
             if constexpr (std::is_integral<std::decay_t<Sy>>::value == true) {
-                return static_cast<Sy>(std::round(std::sqrt(std::accumulate(this->begin(), this->end(), Sy{0}, add_squared))));
+                return static_cast<Sy>(std::round(std::sqrt(_sos)));
             } else {
-                return std::sqrt(std::accumulate(this->begin(), this->end(), Sy{0}, add_squared));
+                return std::sqrt(_sos);
             }
         }
 
@@ -654,6 +686,8 @@ namespace morph {
             if constexpr (test_for_nans) {
                 auto add_squared = [](Sy a, S b) { return std::isnan(b) ? a : a + b * b; };
                 return std::accumulate (this->begin(), this->end(), Sy{0}, add_squared);
+            } else if constexpr (reducible<Sy>) {
+                return morph::reduce::sos<Sy> (this->data(), this->size());
             } else {
                 auto add_squared = [](Sy a, S b) { return a + b * b; };
                 return std::accumulate (this->begin(), this->end(), Sy{0}, add_squared);
@@ -793,8 +827,12 @@ namespace morph {
         template <typename Sy=S, std::enable_if_t<std::is_scalar<std::decay_t<Sy>>::value, int> = 0 >
         S max() const noexcept
         {
-            auto themax = std::max_element (this->begin(), this->end());
-            return themax == this->end() ? S{0} : *themax;
+            if constexpr (reducible<S>) {
+                return this->empty() ? S{0} : (*this)[morph::reduce::argmax (this->data(), this->size())];
+            } else {
+                auto themax = std::max_element (this->begin(), this->end());
+                return themax == this->end() ? S{0} : *themax;
+            }
         }
 
         //! \return the max lengthed element of the vvec. Intended for use with a vvec of vecs
@@ -811,6 +849,7 @@ namespace morph {
         template <typename Sy=S, std::enable_if_t<std::is_scalar<std::decay_t<Sy>>::value, int> = 0 >
         std::size_t argmax() const noexcept
         {
+            if constexpr (reducible<S>) { return morph::reduce::argmax (this->data(), this->size()); }
             auto themax = std::max_element (this->begin(), this->end());
             std::size_t idx = (themax - this->begin());
             return idx;
@@ -829,8 +868,12 @@ namespace morph {
         template <typename Sy=S, std::enable_if_t<std::is_scalar<std::decay_t<Sy>>::value, int> = 0 >
         S min() const noexcept
         {
-            auto themin = std::min_element (this->begin(), this->end());
-            return themin == this->end() ? S{0} : *themin;
+            if constexpr (reducible<S>) {
+                return this->empty() ? S{0} : (*this)[morph::reduce::argmin (this->data(), this->size())];
+            } else {
+                auto themin = std::min_element (this->begin(), this->end());
+                return themin == this->end() ? S{0} : *themin;
+            }
         }
 
         //! For a vvec of vecs, min() is shortest()
@@ -841,6 +884,7 @@ namespace morph {
         template <typename Sy=S, std::enable_if_t<std::is_scalar<std::decay_t<Sy>>::value, int> = 0 >
         std::size_t argmin() const noexcept
         {
+            if constexpr (reducible<S>) { return morph::reduce::argmin (this->data(), this->size()); }
             auto themin = std::min_element (this->begin(), this->end());
             std::size_t idx = (themin - this->begin());
             return idx;
@@ -875,6 +919,8 @@ namespace morph {
                     r.min = mme.first == this->end() ? S{0} : *mme.first;
                     r.max = mme.second == this->end() ? S{0} : *mme.second;
                 }
+            } else if constexpr (reducible<S>) {
+                r = morph::reduce::minmax (this->data(), this->size());
             } else { // no testing for nans
                 // minmax_element returns pair<vvec<S>::iterator, vvec<S>::iterator>
                 auto mme = std::minmax_element (this->begin(), this->end());
@@ -1121,8 +1167,7 @@ namespace morph {
                     return sum / this->size();
                 }
             } else {
-                const Sy sum = std::accumulate (this->begin(), this->end(), Sy{0});
-                return sum / this->size();
+                return this->sum<false, Sy>() / this->size();
             }
         }
 
@@ -1131,6 +1176,9 @@ namespace morph {
         Sy variance() const noexcept
         {
             if (this->empty()) { return S{0}; }
+            if constexpr (!test_for_nans && reducible<Sy> && std::is_floating_point_v<Sy>) {
+                return morph::reduce::welford<Sy> (this->data(), this->size()).variance();
+            }
             Sy _mean = this->mean<test_for_nans, Sy>();
             Sy sos_deviations = Sy{0};
             std::size_t n_nans = 0u;
@@ -1154,6 +1202,21 @@ namespace morph {
             return std::sqrt (this->variance<test_for_nans, Sy>());
         }
 
+        /*!
+         * \return the count, mean, m2 (sum of squared deviations from the mean), min and max of
+         * the elements, found in a single pass. Use this rather than calling mean(), std() and
+         * range() one after the other on a large vvec. For example:
+         *
+         * auto s = v.stats();
+         * std::cout << "mean " << s.mean << " sd " << s.std() << " max " << s.max << std::endl;
+         */
+        template<typename Sy = std::conditional_t<std::is_floating_point_v<S>, S, double>>
+        morph::reduce::stats<Sy> stats() const noexcept
+        {
+            static_assert (reducible<Sy>, "vvec::stats() needs scalar, non-bool elements");
+            return morph::reduce::welford<Sy> (this->data(), this->size());
+        }
+
         //! \return the sum of the elements. If elements are of a constrained type, you can call this something like:
         //! vvec<uint8_t> uv (256, 10);
         //! unsigned int thesum = uv.sum<false, unsigned int>();
@@ -1164,6 +1227,8 @@ namespace morph {
             if constexpr (test_for_nans) {
                 auto _ignoring_nans = [](Sy a, S b) mutable { return std::isnan(b) ? a : a + b; };
                 return std::accumulate (this->begin(), this->end(), Sy{0}, _ignoring_nans);
+            } else if constexpr (reducible<Sy>) {
+                return morph::reduce::sum<Sy> (this->data(), this->size());
             } else {
                 return std::accumulate (this->begin(), this->end(), Sy{0});
             }
@@ -1173,15 +1238,22 @@ namespace morph {
         //! this something like:
         //! vvec<uint8_t> uv (256, 10);
         //! unsigned int theproduct = uv.product<unsigned int>();
+        //! A zero element makes the product 0. The product of an empty vvec is 0. If test_for_nans
+        //! is true, then the product is taken ignoring any nan values (and is 0 if all are nan).
         template<bool test_for_nans = false, typename Sy=S>
         Sy product() const noexcept
         {
             if constexpr (test_for_nans) {
-                auto _product_ign_nans = [](Sy a, S b) mutable { return (a ? (std::isnan(b) ? a : a * b) : b); };
-                return std::accumulate (this->begin(), this->end(), Sy{0}, _product_ign_nans);
+                auto first = std::find_if (this->begin(), this->end(), [](S b) { return !std::isnan(b); });
+                if (first == this->end()) { return Sy{0}; }
+                auto _product_ign_nans = [](Sy a, S b) mutable { return std::isnan(b) ? a : a * b; };
+                return std::accumulate (first + 1, this->end(), static_cast<Sy>(*first), _product_ign_nans);
+            } else if constexpr (reducible<Sy>) {
+                return morph::reduce::product<Sy> (this->data(), this->size());
             } else {
-                auto _product = [](Sy a, S b) mutable { return a ? a * b : b; };
-                return std::accumulate (this->begin(), this->end(), Sy{0}, _product);
+                if (this->empty()) { return Sy{0}; }
+                auto _product = [](Sy a, S b) mutable { return a * b; };
+                return std::accumulate (this->begin() + 1, this->end(), static_cast<Sy>(this->front()), _product);
             }
         }
 
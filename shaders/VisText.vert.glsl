@@ -1,9 +1,19 @@
 // The coded-in shaders tell non-Mac platforms that they use OpenGL 4.5, but Mac limited to 4.1
 #version 410
 
+// Per-frame data, set once per frame by morph::Visual for all of its shader programs (a
+// program may instead declare any of these as an ordinary uniform)
+layout(std140) uniform morph_frame
+{
+    mat4 p_matrix;           // projection matrix
+    vec3 light_colour;       // Colour for both ambient and diffuse. Probably white.
+    float ambient_intensity; // Ambient intensity
+    vec3 diffuse_position;   // Positioned light
+    float diffuse_intensity; // Diffuse light intensity
+};
+
 uniform mat4 m_matrix;
 uniform mat4 v_matrix;
-uniform mat4 p_matrix;
 
 layout(location = 0) in vec4 position; // Attrib location 0 is vertex position
 layout(location = 1) in vec4 vnormal;  // Attrib location 1 is vertex normal
@@ -11,10 +11,16 @@ in VERTEX
 // diffuse_intensity to 0. That means I have just one shader for objects and it's easy
 // to change the lighting.
 
-uniform vec3 light_colour;       // Colour for both ambient and diffuse. Probably white.
-uniform float ambient_intensity; // Ambient intensity
-uniform vec3 diffuse_position;   // Positioned light
-uniform float diffuse_intensity; // Diffuse light intensity
+// Per-frame data, set once per frame by morph::Visual for all of its shader programs (a
+// program may instead declare any of these as an ordinary uniform)
+layout(std140) uniform morph_frame
+{
+    mat4 p_matrix;           // projection matrix
+    vec3 light_colour;       // Colour for both ambient and diffuse. Probably white.
+    float ambient_intensity; // Ambient intensity
+    vec3 diffuse_position;   // Positioned light
+    float diffuse_intensity; // Diffuse light intensity
+};
 
 //uniform mat4 lv_matrix; // 'light' scene view matrix
 //uniform mat4 p_matrix; // projection matrix
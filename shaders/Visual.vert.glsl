@@ -1,13 +1,23 @@
 // The coded-in shaders tell non-Mac platforms that they use OpenGL 4.5, but Mac limited to 4.1
 #version 410
 
+// Per-frame data, set once per frame by morph::Visual for all of its shader programs (a
+// program may instead declare any of these as an ordinary uniform)
+layout(std140) uniform morph_frame
+{
+    mat4 p_matrix;           // projection matrix
+    vec3 light_colour;       // Colour for both ambient and diffuse. Probably white.
+    float ambient_intensity; // Ambient intensity
+    vec3 diffuse_position;   // Positioned light
+    float diffuse_intensity; // Diffuse light intensity
+};
+
 // ProjMatrix * RotnMatrix operation can be carried out on CPU with a single matrix
 //uniform mat4 mvp_matrix;
 // Or, and this is important for lighting effects and possibly text, too, matrices can be passed separately
 //uniform mat4 vp_matrix; // sceneview-projection matrix
 uniform mat4 m_matrix; // model matrix
 uniform mat4 v_matrix; // scene view matrix
-uniform mat4 p_matrix; // projection matrix
 // alpha - to make a model see-through
 uniform float alpha;
 
@@ -22,6 +32,22 @@ out VERTEX
     vec3 fragpos; // fragment position
 } vertex;
 
+// Set to 1 by a VisualModel whose normals are octahedral-packed into normalin.xy (see
+// morph::visgl::vertex_format::packed)
+uniform int oct_normals;
+
+// Return the normal, decoding it first if it is octahedral-packed
+vec4 unpack_normal (vec4 n)
+{
+    if (oct_normals == 0) { return n; }
+    vec3 v = vec3(n.x, n.y, 1.0 - abs(n.x) - abs(n.y));
+    if (v.z < 0.0) {
+        // Unfold the lower half of the octahedron
+        v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return vec4(normalize(v), 1.0);
+}
+
 void main (void)
 {
     gl_Position = (p_matrix * v_matrix * m_matrix * position);
@@ -30,5 +56,5 @@ void main (void)
     // Normals are all automatically computed, so there's no need for
     // this line and the cube program doesn't bother to pass in the
     // normals. Maybe required only for lighting?
-    vertex.normal = normalin;
+    vertex.normal = unpack_normal (normalin);
 }
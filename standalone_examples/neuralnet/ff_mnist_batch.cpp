@@ -0,0 +1,84 @@
+/*
+ * Train a neural network to characterise the MNIST database of numerals, processing each
+ * mini-batch with the batched (matrix-matrix) methods of FeedForwardNet.
+ *
+ * \author TerryHoCQ
+ * \date October 2026
+ */
+
+#include <morph/Mnist.h>
+#include <morph/Random.h>
+#include <morph/nn/FeedForwardNet.h>
+#include <morph/vvec.h>
+#include <fstream>
+#include <vector>
+#include <map>
+
+
+int main()
+{
+    // Read the MNIST data
+    morph::Mnist m;
+
+    // Instantiate the network
+    morph::nn::FeedForwardNet<float> ff1({784,30,10});
+
+    // Create a random number generator
+#ifdef _MSC_VER
+    morph::RandUniform<unsigned short> rng((unsigned short)0, (unsigned short)9);
+#else
+    morph::RandUniform<unsigned char> rng((unsigned char)0, (unsigned char)9);
+#endif
+    // main loop parameters are number of epochs, the size of a mini-batch and the
+    // learning rate eta
+    unsigned int epochs = 30;
+    unsigned int mini_batch_size = 10;
+    float eta = 3.0f;
+
+    // Allocate the mini-batch buffers in the network
+    ff1.setBatchSize (mini_batch_size);
+
+    // Open a file to output costs into (for making a graph)
+    std::ofstream costfile;
+    costfile.open ("cost.csv", std::ios::out|std::ios::trunc);
+
+    morph::vvec<float> theout(10);
+
+    for (unsigned int ep = 0; ep < epochs; ++ep) {
+
+        // At start of epoch, make a copy of the training data:
+        std::multimap<unsigned char, std::pair<int, morph::vvec<float>> > training_f = m.training_f;
+
+        unsigned int jj = training_f.size()/mini_batch_size;
+        for (unsigned int j = 0; j < jj; ++j) {
+
+            // Copy one mini-batch into the network's batch input
+            for (unsigned int mb = 0; mb < mini_batch_size; ++mb) {
+                auto t_iter = training_f.find (static_cast<unsigned char>(rng.get() & 0xff));
+                // Might have run out of that kind of image, so need this:
+                while (t_iter == training_f.end()) {
+                    t_iter = training_f.find (static_cast<unsigned char>(rng.get() & 0xff));
+                }
+                theout.zero();
+                theout[static_cast<unsigned int>(t_iter->first)] = 1.0f;
+                ff1.setBatchInput (mb, t_iter->second.second, theout);
+                training_f.erase (t_iter);
+            }
+
+            // Feedforward and back-propagate the whole mini-batch, leaving the mean
+            // gradients in each connection, then perform the gradient update.
+            ff1.feedforward_batch();
+            costfile << ff1.computeCost_batch() << std::endl;
+            ff1.backprop_batch();
+            ff1.update (eta);
+        }
+
+        // Evaluate the latest network at the end of the epoch (we just trained on the 60000 input patterns)
+        unsigned int numcorrect = ff1.evaluate (m.test_f);
+        std::cout << "In that last Epoch, "<< numcorrect << "/10000 were characterized correctly" << std::endl;
+    }
+
+    costfile.close();
+
+    return 0;
+}
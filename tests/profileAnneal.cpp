@@ -0,0 +1,96 @@
+/*
+ * Time-to-target for Adaptive Simulated Annealing on the Bohachevsky objective from
+ * examples/anneal_asa.cpp (without the visualisation), when each evaluation of the objective
+ * is made expensive, as it is if the objective is a simulation run. Compares a single chain,
+ * a single chain with the reanneal tangent set evaluated in parallel, and parallel tempering
+ * with M chains. Reports the wall time and evaluation count at which an objective value within
+ * the target of the global minimum (0) was first computed, and at the end of the run.
+ *
+ * Usage: profileAnneal [milliseconds_per_evaluation] [M] [target]
+ */
+
+#include <morph/Anneal.h>
+#include <morph/vvec.h>
+#include <morph/vec.h>
+#include <morph/mathconst.h>
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <cmath>
+
+typedef double F;
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    const int eval_ms = argc > 1 ? std::stoi (argv[1]) : 1;
+    const unsigned int M = argc > 2 ? std::stoi (argv[2]) : 4;
+    const F target = argc > 3 ? std::stod (argv[3]) : F{2e-3};
+
+    sc::time_point t0 = sc::now();
+    std::atomic<long long int> t_hit {-1};
+    std::atomic<unsigned long long int> n_evals {0};
+    std::atomic<unsigned long long int> n_hit {0};
+
+    // The Bohachevsky function, with a wait to stand in for an expensive, thread-safe computation
+    auto objective_boha = [&](const morph::vvec<F>& params) {
+        std::this_thread::sleep_for (milliseconds (eval_ms));
+        F x = params[0];
+        F y = params[1];
+        F a = F{1}, b = F{2}, c=F{0.3}, d=F{0.4}, alpha=morph::mathconst<F>::three_pi, gamma=morph::mathconst<F>::four_pi;
+        F fn = a*x*x + b*y*y - c * std::cos(alpha*x) - d * std::cos (gamma * y) + c + d;
+        unsigned long long int n = ++n_evals;
+        long long int unset = -1;
+        if (fn <= target && t_hit.compare_exchange_strong (unset, duration_cast<milliseconds>(sc::now() - t0).count())) {
+            n_hit = n;
+        }
+        return fn;
+    };
+
+    morph::vvec<F> p = { 0.45, 0.45 };
+    morph::vvec<morph::vec<F,2>> p_rng = {{ {-0.5, 0.5}, {-0.5, 0.5} }};
+
+    for (int mode = 0; mode < 3; ++mode) {
+        morph::Anneal<F> anneal (p, p_rng);
+        // The parameters from anneal_asa.cpp
+        anneal.temperature_ratio_scale = F{1e-2};
+        anneal.temperature_anneal_scale = F{200};
+        anneal.cost_parameter_scale_ratio = F{3};
+        anneal.acc_gen_reanneal_ratio = F{1e-6};
+        anneal.delta_param = F{0.01};
+        anneal.objective_repeat_precision = F{1e-6};
+        anneal.f_x_best_repeat_max = 15;
+        anneal.reanneal_after_steps = 100;
+        // Stop at T_f, so that no run goes on for long after reaching the target
+        anneal.exit_at_T_f = true;
+        anneal.display_temperatures = false;
+        anneal.display_reanneal = false;
+        anneal.objective = objective_boha;
+        anneal.tangent_set = mode == 1;
+        anneal.parallel = mode == 1;
+        anneal.init();
+
+        t0 = sc::now();
+        t_hit = -1;
+        n_evals = 0;
+        n_hit = 0;
+        if (mode < 2) { anneal.run(); } else { anneal.run_tempering (M); }
+        sc::time_point t1 = sc::now();
+
+        std::cout << (mode == 0 ? "single chain:              " : (mode == 1 ? "single chain, tangent set: "
+                                                                   : (std::to_string(M) + " chains, tempering:     ")));
+        if (t_hit >= 0) {
+            std::cout << "target after " << t_hit << " ms (" << n_hit << " evaluations); ";
+        } else {
+            std::cout << "target not reached; ";
+        }
+        std::cout << "finished after " << duration_cast<milliseconds>(t1 - t0).count() << " ms ("
+                  << anneal.evaluation_count << " evaluations), f_x_best = " << anneal.f_x_best << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * Profile a scene of many small models (spheres and rods), first with each model added to the
+ * Visual and then with all of them merged into one BatchVisual. Reports the number of draw calls
+ * made per frame and the mean time to render a frame (including waiting for the GL to finish).
+ *
+ * Usage: profileBatchVisual [num_models] [frames]
+ */
+
+#include <morph/VisualOffscreen.h>
+#include <morph/SphereVisual.h>
+#include <morph/RodVisual.h>
+#include <morph/BatchVisual.h>
+#include <iostream>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <cmath>
+
+// Make model i of n: alternately a sphere and a rod, laid out on a square
+template <int glver>
+std::unique_ptr<morph::VisualModel<glver>> make_model (morph::VisualOffscreen<glver>& v, const unsigned int i, const unsigned int n)
+{
+    const unsigned int side = static_cast<unsigned int>(std::ceil (std::sqrt (static_cast<double>(n))));
+    const float d = 1.0f / side;
+    morph::vec<float> p = { d * (i % side), d * (i / side), 0.0f };
+    std::array<float, 3> c = { static_cast<float>(i % side) * d, 0.4f, static_cast<float>(i / side) * d };
+    std::unique_ptr<morph::VisualModel<glver>> m;
+    if (i % 2 == 0) {
+        m = std::make_unique<morph::SphereVisual<glver>> (p, 0.3f * d, c);
+    } else {
+        m = std::make_unique<morph::RodVisual<glver>> (p, morph::vec<float>{}, morph::vec<float>{ 0.0f, 0.0f, 0.8f * d }, 0.1f * d, c);
+    }
+    v.bindmodel (m);
+    m->finalize();
+    return m;
+}
+
+// Render frames frames, turning the scene a little each time. Return the mean ms per frame.
+template <int glver>
+double time_frames (morph::VisualOffscreen<glver>& v, const int frames)
+{
+    using sc = std::chrono::steady_clock;
+    v.render(); // the first frame uploads the vertices
+    sc::time_point t0 = sc::now();
+    for (int f = 0; f < frames; ++f) {
+        v.setSceneTrans (morph::vec<float>{ -0.5f + 0.001f * f, -0.5f, -2.0f });
+        v.render();
+        v.setContext();
+        v.glfn->Finish();
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(sc::now() - t0).count() / (1e3 * frames);
+}
+
+int main (int argc, char** argv)
+{
+    const unsigned int n = argc > 1 ? std::stoul (argv[1]) : 5000u;
+    const int frames = argc > 2 ? std::stoi (argv[2]) : 50;
+
+    double t_plain = 0.0;
+    {
+        morph::VisualOffscreen<> v (640, 480);
+        v.lightingEffects();
+        for (unsigned int i = 0; i < n; ++i) {
+            auto m = make_model (v, i, n);
+            v.addVisualModel (m);
+        }
+        t_plain = time_frames (v, frames);
+    }
+
+    double t_batch = 0.0;
+    std::size_t batch_calls = 0;
+    {
+        morph::VisualOffscreen<> v (640, 480);
+        v.lightingEffects();
+        auto bv = std::make_unique<morph::BatchVisual<>>();
+        v.bindmodel (bv);
+        for (unsigned int i = 0; i < n; ++i) {
+            auto m = make_model (v, i, n);
+            bv->add (m);
+        }
+        bv->finalize();
+        auto bvp = v.addVisualModel (bv);
+        t_batch = time_frames (v, frames);
+        batch_calls = bvp->draw_calls();
+    }
+
+    std::cout << n << " models, one per draw: " << n << " draw calls, " << t_plain << " ms per frame\n";
+    std::cout << n << " models in a BatchVisual: " << batch_calls << " draw call(s), " << t_batch << " ms per frame\n";
+
+    return 0;
+}
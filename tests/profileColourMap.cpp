@@ -0,0 +1,54 @@
+/*
+ * Profile ColourMap conversion: per-element convert() against the batched convert(), with and
+ * without a lookup table. Reports millions of conversions per second.
+ */
+
+#include <morph/ColourMap.h>
+#include <morph/vvec.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+int main()
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    constexpr std::size_t n = 4000000; // e.g. a 2000x2000 grid
+    morph::vvec<float> data (n);
+    data.randomize();
+    std::vector<float> colours (3 * n);
+
+    for (auto cmt : { morph::ColourMapType::Viridis, morph::ColourMapType::Fire, morph::ColourMapType::Monochrome }) {
+        morph::ColourMap<float> cm (cmt);
+        std::cout << cm.getTypeStr() << ":\n";
+
+        sc::time_point t0 = sc::now();
+        for (std::size_t i = 0; i < n; ++i) {
+            std::array<float, 3> c = cm.convert (data[i]);
+            colours[3 * i] = c[0];
+            colours[3 * i + 1] = c[1];
+            colours[3 * i + 2] = c[2];
+        }
+        sc::time_point t1 = sc::now();
+        double us = duration_cast<microseconds>(t1 - t0).count();
+        std::cout << "  per-element convert:      " << us / 1000.0 << " ms (" << n / us << " M/s)\n";
+
+        t0 = sc::now();
+        cm.convert (std::span<const float>{data}, std::span<float>{colours});
+        t1 = sc::now();
+        us = duration_cast<microseconds>(t1 - t0).count();
+        std::cout << "  batched convert (exact):  " << us / 1000.0 << " ms (" << n / us << " M/s)\n";
+
+        for (unsigned int lut_size : { 256u, 4096u }) {
+            cm.setLUTSize (lut_size);
+            t0 = sc::now();
+            cm.convert (std::span<const float>{data}, std::span<float>{colours});
+            t1 = sc::now();
+            us = duration_cast<microseconds>(t1 - t0).count();
+            std::cout << "  batched convert (LUT " << lut_size << "): " << us / 1000.0 << " ms (" << n / us << " M/s)\n";
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * Time HexGrid::computeDistanceToBoundary on a circular domain, comparing the distance transform
+ * with the exhaustive search (every inside hex against every boundary hex) that it replaced. The
+ * exhaustive search is O(N^2), so it is skipped for grids of more than 50000 hexes.
+ *
+ * Usage: profileDistanceToBoundary [hex_to_hex_distance]
+ */
+
+#include <morph/HexGrid.h>
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cmath>
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    const float d = argc > 1 ? std::stof (argv[1]) : 0.01f;
+
+    morph::HexGrid hg (d, 2.2f, 0.0f);
+    hg.setCircularBoundary (1.0f);
+    std::cout << "HexGrid has " << hg.num() << " hexes\n";
+
+    sc::time_point t0 = sc::now();
+    hg.computeDistanceToBoundary();
+    sc::time_point t1 = sc::now();
+    std::cout << "computeDistanceToBoundary (euclidean): "
+              << duration_cast<microseconds>(t1 - t0).count() / 1000.0 << " ms\n";
+
+    t0 = sc::now();
+    hg.computeDistanceToBoundary (morph::distance_metric::euclidean_approx);
+    t1 = sc::now();
+    std::cout << "computeDistanceToBoundary (approx):    "
+              << duration_cast<microseconds>(t1 - t0).count() / 1000.0 << " ms\n";
+
+    t0 = sc::now();
+    hg.computeDistanceToBoundary (morph::distance_metric::path);
+    t1 = sc::now();
+    std::cout << "computeDistanceToBoundary (path):      "
+              << duration_cast<microseconds>(t1 - t0).count() / 1000.0 << " ms\n";
+
+    if (hg.num() > 50000) { return 0; }
+
+    // The exhaustive search, over the Hex list, as computeDistanceToBoundary used to do it
+    t0 = sc::now();
+    for (auto& h : hg.hexen) {
+        if (h.boundaryHex() || !h.insideBoundary()) { continue; }
+        h.distToBoundary = -1.0f;
+        for (auto& bh : hg.hexen) {
+            if (!bh.boundaryHex()) { continue; }
+            float delta = h.distanceFrom (bh);
+            if (delta < h.distToBoundary || h.distToBoundary < 0.0f) { h.distToBoundary = delta; }
+        }
+    }
+    t1 = sc::now();
+    std::cout << "exhaustive search:                     "
+              << duration_cast<microseconds>(t1 - t0).count() / 1000.0 << " ms\n";
+
+    return 0;
+}
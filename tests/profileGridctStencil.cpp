@@ -0,0 +1,96 @@
+/*
+ * Profile the compile-time stencil operations of Gridct (laplacian, blur and advection) against
+ * the same operations written with the per-call neighbour functions of the runtime Grid, on
+ * 256 x 256 and 1024 x 1024 domains.
+ */
+
+#include <morph/Gridct.h>
+#include <morph/Grid.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+// Time f over reps repeats and return the mean time in ms
+template <typename F>
+double time_it (F f, const int reps)
+{
+    using sc = std::chrono::steady_clock;
+    f();
+    sc::time_point t0 = sc::now();
+    for (int i = 0; i < reps; ++i) { f(); }
+    return std::chrono::duration_cast<std::chrono::microseconds>(sc::now() - t0).count() / (1e3 * reps);
+}
+
+constexpr morph::vec<float, 2> dx = { 1.0f, 1.0f };
+constexpr morph::vec<float, 2> offset = { 0.0f, 0.0f };
+
+template <int N>
+void profile (const int reps)
+{
+    constexpr auto wrap = morph::GridDomainWrap::Horizontal;
+    morph::Gridct<int, float, N, N, dx, offset, false, wrap> gct;
+    morph::Grid<int, float> grt (N, N, dx, offset, wrap);
+
+    morph::vvec<float> f (N * N);
+    f.randomize();
+    morph::vvec<float> ux (N * N);
+    morph::vvec<float> uy (N * N);
+    ux.randomize (-1.0f, 1.0f);
+    uy.randomize (-1.0f, 1.0f);
+    morph::vvec<float> out (N * N);
+    morph::vvec<float> out_rt (N * N);
+
+    // Runtime versions, using the Grid's neighbour functions. A missing neighbour takes the value
+    // of the element itself, as with Gridct's clamped edges.
+    auto nb = [&grt](const int i, const int j) { return j == std::numeric_limits<int>::max() ? i : j; };
+    auto lap_rt = [&]() {
+        for (int i = 0; i < grt.n(); ++i) {
+            out_rt[i] = f[nb (i, grt.index_ne (i))] + f[nb (i, grt.index_nw (i))]
+            + f[nb (i, grt.index_nn (i))] + f[nb (i, grt.index_ns (i))] - 4.0f * f[i];
+        }
+    };
+    auto blur_rt = [&]() {
+        for (int i = 0; i < grt.n(); ++i) {
+            const int n = nb (i, grt.index_nn (i));
+            const int s = nb (i, grt.index_ns (i));
+            out_rt[i] = (f[nb (n, grt.index_nw (n))] + 2.0f * f[n] + f[nb (n, grt.index_ne (n))]
+                         + 2.0f * f[nb (i, grt.index_nw (i))] + 4.0f * f[i] + 2.0f * f[nb (i, grt.index_ne (i))]
+                         + f[nb (s, grt.index_nw (s))] + 2.0f * f[s] + f[nb (s, grt.index_ne (s))]) / 16.0f;
+        }
+    };
+    auto adv_rt = [&]() {
+        for (int i = 0; i < grt.n(); ++i) {
+            const float dfdx = ux[i] > 0.0f ? f[i] - f[nb (i, grt.index_nw (i))] : f[nb (i, grt.index_ne (i))] - f[i];
+            const float dfdy = uy[i] > 0.0f ? f[i] - f[nb (i, grt.index_ns (i))] : f[nb (i, grt.index_nn (i))] - f[i];
+            out_rt[i] = -(ux[i] * dfdx + uy[i] * dfdy);
+        }
+    };
+
+    const double mel = N * N / 1e3; // elements per ms / 1e3 = Melements/s
+    auto report = [mel, &out, &out_rt](const char* what, const double t_rt, const double t_ct) {
+        float maxdiff = 0.0f;
+        for (std::size_t i = 0; i < out.size(); ++i) { maxdiff = std::max (maxdiff, std::abs (out[i] - out_rt[i])); }
+        std::cout << "  " << what << ": Grid " << t_rt << " ms (" << mel / t_rt << " Melem/s), Gridct " << t_ct
+                  << " ms (" << mel / t_ct << " Melem/s), speedup " << t_rt / t_ct << ", max difference " << maxdiff << "\n";
+    };
+
+    std::cout << N << " x " << N << ":\n";
+    double t_rt = time_it (lap_rt, reps);
+    double t_ct = time_it ([&]() { gct.laplacian (f, out); }, reps);
+    report ("laplacian", t_rt, t_ct);
+    t_rt = time_it (blur_rt, reps);
+    t_ct = time_it ([&]() { gct.blur (f, out); }, reps);
+    report ("blur     ", t_rt, t_ct);
+    t_rt = time_it (adv_rt, reps);
+    t_ct = time_it ([&]() { gct.advection (f, ux, uy, out); }, reps);
+    report ("advection", t_rt, t_ct);
+}
+
+int main()
+{
+    profile<256> (200);
+    profile<1024> (20);
+    return 0;
+}
@@ -0,0 +1,58 @@
+/*
+ * Profile morph::HealpixGrid: the time to build the neighbour table and Laplacian stencil, and
+ * the throughput of laplacian() for nside from 64 up to a maximum (1024 by default). For
+ * comparison, also time a Laplacian that finds each pixel's neighbours afresh on every step, as a
+ * solver without the table would. Set OMP_NUM_THREADS to choose the number of threads.
+ *
+ * Usage: profileHealpixGrid [max_nside] [steps]
+ */
+
+#include <morph/HealpixGrid.h>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <cmath>
+
+int main (int argc, char** argv)
+{
+    using sc = std::chrono::steady_clock;
+    auto ms_since = [](sc::time_point t0) { return std::chrono::duration_cast<std::chrono::microseconds>(sc::now() - t0).count() / 1e3; };
+
+    const std::int64_t max_nside = argc > 1 ? std::stoll (argv[1]) : 1024;
+    const int steps = argc > 2 ? std::stoi (argv[2]) : 10;
+
+    for (std::int64_t nside = 64; nside <= max_nside; nside *= 2) {
+        sc::time_point t0 = sc::now();
+        morph::HealpixGrid<float> hg (nside);
+        const double t_build = ms_since (t0);
+
+        std::vector<float> f (hg.n()), lapf (hg.n());
+        for (std::int64_t p = 0; p < hg.n(); ++p) { f[p] = hg.centre (p)[2] * hg.centre (p)[0]; }
+
+        t0 = sc::now();
+        for (int s = 0; s < steps; ++s) { hg.laplacian (f, lapf); }
+        const double t_table = ms_since (t0) / steps;
+
+        // Neighbours found for every pixel on every step
+        t0 = sc::now();
+        for (int s = 0; s < steps; ++s) {
+            const std::int64_t np = hg.n();
+#pragma omp parallel for schedule(static)
+            for (std::int64_t p = 0; p < np; ++p) {
+                std::array<std::int32_t, 8> nb = morph::HealpixGrid<float>::find_neighbours (nside, p);
+                const std::array<float, 8>& w = hg.laplacian_weights (p);
+                float sum = 0.0f;
+                for (int k = 0; k < 8; ++k) { if (nb[k] != -1) { sum += w[k] * (f[nb[k]] - f[p]); } }
+                lapf[p] = sum;
+            }
+        }
+        const double t_fresh = ms_since (t0) / steps;
+
+        std::cout << "nside " << nside << " (" << hg.n() << " pixels): build " << t_build << " ms; laplacian "
+                  << t_table << " ms/step (" << hg.n() / (1e3 * t_table) << " Mpixel/s) with the table, "
+                  << t_fresh << " ms/step finding neighbours each step\n";
+    }
+
+    return 0;
+}
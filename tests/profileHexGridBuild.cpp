@@ -0,0 +1,46 @@
+/*
+ * Time the construction of an elliptical HexGrid domain, either by making a large hexagon of hexes
+ * and reducing it with setBoundary ("old") or by rasterising the boundary directly ("new"). Run
+ * each mode in its own process so that the peak memory use (ru_maxrss) can be compared.
+ *
+ * Usage: profileHexGridBuild old|new [hex_to_hex_distance]
+ */
+
+#include <morph/HexGrid.h>
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    const std::string mode = argc > 1 ? std::string(argv[1]) : std::string("new");
+    const float d = argc > 2 ? std::stof (argv[2]) : 0.005f;
+
+    // Compute the boundary points with a small grid of the same hex size
+    morph::HexGrid hg_pts (d, 4.0f * d, 0.0f);
+    std::vector<morph::BezCoord<float>> bpoints = hg_pts.ellipseCompute (1.0f, 0.7f);
+
+    sc::time_point t0 = sc::now();
+    morph::HexGrid hg;
+    if (mode == "old") {
+        hg.init (d, 3.0f, 0.0f);
+        hg.setBoundary (bpoints);
+    } else {
+        hg.init (d, bpoints);
+    }
+    sc::time_point t1 = sc::now();
+
+    struct rusage ru;
+    getrusage (RUSAGE_SELF, &ru);
+
+    std::cout << mode << ": " << hg.num() << " hexes in "
+              << duration_cast<microseconds>(t1 - t0).count() / 1000.0 << " ms; peak RSS "
+              << ru.ru_maxrss / 1024 << " MB\n";
+
+    return 0;
+}
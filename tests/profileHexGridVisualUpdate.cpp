@@ -0,0 +1,74 @@
+/*
+ * Frame times for a dynamic HexGridVisual. Each frame, the data on the HexGrid changes and the
+ * model is updated and rendered offscreen. Compares the in-place update (updateData in
+ * Triangles mode, which re-uploads only the position and colour buffers) with a full rebuild
+ * (reinit) and with HexInterp mode, which always rebuilds.
+ *
+ * Usage: profileHexGridVisualUpdate [num_frames] [hex_to_hex_distance]
+ */
+
+#include <morph/VisualOffscreen.h>
+#include <morph/HexGridVisual.h>
+#include <morph/HexGrid.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cmath>
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    const int nframes = argc > 1 ? std::stoi (argv[1]) : 100;
+    const float d = argc > 2 ? std::stof (argv[2]) : 0.01f;
+
+    morph::VisualOffscreen<> v (800, 600);
+    morph::HexGrid hg (d, 3.0f, 0.0f);
+    hg.setCircularBoundary (0.6f);
+    std::cout << "HexGrid has " << hg.num() << " hexes\n";
+
+    morph::vvec<float> data (hg.num(), 0.0f);
+    auto compute_data = [&hg, &data](const int f) {
+        for (unsigned int i = 0; i < hg.num(); ++i) {
+            data[i] = 0.05f * std::sin (10.0f * hg.d_x[i] + 0.1f * f) * std::cos (7.0f * hg.d_y[i]);
+        }
+    };
+
+    enum class method { in_place, reinit, hexinterp };
+    for (method m : { method::in_place, method::reinit, method::hexinterp }) {
+        compute_data (0);
+        auto hgv = std::make_unique<morph::HexGridVisual<float>> (&hg, morph::vec<float>{});
+        v.bindmodel (hgv);
+        hgv->hexVisMode = m == method::hexinterp ? morph::HexVisMode::HexInterp : morph::HexVisMode::Triangles;
+        hgv->setScalarData (&data);
+        hgv->zScale.setParams (1.0f, 0.0f);
+        hgv->colourScale.compute_scaling (-0.05f, 0.05f);
+        hgv->finalize();
+        auto hgvp = v.addVisualModel (hgv);
+        v.render();
+
+        sc::duration t_update = sc::duration::zero();
+        sc::time_point t0 = sc::now();
+        for (int f = 1; f <= nframes; ++f) {
+            compute_data (f);
+            sc::time_point tu = sc::now();
+            if (m == method::reinit) { hgvp->reinit(); } else { hgvp->updateData (&data); }
+            t_update += sc::now() - tu;
+            v.render();
+        }
+        v.setContext();
+        v.glfn->Finish();
+        sc::time_point t1 = sc::now();
+        v.releaseContext();
+        v.removeVisualModel (hgvp);
+
+        double ms = duration_cast<microseconds>(t1 - t0).count() / 1000.0 / nframes;
+        double ms_update = duration_cast<microseconds>(t_update).count() / 1000.0 / nframes;
+        std::cout << (m == method::in_place ? "updateData (in place): " : m == method::reinit ? "reinit (full rebuild): " : "HexInterp (rebuild):   ")
+                  << ms << " ms/frame, of which " << ms_update << " ms updating the model\n";
+    }
+
+    return 0;
+}
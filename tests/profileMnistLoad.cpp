@@ -0,0 +1,83 @@
+/*
+ * Compare the load time and peak memory of morph::Mnist (a vvec per example in a multimap)
+ * and morph::idx_dataset (one contiguous array) for MNIST-sized data. If the MNIST files are
+ * not found in the given directory, random MNIST-sized files are written there first. Run each
+ * mode in its own process so that the peak memory use (ru_maxrss) can be compared.
+ *
+ * Usage: profileMnistLoad mnist|idx|idx_lazy [directory/]
+ */
+
+#include <morph/Mnist.h>
+#include <morph/idx.h>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+
+void write32 (std::ofstream& f, unsigned int v)
+{
+    char b[4] = { static_cast<char>((v >> 24) & 0xff), static_cast<char>((v >> 16) & 0xff),
+                  static_cast<char>((v >> 8) & 0xff), static_cast<char>(v & 0xff) };
+    f.write (b, 4);
+}
+
+void write_idx (const std::string& tag, unsigned int n)
+{
+    if (std::ifstream (tag + "-images-idx3-ubyte").good()) { return; }
+    std::mt19937 gen (1);
+    std::vector<char> img (784);
+    std::ofstream fi (tag + "-images-idx3-ubyte", std::ios::out | std::ios::binary | std::ios::trunc);
+    write32 (fi, 2051);
+    write32 (fi, n);
+    write32 (fi, 28);
+    write32 (fi, 28);
+    for (unsigned int i = 0; i < n; ++i) {
+        for (auto& c : img) { c = static_cast<char>(gen() & 0xff); }
+        fi.write (img.data(), 784);
+    }
+    std::ofstream fl (tag + "-labels-idx1-ubyte", std::ios::out | std::ios::binary | std::ios::trunc);
+    write32 (fl, 2049);
+    write32 (fl, n);
+    for (unsigned int i = 0; i < n; ++i) { char c = static_cast<char>(i % 10); fl.write (&c, 1); }
+}
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    const std::string mode = argc > 1 ? std::string(argv[1]) : std::string("idx");
+    const std::string dir = argc > 2 ? std::string(argv[2]) : std::string("./");
+    write_idx (dir + "train", 60000);
+    write_idx (dir + "t10k", 10000);
+
+    std::size_t n = 0;
+    sc::time_point t0 = sc::now();
+    if (mode == "mnist") {
+        morph::Mnist m (dir);
+        n = m.num_training() + m.num_test();
+    } else {
+        morph::idx_convert conv = mode == "idx_lazy" ? morph::idx_convert::lazy : morph::idx_convert::eager;
+        morph::idx_dataset train (dir + "train-images-idx3-ubyte", dir + "train-labels-idx1-ubyte", 1.0f / 256.0f, true, conv);
+        morph::idx_dataset test (dir + "t10k-images-idx3-ubyte", dir + "t10k-labels-idx1-ubyte", 1.0f / 256.0f, true, conv);
+        n = train.size() + test.size();
+        if (conv == morph::idx_convert::lazy) {
+            // Touch every example, as one epoch of training would
+            std::vector<float> ex (train.example_size());
+            float sum = 0.0f;
+            for (std::size_t i = 0; i < train.size(); ++i) { train.example_into (i, ex.data()); sum += ex[400]; }
+            std::cout << "(sum " << sum << ")\n";
+        }
+    }
+    sc::time_point t1 = sc::now();
+
+    struct rusage ru;
+    getrusage (RUSAGE_SELF, &ru);
+    std::cout << mode << ": loaded " << n << " examples in "
+              << duration_cast<microseconds>(t1 - t0).count() / 1000.0 << " ms; peak RSS "
+              << ru.ru_maxrss / 1024 << " MB\n";
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Time the Nelder Mead Simplex on the Rosenbrock banana function (the problem in
+ * examples/rosenbrock.cpp, without the visualisation), when each evaluation of the objective is
+ * made expensive, as it is if the objective is a simulation run. Compares the serial run() with
+ * parallel evaluation, parallel evaluation with speculation and K multi-start runs.
+ *
+ * Usage: profileNMSimplex [milliseconds_per_evaluation] [K]
+ */
+
+#include <morph/NM_Simplex.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    const int eval_ms = argc > 1 ? std::stoi (argv[1]) : 2;
+    const int K = argc > 2 ? std::stoi (argv[2]) : 4;
+
+    // The banana function, with a wait to stand in for an expensive, thread-safe computation
+    auto banana = [eval_ms](const morph::vvec<double>& point) {
+        std::this_thread::sleep_for (milliseconds (eval_ms));
+        double x = point[0];
+        double y = point[1];
+        return ((1.0 - x) * (1.0 - x)) + (100.0 * (y - (x * x)) * (y - (x * x)));
+    };
+
+    morph::vvec<morph::vvec<double>> i_vertices = { { 0.7, 0.0 }, { 0.0, 0.6 }, { -0.6, -1.0 } };
+
+    auto report = [](const std::string& label, const morph::NM_Simplex<double>& s, sc::duration d) {
+        std::cout << label << duration_cast<milliseconds>(d).count() << " ms, "
+                  << s.evaluation_count << " evaluations, best value "
+                  << s.best_value() << "\n";
+    };
+
+    for (int mode = 0; mode < 3; ++mode) {
+        morph::NM_Simplex<double> simp (i_vertices);
+        simp.objective = banana;
+        simp.termination_threshold = 1e-8;
+        simp.too_many_operations = 10000;
+        simp.parallel = mode > 0;
+        simp.speculate = mode > 1;
+        sc::time_point t0 = sc::now();
+        simp.run();
+        sc::time_point t1 = sc::now();
+        report (mode == 0 ? "serial:               " : (mode == 1 ? "parallel:             " : "parallel, speculate:  "), simp, t1 - t0);
+    }
+
+    // K restarts, one after the other, then all at once
+    std::vector<morph::vvec<morph::vvec<double>>> starts;
+    for (int k = 0; k < K; ++k) {
+        double o = 0.5 * k;
+        starts.push_back ({ { 0.7 - o, 0.0 + o }, { 0.0 - o, 0.6 }, { -0.6, -1.0 + o } });
+    }
+    sc::time_point t0 = sc::now();
+    for (auto st : starts) {
+        morph::NM_Simplex<double> simp (st);
+        simp.objective = banana;
+        simp.termination_threshold = 1e-8;
+        simp.too_many_operations = 10000;
+        simp.run();
+    }
+    sc::time_point t1 = sc::now();
+    std::cout << K << " starts, serially:    " << duration_cast<milliseconds>(t1 - t0).count() << " ms\n";
+
+    morph::NM_Simplex<double> msimp (2);
+    msimp.objective = banana;
+    msimp.termination_threshold = 1e-8;
+    msimp.too_many_operations = 10000;
+    t0 = sc::now();
+    msimp.run_multistart (starts);
+    t1 = sc::now();
+    std::cout << K << " starts, multistart:  " << duration_cast<milliseconds>(t1 - t0).count() << " ms\n";
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * Measure the rate (numbers per second) at which uniform and normal random numbers are
+ * generated by morph::RandUniform/RandNormal (one get() per number) and by morph::philox4x32
+ * (bulk fills, which run on all OpenMP threads for large spans).
+ *
+ * Usage: profileRandom [N]
+ */
+
+#include <morph/Random.h>
+#include <morph/philox.h>
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <functional>
+
+template <typename T>
+void report (const std::string& label, std::vector<T>& v, std::function<void(std::vector<T>&)> f)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+    f (v); // warm up
+    sc::time_point t0 = sc::now();
+    f (v);
+    sc::time_point t1 = sc::now();
+    double s = duration_cast<microseconds>(t1 - t0).count() / 1e6;
+    double sum = 0.0;
+    for (auto x : v) { sum += x; }
+    std::cout << label << v.size() / s / 1e6 << " M numbers/s (mean " << sum / v.size() << ")\n";
+}
+
+int main (int argc, char** argv)
+{
+    const std::size_t N = argc > 1 ? std::stoul (argv[1]) : 10000000;
+    std::vector<float> vf (N);
+    std::vector<double> vd (N);
+
+    report<float> ("RandUniform<float>::get():          ", vf, [](std::vector<float>& v) {
+        morph::RandUniform<float> ru;
+        for (auto& x : v) { x = ru.get(); }
+    });
+    report<float> ("RandUniform<float, philox4x32>:     ", vf, [](std::vector<float>& v) {
+        morph::RandUniform<float, morph::philox4x32> ru;
+        for (auto& x : v) { x = ru.get(); }
+    });
+    report<float> ("philox4x32::fill_uniform<float>:    ", vf, [](std::vector<float>& v) {
+        morph::philox4x32 gen (1);
+        gen.fill_uniform (std::span<float>(v));
+    });
+    report<double> ("RandUniform<double>::get():         ", vd, [](std::vector<double>& v) {
+        morph::RandUniform<double> ru;
+        for (auto& x : v) { x = ru.get(); }
+    });
+    report<double> ("philox4x32::fill_uniform<double>:   ", vd, [](std::vector<double>& v) {
+        morph::philox4x32 gen (1);
+        gen.fill_uniform (std::span<double>(v));
+    });
+    report<float> ("RandNormal<float>::get():           ", vf, [](std::vector<float>& v) {
+        morph::RandNormal<float> rn;
+        for (auto& x : v) { x = rn.get(); }
+    });
+    report<float> ("philox4x32::fill_normal<float>:     ", vf, [](std::vector<float>& v) {
+        morph::philox4x32 gen (1);
+        gen.fill_normal (std::span<float>(v));
+    });
+    report<double> ("RandNormal<double>::get():          ", vd, [](std::vector<double>& v) {
+        morph::RandNormal<double> rn;
+        for (auto& x : v) { x = rn.get(); }
+    });
+    report<double> ("philox4x32::fill_normal<double>:    ", vd, [](std::vector<double>& v) {
+        morph::philox4x32 gen (1);
+        gen.fill_normal (std::span<double>(v));
+    });
+
+    return 0;
+}
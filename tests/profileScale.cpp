@@ -0,0 +1,63 @@
+/*
+ * Profile morph::scale over a large array. Compares the old element-by-element path (a std::list
+ * container, or transform_one in a loop) with the block transform, and two separate z/colour
+ * transforms with a single transform_pair. Reports millions of elements per second.
+ */
+
+#include <morph/scale.h>
+#include <morph/vvec.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+int main()
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    constexpr std::size_t n = 4000000; // e.g. a 2000x2000 grid
+    constexpr int reps = 10;
+    morph::vvec<float> data (n);
+    data.randomize (0.1f, 10.0f);
+    std::vector<float> z (n);
+    std::vector<float> c (n);
+
+    auto report = [](const char* what, sc::time_point t0, sc::time_point t1) {
+        double secs = duration_cast<microseconds>(t1 - t0).count() / 1e6;
+        std::cout << what << ": " << (reps * n / secs) / 1e6 << " M elements/s\n";
+    };
+
+    for (auto sf : { morph::scaling_function::Linear, morph::scaling_function::Logarithmic }) {
+        std::cout << (sf == morph::scaling_function::Linear ? "Linear" : "Logarithmic") << ":\n";
+        morph::scale<float> zs;
+        zs.setType (sf);
+        zs.do_autoscale = true;
+        morph::scale<float> cs = zs;
+
+        sc::time_point t0 = sc::now();
+        for (int r = 0; r < reps; ++r) {
+            zs.reset();
+            zs.compute_scaling_from_data (data);
+            for (std::size_t i = 0; i < n; ++i) { z[i] = zs.transform_one (data[i]); }
+        }
+        report ("  transform_one loop  ", t0, sc::now());
+
+        t0 = sc::now();
+        for (int r = 0; r < reps; ++r) { zs.reset(); zs.transform (data, z); }
+        report ("  block transform     ", t0, sc::now());
+
+        t0 = sc::now();
+        for (int r = 0; r < reps; ++r) {
+            zs.reset(); cs.reset();
+            zs.transform (data, z);
+            cs.transform (data, c);
+        }
+        report ("  z + colour separate ", t0, sc::now());
+
+        t0 = sc::now();
+        for (int r = 0; r < reps; ++r) { zs.reset(); cs.reset(); zs.transform_pair (data, z, cs, c); }
+        report ("  z + colour pair     ", t0, sc::now());
+    }
+
+    return 0;
+}
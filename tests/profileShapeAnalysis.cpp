@@ -0,0 +1,83 @@
+/*
+ * Time the per-frame analysis of a pattern of domains on a HexGrid: finding the Dirichlet domains
+ * with dirichlet_vertices (vertex search, boundary walks and area fill) against the one pass
+ * hex_regions, and then the Honda analysis of the domains with dirichlet_analyse.
+ *
+ * Usage: profileShapeAnalysis [hex_to_hex_distance] [number_of_domains] [frames]
+ */
+
+#include <morph/HexGrid.h>
+#include <morph/ShapeAnalysis.h>
+#include <morph/vec.h>
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <list>
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    const float d = argc > 1 ? std::stof (argv[1]) : 0.005f;
+    const int K = argc > 2 ? std::stoi (argv[2]) : 80;
+    const int frames = argc > 3 ? std::stoi (argv[3]) : 10;
+
+    morph::HexGrid hg (d, 3.0f, 0.0f);
+    hg.setCircularBoundary (0.6f);
+    std::cout << hg.num() << " hexes, " << K << " domains, " << frames << " frames\n";
+
+    std::mt19937 gen (42);
+    std::uniform_real_distribution<float> u (-0.6f, 0.6f);
+    std::normal_distribution<float> drift (0.0f, 0.005f);
+    std::vector<morph::vec<float, 2>> seeds;
+    while (static_cast<int>(seeds.size()) < K) {
+        morph::vec<float, 2> s = { u(gen), u(gen) };
+        if (s.length() < 0.6f) { seeds.push_back (s); }
+    }
+
+    std::vector<float> f (hg.num());
+    sc::duration t_walk = sc::duration::zero();
+    sc::duration t_regions = sc::duration::zero();
+    sc::duration t_analyse = sc::duration::zero();
+    std::size_t n_walk = 0;
+    std::size_t n_regions = 0;
+    for (int fr = 0; fr < frames; ++fr) {
+        // A Voronoi pattern, with seeds that drift from frame to frame
+        for (auto& s : seeds) { s[0] += drift (gen); s[1] += drift (gen); }
+        for (unsigned int i = 0; i < hg.num(); ++i) {
+            morph::vec<float, 2> p = { hg.d_x[i], hg.d_y[i] };
+            int nearest = 0;
+            for (int k = 1; k < K; ++k) {
+                if ((p - seeds[k]).length() < (p - seeds[nearest]).length()) { nearest = k; }
+            }
+            f[i] = 0.01f * (nearest + 1);
+        }
+
+        sc::time_point t0 = sc::now();
+        std::list<morph::DirichVtx<float>> vertices;
+        std::list<morph::DirichDom<float>> walked = morph::ShapeAnalysis<float>::dirichlet_vertices (&hg, f, vertices);
+        sc::time_point t1 = sc::now();
+        std::list<morph::DirichDom<float>> doms;
+        morph::ShapeAnalysis<float>::hex_regions (&hg, f, &doms);
+        sc::time_point t2 = sc::now();
+        std::vector<morph::vec<float, 2>> d_centres;
+        morph::ShapeAnalysis<float>::dirichlet_analyse (doms, d_centres);
+        sc::time_point t3 = sc::now();
+
+        t_walk += t1 - t0;
+        t_regions += t2 - t1;
+        t_analyse += t3 - t2;
+        n_walk += walked.size();
+        n_regions += doms.size();
+    }
+
+    auto per_frame = [frames](sc::duration t) { return duration_cast<microseconds>(t).count() / frames; };
+    std::cout << "dirichlet_vertices:  " << per_frame (t_walk) << " us/frame (" << n_walk / frames << " domains)\n";
+    std::cout << "hex_regions:         " << per_frame (t_regions) << " us/frame (" << n_regions / frames << " domains)\n";
+    std::cout << "dirichlet_analyse:   " << per_frame (t_analyse) << " us/frame\n";
+
+    return 0;
+}
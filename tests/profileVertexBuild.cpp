@@ -0,0 +1,86 @@
+/*
+ * Profile the CPU-side construction of the vertices of large VisualModels, built on one thread
+ * and with VertexArena::build() sharing the elements out between threads. The models are never
+ * bound to a Visual and never finalized, so no GL context is needed; only initializeVertices()
+ * is timed. Set OMP_NUM_THREADS to choose the number of threads.
+ *
+ * Usage: profileVertexBuild [num_quivers] [grid_side] [repeats]
+ */
+
+// For the GL headers that VisualModels need. No GL context is made.
+#include <morph/VisualOffscreen.h>
+#include <morph/QuiverVisual.h>
+#include <morph/GridVisual.h>
+#include <morph/Grid.h>
+#include <morph/vec.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+#include <cmath>
+
+// Return the mean time, in ms, to make a model with make() and build its vertices
+template <typename M>
+double time_build (M make, const bool parallel, const int repeats, std::size_t& nverts)
+{
+    using sc = std::chrono::steady_clock;
+    sc::duration t = sc::duration::zero();
+    for (int r = 0; r < repeats; ++r) {
+        auto model = make();
+        model->parallel_build = parallel;
+        sc::time_point t0 = sc::now();
+        model->initializeVertices();
+        t += sc::now() - t0;
+        nverts = model->vpos_size() / 3;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(t).count() / (1e3 * repeats);
+}
+
+int main (int argc, char** argv)
+{
+    const unsigned int nq = argc > 1 ? std::stoul (argv[1]) : 200000u;
+    const unsigned int side = argc > 2 ? std::stoul (argv[2]) : 1000u;
+    const int repeats = argc > 3 ? std::stoi (argv[3]) : 3;
+
+    // A field of arrows on a square
+    const unsigned int qside = static_cast<unsigned int>(std::sqrt (static_cast<double>(nq)));
+    std::vector<morph::vec<float>> coords (nq);
+    std::vector<morph::vec<float>> quivs (nq);
+    for (unsigned int i = 0; i < nq; ++i) {
+        float x = static_cast<float>(i % qside) / qside;
+        float y = static_cast<float>(i / qside) / qside;
+        coords[i] = { x, y, 0.0f };
+        quivs[i] = { std::cos (6.0f * y), std::sin (6.0f * x), 0.2f };
+    }
+    auto make_quiver = [&]() {
+        auto qv = std::make_unique<morph::QuiverVisual<float>> (&coords, morph::vec<float>{}, &quivs, morph::ColourMapType::Viridis);
+        qv->quiver_length_gain = 0.5f / qside;
+        qv->shapesides = 8;
+        return qv;
+    };
+
+    // A columns-mode grid
+    morph::Grid<unsigned int, float> grid (side, side, morph::vec<float, 2>{ 1.0f / side, 1.0f / side });
+    morph::vvec<float> data (grid.n());
+    for (unsigned int i = 0; i < grid.n(); ++i) { data[i] = std::sin (0.01f * (i % side)) * std::cos (0.013f * (i / side)); }
+    auto make_grid = [&]() {
+        auto gv = std::make_unique<morph::GridVisual<float>> (&grid, morph::vec<float>{});
+        gv->gridVisMode = morph::GridVisMode::Columns;
+        gv->setScalarData (&data);
+        return gv;
+    };
+
+    std::size_t nv = 0;
+    double ts = time_build (make_quiver, false, repeats, nv);
+    double tp = time_build (make_quiver, true, repeats, nv);
+    std::cout << nq << " quivers (" << nv << " vertices): " << ts << " ms on one thread, " << tp << " ms in parallel\n";
+
+    ts = time_build (make_grid, false, repeats, nv);
+    tp = time_build (make_grid, true, repeats, nv);
+    std::cout << side << "x" << side << " grid in columns (" << nv << " vertices): " << ts << " ms on one thread, "
+              << tp << " ms in parallel\n";
+
+    return 0;
+}
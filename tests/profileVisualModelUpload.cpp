@@ -0,0 +1,75 @@
+/*
+ * Profile the upload of a large GridVisual to the GPU in the separate and packed vertex formats.
+ * For each format, reports the number of bytes copied by reinit_buffers() and the mean time it
+ * takes (including packing the vertices and waiting for the copy to complete), then the time for
+ * a frame in which the colours are updated in place, with and without orphan_on_update.
+ *
+ * Usage: profileVisualModelUpload [grid_side] [repeats]
+ */
+
+#include <morph/VisualOffscreen.h>
+#include <morph/GridVisual.h>
+#include <morph/Grid.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cmath>
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    const unsigned int side = argc > 1 ? std::stoul (argv[1]) : 1000u;
+    const int repeats = argc > 2 ? std::stoi (argv[2]) : 20;
+
+    morph::VisualOffscreen<> v (640, 480);
+    morph::Grid<unsigned int, float> grid (side, side, morph::vec<float, 2>{ 1.0f / side, 1.0f / side });
+    morph::vvec<float> data (grid.n());
+    for (unsigned int i = 0; i < grid.n(); ++i) { data[i] = std::sin (0.01f * (i % side)) * std::cos (0.013f * (i / side)); }
+
+    for (auto vf : { morph::visgl::vertex_format::separate, morph::visgl::vertex_format::packed }) {
+        auto gv = std::make_unique<morph::GridVisual<float>> (&grid, morph::vec<float>{ -0.5f, -0.5f, 0.0f });
+        v.bindmodel (gv);
+        gv->vertex_format = vf;
+        gv->gridVisMode = morph::GridVisMode::Triangles;
+        gv->setScalarData (&data);
+        gv->colourScale.compute_scaling (-1.0f, 1.0f);
+        gv->finalize();
+        auto gvp = v.addVisualModel (gv);
+        v.render();
+
+        sc::duration t = sc::duration::zero();
+        for (int r = 0; r < repeats; ++r) {
+            sc::time_point t0 = sc::now();
+            gvp->reinit_buffers();
+            v.setContext();
+            v.glfn->Finish();
+            t += sc::now() - t0;
+        }
+        std::cout << (vf == morph::visgl::vertex_format::packed ? "packed:   " : "separate: ")
+                  << gvp->upload_bytes() / 1048576.0 << " MB per upload, "
+                  << duration_cast<microseconds>(t).count() / (1e3 * repeats) << " ms per reinit_buffers()\n";
+
+        // Frames in which the colours are updated in place, with and without orphaning
+        for (bool orphan : { false, true }) {
+            gvp->orphan_on_update = orphan;
+            t = sc::duration::zero();
+            for (int r = 0; r < repeats; ++r) {
+                sc::time_point t0 = sc::now();
+                gvp->set_dirty (gvp->colVBO);
+                gvp->reinit_dirty_buffers();
+                v.render();
+                v.setContext();
+                v.glfn->Finish();
+                t += sc::now() - t0;
+            }
+            std::cout << "          colour update and render, orphan_on_update " << (orphan ? "true:  " : "false: ")
+                      << duration_cast<microseconds>(t).count() / (1e3 * repeats) << " ms per frame\n";
+        }
+        v.removeVisualModel (gvp);
+    }
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * Profile headless figure generation with morph::VisualOffscreen. Each 'figure' is a GraphVisual
+ * that is built, rendered and saved as a PNG. Figures are shared out between 1, 2, ... N threads,
+ * each of which owns one VisualOffscreen (and thus one OpenGL context). Reports figures/s.
+ *
+ * Usage: profileVisualOffscreen [num_figures] [max_threads]
+ */
+
+#include <morph/VisualOffscreen.h>
+#include <morph/GraphVisual.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <string>
+
+void make_figures (const int t, const int first, const int last, const std::string& dir)
+{
+    morph::VisualOffscreen<> v (800, 600);
+    morph::vvec<double> x;
+    x.linspace (-1.0, 1.0, 100);
+    for (int f = first; f < last; ++f) {
+        auto gv = std::make_unique<morph::GraphVisual<double>> (morph::vec<float>({-0.5f, -0.5f, 0.0f}));
+        v.bindmodel (gv);
+        gv->setdata (x, (x * static_cast<double>(f + 1)).sin());
+        gv->finalize();
+        auto gvp = v.addVisualModel (gv);
+        v.render();
+        v.saveImage (dir + "/fig_" + std::to_string (t) + "_" + std::to_string (f) + ".png");
+        v.removeVisualModel (gvp);
+    }
+    v.releaseContext();
+}
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    int num_figures = argc > 1 ? std::stoi (argv[1]) : 48;
+    int max_threads = argc > 2 ? std::stoi (argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+    if (max_threads < 1) { max_threads = 1; }
+
+    const std::string dir = "./profileVisualOffscreen_figs";
+    std::filesystem::create_directories (dir);
+
+    for (int nt = 1; nt <= max_threads; nt *= 2) {
+        sc::time_point t0 = sc::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < nt; ++t) {
+            int first = (num_figures * t) / nt;
+            int last = (num_figures * (t + 1)) / nt;
+            threads.emplace_back (make_figures, t, first, last, dir);
+        }
+        for (auto& th : threads) { th.join(); }
+        sc::time_point t1 = sc::now();
+        double secs = duration_cast<microseconds>(t1 - t0).count() / 1e6;
+        std::cout << num_figures << " 800x600 figures with " << nt << " thread(s): "
+                  << secs << " s (" << (num_figures / secs) << " figures/s)\n";
+    }
+
+    std::filesystem::remove_all (dir);
+    return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * Profile the CPU cost of a frame against the number of VisualModels in the scene. Each model is
+ * a small, lit SphereVisual, so the time per frame is dominated by the per-model work done on the
+ * CPU (setting uniforms, binding buffers, issuing draw calls) rather than by the GPU. Renders into
+ * a headless morph::VisualOffscreen and reports the mean time spent in render() for each scene
+ * size, along with the time per model.
+ *
+ * Usage: profileVisualRender [frames] [max_models]
+ */
+
+#include <morph/VisualOffscreen.h>
+#include <morph/SphereVisual.h>
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cmath>
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    const int frames = argc > 1 ? std::stoi (argv[1]) : 100;
+    const int max_models = argc > 2 ? std::stoi (argv[2]) : 4096;
+
+    for (int nm = 1; nm <= max_models; nm *= 4) {
+        morph::VisualOffscreen<> v (640, 480);
+        v.lightingEffects();
+        // Lay the spheres out on a square grid in front of the camera
+        const int side = static_cast<int>(std::ceil (std::sqrt (static_cast<double>(nm))));
+        const float sp = 2.0f / side;
+        for (int i = 0; i < nm; ++i) {
+            morph::vec<float> pos = { -1.0f + sp * (i % side), -1.0f + sp * (i / side), 0.0f };
+            auto sv = std::make_unique<morph::SphereVisual<>> (pos, 0.4f * sp, std::array<float, 3>{ 0.2f, 0.4f, 0.8f });
+            v.bindmodel (sv);
+            sv->finalize();
+            v.addVisualModel (sv);
+        }
+        v.render(); // Warm up; the first frame compiles and links the shaders
+
+        sc::duration cpu = sc::duration::zero();
+        for (int f = 0; f < frames; ++f) {
+            sc::time_point t0 = sc::now();
+            v.render();
+            cpu += sc::now() - t0;
+        }
+        double us = duration_cast<nanoseconds>(cpu).count() / (1e3 * frames);
+        std::cout << nm << " models: " << us << " us per frame, " << us / nm << " us per model\n";
+        v.releaseContext();
+    }
+
+    return 0;
+}
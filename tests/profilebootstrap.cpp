@@ -0,0 +1,52 @@
+/*
+ * Compare the time and peak memory of a bootstrapped standard error of the mean computed by
+ * materialising all the resamples (bootstrap::resample_with_replacement, as error_of_mean used
+ * to) and by streaming them (bootstrap::resample_statistics, as error_of_mean does now). Run
+ * each mode in its own process so that the peak memory use (ru_maxrss) can be compared.
+ *
+ * Usage: profilebootstrap materialise|stream [N] [B]
+ */
+
+#include <morph/vvec.h>
+#include <morph/bootstrap.h>
+#include <morph/Random.h>
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    const std::string mode = argc > 1 ? std::string(argv[1]) : std::string("stream");
+    const unsigned int N = argc > 2 ? std::stoi (argv[2]) : 100000;
+    const unsigned int B = argc > 3 ? std::stoi (argv[3]) : 1000;
+
+    morph::RandNormal<double, std::mt19937_64> rnorm (5, 1, 42);
+    morph::vvec<double> data;
+    data.set_from (rnorm.get (N));
+
+    double eom = 0.0;
+    sc::time_point t0 = sc::now();
+    if (mode == "materialise") {
+        std::vector<morph::vvec<double>> resamples;
+        morph::bootstrap<double>::resample_with_replacement (data, resamples, B, 1);
+        morph::vvec<double> r_mean (B, 0.0);
+        for (unsigned int i = 0; i < B; ++i) { r_mean[i] = resamples[i].mean(); }
+        eom = r_mean.std();
+    } else {
+        eom = morph::bootstrap<double>::error_of_mean (data, B, 1);
+    }
+    sc::time_point t1 = sc::now();
+
+    struct rusage ru;
+    getrusage (RUSAGE_SELF, &ru);
+    std::cout << mode << ": N=" << N << ", B=" << B << ", error of mean " << eom << " in "
+              << duration_cast<milliseconds>(t1 - t0).count() << " ms; peak RSS "
+              << ru.ru_maxrss / 1024 << " MB\n";
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * Compare the training throughput (examples per second) of a 784-30-10 FeedForwardNet (the
+ * size used for MNIST) when it's trained one example at a time and when it's trained with the
+ * batched, matrix-matrix methods. Random inputs stand in for the MNIST images.
+ *
+ * Usage: profileff_batch [mini_batch_size]
+ */
+
+#include <morph/nn/FeedForwardNet.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+
+int main (int argc, char** argv)
+{
+    using namespace std::chrono;
+    using sc = std::chrono::steady_clock;
+
+    const unsigned int bs = argc > 1 ? std::stoul (argv[1]) : 10;
+    const unsigned int n_examples = 6000;
+    const unsigned int n_batches = n_examples / bs;
+    const float eta = 3.0f;
+
+    std::vector<morph::vvec<float>> ins (n_examples);
+    std::vector<morph::vvec<float>> outs (n_examples);
+    for (unsigned int e = 0; e < n_examples; ++e) {
+        ins[e].resize (784);
+        ins[e].randomize();
+        outs[e].resize (10);
+        outs[e].zero();
+        outs[e][e % 10] = 1.0f;
+    }
+
+    // One example at a time, accumulating mean gradients as in ff_mnist.cpp
+    morph::nn::FeedForwardNet<float> ff1({784, 30, 10});
+    std::vector<std::pair<morph::vvec<float>, morph::vvec<float>>> mean_gradients;
+    for (auto& c : ff1.connections) { mean_gradients.push_back (std::make_pair (c.nabla_ws[0], c.nabla_b)); }
+
+    sc::time_point t0 = sc::now();
+    for (unsigned int j = 0; j < n_batches; ++j) {
+        for (auto& mg : mean_gradients) { mg.first.zero(); mg.second.zero(); }
+        for (unsigned int mb = 0; mb < bs; ++mb) {
+            ff1.setInput (ins[j * bs + mb], outs[j * bs + mb]);
+            ff1.feedforward();
+            ff1.computeCost();
+            ff1.backprop();
+            unsigned int i = 0;
+            for (auto& c : ff1.connections) {
+                mean_gradients[i].first += c.nabla_ws[0];
+                mean_gradients[i].second += c.nabla_b;
+                ++i;
+            }
+        }
+        unsigned int i = 0;
+        for (auto& c : ff1.connections) {
+            c.ws[0] -= (mean_gradients[i].first * (eta / bs));
+            c.b -= (mean_gradients[i].second * (eta / bs));
+            ++i;
+        }
+    }
+    sc::time_point t1 = sc::now();
+    double t_single = duration_cast<microseconds>(t1 - t0).count() / 1e6;
+
+    // Batched
+    morph::nn::FeedForwardNet<float> ff2({784, 30, 10});
+    ff2.setBatchSize (bs);
+    t0 = sc::now();
+    for (unsigned int j = 0; j < n_batches; ++j) {
+        for (unsigned int mb = 0; mb < bs; ++mb) { ff2.setBatchInput (mb, ins[j * bs + mb], outs[j * bs + mb]); }
+        ff2.feedforward_batch();
+        ff2.computeCost_batch();
+        ff2.backprop_batch();
+        ff2.update (eta);
+    }
+    t1 = sc::now();
+    double t_batch = duration_cast<microseconds>(t1 - t0).count() / 1e6;
+
+    const double ex = static_cast<double>(n_batches * bs);
+    std::cout << "Mini-batch size " << bs << "\n";
+    std::cout << "One example at a time: " << ex / t_single << " examples/s\n";
+    std::cout << "Batched:               " << ex / t_batch << " examples/s\n";
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * Profile FFT convolution on a rectangular CartGrid against CartGrid::convolve, for square
+ * kernels of increasing width, then time the FFT convolver alone on larger domains, where the
+ * direct method would take too long.
+ */
+
+#include <morph/CartGrid.h>
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// Time f over reps repeats and return the mean time in ms
+template <typename F>
+double time_it (F f, const int reps)
+{
+    using sc = std::chrono::steady_clock;
+    sc::time_point t0 = sc::now();
+    for (int i = 0; i < reps; ++i) { f(); }
+    return std::chrono::duration_cast<std::chrono::microseconds>(sc::now() - t0).count() / (1e3 * reps);
+}
+
+// A w by w CartGrid of unit elements
+morph::CartGrid make_grid (const int w)
+{
+    const float hi = static_cast<float>(w - 1);
+    return morph::CartGrid (1.0f, 1.0f, 0.0f, 0.0f, hi, hi, 0.0f,
+                            morph::GridDomainShape::Rectangle, morph::GridDomainWrap::Horizontal);
+}
+
+// A square kernel of radius r, holding a Gaussian
+std::vector<float> make_kernel (morph::CartGrid& kg, const int r)
+{
+    std::vector<float> kd (kg.num());
+    const float sigma = 0.5f * r;
+    for (auto k : kg.rects) { kd[k.vi] = std::exp (-(k.xi * k.xi + k.yi * k.yi) / (2.0f * sigma * sigma)); }
+    return kd;
+}
+
+int main()
+{
+    constexpr int w = 128;
+    morph::CartGrid cg = make_grid (w);
+    std::vector<float> data (cg.num());
+    for (std::size_t i = 0; i < data.size(); ++i) { data[i] = std::sin (0.37f * i) + 0.001f * i; }
+    std::vector<float> direct (cg.num());
+    std::vector<float> result;
+
+    std::cout << w << " x " << w << " CartGrid\n";
+    std::cout << "kernel | direct (ms) | fft setup (ms) | fft (ms) | speedup | max difference\n";
+    for (int r : { 2, 4, 8, 16 }) {
+        morph::CartGrid kg (1.0f, 1.0f, -r, -r, r, r);
+        const std::vector<float> kd = make_kernel (kg, r);
+        const double t_direct = time_it ([&]() { cg.convolve (kg, kd, data, direct); }, 1);
+        const double t_setup = time_it ([&]() { cg.fft_convolver (kg, kd); }, 1);
+        auto conv = cg.fft_convolver (kg, kd);
+        const double t_fft = time_it ([&]() { conv.convolve (data, result); }, 20);
+        float maxdiff = 0.0f;
+        for (std::size_t i = 0; i < direct.size(); ++i) { maxdiff = std::max (maxdiff, std::abs (result[i] - direct[i])); }
+        std::cout << (2 * r + 1) << "x" << (2 * r + 1) << " | " << t_direct << " | " << t_setup << " | " << t_fft
+                  << " | " << t_direct / t_fft << " | " << maxdiff << "\n";
+    }
+
+    std::cout << "\nFFT convolution alone, 33x33 kernel\n";
+    std::cout << "domain | fft (ms) | pair of fields (ms)\n";
+    for (int wl : { 256, 512, 1024 }) {
+        morph::CartGrid cgl = make_grid (wl);
+        morph::CartGrid kg (1.0f, 1.0f, -16.0f, -16.0f, 16.0f, 16.0f);
+        auto conv = cgl.fft_convolver (kg, make_kernel (kg, 16));
+        std::vector<float> dl (cgl.num(), 1.0f);
+        std::vector<float> r1;
+        std::vector<float> r2;
+        const double t_fft = time_it ([&]() { conv.convolve (dl, r1); }, 5);
+        const double t_pair = time_it ([&]() { conv.convolve (dl, dl, r1, r2); }, 5);
+        std::cout << wl << "x" << wl << " | " << t_fft << " | " << t_pair << "\n";
+    }
+
+    return 0;
+}
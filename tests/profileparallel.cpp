@@ -0,0 +1,76 @@
+/*
+ * Scaling of the morph::parallel thread pool on grid kernels: a 5 point Laplacian on a large
+ * Grid, written with parallel_for and (if compiled with OpenMP) with '#pragma omp parallel for',
+ * and Grid::resample_image, which uses parallel_for. Each is timed on 1, 2, 4, ... threads, up
+ * to twice hardware_concurrency().
+ *
+ * Usage: profileparallel [grid_width] [repeats]
+ */
+
+#include <morph/Grid.h>
+#include <morph/vvec.h>
+#include <morph/parallel.h>
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <thread>
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+// Time f over reps repeats and return the mean time in ms
+template <typename F>
+double time_it (F f, const int reps)
+{
+    using sc = std::chrono::steady_clock;
+    f(); // warm up (and start the pool's threads)
+    sc::time_point t0 = sc::now();
+    for (int i = 0; i < reps; ++i) { f(); }
+    return std::chrono::duration_cast<std::chrono::microseconds>(sc::now() - t0).count() / (1e3 * reps);
+}
+
+int main (int argc, char** argv)
+{
+    const int w = argc > 1 ? std::stoi (argv[1]) : 2048;
+    const int reps = argc > 2 ? std::stoi (argv[2]) : 20;
+
+    morph::Grid<int, float> g (w, w);
+    morph::vvec<float> f (g.n());
+    f.randomize();
+    morph::vvec<float> lap (g.n());
+
+    // 5 point Laplacian on the interior of the grid, one row per iteration
+    auto lap_row = [&f, &lap, w](const int y) {
+        const int r = y * w;
+        for (int x = 1; x < w - 1; ++x) {
+            lap[r + x] = f[r + x - 1] + f[r + x + 1] + f[r + x - w] + f[r + x + w] - 4.0f * f[r + x];
+        }
+    };
+
+    morph::vvec<float> img (64 * 64);
+    img.randomize();
+    morph::Grid<int, float> gr (w / 8, w / 8, morph::vec<float, 2>{ 1.0f / (w / 8), 1.0f / (w / 8) });
+
+    const unsigned int hc = std::thread::hardware_concurrency();
+    std::cout << w << " x " << w << " grid, " << reps << " repeats, hardware_concurrency " << hc << "\n";
+    std::cout << "threads | laplacian pool (ms) | laplacian omp (ms) | resample_image pool (ms)\n";
+    double t1 = 0.0;
+    for (unsigned int nt = 1; nt <= 2 * (hc > 0 ? hc : 1); nt *= 2) {
+        morph::parallel::set_num_threads (nt);
+        const double t_pool = time_it ([&]() { morph::parallel::parallel_for (1, w - 1, lap_row); }, reps);
+        if (nt == 1) { t1 = t_pool; }
+        double t_omp = 0.0;
+#ifdef _OPENMP
+        omp_set_num_threads (static_cast<int>(nt));
+        t_omp = time_it ([&]() {
+#pragma omp parallel for
+            for (int y = 1; y < w - 1; ++y) { lap_row (y); }
+        }, reps);
+#endif
+        const double t_rs = time_it ([&]() { gr.resample_image (img, 64, morph::vec<float, 2>{ 1.0f, 1.0f }, morph::vec<float, 2>{}); }, 1);
+        std::cout << nt << " | " << t_pool << " (speedup " << t1 / t_pool << ") | " << t_omp << " | " << t_rs << "\n";
+    }
+
+    return 0;
+}
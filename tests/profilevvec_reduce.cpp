@@ -0,0 +1,73 @@
+/*
+ * Profile the vvec reductions in morph/reduce.h against the std::accumulate and
+ * std::max_element loops that vvec used before, for throughput and for accuracy. The
+ * reference sums are accumulated in long double.
+ *
+ * Usage: profilevvec_reduce [num_elements] [repeats]
+ */
+
+#include <morph/vvec.h>
+#include <iostream>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <cmath>
+
+// Time f over reps repeats and return the mean time in ms. The result of the last call goes in r.
+template <typename F, typename R>
+double time_it (F f, const int reps, R& r)
+{
+    using sc = std::chrono::steady_clock;
+    sc::time_point t0 = sc::now();
+    for (int i = 0; i < reps; ++i) { r = f(); }
+    return std::chrono::duration_cast<std::chrono::microseconds>(sc::now() - t0).count() / (1e3 * reps);
+}
+
+int main (int argc, char** argv)
+{
+    const std::size_t n = argc > 1 ? std::stoul (argv[1]) : 16777216u;
+    const int reps = argc > 2 ? std::stoi (argv[2]) : 10;
+
+    morph::vvec<float> v (n);
+    v.randomize (1000.0f, 1001.0f);
+
+    long double ref_sum = 0.0L;
+    for (auto f : v) { ref_sum += f; }
+    const long double ref_mean = ref_sum / n;
+    long double ref_m2 = 0.0L;
+    for (auto f : v) { ref_m2 += (f - ref_mean) * (f - ref_mean); }
+    const long double ref_var = ref_m2 / (n - 1);
+
+    auto relerr = [](const long double a, const long double ref) { return static_cast<double>(std::abs ((a - ref) / ref)); };
+
+    float s_old = 0.0f, s_new = 0.0f;
+    const double t_sum_old = time_it ([&v]() { return std::accumulate (v.begin(), v.end(), 0.0f); }, reps, s_old);
+    const double t_sum_new = time_it ([&v]() { return v.sum(); }, reps, s_new);
+
+    // The two-pass variance that vvec used, and the single pass Welford variance
+    float var_old = 0.0f, var_new = 0.0f;
+    auto two_pass = [&v, n]() {
+        const float m = std::accumulate (v.begin(), v.end(), 0.0f) / n;
+        float ss = 0.0f;
+        for (auto f : v) { ss += (f - m) * (f - m); }
+        return ss / (n - 1);
+    };
+    const double t_var_old = time_it (two_pass, reps, var_old);
+    const double t_var_new = time_it ([&v]() { return v.variance(); }, reps, var_new);
+
+    std::size_t am_old = 0, am_new = 0;
+    const double t_am_old = time_it ([&v]() { return static_cast<std::size_t>(std::max_element (v.begin(), v.end()) - v.begin()); }, reps, am_old);
+    const double t_am_new = time_it ([&v]() { return v.argmax(); }, reps, am_new);
+
+    const double gb = n * sizeof (float) / 1e6; // GB/s = bytes / (ms * 1e6)
+    std::cout << n << " floats, " << reps << " repeats\n";
+    std::cout << "sum      accumulate: " << t_sum_old << " ms (" << gb / t_sum_old << " GB/s), rel. error " << relerr (s_old, ref_sum) << "\n";
+    std::cout << "sum      reduce:     " << t_sum_new << " ms (" << gb / t_sum_new << " GB/s), rel. error " << relerr (s_new, ref_sum) << "\n";
+    std::cout << "variance two pass:   " << t_var_old << " ms, rel. error " << relerr (var_old, ref_var) << "\n";
+    std::cout << "variance Welford:    " << t_var_new << " ms, rel. error " << relerr (var_new, ref_var) << "\n";
+    std::cout << "argmax   max_element: " << t_am_old << " ms, argmax reduce: " << t_am_new << " ms"
+              << (am_old == am_new ? "" : " (DIFFERENT RESULTS)") << "\n";
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ * Test Anneal::run(), the per-dimension tangent set (evaluated in parallel) and the
+ * parallel tempering run, run_tempering(), on the Bohachevsky function from
+ * examples/anneal_asa.cpp, which has its global minimum of 0 at (0,0).
+ */
+
+#include "morph/Anneal.h"
+#include "morph/vvec.h"
+#include "morph/vec.h"
+#include "morph/mathconst.h"
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+typedef double F;
+
+F objective_boha (const morph::vvec<F>& params)
+{
+    F x = params[0];
+    F y = params[1];
+    F a = F{1}, b = F{2}, c=F{0.3}, d=F{0.4}, alpha=morph::mathconst<F>::three_pi, gamma=morph::mathconst<F>::four_pi;
+    return a*x*x + b*y*y - c * std::cos(alpha*x) - d * std::cos (gamma * y) + c + d;
+}
+
+void setup (morph::Anneal<F>& anneal)
+{
+    anneal.temperature_ratio_scale = F{1e-2};
+    anneal.temperature_anneal_scale = F{200};
+    anneal.cost_parameter_scale_ratio = F{3};
+    anneal.acc_gen_reanneal_ratio = F{1e-6};
+    anneal.delta_param = F{0.01};
+    anneal.objective_repeat_precision = F{1e-6};
+    anneal.f_x_best_repeat_max = 15;
+    anneal.reanneal_after_steps = 100;
+    anneal.display_temperatures = false;
+    anneal.display_reanneal = false;
+    anneal.objective = objective_boha;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    morph::vvec<F> p = { 0.45, 0.45 };
+    morph::vvec<morph::vec<F,2>> p_rng = {{ {-0.5, 0.5}, {-0.5, 0.5} }};
+    // The annealing is stochastic. A run that ends further than this from the minimum has
+    // found a local minimum (the nearest ones are above 0.2).
+    constexpr F good_enough = F{0.05};
+
+    // run() with no objective should refuse to run
+    morph::Anneal<F> noobj (p, p_rng);
+    if (noobj.run() != false || noobj.run_tempering (4) != -1) { --rtn; }
+
+    // A single chain, with the tangent set evaluated in parallel on reanneals
+    morph::Anneal<F> anneal (p, p_rng);
+    setup (anneal);
+    anneal.tangent_set = true;
+    anneal.parallel = true;
+    anneal.init();
+    anneal.run();
+    if (anneal.state != morph::Anneal_State::ReadyToStop || anneal.x_set.size() != 2 || anneal.f_x_set.size() != 2) {
+        std::cout << "Single chain did not finish, or did not reanneal with a tangent set\n";
+        --rtn;
+    }
+    if (anneal.evaluation_count < anneal.num_generated) { --rtn; }
+    std::cout << "Single chain: f_x_best = " << anneal.f_x_best << " at " << anneal.x_best
+              << " after " << anneal.evaluation_count << " evaluations\n";
+
+    // Parallel tempering with 4 chains. The best of several chains should reliably reach
+    // the global minimum.
+    morph::Anneal<F> pt (p, p_rng);
+    setup (pt);
+    pt.init();
+    std::vector<morph::Anneal<F>> chains;
+    int best = pt.run_tempering (4, 5, F{10}, &chains);
+    std::cout << "Tempering: f_x_best = " << pt.f_x_best << " at " << pt.x_best << " (chain " << best
+              << ") after " << pt.evaluation_count << " evaluations; " << pt.num_exchanges_accepted
+              << "/" << pt.num_exchanges_attempted << " exchanges\n";
+    if (best < 0 || best > 3 || chains.size() != 4) { --rtn; }
+    if (pt.state != morph::Anneal_State::ReadyToStop || chains[0].state != morph::Anneal_State::ReadyToStop) { --rtn; }
+    if (pt.f_x_best != chains[best].f_x_best || pt.x_best != chains[best].x_best) { --rtn; }
+    if (chains[0].tempering_factor != F{1} || std::abs (chains[3].tempering_factor - F{10}) > F{1e-9}) { --rtn; }
+    unsigned long long int evals = 0ULL;
+    for (auto c : chains) {
+        evals += c.evaluation_count;
+        if (c.f_x_best < pt.f_x_best) { --rtn; }
+    }
+    if (evals != pt.evaluation_count) { --rtn; }
+    if (pt.num_exchanges_attempted == 0 || pt.num_exchanges_accepted > pt.num_exchanges_attempted) { --rtn; }
+    if (pt.f_x_best > good_enough || pt.x_best.abs().max() > F{0.1}) {
+        std::cout << "Tempering did not find the global minimum\n";
+        --rtn;
+    }
+    // The exchanges only swap states, so the objective of each chain's x should still be its f_x
+    for (auto c : chains) { if (objective_boha (c.x) != c.f_x) { --rtn; } }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,133 @@
+/*
+ * Test morph::BatchVisual. A scene of spheres merged into one BatchVisual must look the same as
+ * the same spheres added to the Visual one by one, and must still do so after some of the spheres
+ * have been hidden, faded, moved or rescaled. Check, too, that the batch draws with one call when
+ * it can.
+ */
+
+#include <morph/VisualOffscreen.h>
+#include <morph/SphereVisual.h>
+#include <morph/BatchVisual.h>
+#include <morph/quaternion.h>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <array>
+#include <string>
+#include <cstdlib>
+
+// The spheres, either in a batch or each in the Visual
+struct scene
+{
+    scene (const bool batched)
+    {
+        this->v = std::make_unique<morph::VisualOffscreen<>> (200, 150);
+        this->v->lightingEffects();
+        this->v->setSceneTrans (morph::vec<float>{ -0.55f, -0.35f, -2.5f });
+
+        auto bv = std::make_unique<morph::BatchVisual<>>();
+        this->v->bindmodel (bv);
+        for (unsigned int i = 0; i < 24; ++i) {
+            morph::vec<float> p = { 0.2f * (i % 6), 0.2f * (i / 6), 0.0f };
+            std::array<float, 3> c = { 0.04f * i, 0.5f, 1.0f - 0.04f * i };
+            auto sv = std::make_unique<morph::SphereVisual<>> (p, 0.08f, c);
+            this->v->bindmodel (sv);
+            sv->finalize();
+            if (batched) {
+                this->spheres.push_back (bv->add (sv));
+            } else {
+                this->spheres.push_back (this->v->addVisualModel (sv));
+            }
+        }
+        if (batched) {
+            bv->finalize();
+            this->batch = this->v->addVisualModel (bv);
+        }
+    }
+
+    std::vector<unsigned char> grab()
+    {
+        this->v->render();
+        this->v->setContext();
+        std::vector<unsigned char> px (static_cast<std::size_t>(this->v->fb_width()) * this->v->fb_height() * 4, 0);
+        this->v->glfn->ReadPixels (0, 0, this->v->fb_width(), this->v->fb_height(), GL_RGBA, GL_UNSIGNED_BYTE, px.data());
+        this->v->releaseContext();
+        return px;
+    }
+
+    std::unique_ptr<morph::VisualOffscreen<>> v;
+    std::vector<morph::SphereVisual<>*> spheres;
+    morph::BatchVisual<>* batch = nullptr;
+};
+
+int main()
+{
+    int rtn = 0;
+
+    scene plain (false);
+    scene batched (true);
+
+    // Compare the two renders. The batch transforms its vertices on the CPU, so allow for a
+    // little rounding at the edges of the spheres.
+    auto compare = [&plain, &batched, &rtn](const std::string& what, const std::size_t expected_calls) {
+        std::vector<unsigned char> a = plain.grab();
+        std::vector<unsigned char> b = batched.grab();
+        std::size_t ndiff = 0;
+        unsigned int coloured = 0;
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            if (std::abs (static_cast<int>(a[i]) - static_cast<int>(b[i])) > 2) { ++ndiff; }
+            if (i % 4 == 0 && b[i] != b[i + 2]) { ++coloured; }
+        }
+        if (ndiff > a.size() / 200 || coloured < 1000) {
+            std::cout << what << ": batched render differs from plain render in " << ndiff << " channels ("
+                      << coloured << " coloured pixels)\n";
+            --rtn;
+        }
+        if (batched.batch->draw_calls() != expected_calls) {
+            std::cout << what << ": batch made " << batched.batch->draw_calls() << " draw calls, not " << expected_calls << "\n";
+            --rtn;
+        }
+    };
+
+    compare ("initial scene", 1);
+
+    // Hide a sphere in the middle of the batch, splitting it into two runs
+    for (scene* s : { &plain, &batched }) { s->spheres[10]->setHide (true); }
+    compare ("one sphere hidden", 2);
+
+    // Fade the last two spheres
+    for (scene* s : { &plain, &batched }) {
+        s->spheres[22]->setAlpha (0.4f);
+        s->spheres[23]->setAlpha (0.4f);
+    }
+    compare ("two spheres faded", 3);
+
+    // Move, rotate and rescale some spheres
+    for (scene* s : { &plain, &batched }) {
+        s->spheres[3]->setViewTranslation (morph::vec<float>{ 0.5f, 0.5f, 0.1f });
+        s->spheres[7]->setViewRotation (morph::quaternion<float>(morph::vec<float>{ 0.0f, 1.0f, 0.0f }, 1.0f));
+        s->spheres[15]->setSizeScale (1.8f);
+    }
+    compare ("spheres moved and scaled", 3);
+
+    // Show everything again
+    for (scene* s : { &plain, &batched }) {
+        s->spheres[10]->setHide (false);
+        s->spheres[22]->setAlpha (1.0f);
+        s->spheres[23]->setAlpha (1.0f);
+    }
+    compare ("all shown", 1);
+
+    // Hiding the whole batch, or all of its members, should draw no spheres
+    batched.batch->setHide (true);
+    std::vector<unsigned char> empty = batched.grab();
+    batched.batch->setHide (false);
+    for (auto sp : batched.spheres) { sp->setHide (true); }
+    if (batched.grab() != empty) {
+        std::cout << "A batch with every member hidden drew something\n";
+        --rtn;
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,68 @@
+/*
+ * Test the CartGrid that is rasterised directly from a boundary.
+ */
+
+#define CARTGRID_COMPILE_WITH_BEZCURVES 1
+#include <morph/CartGrid.h>
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+int main()
+{
+    int rtn = 0;
+
+    const float dx = 0.015625f;
+    const float dy = 0.03125f;
+    const float a = 1.0f;
+    const float b = 0.6f;
+
+    morph::CartGrid cg_pts (dx, dy, 2.5f, 1.5f);
+    std::vector<morph::BezCoord<float>> bpoints = cg_pts.ellipseCompute (a, b);
+
+    morph::CartGrid cg;
+    cg.init (dx, dy, bpoints);
+    std::cout << "CartGrid has " << cg.num() << " elements\n";
+
+    // Every element whose centre is inside the ellipse should be present, along with the boundary
+    // elements. Count elements on the lattice that are well inside.
+    unsigned int n_inside = 0;
+    unsigned int n_found = 0;
+    for (auto r : cg.rects) {
+        float e = (r.x * r.x) / (a * a) + (r.y * r.y) / (b * b);
+        if (!r.boundaryRect()) {
+            if (e > 1.0f) { std::cout << "Element outside the ellipse at " << r.x << "," << r.y << "\n"; --rtn; }
+            ++n_found;
+        }
+    }
+    for (int yi = -24; yi <= 24; ++yi) {
+        for (int xi = -70; xi <= 70; ++xi) {
+            float x = xi * dx;
+            float y = yi * dy;
+            if ((x * x) / (a * a) + (y * y) / (b * b) < 0.95f) { ++n_inside; }
+        }
+    }
+    if (n_found < n_inside) {
+        std::cout << "Only " << n_found << " inside elements; expected at least " << n_inside << "\n";
+        --rtn;
+    }
+
+    // Neighbour relations should be consistent with the element indices
+    for (auto r : cg.rects) {
+        if (r.has_ne() && (r.ne->xi != r.xi + 1 || r.ne->yi != r.yi)) { --rtn; break; }
+        if (r.has_nn() && (r.nn->xi != r.xi || r.nn->yi != r.yi + 1)) { --rtn; break; }
+        if (r.has_nne() && (r.nne->xi != r.xi + 1 || r.nne->yi != r.yi + 1)) { --rtn; break; }
+        if (r.has_nnw() && (r.nnw->xi != r.xi - 1 || r.nnw->yi != r.yi + 1)) { --rtn; break; }
+        if (r.has_nw() && (r.nw->xi != r.xi - 1 || r.nw->yi != r.yi)) { --rtn; break; }
+        if (r.has_ns() && (r.ns->xi != r.xi || r.ns->yi != r.yi - 1)) { --rtn; break; }
+        // Elements well inside the boundary have all eight neighbours
+        float e = (r.x * r.x) / (a * a) + (r.y * r.y) / (b * b);
+        if (e < 0.8f && (r.getFlags() & RECT_HAS_NEIGHB_ALL) != RECT_HAS_NEIGHB_ALL) { --rtn; break; }
+    }
+
+    // The d_ vectors should be populated for the inside elements
+    if (cg.d_x.size() != cg.num() || cg.d_ne.size() != cg.num()) { --rtn; }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,131 @@
+/*
+ * Test the batched ColourMap::convert, with and without a lookup table.
+ */
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <cmath>
+#include <limits>
+#include <iostream>
+#include <thread>
+#include <morph/ColourMap.h>
+
+// The largest difference in any channel between two colour arrays
+float maxdiff (const std::vector<float>& a, const std::vector<float>& b)
+{
+    float d = 0.0f;
+    for (std::size_t i = 0; i < a.size(); ++i) { d = std::max (d, std::abs (a[i] - b[i])); }
+    return d;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    constexpr std::size_t n = 100000;
+    std::vector<float> data (n);
+    for (std::size_t i = 0; i < n; ++i) { data[i] = static_cast<float>(i) / static_cast<float>(n - 1); }
+    data[10] = -0.5f; // out of range data should be clamped
+    data[20] = 1.5f;
+    data[30] = std::numeric_limits<float>::quiet_NaN();
+
+    std::vector<float> exact (3 * n);
+    std::vector<float> batched (3 * n);
+
+    // Tabulated maps have 256 entries, so a 256 entry LUT should reproduce them exactly. Computed
+    // maps need a bigger table to get close to the exact colours.
+    std::vector<std::pair<morph::ColourMapType, float>> maps = {
+        { morph::ColourMapType::Viridis, 0.0f },
+        { morph::ColourMapType::Batlow, 0.0f },
+        { morph::ColourMapType::CET_L17, 0.0f },
+        { morph::ColourMapType::Greyscale, 0.002f },
+        { morph::ColourMapType::Monochrome, 0.002f },
+        { morph::ColourMapType::Fire, 0.002f }
+    };
+
+    for (auto [cmt, tolerance] : maps) {
+        morph::ColourMap<float> cm (cmt);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::array<float, 3> c = cm.convert (data[i]);
+            exact[3 * i] = c[0];
+            exact[3 * i + 1] = c[1];
+            exact[3 * i + 2] = c[2];
+        }
+
+        // Without a LUT, the batched convert should give identical results
+        cm.convert (std::span<const float>{data}, std::span<float>{batched});
+        if (maxdiff (exact, batched) != 0.0f) {
+            std::cout << cm.getTypeStr() << ": batched convert differs from convert\n";
+            --rtn;
+        }
+
+        cm.setLUTSize (tolerance == 0.0f ? 256 : 4096);
+        cm.convert (std::span<const float>{data}, std::span<float>{batched});
+        float d = maxdiff (exact, batched);
+        if (d > tolerance) {
+            std::cout << cm.getTypeStr() << ": LUT(" << cm.getLUTSize() << ") convert differs by " << d << std::endl;
+            --rtn;
+        }
+        // NaNs should still get the NaN colour
+        std::array<float, 3> nanc = morph::ColourMap<float>::nanColour (cmt);
+        if (batched[90] != nanc[0] || batched[91] != nanc[1] || batched[92] != nanc[2]) {
+            std::cout << cm.getTypeStr() << ": LUT convert gave wrong NaN colour\n";
+            --rtn;
+        }
+    }
+
+    // Changing the map after a LUT has been built should rebuild the LUT
+    morph::ColourMap<float> cm (morph::ColourMapType::Monochrome);
+    cm.setLUTSize (256);
+    std::vector<float> one = { 1.0f };
+    std::vector<float> clr (3);
+    cm.convert (std::span<const float>{one}, std::span<float>{clr});
+    cm.setHue (0.6667f);
+    cm.convert (std::span<const float>{one}, std::span<float>{clr});
+    std::array<float, 3> c = cm.convert (1.0f);
+    if (clr[0] != c[0] || clr[1] != c[1] || clr[2] != c[2]) {
+        std::cout << "LUT was not rebuilt after setHue\n";
+        --rtn;
+    }
+
+    // Several threads may convert with the same (const) ColourMap at once
+    morph::ColourMap<float> cmv (morph::ColourMapType::Viridis);
+    cmv.setLUTSize (256);
+    const morph::ColourMap<float>& cmc = cmv;
+    std::array<std::vector<float>, 4> threaded;
+    std::vector<std::thread> threads;
+    for (auto& tc : threaded) {
+        tc.resize (3 * n);
+        threads.emplace_back ([&cmc, &data, &tc]() { cmc.convert (std::span<const float>{data}, std::span<float>{tc}); });
+    }
+    for (auto& t : threads) { t.join(); }
+    std::vector<float> single (3 * n);
+    cmc.convert (std::span<const float>{data}, std::span<float>{single});
+    for (const auto& tc : threaded) {
+        if (tc != single) {
+            std::cout << "Concurrent batched convert gave a different result\n";
+            --rtn;
+            break;
+        }
+    }
+
+    // Integral data uses range_max
+    morph::ColourMap<unsigned char> cmuc (morph::ColourMapType::Jet);
+    cmuc.setLUTSize (256);
+    std::vector<unsigned char> ucdata (256);
+    for (unsigned int i = 0; i < 256; ++i) { ucdata[i] = static_cast<unsigned char>(i); }
+    std::vector<float> ucclr (3 * 256);
+    cmuc.convert (std::span<const unsigned char>{ucdata}, std::span<float>{ucclr});
+    for (unsigned int i = 0; i < 256; ++i) {
+        c = cmuc.convert (ucdata[i]);
+        if (std::abs (ucclr[3 * i] - c[0]) > 0.01f || std::abs (ucclr[3 * i + 1] - c[1]) > 0.01f) {
+            std::cout << "uchar LUT convert differs at " << i << std::endl;
+            --rtn;
+            break;
+        }
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,113 @@
+/*
+ * Test the distance transform used by HexGrid::computeDistanceToBoundary and
+ * CartGrid::computeDistanceToBoundary against an exhaustive search over the boundary elements.
+ */
+
+#include <morph/HexGrid.h>
+#include <morph/CartGrid.h>
+#include <morph/distance_transform.h>
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+// The exhaustive distance from each inside element to the nearest boundary element
+std::vector<float> exhaustive (const std::vector<float>& x, const std::vector<float>& y,
+                               const std::vector<unsigned int>& flags, unsigned int bflag, unsigned int iflag)
+{
+    std::vector<float> dist (x.size(), -100.0f);
+    for (unsigned int i = 0; i < x.size(); ++i) {
+        if (flags[i] & bflag) {
+            dist[i] = 0.0f;
+        } else if (flags[i] & iflag) {
+            for (unsigned int j = 0; j < x.size(); ++j) {
+                if (!(flags[j] & bflag)) { continue; }
+                float d = std::sqrt ((x[i] - x[j]) * (x[i] - x[j]) + (y[i] - y[j]) * (y[i] - y[j]));
+                if (dist[i] < 0.0f || d < dist[i]) { dist[i] = d; }
+            }
+        }
+    }
+    return dist;
+}
+
+// Compare a computed distance transform with the exhaustive one. Return number of failures. If
+// exact, every element must match the exhaustive search.
+int compare (const std::string& name, const std::vector<float>& dist, const std::vector<float>& ref, float spacing,
+             bool exact = true)
+{
+    int fails = 0;
+    unsigned int nexact = 0;
+    float maxerr = 0.0f;
+    for (unsigned int i = 0; i < ref.size(); ++i) {
+        float err = dist[i] - ref[i];
+        if (err < 0.0f) {
+            // Never less than the true distance to the nearest boundary element
+            if (err < -1e-5f) { ++fails; }
+            err = -err;
+        }
+        if (err < 1e-5f) { ++nexact; }
+        maxerr = err > maxerr ? err : maxerr;
+    }
+    std::cout << name << ": " << nexact << "/" << ref.size() << " exact; max error "
+              << maxerr << " (" << maxerr / spacing << " x element spacing)\n";
+    if (exact) {
+        if (nexact != ref.size()) { ++fails; }
+    } else {
+        if (maxerr > 0.2f * spacing) { ++fails; }
+        // No more than 3% of elements should differ from the exhaustive search
+        if (nexact < 0.97f * ref.size()) { ++fails; }
+    }
+    return fails;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    // HexGrid with an elliptical boundary
+    morph::HexGrid hg (0.02f, 4.0f, 0.0f);
+    hg.setEllipticalBoundary (1.0f, 0.6f);
+    hg.computeDistanceToBoundary();
+    std::vector<float> ref = exhaustive (hg.d_x, hg.d_y, hg.d_flags, HEX_IS_BOUNDARY, HEX_INSIDE_BOUNDARY);
+    if (compare ("HexGrid ellipse", hg.d_distToBoundary, ref, hg.getd()) > 0) { --rtn; }
+
+    // Propagation alone is close to the exhaustive search, but not always exact
+    std::vector<float> euclid = hg.d_distToBoundary;
+    hg.computeDistanceToBoundary (morph::distance_metric::euclidean_approx);
+    if (compare ("HexGrid ellipse (approx)", hg.d_distToBoundary, ref, hg.getd(), false) > 0) { --rtn; }
+    hg.computeDistanceToBoundary();
+
+    // d_distToBoundary and Hex::distToBoundary should agree
+    for (auto h : hg.hexen) {
+        if (h.distToBoundary != hg.d_distToBoundary[h.di]) { --rtn; break; }
+        if (h.boundaryHex() && h.distToBoundary != 0.0f) { --rtn; break; }
+    }
+
+    // The shortest path through neighbouring hexes is never shorter than the straight line
+    hg.computeDistanceToBoundary (morph::distance_metric::path);
+    for (unsigned int i = 0; i < hg.num(); ++i) {
+        if (hg.d_distToBoundary[i] < euclid[i] - 1e-5f) { --rtn; break; }
+        // On a hex grid, each path step is one hex-to-hex distance
+        float steps = hg.d_distToBoundary[i] / hg.getd();
+        if (std::abs (steps - std::round (steps)) > 1e-3f) { --rtn; break; }
+    }
+
+    // HexGrid with a circular boundary which doesn't fill the grid's extent
+    morph::HexGrid hg2 (0.03f, 3.0f, 0.0f);
+    hg2.setCircularBoundary (0.8f, {0.2f, -0.1f});
+    hg2.computeDistanceToBoundary();
+    ref = exhaustive (hg2.d_x, hg2.d_y, hg2.d_flags, HEX_IS_BOUNDARY, HEX_INSIDE_BOUNDARY);
+    if (compare ("HexGrid circle", hg2.d_distToBoundary, ref, hg2.getd()) > 0) { --rtn; }
+
+    // A rectangular CartGrid, whose boundary is its outer edge
+    morph::CartGrid cg (0.025f, 0.025f, 1.0f, 0.5f);
+    cg.setBoundaryOnOuterEdge();
+    cg.computeDistanceToBoundary();
+    ref = exhaustive (cg.d_x, cg.d_y, cg.d_flags, RECT_IS_BOUNDARY, RECT_INSIDE_BOUNDARY);
+    if (compare ("CartGrid rectangle", cg.d_distToBoundary, ref, cg.getd()) > 0) { --rtn; }
+    for (auto r : cg.rects) {
+        if (r.distToBoundary != cg.d_distToBoundary[r.di]) { --rtn; break; }
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,145 @@
+/*
+ * Test the compile-time stencil operations on Gridct (apply, laplacian, blur, advection and
+ * for_each_stencil) against the same sums made with Gridct's runtime neighbour functions, for
+ * every combination of wrapping and element order.
+ */
+
+#include "morph/Gridct.h"
+#include <iostream>
+#include <limits>
+#include <cmath>
+#include <string>
+
+constexpr morph::vec<float, 2> dx = { 0.5f, 2.0f };
+constexpr morph::vec<float, 2> offset = { 0.0f, 0.0f };
+
+// An asymmetric stencil, to check that rows run north to south and columns west to east
+constexpr morph::stencil<float, 1, 1> asym = {{ 1, 2, 3,
+                                                4, 5, 6,
+                                                7, 8, 9 }};
+
+template <morph::GridDomainWrap wrap, morph::GridOrder order>
+int test_stencils (const std::string& name)
+{
+    int rtn = 0;
+    using G = morph::Gridct<int, float, 9, 7, dx, offset, true, wrap, order>;
+    G g;
+
+    // The element ox steps east and oy north of i, one step at a time with the runtime neighbour
+    // functions, staying put at an edge that doesn't wrap.
+    auto nbr = [&g](int i, int ox, int oy) {
+        constexpr int none = std::numeric_limits<int>::max();
+        for (; ox > 0; --ox) { if (g.index_ne (i) != none) { i = g.index_ne (i); } }
+        for (; ox < 0; ++ox) { if (g.index_nw (i) != none) { i = g.index_nw (i); } }
+        for (; oy > 0; --oy) { if (g.index_nn (i) != none) { i = g.index_nn (i); } }
+        for (; oy < 0; ++oy) { if (g.index_ns (i) != none) { i = g.index_ns (i); } }
+        return i;
+    };
+
+    morph::vvec<float> f (G::n);
+    for (int i = 0; i < G::n; ++i) { f[i] = std::sin (0.37f * i) + 0.01f * i * i; }
+    morph::vvec<float> ux (G::n);
+    morph::vvec<float> uy (G::n);
+    for (int i = 0; i < G::n; ++i) { ux[i] = std::cos (0.5f * i); uy[i] = std::sin (0.3f * i + 1.0f); }
+
+    auto check = [&rtn, &name](const std::string& what, const morph::vvec<float>& got, const morph::vvec<float>& expected) {
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            if (std::abs (got[i] - expected[i]) > 1e-4f * (1.0f + std::abs (expected[i]))) {
+                std::cout << name << " " << what << ": element " << i << " is " << got[i] << ", expected " << expected[i] << "\n";
+                --rtn;
+                return;
+            }
+        }
+    };
+
+    morph::vvec<float> out;
+    morph::vvec<float> ref (G::n, 0.0f);
+
+    // Laplacian
+    g.laplacian (f, out);
+    for (int i = 0; i < G::n; ++i) {
+        ref[i] = (f[nbr (i, 1, 0)] + f[nbr (i, -1, 0)] - 2.0f * f[i]) / (dx[0] * dx[0])
+        + (f[nbr (i, 0, 1)] + f[nbr (i, 0, -1)] - 2.0f * f[i]) / (dx[1] * dx[1]);
+    }
+    check ("laplacian", out, ref);
+
+    // The asymmetric stencil
+    g.template apply<asym> (f, out);
+    for (int i = 0; i < G::n; ++i) {
+        ref[i] = 0.0f;
+        for (int k = 0; k < 9; ++k) { ref[i] += (k + 1) * f[nbr (i, k % 3 - 1, 1 - k / 3)]; }
+    }
+    check ("asymmetric stencil", out, ref);
+
+    // Radius 2 blur, which reaches two elements beyond the edges
+    g.template blur<2> (f, out);
+    const float b[5] = { 1, 4, 6, 4, 1 };
+    for (int i = 0; i < G::n; ++i) {
+        ref[i] = 0.0f;
+        for (int oy = -2; oy <= 2; ++oy) {
+            for (int ox = -2; ox <= 2; ++ox) { ref[i] += b[ox + 2] * b[oy + 2] / 256.0f * f[nbr (i, ox, oy)]; }
+        }
+    }
+    check ("blur<2>", out, ref);
+
+    // A blur of a constant field is the same constant
+    morph::vvec<float> c (G::n, 3.0f);
+    g.blur (c, out);
+    check ("blur of constant", out, c);
+
+    // Upwind advection
+    g.advection (f, ux, uy, out);
+    for (int i = 0; i < G::n; ++i) {
+        const float dfdx = ux[i] > 0.0f ? (f[i] - f[nbr (i, -1, 0)]) / dx[0] : (f[nbr (i, 1, 0)] - f[i]) / dx[0];
+        const float dfdy = uy[i] > 0.0f ? (f[i] - f[nbr (i, 0, -1)]) / dx[1] : (f[nbr (i, 0, 1)] - f[i]) / dx[1];
+        ref[i] = -(ux[i] * dfdx + uy[i] * dfdy);
+    }
+    check ("advection", out, ref);
+
+    // A user stencil with for_each_stencil: the largest value within a radius 1 by 2 box
+    g.template for_each_stencil<1, 2> ([&f, &out](const int i, const auto nb) {
+        float m = f[i];
+        for (int oy = -2; oy <= 2; ++oy) {
+            for (int ox = -1; ox <= 1; ++ox) { m = std::max (m, f[nb (ox, oy)]); }
+        }
+        out[i] = m;
+    });
+    for (int i = 0; i < G::n; ++i) {
+        ref[i] = f[i];
+        for (int oy = -2; oy <= 2; ++oy) {
+            for (int ox = -1; ox <= 1; ++ox) { ref[i] = std::max (ref[i], f[nbr (i, ox, oy)]); }
+        }
+    }
+    check ("for_each_stencil box max", out, ref);
+
+    return rtn;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    using W = morph::GridDomainWrap;
+    using O = morph::GridOrder;
+    rtn += test_stencils<W::None, O::bottomleft_to_topright> ("None/bltr");
+    rtn += test_stencils<W::Horizontal, O::bottomleft_to_topright> ("Horizontal/bltr");
+    rtn += test_stencils<W::Vertical, O::bottomleft_to_topright> ("Vertical/bltr");
+    rtn += test_stencils<W::Both, O::bottomleft_to_topright> ("Both/bltr");
+    rtn += test_stencils<W::None, O::topleft_to_bottomright> ("None/tlbr");
+    rtn += test_stencils<W::Horizontal, O::topleft_to_bottomright> ("Horizontal/tlbr");
+    rtn += test_stencils<W::Vertical, O::topleft_to_bottomright> ("Vertical/tlbr");
+    rtn += test_stencils<W::Both, O::topleft_to_bottomright> ("Both/tlbr");
+
+    // A field of the wrong size is an error
+    morph::Gridct<int, float, 4, 4> g4;
+    morph::vvec<float> wrong (15, 1.0f);
+    morph::vvec<float> out;
+    try {
+        g4.laplacian (wrong, out);
+        std::cout << "laplacian of a wrongly sized field didn't throw\n";
+        --rtn;
+    } catch (const std::runtime_error&) {}
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
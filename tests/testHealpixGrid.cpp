@@ -0,0 +1,102 @@
+/*
+ * Test morph::HealpixGrid. The neighbour table must be symmetric, with 7 neighbours for exactly
+ * 24 pixels, and neighbours must be close by. The Laplacian stencil must reproduce the eigenvalues
+ * -l(l+1) of some low order spherical harmonics, with an error that falls as nside increases.
+ */
+
+#include <morph/HealpixGrid.h>
+#include <morph/vec.h>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cmath>
+
+// A mix of spherical harmonics of degrees 1, 2 and 3 at the unit vector v, and its Laplacian
+template <typename F>
+F field (const morph::vec<F>& v, F& lap)
+{
+    const F x = v[0], y = v[1], z = v[2];
+    const F y1 = F{0.5} * x;                                // l = 1
+    const F y2 = x * y + F{3} * z * z - F{1};               // l = 2
+    const F y3 = F{0.5} * (F{5} * z * z * z - F{3} * z) + x * y * z; // l = 3
+    lap = F{-2} * y1 + F{-6} * y2 + F{-12} * y3;
+    return y1 + y2 + y3;
+}
+
+// Return the largest error in the Laplacian, relative to the largest value of the Laplacian
+template <typename F>
+F laplacian_error (const morph::HealpixGrid<F>& hg)
+{
+    std::vector<F> f (hg.n()), lapf (hg.n()), expected (hg.n());
+    const F r = hg.get_radius();
+    for (std::int64_t p = 0; p < hg.n(); ++p) {
+        f[p] = field<F> (hg.centre (p) / r, expected[p]);
+        expected[p] /= r * r;
+    }
+    hg.laplacian (f, lapf);
+    F maxerr = F{0};
+    F maxlap = F{0};
+    for (std::int64_t p = 0; p < hg.n(); ++p) {
+        maxerr = std::max (maxerr, std::abs (lapf[p] - expected[p]));
+        maxlap = std::max (maxlap, std::abs (expected[p]));
+    }
+    return maxerr / maxlap;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    for (std::int64_t nside : { 2, 4, 16, 64 }) {
+        morph::HealpixGrid<float> hg (nside);
+        int n7 = 0;
+        const float maxdist = 2.5f * std::sqrt (hg.pixel_area());
+        for (std::int64_t p = 0; p < hg.n(); ++p) {
+            const int nn = hg.num_neighbours (p);
+            if (nn == 7) { ++n7; } else if (nn != 8) { --rtn; }
+            for (auto q : hg.neighbours (p)) {
+                if (q == -1) { continue; }
+                if (q < 0 || q >= hg.n() || q == p) { --rtn; continue; }
+                // p must be one of q's neighbours
+                bool found = false;
+                for (auto pp : hg.neighbours (q)) { found = found || pp == p; }
+                if (!found) { --rtn; }
+                if ((hg.centre (q) - hg.centre (p)).length() > maxdist) { --rtn; }
+            }
+        }
+        if (n7 != 24) {
+            std::cout << "nside " << nside << ": " << n7 << " pixels have 7 neighbours (expected 24)\n";
+            --rtn;
+        }
+        if (rtn != 0) { std::cout << "nside " << nside << ": neighbour table is wrong\n"; }
+    }
+
+    // Pixel 27 (x=5, y=3) is inside face 0. Pixel 0 is at the southern corner of face 0, so its
+    // SW neighbour is at x=7, y=0 on face 4.
+    using hgd = morph::HealpixGrid<double>;
+    hgd hg8 (8);
+    if (hg8.neighbour (27, hgd::dirn::ne) != 30 || hg8.neighbour (27, hgd::dirn::nw) != 49
+        || hg8.neighbour (0, hgd::dirn::sw) != 4 * 64 + 21) {
+        std::cout << "Neighbours of pixels 27 and 0 are wrong\n";
+        --rtn;
+    }
+
+    // Laplacian accuracy
+    float e32 = laplacian_error (morph::HealpixGrid<float> (32));
+    float e128 = laplacian_error (morph::HealpixGrid<float> (128, 2.0f));
+    double e128d = laplacian_error (morph::HealpixGrid<double> (128));
+    if (e32 > 0.03f || e128 > 0.01f || e128 >= e32 || e128d > 0.01) {
+        std::cout << "Laplacian errors: " << e32 << " (nside 32), " << e128 << " (nside 128, radius 2), "
+                  << e128d << " (nside 128, double)\n";
+        --rtn;
+    }
+
+    // nside must be a power of 2
+    try {
+        morph::HealpixGrid<float> bad (12);
+        --rtn;
+    } catch (const std::runtime_error&) {}
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
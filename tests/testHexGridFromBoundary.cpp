@@ -0,0 +1,73 @@
+/*
+ * Test that a HexGrid rasterised directly from a boundary is the same as a HexGrid which is built
+ * as a hexagon of hexes, then reduced with setBoundary().
+ */
+
+#include <morph/HexGrid.h>
+#include <morph/ReadCurves.h>
+#include <morph/tools.h>
+#include <iostream>
+#include <vector>
+#include <string>
+
+// Compare the two grids, hex by hex. Return the number of differences.
+int compare (const std::string& name, const morph::HexGrid& hg_reduced, const morph::HexGrid& hg_raster)
+{
+    int diffs = 0;
+    if (hg_reduced.num() != hg_raster.num()) {
+        std::cout << name << ": " << hg_reduced.num() << " hexes by setBoundary, but "
+                  << hg_raster.num() << " hexes by rasterisation\n";
+        return 1;
+    }
+    for (unsigned int i = 0; i < hg_reduced.num(); ++i) {
+        if (hg_reduced.d_x[i] != hg_raster.d_x[i] || hg_reduced.d_y[i] != hg_raster.d_y[i]
+            || hg_reduced.d_flags[i] != hg_raster.d_flags[i]
+            || hg_reduced.d_ne[i] != hg_raster.d_ne[i] || hg_reduced.d_nne[i] != hg_raster.d_nne[i]
+            || hg_reduced.d_nnw[i] != hg_raster.d_nnw[i] || hg_reduced.d_nw[i] != hg_raster.d_nw[i]
+            || hg_reduced.d_nsw[i] != hg_raster.d_nsw[i] || hg_reduced.d_nse[i] != hg_raster.d_nse[i]) {
+            ++diffs;
+        }
+    }
+    std::cout << name << ": " << hg_raster.num() << " hexes, " << diffs << " differ\n";
+    return diffs;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    // An ellipse
+    morph::HexGrid hg1 (0.02f, 3.0f, 0.0f);
+    std::vector<morph::BezCoord<float>> bpoints = hg1.ellipseCompute (1.0f, 0.7f);
+    std::vector<morph::BezCoord<float>> bpoints_copy = bpoints;
+    hg1.setBoundary (bpoints);
+    morph::HexGrid hg2;
+    hg2.init (0.02f, bpoints_copy);
+    if (compare ("ellipse", hg1, hg2) != 0) { --rtn; }
+
+    // A circle, offset from the origin and not re-centred
+    morph::HexGrid hg3 (0.03f, 4.0f, 0.0f);
+    bpoints = hg3.ellipseCompute (0.8f, 0.8f, {0.3f, -0.2f});
+    bpoints_copy = bpoints;
+    hg3.setBoundary (bpoints, false);
+    morph::HexGrid hg4;
+    hg4.init (0.03f, bpoints_copy, 0.0f, false);
+    if (compare ("offset circle", hg3, hg4) != 0) { --rtn; }
+
+    // A boundary read from an SVG file
+    try {
+        morph::ReadCurves r ("../../tests/trial.svg");
+        morph::HexGrid hg5 (0.02f, 7.0f, 0.0f);
+        hg5.setBoundary (r.getCorticalPath());
+        morph::HexGrid hg6 (0.02f, r.getCorticalPath());
+        if (compare ("trial.svg", hg5, hg6) != 0) { --rtn; }
+        if (hg5.getBoundary().size() != hg6.getBoundary().size()) { --rtn; }
+    } catch (const std::exception& e) {
+        std::cerr << "Caught exception reading trial.svg: " << e.what() << std::endl;
+        std::cerr << "Current working directory: " << morph::tools::getPwd() << std::endl;
+        --rtn;
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
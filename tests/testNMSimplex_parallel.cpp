@@ -0,0 +1,79 @@
+/*
+ * Test the parallel evaluation (with speculation) and the multi-start runs of the Nelder Mead
+ * Simplex algorithm on the Rosenbrock banana function.
+ */
+
+#include "morph/NM_Simplex.h"
+#include "morph/vvec.h"
+#include <iostream>
+#include <cmath>
+#include <limits>
+
+int main()
+{
+    int rtn = 0;
+
+    auto banana = [](const morph::vvec<FLT>& point) {
+        FLT x = point[0];
+        FLT y = point[1];
+        constexpr FLT a = FLT{1};
+        constexpr FLT b = FLT{100};
+        return ((a-x)*(a-x)) + (b * (y-(x*x)) * (y-(x*x)));
+    };
+
+    morph::vvec<morph::vvec<FLT>> i_vertices = {
+        { 0.7, 0.0 },
+        { 0.0, 0.6 },
+        { -0.6, -1.0 }
+    };
+
+    // Serial reference
+    morph::NM_Simplex<FLT> simp(i_vertices);
+    simp.objective = banana;
+    simp.termination_threshold = std::numeric_limits<FLT>::epsilon();
+    simp.run();
+
+    // Parallel, with speculation. Should follow exactly the same path.
+    morph::NM_Simplex<FLT> psimp(i_vertices);
+    psimp.objective = banana;
+    psimp.termination_threshold = std::numeric_limits<FLT>::epsilon();
+    psimp.parallel = true;
+    psimp.speculate = true;
+    psimp.run();
+
+    if (psimp.operation_count != simp.operation_count
+        || psimp.best_vertex() != simp.best_vertex()
+        || psimp.best_value() != simp.best_value()) {
+        std::cout << "Parallel run differs from serial run\n";
+        --rtn;
+    }
+    if (psimp.evaluation_count <= simp.evaluation_count) {
+        std::cout << "Expected more evaluations with speculation\n";
+        --rtn;
+    }
+
+    // Multi-start from several simplexes, one of which is a poor start
+    std::vector<morph::vvec<morph::vvec<FLT>>> starts = {
+        { { -1.5, 2.0 }, { -1.4, 2.0 }, { -1.5, 2.1 } },
+        i_vertices,
+        { { 2.0, 2.0 }, { 1.5, 2.5 }, { 2.5, 1.0 } },
+        { { -2.0, -2.0 }, { 0.0, -2.0 }, { -1.0, 0.0 } }
+    };
+    morph::NM_Simplex<FLT> msimp (2);
+    msimp.objective = banana;
+    msimp.termination_threshold = std::numeric_limits<FLT>::epsilon();
+    msimp.too_many_operations = 10000;
+    morph::vvec<FLT> run_values;
+    int best = msimp.run_multistart (starts, &run_values);
+    if (best < 0 || run_values.size() != starts.size() || msimp.best_value() != run_values.min()) {
+        --rtn;
+    }
+    morph::vvec<FLT> thebest = msimp.best_vertex();
+    if (std::abs(thebest[0] - FLT{1}) > FLT{1e-3} || std::abs(thebest[1] - FLT{1}) > FLT{1e-3}) {
+        std::cout << "Multistart best (" << thebest << ") is not near (1,1)\n";
+        --rtn;
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,150 @@
+/*
+ * Test the block transforms of morph::scale: contiguous-container and std::span transform(),
+ * autoscale_transform() and the single pass z/colour transform_pair(). Each must give exactly
+ * the result of calling transform_one() on each element.
+ */
+
+#include <morph/scale.h>
+#include <morph/vvec.h>
+#include <vector>
+#include <list>
+#include <span>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+// Compare output against transform_one() for every element of data
+template <typename T, typename S>
+int check_against_one (const morph::scale<T, S>& s, const std::vector<T>& data, const std::vector<S>& output, const char* what)
+{
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        if (output[i] != s.transform_one (data[i])) {
+            std::cout << what << ": element " << i << " is " << output[i]
+                      << " but transform_one gives " << s.transform_one (data[i]) << std::endl;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    morph::vvec<double> vd (10001);
+    vd.randomize (0.1, 20.0);
+    std::vector<double> data (vd);
+
+    // Linear and log, contiguous container path
+    for (auto sf : { morph::scaling_function::Linear, morph::scaling_function::Logarithmic }) {
+        morph::scale<double, float> s;
+        s.setType (sf);
+        s.do_autoscale = true;
+        std::vector<float> out (data.size());
+        s.transform (data, out);
+        rtn += check_against_one (s, data, out, "vector transform");
+
+        // A non-contiguous container still takes the element-by-element path
+        std::list<double> ldata (data.begin(), data.end());
+        std::list<float> lout (ldata.size());
+        s.transform (ldata, lout);
+        if (!std::equal (lout.begin(), lout.end(), out.begin())) {
+            std::cout << "list transform differs from vector transform\n";
+            --rtn;
+        }
+
+        // span overload (autoscaling on a fresh scale)
+        morph::scale<double, float> s2;
+        s2.setType (sf);
+        s2.do_autoscale = true;
+        std::vector<float> sout (data.size());
+        s2.transform (std::span<const double>{data}, std::span<float>{sout});
+        if (sout != out) {
+            std::cout << "span transform differs from container transform\n";
+            --rtn;
+        }
+    }
+
+    // Integer input, float output
+    {
+        std::vector<int> idata = { -3, 7, 0, 12, 5, -1 };
+        morph::scale<int, float> s;
+        s.do_autoscale = true;
+        std::vector<float> out (idata.size());
+        s.transform (idata, out);
+        rtn += check_against_one (s, idata, out, "int transform");
+        if (std::abs (out[0]) > 1e-6f || std::abs (out[3] - 1.0f) > 1e-6f) { std::cout << "int autoscale wrong\n"; --rtn; }
+    }
+
+    // In place transform
+    {
+        morph::scale<float> s;
+        s.compute_scaling (-1.0f, 1.0f);
+        std::vector<float> d = { -1.0f, 0.0f, 0.5f, 1.0f };
+        s.transform (d, d);
+        if (d != std::vector<float>({ 0.0f, 0.5f, 0.75f, 1.0f })) { std::cout << "in place transform wrong\n"; --rtn; }
+    }
+
+    // autoscale_transform recomputes the scaling even when the scale is ready
+    {
+        morph::scale<double, float> s;
+        s.compute_scaling (0.0, 1000.0);
+        std::vector<float> out (data.size());
+        s.autoscale_transform (data, out);
+        float mn = out[0], mx = out[0];
+        for (auto o : out) { mn = o < mn ? o : mn; mx = o > mx ? o : mx; }
+        if (std::abs (mn) > 1e-6f || std::abs (mx - 1.0f) > 1e-6f) {
+            std::cout << "autoscale_transform gave range " << mn << " to " << mx << std::endl;
+            --rtn;
+        }
+        if (s.do_autoscale != false) { std::cout << "autoscale_transform changed do_autoscale\n"; --rtn; }
+    }
+
+    // transform_pair must equal two separate transforms, for each combination of scaling functions
+    for (auto zf : { morph::scaling_function::Linear, morph::scaling_function::Logarithmic }) {
+        for (auto cf : { morph::scaling_function::Linear, morph::scaling_function::Logarithmic }) {
+            morph::scale<double, float> zs, cs;
+            zs.setType (zf);
+            cs.setType (cf);
+            zs.do_autoscale = true;
+            cs.do_autoscale = true;
+            zs.output_range = morph::range<float>{ -0.5f, 0.5f };
+
+            morph::scale<double, float> zs_ref = zs;
+            morph::scale<double, float> cs_ref = cs;
+            std::vector<float> zref (data.size()), cref (data.size());
+            zs_ref.transform (data, zref);
+            cs_ref.transform (data, cref);
+
+            morph::vvec<float> z (data.size()), c (data.size());
+            zs.transform_pair (data, z, cs, c);
+            if (z != zref || c != cref) {
+                std::cout << "transform_pair differs from separate transforms\n";
+                --rtn;
+            }
+        }
+    }
+
+    // transform_pair with one scale fixed and one autoscaling
+    {
+        morph::scale<double, float> zs, cs;
+        zs.setParams (2.0f, 1.0f);
+        cs.do_autoscale = true;
+        std::vector<float> z (data.size()), c (data.size());
+        zs.transform_pair (data, z, cs, c);
+        rtn += check_against_one (zs, data, z, "pair (fixed)");
+        rtn += check_against_one (cs, data, c, "pair (autoscaled)");
+        if (zs.getParams(0) != 2.0f) { std::cout << "transform_pair changed fixed params\n"; --rtn; }
+
+        // Neither ready nor autoscaling should throw
+        morph::scale<double, float> unset;
+        try {
+            zs.transform_pair (data, z, unset, c);
+            std::cout << "expected transform_pair to throw\n";
+            --rtn;
+        } catch (const std::exception&) {}
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
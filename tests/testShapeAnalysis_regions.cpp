@@ -0,0 +1,104 @@
+/*
+ * Test ShapeAnalysis::hex_regions and ShapeAnalysis::dirichlet_domains on a Voronoi pattern on a
+ * circular HexGrid. The Dirichlet domains should match those found by the vertex search and
+ * boundary walks of ShapeAnalysis::dirichlet_vertices.
+ */
+
+#include <morph/HexGrid.h>
+#include <morph/ShapeAnalysis.h>
+#include <morph/vec.h>
+#include <iostream>
+#include <random>
+#include <cmath>
+#include <list>
+#include <vector>
+
+int main()
+{
+    int rtn = 0;
+
+    morph::HexGrid hg (0.01f, 3.0f, 0.0f);
+    hg.setCircularBoundary (0.6f);
+
+    // Give each hex the identity of the nearest of K seed points
+    constexpr int K = 40;
+    std::mt19937 gen (7);
+    std::uniform_real_distribution<float> u (-0.6f, 0.6f);
+    std::vector<morph::vec<float, 2>> seeds;
+    while (static_cast<int>(seeds.size()) < K) {
+        morph::vec<float, 2> s = { u(gen), u(gen) };
+        if (s.length() < 0.6f) { seeds.push_back (s); }
+    }
+    std::vector<float> f (hg.num());
+    for (unsigned int i = 0; i < hg.num(); ++i) {
+        morph::vec<float, 2> p = { hg.d_x[i], hg.d_y[i] };
+        int nearest = 0;
+        for (int k = 1; k < K; ++k) {
+            if ((p - seeds[k]).length() < (p - seeds[nearest]).length()) { nearest = k; }
+        }
+        f[i] = 0.01f * (nearest + 1);
+    }
+    // Put a single hex island into one region, so that it has a hole
+    f[hg.findHexNearest ({ 0.0f, 0.0f })->vi] = 1.0f;
+
+    std::list<morph::DirichDom<float>> doms;
+    std::vector<morph::ShapeAnalysis<float>::hexregion> regions = morph::ShapeAnalysis<float>::hex_regions (&hg, f, &doms);
+
+    // Regions should account for every hex, and their centroids should match region_centroids
+    std::map<float, morph::vec<float, 2>> centroids = morph::ShapeAnalysis<float>::region_centroids (&hg, f);
+    if (regions.size() != centroids.size()) {
+        std::cout << regions.size() << " regions but " << centroids.size() << " identities\n";
+        --rtn;
+    }
+    unsigned int hexcount = 0;
+    int holes = 0;
+    for (auto r : regions) {
+        hexcount += r.hexcount;
+        if ((r.centroid - centroids[r.f]).length() > 1e-4f) { --rtn; }
+        if (std::abs (r.area - r.hexcount * hg.getHexArea()) > 1e-6f) { --rtn; }
+        if (r.contours.empty()) { --rtn; }
+        holes += static_cast<int>(r.contours.size()) - 1;
+        if (r.f == 1.0f && (r.hexcount != 1 || r.contours[0].size() != 6 || r.vertices.size() != 0)) { --rtn; }
+    }
+    if (hexcount != hg.num()) { --rtn; }
+    if (holes != 1) { std::cout << holes << " holes, expected 1\n"; --rtn; }
+
+    // Compare the domains with those from dirichlet_vertices
+    std::list<morph::DirichVtx<float>> vertices;
+    std::list<morph::DirichDom<float>> walked = morph::ShapeAnalysis<float>::dirichlet_vertices (&hg, f, vertices);
+    if (walked.size() != doms.size() || doms.empty()) {
+        std::cout << doms.size() << " domains, but dirichlet_vertices found " << walked.size() << "\n";
+        --rtn;
+    }
+    for (auto w : walked) {
+        bool found = false;
+        for (auto d : doms) {
+            if (d.f != w.f) { continue; }
+            found = true;
+            if (d.vertices.size() != w.vertices.size()) { --rtn; break; }
+            // The vertices should run in the same direction, though they may start elsewhere
+            auto dv = d.vertices.begin();
+            while (dv != d.vertices.end() && !w.vertices.front().compare (dv->v)) { ++dv; }
+            for (auto wv : w.vertices) {
+                if (dv == d.vertices.end()) { dv = d.vertices.begin(); }
+                if (!wv.compare (dv->v) || (wv.vn - dv->vn).length() > wv.threshold || wv.neighb != dv->neighb
+                    || wv.pathto_next.size() != dv->pathto_next.size()
+                    || wv.pathto_neighbour.size() != dv->pathto_neighbour.size()) {
+                    std::cout << "Vertex " << wv.v << " of domain " << w.f << " differs\n";
+                    --rtn;
+                }
+                ++dv;
+            }
+            if (std::abs (d.edge_deviation - w.edge_deviation) > 1e-5f) { --rtn; }
+        }
+        if (!found) { --rtn; }
+    }
+
+    // The Honda analysis should run on the domains
+    std::vector<morph::vec<float, 2>> d_centres;
+    float honda = morph::ShapeAnalysis<float>::dirichlet_analyse (doms, d_centres);
+    if (!(honda >= 0.0f) || d_centres.size() != doms.size()) { --rtn; }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,113 @@
+/*
+ * Test morph::VertexArena::build(). Building a model's elements in parallel, each thread into an
+ * arena of its own, and then appending the arenas must give exactly the same vertices and
+ * indices as building the elements one after another. This needs no GL context.
+ */
+
+#include <morph/VertexArena.h>
+#include <morph/vec.h>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <array>
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+// Some deterministic primitives for element i. The number of vertices varies from one element to
+// the next, so that the index offsets of the arenas are all different.
+void element (morph::VertexArena& a, const std::size_t i)
+{
+    morph::vec<float> c = { 0.01f * static_cast<float>(i % 100), 0.01f * static_cast<float>(i / 100), 0.0f };
+    std::array<float, 3> clr = { 0.001f * static_cast<float>(i % 1000), 0.5f, 0.2f };
+    a.computeSphere (c, clr, 0.004f, 4 + static_cast<int>(i % 3), 6 + static_cast<int>(i % 5));
+    if (i % 7 == 0) { a.computeTetrahedron (c, 0.003f, clr); }
+    a.computeRectCuboid (c, 0.002f, 0.002f, 0.001f * static_cast<float>(1 + i % 4), clr);
+}
+
+bool same (const morph::VertexArena& a, const morph::VertexArena& b)
+{
+    return a.vertexPositions == b.vertexPositions && a.vertexNormals == b.vertexNormals
+    && a.vertexColors == b.vertexColors && a.indices == b.indices && a.idx == b.idx;
+}
+
+int main()
+{
+    int rtn = 0;
+
+#ifdef _OPENMP
+    // Make sure that the parallel path is taken, however many cores there are
+    omp_set_num_threads (4);
+#endif
+
+    constexpr std::size_t n = 5000;
+
+    // Serial and parallel builds, each appended to an arena that already holds a sphere
+    morph::VertexArena serial;
+    serial.parallel_build = false;
+    serial.computeSphere (morph::vec<float>{ 1, 1, 1 }, std::array<float, 3>{ 1, 0, 0 }, 0.1f);
+    serial.build (n, element);
+
+    morph::VertexArena parallel;
+    parallel.computeSphere (morph::vec<float>{ 1, 1, 1 }, std::array<float, 3>{ 1, 0, 0 }, 0.1f);
+    parallel.build (n, element);
+
+    if (!same (serial, parallel)) {
+        std::cout << "Parallel build differs from serial build (" << parallel.idx << " vertices vs. "
+                  << serial.idx << ")\n";
+        --rtn;
+    }
+    if (serial.idx * 3 != serial.vertexPositions.size()) {
+        std::cout << "idx (" << serial.idx << ") does not match the number of vertices\n";
+        --rtn;
+    }
+    // The indices should all refer to vertices that exist
+    for (auto i : parallel.indices) {
+        if (i >= parallel.idx) {
+            std::cout << "Index " << i << " is out of range\n";
+            --rtn;
+            break;
+        }
+    }
+
+    // Primitives can still be added after a parallel build
+    serial.computeSphere (morph::vec<float>{ -1, 1, 1 }, std::array<float, 3>{ 0, 1, 0 }, 0.1f);
+    parallel.computeSphere (morph::vec<float>{ -1, 1, 1 }, std::array<float, 3>{ 0, 1, 0 }, 0.1f);
+    if (!same (serial, parallel)) {
+        std::cout << "Arenas differ after adding a primitive to them\n";
+        --rtn;
+    }
+
+    // Appending arenas directly, including an empty one
+    std::vector<morph::VertexArena> arenas (3);
+    element (arenas[0], 1);
+    element (arenas[2], 2);
+    morph::VertexArena appended;
+    appended.append (arenas);
+    morph::VertexArena direct;
+    element (direct, 1);
+    element (direct, 2);
+    if (!same (appended, direct)) {
+        std::cout << "append() gives a different result from building directly\n";
+        --rtn;
+    }
+
+    // An exception thrown by the builder reaches the caller
+    morph::VertexArena throws;
+    bool caught = false;
+    try {
+        throws.build (n, [](morph::VertexArena& a, const std::size_t i) {
+            if (i == n / 2) { throw std::runtime_error ("builder failed"); }
+            element (a, i);
+        });
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    if (!caught) {
+        std::cout << "An exception thrown by the builder was not passed on\n";
+        --rtn;
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
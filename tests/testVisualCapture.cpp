@@ -0,0 +1,148 @@
+/*
+ * Test the CPU side of the asynchronous frame capture pipeline (morph::VisualCapture). Synthetic
+ * 'glReadPixels' frames are pushed through the worker pool to a y4m stream and to PNG files, and
+ * the content of each streamed frame is checked against its frame number. The frame rate achieved
+ * is reported.
+ */
+
+#include <morph/VisualCapture.h>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <string>
+
+// Fill a frame as GL would return it (bottom row first), with frame number f encoded in pixel values
+void fill_frame (unsigned char* px, const int w, const int h, const unsigned int f)
+{
+    for (int i = 0; i < h; ++i) {
+        for (int j = 0; j < w; ++j) {
+            unsigned char* p = px + 4 * (i * w + j);
+            p[0] = static_cast<unsigned char>(i);
+            p[1] = static_cast<unsigned char>(j);
+            p[2] = static_cast<unsigned char>(f);
+            p[3] = 128;
+        }
+    }
+}
+
+int main()
+{
+    int rtn = 0;
+
+    // First check flip_rows on a tiny image
+    constexpr int tw = 3;
+    constexpr int th = 2;
+    unsigned char in[tw * th * 4];
+    unsigned char out[tw * th * 4];
+    fill_frame (in, tw, th, 7);
+    morph::VisualCapture::flip_rows (in, out, tw, th, false);
+    // Top row of output should be the last row of input, with opaque alpha
+    if (out[0] != 1 || out[4 * tw] != 0 || out[3] != 255) {
+        std::cerr << "flip_rows failed\n";
+        --rtn;
+    }
+    morph::VisualCapture::flip_rows (in, out, tw, th, true);
+    if (out[3] != 128) {
+        std::cerr << "flip_rows did not preserve alpha\n";
+        --rtn;
+    }
+
+    // Now stream frames to a y4m file
+    constexpr int w = 640;
+    constexpr int h = 480;
+    constexpr unsigned int nframes = 120;
+    std::string y4mpath = "./testVisualCapture.y4m";
+
+    morph::capture_options co;
+    co.format = morph::capture_format::y4m;
+    co.output_path = y4mpath;
+    co.num_threads = 2;
+    co.num_buffers = 4;
+
+    using sc = std::chrono::steady_clock;
+    sc::time_point t0 = sc::now();
+    {
+        morph::VisualCapture cap (co, w, h);
+        for (unsigned int f = 0; f < nframes; ++f) {
+            unsigned int b = cap.acquire();
+            fill_frame (cap.pixels (b), w, h, f);
+            cap.submit (b);
+            // Every so often, acquire a buffer and give it back unused, as the Visual does when a
+            // frame can't be read back. That must not add a frame to the stream.
+            if (f % 10 == 5) {
+                b = cap.acquire();
+                fill_frame (cap.pixels (b), w, h, 255);
+                cap.release (b);
+            }
+        }
+        cap.finish();
+        if (cap.frames_written() != nframes) {
+            std::cerr << "Wrote " << cap.frames_written() << " frames, not " << nframes << std::endl;
+            --rtn;
+        }
+    }
+    sc::time_point t1 = sc::now();
+    double secs = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() / 1e6;
+    std::cout << "y4m capture: " << nframes << " frames of " << w << "x" << h << " at "
+              << (nframes / secs) << " frames/s\n";
+
+    // Check the file length, then that each frame holds the pixels of the frame with its number,
+    // which catches frames that are out of order, repeated or never filled.
+    std::string hdr = "YUV4MPEG2 W640 H480 F60:1 Ip A1:1 C444\n";
+    const std::size_t framebytes = std::size_t{w} * h * 3;
+    std::uintmax_t expected = hdr.size() + nframes * (6 + framebytes);
+    std::uintmax_t actual = std::filesystem::file_size (y4mpath);
+    if (actual != expected) {
+        std::cerr << "y4m file size " << actual << " != expected " << expected << std::endl;
+        --rtn;
+    }
+    std::ifstream yf (y4mpath, std::ios::binary);
+    std::vector<unsigned char> rgba (std::size_t{w} * h * 4);
+    std::vector<unsigned char> yuv (framebytes);
+    std::vector<char> got (framebytes);
+    for (unsigned int f = 0; f < nframes && rtn == 0; ++f) {
+        fill_frame (rgba.data(), w, h, f);
+        morph::VisualCapture::rgba_to_yuv444 (rgba.data(), yuv.data(), w, h);
+        yf.seekg (hdr.size() + f * (6 + framebytes) + 6);
+        yf.read (got.data(), framebytes);
+        if (!yf || std::memcmp (got.data(), yuv.data(), framebytes) != 0) {
+            std::cerr << "Frame " << f << " does not hold the pixels of frame " << f << "\n";
+            --rtn;
+        }
+    }
+    yf.close();
+    std::filesystem::remove (y4mpath);
+
+    // PNG output
+    std::filesystem::create_directories ("./testVisualCapture_frames");
+    co.format = morph::capture_format::png;
+    co.filename_stem = "./testVisualCapture_frames/f";
+    constexpr unsigned int npng = 10;
+    t0 = sc::now();
+    {
+        morph::VisualCapture cap (co, w, h);
+        for (unsigned int f = 0; f < npng; ++f) {
+            unsigned int b = cap.acquire();
+            fill_frame (cap.pixels (b), w, h, f);
+            cap.submit (b);
+        }
+    } // destructor finishes
+    t1 = sc::now();
+    secs = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count() / 1e6;
+    std::cout << "png capture: " << npng << " frames at " << (npng / secs) << " frames/s\n";
+    for (unsigned int f = 0; f < npng; ++f) {
+        std::string fn = "./testVisualCapture_frames/f0000" + std::to_string(f) + ".png";
+        if (!std::filesystem::exists (fn)) {
+            std::cerr << "Missing " << fn << std::endl;
+            --rtn;
+        }
+    }
+    std::filesystem::remove_all ("./testVisualCapture_frames");
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,126 @@
+/*
+ * Test the packed vertex format of VisualModel. Normals must survive octahedral encoding with
+ * little error, and a lit scene rendered with packed models must look the same (to within the
+ * 8 bit quantisation of the colours) as the same scene rendered with separate buffers. This is
+ * checked both for a small model, which gets 16 bit indices, and a large one, which doesn't.
+ */
+
+#include <morph/VisualOffscreen.h>
+#include <morph/SphereVisual.h>
+#include <morph/GridVisual.h>
+#include <morph/Grid.h>
+#include <morph/mathconst.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cmath>
+
+// Render v and return the framebuffer
+template <int glver>
+std::vector<unsigned char> grab (morph::VisualOffscreen<glver>& v)
+{
+    v.render();
+    v.setContext();
+    std::vector<unsigned char> px (static_cast<std::size_t>(v.fb_width()) * v.fb_height() * 4, 0);
+    v.glfn->ReadPixels (0, 0, v.fb_width(), v.fb_height(), GL_RGBA, GL_UNSIGNED_BYTE, px.data());
+    v.releaseContext();
+    return px;
+}
+
+// Render a lit sphere and a grid in the given vertex format. Return the upload sizes in bytes.
+std::vector<unsigned char> render_scene (const morph::visgl::vertex_format vf, const unsigned int gridside,
+                                         std::size_t& sphere_bytes, std::size_t& grid_bytes)
+{
+    morph::VisualOffscreen<> v (240, 180);
+    v.lightingEffects();
+    v.setSceneTrans (morph::vec<float>{ -0.3f, -0.3f, -3.0f });
+
+    auto sv = std::make_unique<morph::SphereVisual<>> (morph::vec<float>{ -0.5f, 0.3f, 0.0f }, 0.4f,
+                                                         std::array<float, 3>{ 0.9f, 0.3f, 0.1f });
+    v.bindmodel (sv);
+    sv->vertex_format = vf;
+    sv->finalize();
+    sphere_bytes = sv->upload_bytes();
+    v.addVisualModel (sv);
+
+    morph::Grid<unsigned int, float> grid (gridside, gridside, morph::vec<float, 2>{ 1.0f / gridside, 1.0f / gridside });
+    morph::vvec<float> data (grid.n());
+    for (unsigned int i = 0; i < grid.n(); ++i) { data[i] = std::sin (0.05f * (i % gridside)) * std::cos (0.07f * (i / gridside)); }
+    auto gv = std::make_unique<morph::GridVisual<float>> (&grid, morph::vec<float>{ 0.0f, -0.5f, 0.0f });
+    v.bindmodel (gv);
+    gv->vertex_format = vf;
+    gv->gridVisMode = morph::GridVisMode::Triangles;
+    gv->setScalarData (&data);
+    gv->zScale.setParams (0.2f, 0.0f);
+    gv->colourScale.compute_scaling (-1.0f, 1.0f);
+    gv->finalize();
+    grid_bytes = gv->upload_bytes();
+    v.addVisualModel (gv);
+
+    return grab (v);
+}
+
+int main()
+{
+    int rtn = 0;
+
+    // Octahedral encoding of normals, including the axes and the folded lower hemisphere
+    std::vector<morph::vec<float>> normals = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    std::mt19937 gen (7);
+    std::normal_distribution<float> nd (0.0f, 1.0f);
+    for (int i = 0; i < 100000; ++i) {
+        morph::vec<float> n = { nd (gen), nd (gen), nd (gen) };
+        n.renormalize();
+        normals.push_back (n);
+    }
+    float max_err = 0.0f;
+    for (auto n : normals) {
+        morph::vec<float> d = morph::visgl::oct_decode (morph::visgl::oct_encode (n[0], n[1], n[2]));
+        // For small angles, |d x n| is more accurate than acos(d.n)
+        max_err = std::max (max_err, std::asin (std::min (1.0f, d.cross (n).length())));
+    }
+    max_err *= 180.0f / morph::mathconst<float>::pi;
+    if (max_err > 0.01f) {
+        std::cout << "Largest error in octahedral-encoded normal: " << max_err << " degrees\n";
+        --rtn;
+    }
+    if (morph::visgl::unorm8 (1.0f) != 255 || morph::visgl::unorm8 (-0.5f) != 0 || morph::visgl::unorm8 (0.5f) != 128) { --rtn; }
+
+    // Compare renders. A 300x300 grid has more than 65536 vertices, so keeps 32 bit indices.
+    for (unsigned int gridside : { 40u, 300u }) {
+        std::size_t s_sphere = 0, s_grid = 0, p_sphere = 0, p_grid = 0;
+        std::vector<unsigned char> sep = render_scene (morph::visgl::vertex_format::separate, gridside, s_sphere, s_grid);
+        std::vector<unsigned char> pkd = render_scene (morph::visgl::vertex_format::packed, gridside, p_sphere, p_grid);
+        int maxdiff = 0;
+        std::size_t ndiff = 0;
+        for (std::size_t i = 0; i < sep.size(); ++i) {
+            int d = std::abs (static_cast<int>(sep[i]) - static_cast<int>(pkd[i]));
+            maxdiff = std::max (maxdiff, d);
+            if (d > 0) { ++ndiff; }
+        }
+        if (maxdiff > 3) {
+            std::cout << gridside << "x" << gridside << " grid: packed render differs from separate render by up to "
+                      << maxdiff << " in " << ndiff << " channels\n";
+            --rtn;
+        }
+        unsigned int coloured = 0;
+        for (std::size_t i = 0; i < pkd.size(); i += 4) { if (pkd[i] != pkd[i + 2]) { ++coloured; } }
+        if (coloured < 1000) {
+            std::cout << "Too few coloured pixels (" << coloured << ") in the packed render\n";
+            --rtn;
+        }
+        // Small models get 16 bit indices: 20 bytes per vertex and 2 per index instead of 36 and
+        // 4, so they should shrink by more than 40%. With 32 bit indices (and about 6 indices
+        // per vertex) the large grid should shrink by about 25%.
+        const bool grid_ok = gridside < 300u ? p_grid * 10 < s_grid * 6 : (p_grid * 10 > s_grid * 6 && p_grid * 4 < s_grid * 3);
+        if (p_sphere * 10 > s_sphere * 6 || !grid_ok) {
+            std::cout << "Packed uploads are " << p_sphere << " and " << p_grid << " bytes; separate uploads are "
+                      << s_sphere << " and " << s_grid << " bytes\n";
+            --rtn;
+        }
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,121 @@
+/*
+ * Test the headless morph::VisualOffscreen. A graph is rendered into the offscreen framebuffer of
+ * one Visual, and then into several Visuals, each in its own thread. The images are saved with
+ * saveImage() and the framebuffer contents are checked. Lastly, a short sequence of frames is
+ * recorded with startCapture().
+ */
+
+#include <morph/VisualOffscreen.h>
+#include <morph/GraphVisual.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+// Make a figure with a graph of y = x^n in v, render it and return the number of pixels that differ
+// from the (white) background
+template <int glver>
+int make_figure (morph::VisualOffscreen<glver>& v, const int n)
+{
+    auto gv = std::make_unique<morph::GraphVisual<double>> (morph::vec<float>({-0.5f, -0.5f, 0.0f}));
+    v.bindmodel (gv);
+    morph::vvec<double> x;
+    x.linspace (-0.5, 0.8, 14);
+    gv->setdata (x, x.pow(n));
+    gv->finalize();
+    v.addVisualModel (gv);
+    v.render();
+
+    v.setContext();
+    const int w = v.fb_width();
+    const int h = v.fb_height();
+    std::vector<unsigned char> px (static_cast<size_t>(w) * h * 4, 0);
+    v.glfn->ReadPixels (0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, px.data());
+    int nonbg = 0;
+    for (size_t i = 0; i < px.size(); i += 4) {
+        if (px[i] < 200 || px[i+1] < 200 || px[i+2] < 200) { ++nonbg; }
+    }
+    v.releaseContext();
+    return nonbg;
+}
+
+int main()
+{
+    int rtn = 0;
+    constexpr int w = 320;
+    constexpr int h = 240;
+
+    // One Visual in the main thread
+    {
+        morph::VisualOffscreen<> v (w, h, "testVisualOffscreen", true);
+        int nonbg = make_figure (v, 3);
+        if (nonbg < 100) {
+            std::cerr << "Expected a graph in the framebuffer, but only " << nonbg << " pixels drawn\n";
+            --rtn;
+        }
+        morph::vec<int, 2> dims = v.saveImage ("./testVisualOffscreen.png");
+        if (dims[0] != w || dims[1] != h || !std::filesystem::exists ("./testVisualOffscreen.png")) {
+            std::cerr << "saveImage failed (dims " << dims << ")\n";
+            --rtn;
+        }
+        std::filesystem::remove ("./testVisualOffscreen.png");
+
+        // Resize and check that saved images follow
+        v.resize (w / 2, h / 2);
+        v.render();
+        dims = v.saveImage ("./testVisualOffscreen_small.png");
+        if (dims[0] != w / 2 || dims[1] != h / 2) {
+            std::cerr << "After resize, saveImage gave dims " << dims << std::endl;
+            --rtn;
+        }
+        std::filesystem::remove ("./testVisualOffscreen_small.png");
+
+        // Record a few frames through the asynchronous capture path
+        morph::capture_options co;
+        co.format = morph::capture_format::raw;
+        co.output_path = "./testVisualOffscreen.rgba";
+        co.num_threads = 1;
+        v.startCapture (co);
+        constexpr unsigned int nframes = 6;
+        for (unsigned int f = 0; f < nframes; ++f) { v.render(); }
+        v.stopCapture();
+        std::uintmax_t expected = nframes * std::uintmax_t{w / 2} * (h / 2) * 4;
+        std::uintmax_t actual = std::filesystem::file_size ("./testVisualOffscreen.rgba");
+        if (actual != expected) {
+            std::cerr << "Capture wrote " << actual << " bytes; expected " << expected << std::endl;
+            --rtn;
+        }
+        std::filesystem::remove ("./testVisualOffscreen.rgba");
+    }
+
+    // Several Visuals, each created, rendered and saved in its own thread
+    constexpr int nthreads = 3;
+    std::atomic<int> failures = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthreads; ++t) {
+        threads.emplace_back ([t, &failures]() {
+            try {
+                morph::VisualOffscreen<> v (w, h);
+                if (make_figure (v, t + 1) < 100) { ++failures; }
+                std::string fn = "./testVisualOffscreen_t" + std::to_string (t) + ".png";
+                morph::vec<int, 2> dims = v.saveImage (fn);
+                if (dims[0] != w || !std::filesystem::exists (fn)) { ++failures; }
+                std::filesystem::remove (fn);
+                v.releaseContext();
+            } catch (const std::exception& e) {
+                std::cerr << "Thread " << t << ": " << e.what() << std::endl;
+                ++failures;
+            }
+        });
+    }
+    for (auto& th : threads) { th.join(); }
+    if (failures > 0) {
+        std::cerr << failures << " failures in threaded offscreen rendering\n";
+        --rtn;
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,116 @@
+/*
+ * Test render-on-demand and the frame rate limit of morph::Visual. With renderOnDemand set,
+ * render() should draw only when a model, the camera, the window or some text has changed, and
+ * should leave the last frame in place otherwise. With max_frame_rate set, render() should draw
+ * no more often than the rate allows, however often it is called.
+ */
+
+#include <morph/VisualOffscreen.h>
+#include <morph/GridVisual.h>
+#include <morph/Grid.h>
+#include <morph/vvec.h>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <string>
+
+// Read back the framebuffer of v
+template <int glver>
+std::vector<unsigned char> pixels (morph::VisualOffscreen<glver>& v)
+{
+    v.setContext();
+    std::vector<unsigned char> px (static_cast<std::size_t>(v.fb_width()) * v.fb_height() * 4, 0);
+    v.glfn->ReadPixels (0, 0, v.fb_width(), v.fb_height(), GL_RGBA, GL_UNSIGNED_BYTE, px.data());
+    v.releaseContext();
+    return px;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    morph::VisualOffscreen<> v (160, 120);
+    v.renderOnDemand (true);
+    v.setSceneTrans (morph::vec<float>{ -0.5f, -0.5f, -3.0f });
+
+    morph::Grid<unsigned int, float> grid (20u, 20u, morph::vec<float, 2>{ 0.05f, 0.05f });
+    morph::vvec<float> data (grid.n());
+    data.linspace (0.0f, 1.0f);
+    auto gv = std::make_unique<morph::GridVisual<float>> (&grid, morph::vec<float>{});
+    v.bindmodel (gv);
+    gv->setScalarData (&data);
+    gv->finalize();
+    auto gvp = v.addVisualModel (gv);
+
+    // Check that a call to render() draws (or doesn't draw) a frame
+    auto expect = [&v, &rtn](const bool drawn, const std::string& what) {
+        std::uint64_t n0 = v.frames_rendered;
+        v.render();
+        if ((v.frames_rendered > n0) != drawn) {
+            std::cout << "render() after " << what << (drawn ? " did not draw" : " drew") << " a frame\n";
+            --rtn;
+        }
+    };
+
+    expect (true, "adding a model");
+    std::vector<unsigned char> first = pixels (v);
+    expect (false, "no change");
+    expect (false, "no change (again)");
+    if (pixels (v) != first) {
+        std::cout << "The last frame was not left in place when render() skipped drawing\n";
+        --rtn;
+    }
+
+    gvp->setViewRotation (morph::quaternion<float>(morph::vec<float>{ 0.0f, 0.0f, 1.0f }, 0.3f));
+    expect (true, "rotating a model");
+    if (pixels (v) == first) {
+        std::cout << "Rotating the model did not change the image\n";
+        --rtn;
+    }
+    expect (false, "no change");
+
+    data *= 0.5f;
+    gvp->updateData (&data);
+    expect (true, "updating a model's data");
+
+    gvp->addLabel ("label", morph::vec<float>{ 0.0f, -0.2f, 0.0f });
+    expect (true, "adding a text label");
+
+    v.setSceneTrans (morph::vec<float>{ -0.4f, -0.5f, -3.0f });
+    expect (true, "moving the camera");
+
+    v.scroll_callback (0.0, 1.0);
+    expect (true, "scrolling");
+
+    v.window_size_callback (160, 120);
+    expect (true, "a window resize");
+
+    gvp->setHide (true);
+    expect (true, "hiding a model");
+
+    v.bgcolour = { 0.0f, 0.0f, 0.0f, 1.0f };
+    expect (false, "directly changing bgcolour");
+    v.markDirty();
+    expect (true, "markDirty()");
+
+    // Frame rate limit. Call render() as fast as possible for 0.25 s at 20 fps, with a change
+    // to the scene before every call.
+    v.max_frame_rate = 20.0;
+    std::uint64_t n0 = v.frames_rendered;
+    std::uint64_t calls = 0;
+    using sc = std::chrono::steady_clock;
+    sc::time_point t0 = sc::now();
+    while (sc::now() - t0 < std::chrono::milliseconds (250)) {
+        gvp->addViewRotation (morph::quaternion<float>(morph::vec<float>{ 0.0f, 0.0f, 1.0f }, 0.01f));
+        v.render();
+        ++calls;
+    }
+    std::uint64_t drawn = v.frames_rendered - n0;
+    if (drawn < 2 || drawn > 6 || calls <= drawn) {
+        std::cout << "At 20 fps for 0.25 s, " << drawn << " frames were drawn from " << calls << " calls\n";
+        --rtn;
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
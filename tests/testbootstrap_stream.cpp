@@ -0,0 +1,77 @@
+// Test the streaming bootstrap, bootstrap::resample_statistics(), with built in and custom
+// reducers and check that results are reproducible for a given seed.
+
+#include <morph/vvec.h>
+#include <morph/vec.h>
+#include <morph/bootstrap.h>
+#include <morph/Random.h>
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+
+int main()
+{
+    int rtn = 0;
+
+    morph::RandNormal<double, std::mt19937_64> rnorm (5, 1, 42);
+    morph::vvec<double> data;
+    data.set_from (rnorm.get (2000));
+
+    // The same seed gives the same resamples, and so the same statistics
+    double eom1 = morph::bootstrap<double>::error_of_mean (data, 1000, 1234);
+    double eom2 = morph::bootstrap<double>::error_of_mean (data, 1000, 1234);
+    double eom3 = morph::bootstrap<double>::error_of_mean (data, 1000, 4321);
+    if (eom1 != eom2 || eom1 == eom3) {
+        std::cout << "Seeding is not reproducible: " << eom1 << ", " << eom2 << ", " << eom3 << "\n";
+        --rtn;
+    }
+
+    // The standard error of the mean should be close to SD/sqrt(N)
+    double sem = data.std() / std::sqrt (data.size());
+    if (std::abs (eom1 - sem) / sem > 0.1) {
+        std::cout << "error_of_mean " << eom1 << " is not close to SD/sqrt(N) = " << sem << "\n";
+        --rtn;
+    }
+
+    // The resamples drawn by resample_with_replacement with the same seed should give the
+    // same means as resample_statistics
+    std::vector<morph::vvec<double>> resamples;
+    morph::bootstrap<double>::resample_with_replacement (data, resamples, 50, 99);
+    morph::vvec<double> means = morph::bootstrap<double>::resample_statistics (data, 50, [](morph::vvec<double>& r) { return r.mean(); }, 99);
+    for (unsigned int i = 0; i < 50; ++i) {
+        if (resamples[i].mean() != means[i]) { --rtn; break; }
+    }
+
+    // A custom reducer (the median) which modifies its resample
+    auto median = [](morph::vvec<double>& r) {
+        auto mid = r.begin() + r.size() / 2;
+        std::nth_element (r.begin(), mid, r.end());
+        return *mid;
+    };
+    morph::vvec<double> medians = morph::bootstrap<double>::resample_statistics (data, 500, median, 7);
+    if (medians.size() != 500 || std::abs (medians.mean() - 5.0) > 0.1) {
+        std::cout << "Bootstrapped median " << medians.mean() << " is not close to 5\n";
+        --rtn;
+    }
+    // Standard error of the median of a normal distribution is about 1.2533 SD/sqrt(N)
+    if (std::abs (medians.std() - 1.2533 * sem) / (1.2533 * sem) > 0.2) {
+        std::cout << "Standard error of the median " << medians.std() << " is not close to " << 1.2533 * sem << "\n";
+        --rtn;
+    }
+
+    // A reducer returning more than one value
+    morph::vvec<morph::vec<double, 2>> meansd = morph::bootstrap<double>::resample_statistics (
+        data, 100, [](morph::vvec<double>& r) { return morph::vec<double, 2>({ r.mean(), r.std() }); }, 7);
+    if (meansd.size() != 100 || std::abs (meansd[0][1] - 1.0) > 0.1) { --rtn; }
+
+    // The t-test is reproducible with a seed, too
+    morph::RandNormal<double, std::mt19937_64> rnorm2 (5.5, 1, 43);
+    morph::vvec<double> data2;
+    data2.set_from (rnorm2.get (2000));
+    morph::vec<double, 2> asl1 = morph::bootstrap<double>::ttest_equalityofmeans (data, data2, 500, 5);
+    morph::vec<double, 2> asl2 = morph::bootstrap<double>::ttest_equalityofmeans (data, data2, 500, 5);
+    if (asl1 != asl2 || asl1[0] > asl1[1]) { --rtn; }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
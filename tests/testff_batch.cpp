@@ -0,0 +1,100 @@
+/*
+ * Check that the batched (mini-batch matrix) training methods of FeedForwardNet give the same
+ * outputs, cost and mean gradients as the one-example-at-a-time methods.
+ */
+
+#include <morph/nn/FeedForwardNet.h>
+#include <morph/vvec.h>
+#include <vector>
+#include <iostream>
+#include <cmath>
+
+int main()
+{
+    int rtn = 0;
+
+    constexpr unsigned int bs = 9;
+    morph::nn::FeedForwardNet<float> ff1({37, 13, 6});
+
+    // Make up a mini-batch of inputs and desired outputs
+    std::vector<morph::vvec<float>> ins (bs);
+    std::vector<morph::vvec<float>> outs (bs);
+    for (unsigned int s = 0; s < bs; ++s) {
+        ins[s].resize (37);
+        ins[s].randomize();
+        outs[s].resize (6);
+        outs[s].zero();
+        outs[s][s % 6] = 1.0f;
+    }
+
+    // Per-example: accumulate the mean gradients and cost
+    std::vector<morph::vvec<float>> mean_nabla_w;
+    std::vector<morph::vvec<float>> mean_nabla_b;
+    for (auto& c : ff1.connections) {
+        mean_nabla_w.push_back (c.nabla_ws[0]);
+        mean_nabla_w.back().zero();
+        mean_nabla_b.push_back (c.nabla_b);
+        mean_nabla_b.back().zero();
+    }
+    std::vector<morph::vvec<float>> outputs (bs);
+    float cost = 0.0f;
+    for (unsigned int s = 0; s < bs; ++s) {
+        ff1.setInput (ins[s], outs[s]);
+        ff1.feedforward();
+        outputs[s] = ff1.neurons.back();
+        cost += ff1.computeCost();
+        ff1.backprop();
+        unsigned int i = 0;
+        for (auto& c : ff1.connections) {
+            mean_nabla_w[i] += c.nabla_ws[0] / static_cast<float>(bs);
+            mean_nabla_b[i] += c.nabla_b / static_cast<float>(bs);
+            ++i;
+        }
+    }
+    cost /= static_cast<float>(bs);
+
+    // Batched
+    ff1.setBatchSize (bs);
+    for (unsigned int s = 0; s < bs; ++s) { ff1.setBatchInput (s, ins[s], outs[s]); }
+    ff1.feedforward_batch();
+    float cost_b = ff1.computeCost_batch();
+    ff1.backprop_batch();
+
+    const float tol = 1e-5f;
+    if (std::abs (cost - cost_b) > tol) {
+        std::cout << "Cost differs: " << cost << " vs. " << cost_b << std::endl;
+        --rtn;
+    }
+    for (unsigned int s = 0; s < bs; ++s) {
+        for (unsigned int j = 0; j < 6; ++j) {
+            if (std::abs (outputs[s][j] - ff1.neurons_batch.back()[s * 6 + j]) > tol) { --rtn; }
+        }
+    }
+    unsigned int i = 0;
+    for (auto& c : ff1.connections) {
+        if ((c.nabla_ws[0] - mean_nabla_w[i]).abs().max() > tol) {
+            std::cout << "nabla_w differs for connection " << i << std::endl;
+            --rtn;
+        }
+        if ((c.nabla_b - mean_nabla_b[i]).abs().max() > tol) {
+            std::cout << "nabla_b differs for connection " << i << std::endl;
+            --rtn;
+        }
+        ++i;
+    }
+
+    // A few steps of gradient descent on the batch should reduce the cost
+    for (unsigned int k = 0; k < 20; ++k) {
+        ff1.update (1.0f);
+        ff1.feedforward_batch();
+        ff1.computeCost_batch();
+        ff1.backprop_batch();
+    }
+    if (!(ff1.cost < cost_b)) {
+        std::cout << "Cost did not fall: " << cost_b << " -> " << ff1.cost << std::endl;
+        --rtn;
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,157 @@
+/*
+ * Test FFT convolution. The bundled FFT is checked against a direct DFT for lengths that are and
+ * are not powers of 2, then CartGrid::fft_convolver and HexGrid::fft_convolver are checked
+ * against CartGrid::convolve and HexGrid::convolve on rectangular and parallelogram domains,
+ * with and without wrapping.
+ */
+
+#include <morph/fft.h>
+#include <morph/CartGrid.h>
+#include <morph/HexGrid.h>
+#include <morph/mathconst.h>
+#include <iostream>
+#include <complex>
+#include <vector>
+#include <string>
+#include <cmath>
+
+using cplx = std::complex<double>;
+
+// Compare an FFT of length n with a direct evaluation of the DFT
+int test_plan (const std::size_t n)
+{
+    std::vector<cplx> a (n);
+    for (std::size_t k = 0; k < n; ++k) { a[k] = cplx (std::sin (0.7 * k) + 0.1 * k, std::cos (1.3 * k)); }
+
+    std::vector<cplx> expected (n);
+    for (std::size_t f = 0; f < n; ++f) {
+        for (std::size_t k = 0; k < n; ++k) {
+            const double ang = -morph::mathconst<double>::two_pi * static_cast<double>((f * k) % n) / n;
+            expected[f] += a[k] * cplx (std::cos (ang), std::sin (ang));
+        }
+    }
+
+    morph::fft::plan<double> p (n);
+    std::vector<cplx> work (p.work_size());
+    std::vector<cplx> b = a;
+    p.transform (b.data(), false, work.data());
+    double maxerr = 0.0;
+    for (std::size_t f = 0; f < n; ++f) { maxerr = std::max (maxerr, std::abs (b[f] - expected[f])); }
+    // And back again
+    p.transform (b.data(), true, work.data());
+    double maxerr_inv = 0.0;
+    for (std::size_t k = 0; k < n; ++k) { maxerr_inv = std::max (maxerr_inv, std::abs (b[k] - a[k])); }
+
+    if (maxerr > 1e-9 * n || maxerr_inv > 1e-12 * n) {
+        std::cout << "FFT of length " << n << ": error " << maxerr << ", inverse error " << maxerr_inv << "\n";
+        return -1;
+    }
+    return 0;
+}
+
+int compare (const std::string& name, const std::vector<float>& got, const std::vector<float>& expected)
+{
+    if (got.size() != expected.size()) {
+        std::cout << name << ": result has " << got.size() << " elements, expected " << expected.size() << "\n";
+        return -1;
+    }
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        if (std::abs (got[i] - expected[i]) > 1e-4f * (1.0f + std::abs (expected[i]))) {
+            std::cout << name << ": element " << i << " is " << got[i] << ", expected " << expected[i] << "\n";
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Convolve with CartGrid::convolve and with an FFT convolver and compare
+int test_cartgrid (const morph::GridDomainWrap wrap, const float kernel_halfwidth, const std::string& name)
+{
+    int rtn = 0;
+    morph::CartGrid cg (0.1f, 0.1f, 0.0f, 0.0f, 1.9f, 1.2f, 0.0f, morph::GridDomainShape::Rectangle, wrap);
+    morph::CartGrid kg (0.1f, 0.1f, -kernel_halfwidth, -kernel_halfwidth, kernel_halfwidth, kernel_halfwidth);
+
+    std::vector<float> kerneldata (kg.num());
+    for (std::size_t k = 0; k < kerneldata.size(); ++k) { kerneldata[k] = std::cos (0.9f * k) + 0.2f; }
+    std::vector<float> data (cg.num());
+    std::vector<float> data2 (cg.num());
+    for (std::size_t i = 0; i < data.size(); ++i) { data[i] = std::sin (0.37f * i) + 0.001f * i; data2[i] = std::cos (0.11f * i); }
+
+    std::vector<float> expected (cg.num());
+    std::vector<float> expected2 (cg.num());
+    cg.convolve (kg, kerneldata, data, expected);
+    cg.convolve (kg, kerneldata, data2, expected2);
+
+    auto conv = cg.fft_convolver (kg, kerneldata);
+    std::vector<float> result;
+    conv.convolve (data, result);
+    rtn += compare (name, result, expected);
+
+    // Applying the convolver again gives the same result
+    conv.convolve (data, result);
+    rtn += compare (name + " (second application)", result, expected);
+
+    // Two fields at once
+    std::vector<float> result1;
+    std::vector<float> result2;
+    conv.convolve (data, data2, result1, result2);
+    rtn += compare (name + " (pair, first)", result1, expected);
+    rtn += compare (name + " (pair, second)", result2, expected2);
+
+    return rtn;
+}
+
+int test_hexgrid (const bool wrap, const float kernel_span, const std::string& name)
+{
+    int rtn = 0;
+    morph::HexGrid hg (0.1f, 5.0f);
+    hg.setParallelogramBoundary (11, 8);
+    if (wrap) { hg.setParallelogramWrap (true, true); }
+    morph::HexGrid kg (0.1f, kernel_span);
+
+    std::vector<float> kerneldata (kg.num());
+    for (std::size_t k = 0; k < kerneldata.size(); ++k) { kerneldata[k] = std::cos (0.9f * k) + 0.2f; }
+    std::vector<float> data (hg.num());
+    for (std::size_t i = 0; i < data.size(); ++i) { data[i] = std::sin (0.37f * i) + 0.001f * i; }
+
+    std::vector<float> expected (hg.num());
+    hg.convolve (kg, kerneldata, data, expected);
+
+    auto conv = hg.fft_convolver (kg, kerneldata);
+    std::vector<float> result;
+    conv.convolve (data, result);
+    rtn += compare (name, result, expected);
+
+    return rtn;
+}
+
+int main()
+{
+    int rtn = 0;
+
+    for (std::size_t n : { 1, 2, 4, 8, 64, 1024, 3, 5, 12, 17, 100, 243, 1000 }) { rtn += test_plan (n); }
+
+    // Kernels smaller than the domain, and one that reaches beyond it
+    using W = morph::GridDomainWrap;
+    rtn += test_cartgrid (W::None, 0.3f, "CartGrid, no wrap");
+    rtn += test_cartgrid (W::Horizontal, 0.3f, "CartGrid, horizontal wrap");
+    rtn += test_cartgrid (W::None, 1.5f, "CartGrid, no wrap, large kernel");
+    rtn += test_cartgrid (W::Horizontal, 2.5f, "CartGrid, horizontal wrap, large kernel");
+
+    rtn += test_hexgrid (false, 0.5f, "HexGrid, no wrap");
+    rtn += test_hexgrid (true, 0.5f, "HexGrid, wrapped");
+    rtn += test_hexgrid (false, 2.5f, "HexGrid, no wrap, large kernel");
+    rtn += test_hexgrid (true, 2.5f, "HexGrid, wrapped, large kernel");
+
+    // A HexGrid that is not a parallelogram can't be convolved by FFT
+    morph::HexGrid hexagonal (0.1f, 1.0f);
+    morph::HexGrid kg (0.1f, 0.3f);
+    try {
+        auto conv = hexagonal.fft_convolver (kg, std::vector<float> (kg.num(), 1.0f));
+        std::cout << "fft_convolver on a hexagonal HexGrid didn't throw\n";
+        --rtn;
+    } catch (const std::runtime_error&) {}
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,89 @@
+/*
+ * Test morph::idx_file and morph::idx_dataset by writing some small MNIST-like IDX files,
+ * then loading them both with idx_dataset and with morph::Mnist.
+ */
+
+#include <morph/idx.h>
+#include <morph/Mnist.h>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <set>
+
+// Write a big-endian 32 bit int
+void write32 (std::ofstream& f, unsigned int v)
+{
+    char b[4] = { static_cast<char>((v >> 24) & 0xff), static_cast<char>((v >> 16) & 0xff),
+                  static_cast<char>((v >> 8) & 0xff), static_cast<char>(v & 0xff) };
+    f.write (b, 4);
+}
+
+// Write n random 28x28 images and their labels with the given file name tag
+void write_idx (const std::string& tag, unsigned int n, std::mt19937& gen)
+{
+    std::uniform_int_distribution<int> pix (0, 255);
+    std::ofstream fi (tag + "-images-idx3-ubyte", std::ios::out | std::ios::binary | std::ios::trunc);
+    write32 (fi, 2051);
+    write32 (fi, n);
+    write32 (fi, 28);
+    write32 (fi, 28);
+    for (unsigned int i = 0; i < n * 784; ++i) { char c = static_cast<char>(pix (gen)); fi.write (&c, 1); }
+    std::ofstream fl (tag + "-labels-idx1-ubyte", std::ios::out | std::ios::binary | std::ios::trunc);
+    write32 (fl, 2049);
+    write32 (fl, n);
+    for (unsigned int i = 0; i < n; ++i) { char c = static_cast<char>(i % 10); fl.write (&c, 1); }
+}
+
+int main()
+{
+    int rtn = 0;
+
+    std::mt19937 gen (42);
+    write_idx ("./testidx_train", 120, gen);
+    write_idx ("./testidx_t10k", 30, gen);
+
+    morph::idx_file f ("./testidx_train-images-idx3-ubyte");
+    if (f.shape().size() != 3 || f.count() != 120 || f.item_size() != 784) { --rtn; }
+
+    morph::idx_dataset ds ("./testidx_train-images-idx3-ubyte", "./testidx_train-labels-idx1-ubyte");
+    if (ds.size() != 120 || ds.example_size() != 784 || ds.data.size() != 120 * 784) { --rtn; }
+    if (ds.by_label.size() != 10 || ds.by_label[3].size() != 12 || ds.labels[13] != 3) { --rtn; }
+
+    // Compare with Mnist, which keeps a vvec per example in a multimap keyed by label
+    morph::Mnist m ("./testidx_");
+    if (m.num_training() != 120 || m.num_test() != 30) { --rtn; }
+    for (auto ex : m.training_f) {
+        const int id = ex.second.first;
+        if (ds.labels[id] != ex.first) { --rtn; break; }
+        std::span<const float> e = ds.example (id);
+        bool same = true;
+        for (unsigned int k = 0; k < 784; ++k) { if (e[k] != ex.second.second[k]) { same = false; } }
+        if (!same) { std::cout << "Example " << id << " differs\n"; --rtn; break; }
+    }
+
+    // Lazily converted examples should match the eagerly converted ones
+    morph::idx_dataset dsl ("./testidx_train-images-idx3-ubyte", "./testidx_train-labels-idx1-ubyte",
+                            1.0f / 256.0f, true, morph::idx_convert::lazy);
+    std::vector<float> ex (dsl.example_size());
+    dsl.example_into (57, ex.data());
+    for (unsigned int k = 0; k < 784; ++k) { if (ex[k] != ds.example(57)[k]) { --rtn; break; } }
+
+    // Shuffled mini-batches should visit each example once
+    ds.shuffle (gen);
+    std::set<std::size_t> seen;
+    for (std::size_t b = 0; b < ds.num_batches (10); ++b) {
+        for (std::size_t i : ds.batch (b, 10)) { seen.insert (i); }
+    }
+    if (seen.size() != 120) { --rtn; }
+
+    // Bad files should throw
+    try {
+        morph::idx_file bad ("./testidx_does-not-exist");
+        --rtn;
+    } catch (const std::exception&) {}
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
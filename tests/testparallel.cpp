@@ -0,0 +1,104 @@
+/*
+ * Test morph::parallel: that parallel_for visits every index exactly once, that parallel_reduce
+ * gives the same answer on any number of threads, that loops can be nested, and that exceptions
+ * thrown in tasks reach the caller.
+ */
+
+#include <morph/parallel.h>
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <cmath>
+
+int main()
+{
+    int rtn = 0;
+
+    std::vector<float> data (1000003);
+    for (std::size_t i = 0; i < data.size(); ++i) { data[i] = 1.0f + std::sin (0.001f * i) * 1000.0f; }
+
+    auto sum = [&data]() {
+        return morph::parallel::parallel_reduce (std::size_t{0}, data.size(), 0.0f,
+                                                 [&data](std::size_t i0, std::size_t i1) {
+                                                     float s = 0.0f;
+                                                     for (std::size_t i = i0; i < i1; ++i) { s += data[i]; }
+                                                     return s;
+                                                 },
+                                                 [](float a, float b) { return a + b; });
+    };
+
+    float sum1 = 0.0f;
+    for (unsigned int nt : { 1u, 2u, 3u, 4u, 7u }) {
+        morph::parallel::set_num_threads (nt);
+        if (morph::parallel::num_threads() != nt || morph::parallel::pool().size() != nt) {
+            std::cout << "Asked for " << nt << " threads, got " << morph::parallel::pool().size() << "\n";
+            --rtn;
+        }
+
+        // Each index visited once, with signed and unsigned indices and various grains
+        for (std::size_t grain : { std::size_t{0}, std::size_t{1}, std::size_t{1000}, std::size_t{5000000} }) {
+            std::vector<std::atomic<int>> visits (10007);
+            morph::parallel::parallel_for (std::int64_t{0}, std::int64_t{10007}, [&visits](std::int64_t i) { visits[i]++; }, grain);
+            morph::parallel::parallel_for (5u, 10007u, [&visits](unsigned int i) { visits[i]++; }, grain);
+            for (std::size_t i = 0; i < visits.size(); ++i) {
+                if (visits[i] != (i < 5 ? 1 : 2)) {
+                    std::cout << nt << " threads, grain " << grain << ": index " << i << " visited " << visits[i] << " times\n";
+                    --rtn;
+                    break;
+                }
+            }
+        }
+
+        // Empty and reversed ranges do nothing
+        int calls = 0;
+        morph::parallel::parallel_for (10, 10, [&calls](int) { ++calls; });
+        morph::parallel::parallel_for (10, 3, [&calls](int) { ++calls; });
+        if (calls != 0) { std::cout << "An empty range made " << calls << " calls\n"; --rtn; }
+
+        // The float reduction is bitwise the same on every number of threads
+        float s = sum();
+        if (nt == 1) {
+            sum1 = s;
+        } else if (s != sum1) {
+            std::cout << "Sum on " << nt << " threads (" << s << ") differs from sum on one thread (" << sum1 << ")\n";
+            --rtn;
+        }
+
+        // Nested loops
+        std::vector<std::atomic<int>> cells (64 * 64);
+        morph::parallel::parallel_for (0, 64, [&cells](int r) {
+            morph::parallel::parallel_for (0, 64, [&cells, r](int c) { cells[r * 64 + c] += r + c; }, 8);
+        }, 1);
+        for (int r = 0; r < 64; ++r) {
+            for (int c = 0; c < 64; ++c) {
+                if (cells[r * 64 + c] != r + c) { std::cout << "Nested loop missed cell " << r << "," << c << "\n"; --rtn; r = 64; break; }
+            }
+        }
+
+        // Task groups, and an exception thrown in one task
+        std::atomic<int> done = 0;
+        morph::parallel::task_group g;
+        for (int t = 0; t < 20; ++t) { g.run ([&done]{ done++; }); }
+        g.run ([]{ throw std::runtime_error ("task failed"); });
+        bool caught = false;
+        try { g.wait(); } catch (const std::runtime_error&) { caught = true; }
+        if (done != 20 || !caught) {
+            std::cout << nt << " threads: task group ran " << done << " tasks, exception " << (caught ? "" : "not ") << "caught\n";
+            --rtn;
+        }
+
+        // An exception thrown in a parallel_for body
+        caught = false;
+        try {
+            morph::parallel::parallel_for (0, 100000, [](int i) { if (i == 77777) { throw std::runtime_error ("loop failed"); } });
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        if (!caught) { std::cout << nt << " threads: exception from parallel_for not caught\n"; --rtn; }
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
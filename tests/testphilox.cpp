@@ -0,0 +1,92 @@
+/*
+ * Test morph::philox4x32 against the known answers from the Random123 distribution, and test
+ * its bulk fill functions.
+ */
+
+#include <morph/philox.h>
+#include <morph/vvec.h>
+#include <morph/Random.h>
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+int main()
+{
+    int rtn = 0;
+
+    // Known answer tests. Key (k0, k1) is the seed; counter (c0, c1, c2, c3) is the block
+    // number (c0, c1) and the stream (c2, c3).
+    struct kat { std::uint32_t k[2]; std::uint32_t c[4]; std::uint32_t r[4]; };
+    std::vector<kat> kats = {
+        { { 0u, 0u }, { 0u, 0u, 0u, 0u }, { 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u } },
+        { { 0xffffffffu, 0xffffffffu }, { 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu },
+          { 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu } },
+        { { 0xa4093822u, 0x299f31d0u }, { 0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u },
+          { 0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u } }
+    };
+    for (auto t : kats) {
+        morph::philox4x32 gen ((static_cast<std::uint64_t>(t.k[1]) << 32) | t.k[0],
+                               (static_cast<std::uint64_t>(t.c[3]) << 32) | t.c[2]);
+        morph::philox4x32::block_type r = gen.block ((static_cast<std::uint64_t>(t.c[1]) << 32) | t.c[0]);
+        for (int i = 0; i < 4; ++i) {
+            if (r[i] != t.r[i]) { std::cout << "Known answer test failed\n"; --rtn; break; }
+        }
+    }
+
+    // discard() jumps to the same place as drawing
+    morph::philox4x32 g1 (7);
+    morph::philox4x32 g2 (7);
+    for (int i = 0; i < 1001; ++i) { g1(); }
+    g2.discard (1001);
+    if (g1() != g2() || g1.position() != 1002) { --rtn; }
+
+    // Different streams differ
+    morph::philox4x32 s0 (7, 0);
+    morph::philox4x32 s1 (7, 1);
+    if (s0() == s1()) { --rtn; }
+
+    // A bulk fill gives the same numbers as two fills of its two halves (with a whole number
+    // of blocks in the first half), whatever the number of threads doing the work.
+    std::vector<float> whole (200000);
+    std::vector<float> halves (200000);
+    morph::philox4x32 fw (99);
+    fw.fill_uniform (std::span<float>(whole));
+    morph::philox4x32 fh (99);
+    fh.fill_uniform (std::span<float>(halves.data(), 100000));
+    fh.fill_uniform (std::span<float>(halves.data() + 100000, 100000));
+    if (whole != halves || fw.position() != fh.position()) { std::cout << "Fills differ\n"; --rtn; }
+
+    // Uniform doubles in [2, 5): check range and moments
+    morph::vvec<double> u (400000);
+    morph::philox4x32 fu (3);
+    fu.fill_uniform (std::span<double>(u), 2.0, 5.0);
+    morph::range<double> ur = u.minmax();
+    if (ur.min < 2.0 || ur.max >= 5.0 || std::abs (u.mean() - 3.5) > 0.01 || std::abs (u.std() - std::sqrt (0.75)) > 0.01) {
+        std::cout << "Uniform fill: range " << ur << ", mean " << u.mean() << ", sd " << u.std() << "\n";
+        --rtn;
+    }
+
+    // Normal floats (an odd number of them) with mean 1, sigma 2
+    morph::vvec<float> n (300001);
+    morph::philox4x32 fn (4);
+    fn.fill_normal (std::span<float>(n), 1.0f, 2.0f);
+    if (std::abs (n.mean() - 1.0f) > 0.02f || std::abs (n.std() - 2.0f) > 0.02f || n.has_nan_or_inf()) {
+        std::cout << "Normal fill: mean " << n.mean() << ", sd " << n.std() << "\n";
+        --rtn;
+    }
+
+    // philox4x32 serves as an engine for the morph::Random classes
+    morph::RandUniform<float, morph::philox4x32> ru;
+    float f = ru.get();
+    if (f < 0.0f || f >= 1.0f) { --rtn; }
+
+    // vvec::randomize uses it
+    morph::vvec<float> vr (1000);
+    vr.randomize (-1.0f, 1.0f);
+    if (vr.min() < -1.0f || vr.max() >= 1.0f || std::abs (vr.mean()) > 0.1f) { --rtn; }
+    vr.randomizeN (10.0f, 0.5f);
+    if (std::abs (vr.mean() - 10.0f) > 0.1f) { --rtn; }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
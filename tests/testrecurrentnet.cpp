@@ -0,0 +1,108 @@
+/*
+ * Test that RecurrentNetwork's forward, backward and weight update dynamics, which work on
+ * compressed sparse row/column forms of the connectivity, match the same dynamics computed
+ * directly from the list of (Pre, Post, W) connections.
+ */
+
+#include <morph/nn/RecurrentNetwork.h>
+#include <morph/rngd.h>
+#include <vector>
+#include <iostream>
+#include <cmath>
+#include <utility>
+#include <stdexcept>
+
+// The reference dynamics, looping over the connection list
+struct reference
+{
+    std::vector<double> X, U, F, Fprime, V, Y;
+};
+
+int main()
+{
+    int rtn = 0;
+
+    const int N = 300;
+    morph::nn::recurrentnet::RecurrentNetwork P (N, 0.1, 10.0, 1.0, 1.0, 0.0001, 100);
+    // Random, unordered connectivity
+    for (int k = 0; k < 6000; ++k) {
+        P.connect (static_cast<int>(morph::randDouble() * N) % N, static_cast<int>(morph::randDouble() * N) % N);
+    }
+    P.addBias();
+    P.setNet();
+    P.randomizeWeights (-1.0, 1.0);
+    P.randomizeState();
+    for (int i = 0; i < 10; ++i) { P.Input[i] = 0.5; }
+
+    reference r;
+    r.X = P.X;
+    r.U.assign (N, 0.0);
+    r.F.assign (N, 0.0);
+    r.Fprime.assign (N, 0.0);
+    r.V.assign (N + 1, 0.0);
+    r.Y = P.Y;
+    std::vector<double> Wr = P.W;
+
+    std::vector<int> oID = {N - 1, N - 2, N - 3};
+    std::vector<double> target = {0.2, 0.4, 0.6};
+
+    for (int t = 0; t < 20; ++t) {
+        // Reference forward
+        std::fill (r.U.begin(), r.U.end(), 0.0);
+        for (int k = 0; k < P.Nweight; ++k) { r.U[P.Post[k]] += r.X[P.Pre[k]] * Wr[k]; }
+        for (int i = 0; i < N; ++i) { r.F[i] = 1.0 / (1.0 + std::exp (-r.U[i])); }
+        for (int i = 0; i < N; ++i) { r.X[i] += P.dtOverTauX * (-r.X[i] + r.F[i] + P.Input[i]); }
+        P.forward();
+
+        P.setError (oID, target);
+
+        // Reference backward
+        for (int i = 0; i < N; ++i) { r.Fprime[i] = r.F[i] * (1.0 - r.F[i]); }
+        std::fill (r.V.begin(), r.V.end(), 0.0);
+        for (int k = 0; k < P.Nweight; ++k) { r.V[P.Pre[k]] += r.Fprime[P.Post[k]] * Wr[k] * r.Y[P.Post[k]]; }
+        for (int i = 0; i < N; ++i) { r.Y[i] += P.dtOverTauY * (r.V[i] - r.Y[i] + P.J[i]); }
+        P.backward();
+
+        // Reference weight update
+        for (int k = 0; k < P.Nweight; ++k) {
+            double delta = r.X[P.Pre[k]] * r.Y[P.Post[k]] * r.Fprime[P.Post[k]];
+            if (delta < -1.0) { Wr[k] -= P.dtOverTauW; }
+            else if (delta > 1.0) { Wr[k] += P.dtOverTauW; }
+            else { Wr[k] += P.dtOverTauW * delta; }
+        }
+        P.weightUpdate();
+    }
+
+    // Summation is in the same order in each case, so results should agree very closely
+    const double tol = 1e-12;
+    for (int i = 0; i < N; ++i) {
+        if (std::abs (P.X[i] - r.X[i]) > tol || std::abs (P.Y[i] - r.Y[i]) > tol) { --rtn; break; }
+    }
+    for (int k = 0; k < P.Nweight; ++k) {
+        if (std::abs (P.W[k] - Wr[k]) > tol) { --rtn; break; }
+    }
+
+    // The weight matrix has an element for each pre/post pair, including the bias node
+    std::vector<double> wm = P.getWeightMatrix();
+    if (static_cast<int>(wm.size()) != (N + 1) * (N + 1)) { --rtn; }
+    if (wm[P.Pre[0] * (N + 1) + P.Post[0]] == 0.0) { --rtn; }
+
+    // Connections to or from nodes that don't exist are rejected by setNet
+    for (auto pp : { std::pair<int, int>{0, N}, {N, 0}, {-1, 0}, {0, -1} }) {
+        morph::nn::recurrentnet::RecurrentNetwork Q (N, 0.1, 10.0, 1.0, 1.0, 0.0001, 100);
+        Q.connect (pp.first, pp.second);
+        try {
+            Q.setNet();
+            std::cout << "setNet accepted a connection from " << pp.first << " to " << pp.second << "\n";
+            --rtn;
+        } catch (const std::runtime_error&) {}
+    }
+    // With a bias, node N is a valid pre-synaptic node
+    morph::nn::recurrentnet::RecurrentNetwork Qb (N, 0.1, 10.0, 1.0, 1.0, 0.0001, 100);
+    Qb.connect (N - 1, 0);
+    Qb.addBias();
+    try { Qb.setNet(); } catch (const std::runtime_error& e) { std::cout << e.what() << "\n"; --rtn; }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}
@@ -0,0 +1,172 @@
+/*
+ * Test the reductions in morph/reduce.h, which vvec::sum(), mean(), variance(), max() and friends
+ * use. Check their accuracy against long double references, that they give the same answers on
+ * one thread as on several, and the edge cases: empty vvecs, ties and integer elements.
+ */
+
+#include <morph/vvec.h>
+#include <morph/reduce.h>
+#include <iostream>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <complex>
+#include <algorithm>
+#ifdef _OPENMP
+# include <omp.h>
+#endif
+
+int main()
+{
+    int rtn = 0;
+
+    // Ten million floats with a large mean, which is hard on a naive running sum
+    morph::vvec<float> v (10000000);
+    v.randomize (1000.0f, 1001.0f);
+
+    long double ref_sum = 0.0L;
+    for (auto f : v) { ref_sum += f; }
+    const long double ref_mean = ref_sum / v.size();
+    long double ref_m2 = 0.0L;
+    for (auto f : v) { ref_m2 += (f - ref_mean) * (f - ref_mean); }
+    const long double ref_var = ref_m2 / (v.size() - 1);
+
+    const float s = v.sum();
+    const long double rel_sum_err = std::abs ((s - ref_sum) / ref_sum);
+    if (rel_sum_err > 1e-6L) {
+        std::cout << "float sum relative error " << static_cast<double>(rel_sum_err) << " is too large\n";
+        --rtn;
+    }
+
+    // A running float sum of these elements is wrong in the fourth significant figure, and the
+    // one-pass variance formula would lose every digit. Welford's algorithm should not.
+    const float var = v.variance();
+    const long double rel_var_err = std::abs ((var - ref_var) / ref_var);
+    if (rel_var_err > 1e-4L) {
+        std::cout << "float variance " << var << " (relative error " << static_cast<double>(rel_var_err) << ") is inaccurate\n";
+        --rtn;
+    }
+
+    // stats() gives the same as its separate counterparts. mean() divides a pairwise sum, so may
+    // differ from the Welford mean in the last few places.
+    morph::reduce::stats<float> st = v.stats();
+    morph::range<float> r = v.range();
+    if (st.n != v.size() || st.min != r.min || st.max != r.max || std::abs (st.mean - v.mean()) > 1e-3f
+        || st.variance() != var || st.std() != v.std()) {
+        std::cout << "stats() disagrees with range(), mean(), variance() or std()\n";
+        --rtn;
+    }
+
+    // The same answers from one thread as from several
+#ifdef _OPENMP
+    omp_set_num_threads (1);
+    const float s1 = v.sum();
+    const float var1 = v.variance();
+    const std::size_t am1 = v.argmax();
+    omp_set_num_threads (4);
+    const float s4 = v.sum();
+    const float var4 = v.variance();
+    const std::size_t am4 = v.argmax();
+    if (s1 != s4 || var1 != var4 || am1 != am4) {
+        std::cout << "Results on 1 and 4 threads differ: sum " << s1 << "/" << s4
+                  << ", variance " << var1 << "/" << var4 << ", argmax " << am1 << "/" << am4 << "\n";
+        --rtn;
+    }
+#endif
+
+    // Merging the stats of two halves gives the stats of the whole
+    morph::reduce::stats<double> sa = morph::reduce::welford<double> (v.data(), 3000001);
+    morph::reduce::stats<double> sb = morph::reduce::welford<double> (v.data() + 3000001, v.size() - 3000001);
+    sa.merge (sb);
+    morph::reduce::stats<double> sw = v.stats<double>();
+    if (sa.n != sw.n || std::abs (sa.mean - sw.mean) > 1e-9 || std::abs (sa.variance() - sw.variance()) / sw.variance() > 1e-9) {
+        std::cout << "Merged stats " << sa.mean << "/" << sa.variance() << " != " << sw.mean << "/" << sw.variance() << "\n";
+        --rtn;
+    }
+
+    // argmax and argmin return the first of several equal extrema, even across chunks
+    morph::vvec<int> iv (3 * morph::reduce::chunk, 1);
+    iv[morph::reduce::chunk + 7] = 9;
+    iv[2 * morph::reduce::chunk + 5] = 9;
+    iv[40] = 9;
+    iv[morph::reduce::chunk - 1] = -2;
+    iv[2 * morph::reduce::chunk] = -2;
+    if (iv.argmax() != 40 || iv.max() != 9 || iv.argmin() != morph::reduce::chunk - 1 || iv.min() != -2) {
+        std::cout << "argmax " << iv.argmax() << " or argmin " << iv.argmin() << " is not the first extremum\n";
+        --rtn;
+    }
+
+    // With NaNs, argmax and argmin agree with std::max_element and std::min_element: a leading
+    // NaN is returned, other NaNs are passed over and an all-NaN vvec gives 0
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    for (std::size_t n : { std::size_t{3}, std::size_t{20}, 3 * morph::reduce::chunk + 5 }) {
+        for (int pattern = 0; pattern < 4; ++pattern) {
+            morph::vvec<float> fv (n);
+            for (std::size_t i = 0; i < n; ++i) { fv[i] = std::sin (0.1f * i); }
+            // NaN patterns: leading, interior, all, and one at the start of each chunk
+            if (pattern == 0) { fv[0] = nan; }
+            if (pattern == 1) { for (std::size_t i = 1; i < n; i += 2) { fv[i] = nan; } }
+            if (pattern == 2) { fv.set_from (nan); }
+            if (pattern == 3) { for (std::size_t i = morph::reduce::chunk; i < n; i += morph::reduce::chunk) { fv[i] = nan; } fv[1] = nan; }
+            const std::size_t emax = std::max_element (fv.begin(), fv.end()) - fv.begin();
+            const std::size_t emin = std::min_element (fv.begin(), fv.end()) - fv.begin();
+            const float vmax = fv.max();
+            const float vmin = fv.min();
+            if (fv.argmax() != emax || fv.argmin() != emin
+                || !(vmax == fv[emax] || (std::isnan (vmax) && std::isnan (fv[emax])))
+                || !(vmin == fv[emin] || (std::isnan (vmin) && std::isnan (fv[emin])))) {
+                std::cout << n << " elements, NaN pattern " << pattern << ": argmax " << fv.argmax() << " (expected " << emax
+                          << "), argmin " << fv.argmin() << " (expected " << emin << ")\n";
+                --rtn;
+            }
+        }
+    }
+
+    // Integer sums are exact, and can be accumulated in a wider type
+    morph::vvec<std::int32_t> big (2000000, 2000);
+    if (big.sum<false, std::int64_t>() != std::int64_t{4000000000}) {
+        std::cout << "int64 sum of int32 elements is " << big.sum<false, std::int64_t>() << "\n";
+        --rtn;
+    }
+    morph::vvec<int> seq (5000);
+    seq.linspace (1, 5000);
+    if (seq.sum() != 12502500 || seq.mean() != 2500 || seq.sos<false, std::int64_t>() != std::int64_t{41679167500}) {
+        std::cout << "Integer sum " << seq.sum() << ", mean " << seq.mean() << " or sos " << seq.sos<false, std::int64_t>() << " is wrong\n";
+        --rtn;
+    }
+
+    // A product with zero in it is zero
+    morph::vvec<float> pz = { 2.0f, 0.0f, 3.0f };
+    morph::vvec<float> p = { 2.0f, 1.5f, 3.0f };
+    if (pz.product() != 0.0f || p.product() != 9.0f) {
+        std::cout << "products " << pz.product() << " and " << p.product() << " are wrong\n";
+        --rtn;
+    }
+    // ...whether or not nans are being skipped
+    const float nanf = std::numeric_limits<float>::quiet_NaN();
+    morph::vvec<float> pzn = { nanf, 2.0f, nanf, 0.0f, 3.0f };
+    morph::vvec<float> pn = { nanf, 2.0f, nanf, 1.5f, 3.0f };
+    morph::vvec<float> pallnan = { nanf, nanf };
+    if (pz.product<true>() != 0.0f || pzn.product<true>() != 0.0f || pn.product<true>() != 9.0f || pallnan.product<true>() != 0.0f) {
+        std::cout << "products ignoring nans " << pz.product<true>() << ", " << pzn.product<true>() << ", "
+                  << pn.product<true>() << " and " << pallnan.product<true>() << " are wrong\n";
+        --rtn;
+    }
+    // ...and for element types that aren't handled by morph::reduce
+    morph::vvec<std::complex<float>> cz = { {2.0f, 1.0f}, {0.0f, 0.0f}, {3.0f, 0.0f} };
+    morph::vvec<std::complex<float>> c = { {2.0f, 1.0f}, {0.0f, 1.0f}, {3.0f, 0.0f} };
+    if (cz.product() != std::complex<float>{0.0f, 0.0f} || c.product() != std::complex<float>{-3.0f, 6.0f}) {
+        std::cout << "complex products " << cz.product() << " and " << c.product() << " are wrong\n";
+        --rtn;
+    }
+
+    // Empty vvecs
+    morph::vvec<double> e;
+    if (e.sum() != 0.0 || e.max() != 0.0 || e.min() != 0.0 || e.argmax() != 0 || e.variance() != 0.0 || e.stats().n != 0) {
+        std::cout << "reductions of an empty vvec are not zero\n";
+        --rtn;
+    }
+
+    std::cout << "Test " << (rtn == 0 ? "PASSED" : "FAILED") << std::endl;
+    return rtn;
+}